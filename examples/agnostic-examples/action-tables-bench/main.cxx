@@ -0,0 +1,302 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Times the making of the lists of actions adding, requiring and deleting
+// each fluent, in the CSR tables of STRIPS_Problem and in the vectors of
+// vectors they replace, and a pass over the actions adding each fluent,
+// as h1 and the landmark graph do. The task is read with the PDDL_Reader,
+// or made up at random, large enough to have millions of (fluent, action)
+// pairs.
+#include <strips_prob.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <lifted_task.hxx>
+#include <relaxed_grounder.hxx>
+#include <pddl_reader.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+using	aptk::Action;
+using	aptk::Action_Span;
+using	aptk::Fluent_Vec;
+using	aptk::agnostic::Lifted_Task;
+using	aptk::agnostic::Relaxed_Grounder;
+using	aptk::agnostic::PDDL_Reader;
+
+typedef	std::vector< std::vector< const Action* > >	Nested_Table;
+
+struct Nested_Tables {
+	Nested_Table	requiring;
+	Nested_Table	adding;
+	Nested_Table	deleting;
+	std::vector< std::vector< std::pair< unsigned, const Action* > > >	ceffs_adding;
+
+	// As the tables used to be made, one action at a time
+	void	make( const STRIPS_Problem& prob ) {
+		unsigned nf = prob.num_fluents();
+		requiring.assign( nf, std::vector< const Action* >() );
+		adding.assign( nf, std::vector< const Action* >() );
+		deleting.assign( nf, std::vector< const Action* >() );
+		ceffs_adding.assign( nf, std::vector< std::pair< unsigned, const Action* > >() );
+		for ( unsigned k = 0; k < prob.actions().size(); k++ ) {
+			const Action* a = prob.actions()[k];
+			for ( unsigned i = 0; i < a->prec_vec().size(); i++ )
+				requiring[ a->prec_vec()[i] ].push_back( a );
+			for ( unsigned i = 0; i < a->add_vec().size(); i++ )
+				adding[ a->add_vec()[i] ].push_back( a );
+			for ( unsigned c = 0; c < a->ceff_vec().size(); c++ )
+				for ( unsigned i = 0; i < a->ceff_vec()[c]->add_vec().size(); i++ )
+					ceffs_adding[ a->ceff_vec()[c]->add_vec()[i] ].push_back( std::make_pair( c, a ) );
+			for ( unsigned i = 0; i < a->del_vec().size(); i++ )
+				deleting[ a->del_vec()[i] ].push_back( a );
+		}
+	}
+
+	template <typename Table>
+	static size_t	bytes( const Table& t ) {
+		size_t b = t.capacity() * sizeof( typename Table::value_type );
+		for ( unsigned f = 0; f < t.size(); f++ )
+			b += t[f].capacity() * sizeof( typename Table::value_type::value_type );
+		return b;
+	}
+
+	size_t	bytes() const {
+		return bytes( requiring ) + bytes( adding ) + bytes( deleting ) + bytes( ceffs_adding );
+	}
+};
+
+// Fluents of an action are drawn from a window around a point of the
+// fluents, so that lists of neighbouring fluents share actions, as those
+// of the same objects do in grounded tasks
+struct Random_Task {
+	unsigned	fluents;
+	unsigned	actions;
+	unsigned	precs;
+	unsigned	adds;
+	unsigned	dels;
+	unsigned	ceffs;
+	uint64_t	state;
+
+	unsigned	next( unsigned n ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (unsigned)( ( state >> 33 ) % n );
+	}
+
+	void	pick( unsigned centre, unsigned n, Fluent_Vec& out ) {
+		out.clear();
+		unsigned window = std::min( fluents, 64u );
+		while ( out.size() < n && out.size() < window ) {
+			unsigned f = ( centre + next( window ) ) % fluents;
+			if ( std::find( out.begin(), out.end(), f ) == out.end() )
+				out.push_back( f );
+		}
+	}
+
+	void	make( STRIPS_Problem& prob ) {
+		for ( unsigned f = 0; f < fluents; f++ ) {
+			std::stringstream sig;
+			sig << "(F" << f << ")";
+			STRIPS_Problem::add_fluent( prob, sig.str() );
+		}
+		Fluent_Vec pre, add, del, cpre, cadd, cdel;
+		for ( unsigned k = 0; k < actions; k++ ) {
+			unsigned centre = next( fluents );
+			pick( centre, precs, pre );
+			pick( centre, adds, add );
+			pick( centre, dels, del );
+			aptk::Conditional_Effect_Vec ce;
+			for ( unsigned c = 0; c < ceffs; c++ ) {
+				aptk::Conditional_Effect* e = new aptk::Conditional_Effect( prob );
+				pick( centre, 1, cpre );
+				pick( centre, 1, cadd );
+				e->define( cpre, cadd, cdel );
+				ce.push_back( e );
+			}
+			std::stringstream sig;
+			sig << "(A" << k << ")";
+			STRIPS_Problem::add_action( prob, sig.str(), pre, add, del, ce );
+		}
+	}
+};
+
+size_t	incidences( const STRIPS_Problem& prob ) {
+	size_t n = 0;
+	for ( unsigned k = 0; k < prob.actions().size(); k++ ) {
+		const Action* a = prob.actions()[k];
+		n += a->prec_vec().size() + a->add_vec().size() + a->del_vec().size();
+		for ( unsigned c = 0; c < a->ceff_vec().size(); c++ )
+			n += a->ceff_vec()[c]->add_vec().size();
+	}
+	return n;
+}
+
+// The walk h1 does over the achievers of each fluent
+template <typename Table>
+float	walk_nested( const STRIPS_Problem& prob, const Table& adding ) {
+	float sum = 0;
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ )
+		for ( unsigned k = 0; k < adding[f].size(); k++ )
+			sum += adding[f][k]->cost();
+	return sum;
+}
+
+float	walk_csr( const STRIPS_Problem& prob ) {
+	float sum = 0;
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ ) {
+		Action_Span adding = prob.actions_adding( f );
+		for ( unsigned k = 0; k < adding.size(); k++ )
+			sum += adding[k]->cost();
+	}
+	return sum;
+}
+
+bool	same_lists( const STRIPS_Problem& prob, const Nested_Tables& nested ) {
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ ) {
+		Action_Span adding = prob.actions_adding( f );
+		Action_Span requiring = prob.actions_requiring( f );
+		Action_Span deleting = prob.actions_deleting( f );
+		aptk::Ceff_Span ceffs = prob.ceffs_adding( f );
+		if ( adding.size() != nested.adding[f].size()
+			|| requiring.size() != nested.requiring[f].size()
+			|| deleting.size() != nested.deleting[f].size()
+			|| ceffs.size() != nested.ceffs_adding[f].size() )
+			return false;
+		if ( !std::equal( adding.begin(), adding.end(), nested.adding[f].begin() )
+			|| !std::equal( requiring.begin(), requiring.end(), nested.requiring[f].begin() )
+			|| !std::equal( deleting.begin(), deleting.end(), nested.deleting[f].begin() ) )
+			return false;
+		for ( unsigned k = 0; k < ceffs.size(); k++ )
+			if ( ceffs[k] != nested.ceffs_adding[f][k] )
+				return false;
+	}
+	return true;
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "domain", po::value<std::string>(), "Input PDDL domain description, a random task is made without one" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "fluents", po::value<unsigned>()->default_value(200000), "Fluents of the random task" )
+		( "actions", po::value<unsigned>()->default_value(400000), "Actions of the random task" )
+		( "precs", po::value<unsigned>()->default_value(4), "Preconditions of each action" )
+		( "adds", po::value<unsigned>()->default_value(2), "Add effects of each action" )
+		( "dels", po::value<unsigned>()->default_value(2), "Delete effects of each action" )
+		( "ceffs", po::value<unsigned>()->default_value(1), "Conditional effects of each action" )
+		( "seed", po::value<unsigned>()->default_value(1), "Seed for the random task" )
+		( "repeat", po::value<unsigned>()->default_value(5), "Times each table is made and walked, the best time is kept" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") ) {
+		std::cout << desc << std::endl;
+		return 0;
+	}
+
+	STRIPS_Problem prob;
+	std::string name = "random";
+	if ( vm.count("domain") && vm.count("problem") ) {
+		Lifted_Task task;
+		PDDL_Reader reader( task );
+		reader.read_domain( vm["domain"].as<std::string>() );
+		reader.read_problem( vm["problem"].as<std::string>() );
+		Relaxed_Grounder grounder( task );
+		grounder.ground( prob );
+		name = vm["problem"].as<std::string>();
+	}
+	else {
+		Random_Task r;
+		r.fluents = vm["fluents"].as<unsigned>();
+		r.actions = vm["actions"].as<unsigned>();
+		r.precs = vm["precs"].as<unsigned>();
+		r.adds = vm["adds"].as<unsigned>();
+		r.dels = vm["dels"].as<unsigned>();
+		r.ceffs = vm["ceffs"].as<unsigned>();
+		r.state = vm["seed"].as<unsigned>();
+		r.make( prob );
+	}
+
+	unsigned repeat = std::max( 1u, vm["repeat"].as<unsigned>() );
+	double csr_secs = 1e30, nested_secs = 1e30, csr_walk_secs = 1e30, nested_walk_secs = 1e30;
+	float csr_sum = 0, nested_sum = 0;
+	Nested_Tables nested;
+	for ( unsigned k = 0; k < repeat; k++ ) {
+		double t0 = aptk::wall_time();
+		prob.make_fluent_action_tables();
+		csr_secs = std::min( csr_secs, aptk::wall_time() - t0 );
+
+		Nested_Tables n;
+		t0 = aptk::wall_time();
+		n.make( prob );
+		nested_secs = std::min( nested_secs, aptk::wall_time() - t0 );
+		if ( k == 0 ) std::swap( nested, n );
+
+		t0 = aptk::wall_time();
+		csr_sum = walk_csr( prob );
+		csr_walk_secs = std::min( csr_walk_secs, aptk::wall_time() - t0 );
+
+		t0 = aptk::wall_time();
+		nested_sum = walk_nested( prob, nested.adding );
+		nested_walk_secs = std::min( nested_walk_secs, aptk::wall_time() - t0 );
+	}
+
+	if ( !same_lists( prob, nested ) || csr_sum != nested_sum ) {
+		std::cerr << "CSR tables differ from the vectors of actions" << std::endl;
+		return 1;
+	}
+
+	std::ofstream log( "action-tables-bench.log" );
+	const char* header = "problem,fluents,actions,incidences,csr_secs,csr_bytes,nested_secs,nested_bytes,csr_walk_secs,nested_walk_secs";
+	std::stringstream row;
+	row << name << "," << prob.num_fluents() << "," << prob.num_actions() << "," << incidences( prob ) << ","
+		<< csr_secs << "," << prob.fluent_action_tables_bytes() << ","
+		<< nested_secs << "," << nested.bytes() << ","
+		<< csr_walk_secs << "," << nested_walk_secs;
+	std::cout << header << std::endl << row.str() << std::endl;
+	log << header << std::endl << row.str() << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,406 @@
+#!/usr/bin/python
+# Runs a matrix of planner configurations over the IPC-2006 benchmarks,
+# with limits on the CPU time and memory of each run and several runs at
+# once, and writes coverage, expansions, time to the first plan, cost of
+# the last plan and peak RSS of each run as CSV. Given the CSV of an
+# earlier run as baseline, it flags the slowdowns that are significant.
+#
+# Usage: bench_matrix.py [options]
+#
+#  -m --matrix <file>        Configurations, one per line: a name, the planner
+#                            binary relative to this folder, and its arguments.
+#                            {time} and {memory} are replaced by the limits.
+#                            Those in DEFAULT_MATRIX below if not given
+#  -c --configs <names>      Configurations of the matrix run, comma separated
+#  -b --benchmarks <dir>     Defaults to benchmarks/ipc-2006 of the repository
+#  -d --domains <names>      Domains, comma separated, all by default
+#  -p --problems <names>     Problems, comma separated (p01,p02), or the first
+#                            N problems of each domain if a number (5 by default)
+#  -t --max-time <secs>      Time given to each run (300 by default). The CPU
+#                            limit is 5 secs more, for the planners to write
+#                            their logs once their own budget is spent
+#  -M --max-memory <MB>      Address space of each run (2048 by default)
+#  -j --jobs <n>             Runs at the same time (1 by default)
+#  -r --repeat <n>           Runs of each configuration and problem (1 by default)
+#  -w --work <dir>           Folder where each run has a folder of its own
+#  -o --output <file>        CSV with the runs (bench_matrix.csv by default)
+#  -B --baseline <file>      CSV written by an earlier run to compare with
+#  -k --metric <column>      Compared column (first_plan_secs by default)
+#  -T --threshold <ratio>    Slowdowns below this are not flagged (0.1 by default)
+#  -a --alpha <p>            Significance level (0.05 by default)
+#
+# The comparison is made for each problem, with a Welch t-test on the log
+# of the times when both sides have two runs or more, and for each
+# configuration, with a paired t-test on the log of the ratios over the
+# problems both solve. Problems solved in the baseline and not any more are
+# flagged too, and the exit code is 1 when anything is flagged.
+from	__future__ import print_function, division
+import 	sys, os, io, glob, getopt, math, time, signal, resource, csv
+
+here = os.path.dirname( os.path.abspath( sys.argv[0] ) )
+
+DEFAULT_MATRIX = """
+# name		planner				arguments
+wa		wa-planner/planner		--time {time}
+rwa		rwa-planner/planner		--time {time}
+pe-1		parallel-eval-planner/planner	--time {time} --threads 1
+pe-2		parallel-eval-planner/planner	--time {time} --threads 2
+hda-2		hda-planner/planner		--time {time} --threads 2
+siw		siw/siw
+"""
+
+COLUMNS = [ 'config', 'domain', 'problem', 'run', 'status', 'exit', 'cpu_secs', 'wall_secs',
+		'peak_rss_mb', 'plans', 'first_plan_secs', 'cost', 'expanded' ]
+
+# Times below this are taken to be this, so that runs of a few
+# milliseconds do not make ratios out of noise
+MIN_SECS = 0.05
+
+class Options :
+
+	def __init__( self, args ) :
+		try :
+			opts, args = getopt.getopt( args, "hm:c:b:d:p:t:M:j:r:w:o:B:k:T:a:",
+						[ "help", "matrix=", "configs=", "benchmarks=", "domains=", "problems=",
+						"max-time=", "max-memory=", "jobs=", "repeat=", "work=", "output=",
+						"baseline=", "metric=", "threshold=", "alpha=" ] )
+		except getopt.GetoptError as e :
+			bail_out( str(e) )
+
+		self.matrix = None
+		self.configs = None
+		self.benchmarks = os.path.join( here, '..', '..', 'benchmarks', 'ipc-2006' )
+		self.domains = None
+		self.problems = '5'
+		self.max_time = 300
+		self.max_memory = 2048
+		self.jobs = 1
+		self.repeat = 1
+		self.work = 'bench-runs'
+		self.output = 'bench_matrix.csv'
+		self.baseline = None
+		self.metric = 'first_plan_secs'
+		self.threshold = 0.1
+		self.alpha = 0.05
+
+		for opcode, oparg in opts :
+			if opcode in ( '-h', '--help' ) :
+				usage()
+				sys.exit(0)
+			elif opcode in ( '-m', '--matrix' ) : self.matrix = oparg
+			elif opcode in ( '-c', '--configs' ) : self.configs = oparg.split(',')
+			elif opcode in ( '-b', '--benchmarks' ) : self.benchmarks = oparg
+			elif opcode in ( '-d', '--domains' ) : self.domains = oparg.split(',')
+			elif opcode in ( '-p', '--problems' ) : self.problems = oparg
+			elif opcode in ( '-t', '--max-time' ) : self.max_time = positive( oparg, int )
+			elif opcode in ( '-M', '--max-memory' ) : self.max_memory = positive( oparg, int )
+			elif opcode in ( '-j', '--jobs' ) : self.jobs = positive( oparg, int )
+			elif opcode in ( '-r', '--repeat' ) : self.repeat = positive( oparg, int )
+			elif opcode in ( '-w', '--work' ) : self.work = oparg
+			elif opcode in ( '-o', '--output' ) : self.output = oparg
+			elif opcode in ( '-B', '--baseline' ) : self.baseline = oparg
+			elif opcode in ( '-k', '--metric' ) :
+				if oparg not in COLUMNS[6:] :
+					bail_out( "The metric has to be one of %s"%', '.join( COLUMNS[6:] ) )
+				self.metric = oparg
+			elif opcode in ( '-T', '--threshold' ) : self.threshold = positive( oparg, float )
+			elif opcode in ( '-a', '--alpha' ) : self.alpha = positive( oparg, float )
+
+# The comments at the top of this file
+def usage() :
+	for line in open( os.path.abspath( sys.argv[0] ) ) :
+		if not line.startswith( '#' ) : break
+		if not line.startswith( '#!' ) : print( line[2:].rstrip() )
+
+def bail_out( msg ) :
+	print( msg, file=sys.stderr )
+	print( "Bailing out!", file=sys.stderr )
+	sys.exit(2)
+
+def positive( arg, kind ) :
+	try :
+		v = kind( arg )
+	except ValueError :
+		bail_out( "%s is not a number"%arg )
+	if v <= 0 :
+		bail_out( "%s has to be greater than zero"%arg )
+	return v
+
+def read_matrix( text, wanted ) :
+	configs = []
+	for line in text.splitlines() :
+		line = line.split('#')[0].split()
+		if len(line) < 2 : continue
+		if wanted is not None and line[0] not in wanted : continue
+		planner = os.path.join( here, line[1] )
+		if not os.path.exists( planner ) :
+			bail_out( "Could not find %s for %s, build it first"%( planner, line[0] ) )
+		configs.append( ( line[0], planner, line[2:] ) )
+	if len(configs) == 0 :
+		bail_out( "No configurations to run" )
+	return configs
+
+# Most domains have their problems in problems/, pathways has them next
+# to a domain file for each
+def instances( bench_dir, domains, problems ) :
+	if domains is None :
+		domains = sorted( [ d for d in os.listdir( bench_dir ) if os.path.isdir( os.path.join( bench_dir, d ) ) ] )
+	for dom in domains :
+		d = os.path.join( bench_dir, dom )
+		found = sorted( glob.glob( os.path.join( d, 'problems', '*.pddl' ) ) )
+		if len(found) == 0 :
+			found = sorted( glob.glob( os.path.join( d, 'p*.pddl' ) ) )
+		if problems.isdigit() :
+			found = found[:int(problems)]
+		else :
+			names = problems.split(',')
+			found = [ p for p in found if os.path.basename(p).replace('.pddl','') in names ]
+		for p in found :
+			domain = os.path.join( d, 'domain.pddl' )
+			if not os.path.exists( domain ) :
+				domain = os.path.join( d, 'domain_' + os.path.basename(p) )
+			yield dom, domain, p
+
+class Run :
+
+	def __init__( self, config, dom, domain, problem, rep, opts ) :
+		self.config, self.planner, args = config
+		self.dom = dom
+		self.problem = os.path.basename( problem ).replace( '.pddl', '' )
+		self.rep = rep
+		self.dir = os.path.abspath( os.path.join( opts.work, self.config, dom, self.problem, str(rep) ) )
+		limits = { 'time' : opts.max_time, 'memory' : opts.max_memory }
+		self.argv = [ self.planner, '--domain', os.path.abspath( domain ), '--problem', os.path.abspath( problem ) ]
+		self.argv += [ a.format( **limits ) for a in args ]
+		self.max_time = opts.max_time
+		self.max_memory = opts.max_memory
+		self.pid = None
+
+	def start( self ) :
+		if not os.path.exists( self.dir ) :
+			os.makedirs( self.dir )
+		self.t0 = time.time()
+		self.pid = os.fork()
+		if self.pid == 0 :
+			try :
+				os.chdir( self.dir )
+				out = os.open( 'output', os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o644 )
+				os.dup2( out, 1 )
+				os.dup2( out, 2 )
+				resource.setrlimit( resource.RLIMIT_CPU, ( self.max_time + 5, self.max_time + 10 ) )
+				memory = self.max_memory * 1024 * 1024
+				resource.setrlimit( resource.RLIMIT_AS, ( memory, memory ) )
+				resource.setrlimit( resource.RLIMIT_CORE, ( 0, 0 ) )
+				os.execv( self.planner, self.argv )
+			finally :
+				os._exit( 127 )
+
+	# Runs that block without using CPU are killed after twice their time
+	def overdue( self ) :
+		return time.time() - self.t0 > 2 * self.max_time + 20
+
+	def finish( self, status, usage ) :
+		self.wall = time.time() - self.t0
+		self.cpu = usage.ru_utime + usage.ru_stime
+		# ru_maxrss is in KB on Linux
+		self.rss = usage.ru_maxrss / 1024
+		self.signal = os.WTERMSIG( status ) if os.WIFSIGNALED( status ) else 0
+		self.exit = os.WEXITSTATUS( status ) if os.WIFEXITED( status ) else -self.signal
+		self.read_logs()
+
+	# The planners write the plans and counts to the output or to log files
+	# of their own, as
+	#	Plan found with cost: <cost>
+	#	Time: <secs since the last plan>
+	#	Nodes expanded during search: <nodes>
+	def read_logs( self ) :
+		self.plans, self.cost, self.first_plan, self.expanded = 0, None, None, None
+		self.memout = False
+		files = [ os.path.join( self.dir, 'output' ) ] + sorted( glob.glob( os.path.join( self.dir, '*.log' ) ) )
+		for name in files :
+			plan_time = None
+			for line in io.open( name, errors='replace' ) :
+				if line.startswith( 'Plan found with cost:' ) :
+					self.plans += 1
+					self.cost = float( line.split(':')[1] )
+					plan_time = self.plans == 1
+				elif line.startswith( 'Time:' ) and plan_time :
+					self.first_plan = float( line.split(':')[1] )
+					plan_time = False
+				elif line.startswith( 'Nodes expanded during search:' ) :
+					self.expanded = int( line.split(':')[1] )
+				elif 'bad_alloc' in line :
+					self.memout = True
+
+	def status( self ) :
+		if self.plans > 0 : return 'solved'
+		if self.memout : return 'memout'
+		if self.signal in ( signal.SIGXCPU, signal.SIGKILL ) : return 'timeout'
+		if self.signal != 0 : return 'crash'
+		return 'unsolved'
+
+	def row( self ) :
+		def opt( v ) : return '' if v is None else v
+		return { 'config' : self.config, 'domain' : self.dom, 'problem' : self.problem, 'run' : self.rep,
+			'status' : self.status(), 'exit' : self.exit, 'cpu_secs' : '%.3f'%self.cpu,
+			'wall_secs' : '%.3f'%self.wall, 'peak_rss_mb' : '%.1f'%self.rss, 'plans' : self.plans,
+			'first_plan_secs' : opt( self.first_plan ), 'cost' : opt( self.cost ), 'expanded' : opt( self.expanded ) }
+
+def run_all( runs, jobs, writer, out ) :
+	pending = list( runs )
+	pending.reverse()
+	running = {}
+	done = []
+	while pending or running :
+		while pending and len(running) < jobs :
+			r = pending.pop()
+			r.start()
+			running[ r.pid ] = r
+		pid, status, usage = os.wait4( -1, os.WNOHANG )
+		if pid == 0 :
+			for r in running.values() :
+				if r.overdue() :
+					os.kill( r.pid, signal.SIGKILL )
+			time.sleep( 0.05 )
+			continue
+		r = running.pop( pid )
+		r.finish( status, usage )
+		writer.writerow( r.row() )
+		out.flush()
+		done.append( r.row() )
+		print( "%-10s %-12s %-4s %d  %-8s cpu %8.2f  rss %7.1f MB  plans %d"%( r.config, r.dom, r.problem,
+			r.rep, r.status(), r.cpu, r.rss, r.plans ) )
+	return done
+
+def coverage( rows ) :
+	solved = {}
+	for row in rows :
+		key = ( row['config'], row['domain'], row['problem'] )
+		solved[key] = solved.get( key, False ) or row['status'] == 'solved'
+	configs = sorted( set( k[0] for k in solved ) )
+	print( "\nCoverage" )
+	for c in configs :
+		cells = [ k for k in solved if k[0] == c ]
+		print( "%-10s %d of %d"%( c, len( [ k for k in cells if solved[k] ] ), len(cells) ) )
+
+# Values of the metric over the solved runs of each configuration and problem
+def samples( rows, metric ) :
+	s = {}
+	for row in rows :
+		key = ( row['config'], row['domain'], row['problem'] )
+		s.setdefault( key, [] )
+		if row['status'] == 'solved' and row[metric] != '' :
+			s[key].append( max( float( row[metric] ), MIN_SECS ) if metric.endswith( 'secs' ) else max( float( row[metric] ), 1.0 ) )
+	return s
+
+def mean( v ) :
+	return sum( v ) / len( v )
+
+def variance( v ) :
+	m = mean( v )
+	return sum( ( x - m ) ** 2 for x in v ) / ( len( v ) - 1 )
+
+# Regularized incomplete beta function, by its continued fraction
+# (Numerical Recipes, 6.4)
+def betacf( a, b, x ) :
+	tiny = 1e-30
+	def clamp( v ) : return v if abs(v) > tiny else tiny
+	qab, qap, qam = a + b, a + 1.0, a - 1.0
+	c, d = 1.0, 1.0 / clamp( 1.0 - qab * x / qap )
+	h = d
+	for m in range( 1, 300 ) :
+		m2 = 2 * m
+		aa = m * ( b - m ) * x / ( ( qam + m2 ) * ( a + m2 ) )
+		d = 1.0 / clamp( 1.0 + aa * d )
+		c = clamp( 1.0 + aa / c )
+		h *= d * c
+		aa = -( a + m ) * ( qab + m ) * x / ( ( a + m2 ) * ( qap + m2 ) )
+		d = 1.0 / clamp( 1.0 + aa * d )
+		c = clamp( 1.0 + aa / c )
+		h *= d * c
+		if abs( d * c - 1.0 ) < 3e-12 : break
+	return h
+
+def betainc( a, b, x ) :
+	if x <= 0.0 : return 0.0
+	if x >= 1.0 : return 1.0
+	front = math.exp( math.lgamma( a + b ) - math.lgamma( a ) - math.lgamma( b ) + a * math.log( x ) + b * math.log( 1.0 - x ) )
+	if x < ( a + 1.0 ) / ( a + b + 2.0 ) :
+		return front * betacf( a, b, x ) / a
+	return 1.0 - front * betacf( b, a, 1.0 - x ) / b
+
+# P( T > t ) for Student's t with df degrees of freedom
+def t_tail( t, df ) :
+	p = 0.5 * betainc( df / 2, 0.5, df / ( df + t * t ) )
+	return p if t > 0 else 1.0 - p
+
+# One sided, that the new values are larger
+def welch( new, old ) :
+	vn, vo = variance( new ) / len( new ), variance( old ) / len( old )
+	if vn + vo == 0.0 :
+		return 0.0 if mean( new ) > mean( old ) else 1.0
+	t = ( mean( new ) - mean( old ) ) / math.sqrt( vn + vo )
+	df = ( vn + vo ) ** 2 / ( vn ** 2 / ( len( new ) - 1 ) + vo ** 2 / ( len( old ) - 1 ) )
+	return t_tail( t, df )
+
+def one_sample( v ) :
+	if len( v ) < 2 : return 1.0
+	var = variance( v )
+	if var == 0.0 :
+		return 0.0 if mean( v ) > 0 else 1.0
+	return t_tail( mean( v ) / math.sqrt( var / len( v ) ), len( v ) - 1 )
+
+def compare( rows, baseline_rows, opts ) :
+	new, old = samples( rows, opts.metric ), samples( baseline_rows, opts.metric )
+	flagged = 0
+	print( "\nCompared with %s on %s"%( opts.baseline, opts.metric ) )
+	ratios = {}
+	for key in sorted( new ) :
+		if key not in old or len( old[key] ) == 0 : continue
+		if len( new[key] ) == 0 :
+			print( "LOST     %-10s %-12s %-4s solved in the baseline"%key )
+			flagged += 1
+			continue
+		ln, lo = [ math.log(x) for x in new[key] ], [ math.log(x) for x in old[key] ]
+		r = math.exp( mean( ln ) - mean( lo ) )
+		ratios.setdefault( key[0], [] ).append( mean( ln ) - mean( lo ) )
+		if len( ln ) > 1 and len( lo ) > 1 :
+			p = welch( ln, lo )
+			if r > 1 + opts.threshold and p < opts.alpha :
+				print( "SLOWER   %-10s %-12s %-4s x%.2f p=%.3f"%( key + ( r, p ) ) )
+				flagged += 1
+	for c in sorted( ratios ) :
+		p = one_sample( ratios[c] )
+		r = math.exp( mean( ratios[c] ) )
+		mark = "SLOWER  " if r > 1 + opts.threshold and p < opts.alpha else "        "
+		if mark != "        " : flagged += 1
+		print( "%s %-10s x%.2f geometric mean over %d problems, p=%.3f"%( mark, c, r, len( ratios[c] ), p ) )
+	return flagged
+
+def main() :
+	opts = Options( sys.argv[1:] )
+	text = open( opts.matrix ).read() if opts.matrix else DEFAULT_MATRIX
+	configs = read_matrix( text, opts.configs )
+	if not os.path.isdir( opts.benchmarks ) :
+		bail_out( "Could not find the benchmarks in %s"%opts.benchmarks )
+
+	runs = []
+	for dom, domain, problem in instances( opts.benchmarks, opts.domains, opts.problems ) :
+		for config in configs :
+			for rep in range( opts.repeat ) :
+				runs.append( Run( config, dom, domain, problem, rep, opts ) )
+
+	with open( opts.output, 'w' ) as out :
+		writer = csv.DictWriter( out, COLUMNS )
+		writer.writeheader()
+		rows = run_all( runs, opts.jobs, writer, out )
+
+	coverage( rows )
+	if opts.baseline :
+		with open( opts.baseline ) as f :
+			baseline_rows = list( csv.DictReader( f ) )
+		if compare( rows, baseline_rows, opts ) > 0 :
+			sys.exit(1)
+
+if __name__ == '__main__' :
+	main()
@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <fwd_search_prob.hxx>
 
 #include <aptk/brfs.hxx>
+#include <aptk/parallel_brfs.hxx>
 #include <aptk/string_conversions.hxx>
 
 #include <boost/program_options.hpp>
@@ -44,9 +45,11 @@ using	aptk::STRIPS_Problem;
 using	aptk::agnostic::Fwd_Search_Problem;
 
 using	aptk::search::brfs::BRFS;
+using	aptk::search::brfs::Parallel_BRFS;
 
 // NIR: Now we're ready to define the BRFS algorithm
 typedef		BRFS< Fwd_Search_Problem > BRFS_Fwd;
+typedef		Parallel_BRFS< Fwd_Search_Problem > Parallel_BRFS_Fwd;
 
 template <typename Search_Engine>
 float do_search( Search_Engine& engine, STRIPS_Problem& plan_prob, float budget, std::string logfile ) {
@@ -101,6 +104,7 @@ void process_command_line_options( int ac, char** av, po::variables_map& vars )
 		( "help", "Show help message" )
 		( "domain", po::value<std::string>(), "Input PDDL domain description" )
 		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "threads", po::value<unsigned>()->default_value(1), "Number of threads expanding each layer" )
 	;
 	
 	try {
@@ -154,8 +158,16 @@ int main( int argc, char** argv ) {
 
 	std::cout << "Starting search with BrFS (time budget is 60 secs)..." << std::endl;
 
-	BRFS_Fwd brfs_engine( search_prob );
-	float brfs_t = do_search( brfs_engine, prob, 0.0f, "brfs.log" );
+	float brfs_t;
+	unsigned threads = vm["threads"].as<unsigned>();
+	if ( threads > 1 ) {
+		Parallel_BRFS_Fwd brfs_engine( search_prob, threads );
+		brfs_t = do_search( brfs_engine, prob, 0.0f, "brfs.log" );
+	}
+	else {
+		BRFS_Fwd brfs_engine( search_prob );
+		brfs_t = do_search( brfs_engine, prob, 0.0f, "brfs.log" );
+	}
 
 	std::cout << "BrFS search completed in " << brfs_t << " secs, check 'brfs.log' for details" << std::endl;
 
@@ -0,0 +1,187 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Anytime greedy best-first search with h_add relaxed plans, where the
+// search space is distributed among several processes by hashing states
+#include <strips_prob.hxx>
+#include <ff_to_aptk.hxx>
+
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <strips_state.hxx>
+
+#include <fwd_search_prob.hxx>
+#include <h_1.hxx>
+#include <rp_heuristic.hxx>
+#include <aptk/open_list.hxx>
+#include <state_codec.hxx>
+#include <aptk/dist_bfs.hxx>
+
+#include <iostream>
+#include <iterator>
+#include <fstream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using   aptk::STRIPS_Problem;
+using	aptk::agnostic::Fwd_Search_Problem;
+
+using 	aptk::agnostic::H1_Heuristic;
+using	aptk::agnostic::H_Add_Evaluation_Function;
+using	aptk::agnostic::Relaxed_Plan_Heuristic;
+
+using 	aptk::search::Open_List;
+using	aptk::search::Node_Comparer;
+using	aptk::agnostic::Fluent_State_Codec;
+using 	aptk::search::dist::Node;
+using	aptk::search::dist::Distributed_BFS;
+
+typedef		Node< aptk::State >						Search_Node;
+typedef		Node_Comparer< Search_Node >					Tie_Breaking_Algorithm;
+typedef		Open_List< Tie_Breaking_Algorithm, Search_Node >		BFS_Open_List;
+
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Add_Evaluation_Function>	H_Add_Fwd;
+typedef		Relaxed_Plan_Heuristic< Fwd_Search_Problem, H_Add_Fwd >		H_Add_Rp_Fwd;
+
+typedef		Distributed_BFS< Fwd_Search_Problem, H_Add_Rp_Fwd, BFS_Open_List,
+					Fluent_State_Codec >				Dist_BFS_H_Add_Rp_Fwd;
+
+template <typename Search_Engine>
+float do_search( Search_Engine& engine, const STRIPS_Problem& plan_prob, float budget, std::string logfile ) {
+
+	std::ofstream out( logfile.c_str() );
+
+	engine.set_budget( budget );
+	engine.start();
+
+	std::vector< aptk::Action_Idx > plan;
+	float				cost;
+
+	// Wall-clock time, CPU time adds up over all threads
+	float ref = aptk::wall_time();
+	float t0 = aptk::wall_time();
+
+	while ( engine.find_solution( cost, plan ) ) {
+		out << "Plan found with cost: " << cost << std::endl;
+		for ( unsigned k = 0; k < plan.size(); k++ ) {
+			out << k+1 << ". ";
+			const aptk::Action& a = *(plan_prob.actions()[ plan[k] ]);
+			out << a.signature();
+			out << std::endl;
+		}
+		// Workers start afresh on every call
+		float tf = aptk::wall_time();
+		out << "Time: " << tf - t0 << std::endl;
+		out << "Generated: " << engine.generated() << std::endl;
+		out << "Expanded: " << engine.expanded() << std::endl;
+		t0 = tf;
+		plan.clear();
+	}
+	float total_time = aptk::wall_time() - ref;
+	out << "Total time: " << total_time << std::endl;
+	out << "Processes: " << engine.num_procs() << std::endl;
+	out << "Batch size: " << engine.batch_size() << std::endl;
+	out << "Nodes generated during search: " << engine.generated() << std::endl;
+	out << "Nodes expanded during search: " << engine.expanded() << std::endl;
+	out << "Nodes sent to other processes: " << engine.sent() << std::endl;
+	out << "Nodes pruned by bound: " << engine.pruned_by_bound() << std::endl;
+	out << "Dead-end nodes: " << engine.dead_ends() << std::endl;
+	for ( unsigned k = 0; k < engine.num_procs(); k++ )
+		out << "Process " << k << " expanded: " << engine.expanded(k) << std::endl;
+
+	out.close();
+
+	return total_time;
+}
+
+void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
+	po::options_description desc( "Options:" );
+
+	desc.add_options()
+		( "help", "Show help message" )
+		( "domain", po::value<std::string>(), "Input PDDL domain description" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "time", po::value<int>()->default_value(1800), "Time to find a solution (in seconds)")
+		( "procs", po::value<unsigned>()->default_value(2), "Number of worker processes" )
+		( "batch-size", po::value<unsigned>()->default_value(32), "Nodes sent to other processes per message" )
+		( "memory", po::value<unsigned>()->default_value(0), "Memory limit for each worker process, in MB (0 means no limit)" )
+	;
+
+	try {
+		po::store( po::parse_command_line( ac, av, desc ), vars );
+		po::notify( vars );
+	}
+	catch ( std::exception& e ) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+	catch ( ... ) {
+		std::cerr << "Exception of unknown type!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( vars.count("help") ) {
+		std::cout << desc << std::endl;
+		std::exit(0);
+	}
+
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+
+	process_command_line_options( argc, argv, vm );
+
+	if ( !vm.count( "domain" ) ) {
+		std::cerr << "No PDDL domain was specified!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( !vm.count( "problem" ) ) {
+		std::cerr << "No PDDL problem was specified!" << std::endl;
+		std::exit(1);
+	}
+
+	STRIPS_Problem	prob;
+
+	aptk::FF_Parser::get_problem_description( vm["domain"].as<std::string>(), vm["problem"].as<std::string>(), prob );
+
+	std::cout << "PDDL problem description loaded: " << std::endl;
+	std::cout << "\tDomain: " << prob.domain_name() << std::endl;
+	std::cout << "\tProblem: " << prob.problem_name() << std::endl;
+	std::cout << "\t#Actions: " << prob.num_actions() << std::endl;
+	std::cout << "\t#Fluents: " << prob.num_fluents() << std::endl;
+
+	Fwd_Search_Problem	search_prob( &prob );
+
+	Dist_BFS_H_Add_Rp_Fwd engine( search_prob, vm["procs"].as<unsigned>(), vm["batch-size"].as<unsigned>() );
+	engine.set_memory_limit( vm["memory"].as<unsigned>() );
+	// Every call to find_solution() returns as soon as a better plan is found
+	engine.set_stop_at_first_solution( true );
+	float time = vm["time"].as<int>();
+	float total_time = do_search( engine, prob, time - 0.005f, "dist-bfs.log" );
+	std::cout << "Total time: " << total_time << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,305 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Compares grounding with FF against grounding with the Relaxed_Grounder,
+// with the task parsed by FF and by the PDDL_Reader. Each of them runs in
+// a process of its own, so the peak resident memory the kernel reports for
+// it belongs to it alone.
+#include <ff_to_aptk.hxx>
+#include <strips_prob.hxx>
+#include <lifted_task.hxx>
+#include <relaxed_grounder.hxx>
+#include <pddl_reader.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+using	aptk::agnostic::Lifted_Task;
+using	aptk::agnostic::Relaxed_Grounder;
+using	aptk::agnostic::PDDL_Reader;
+
+struct Instance {
+	std::string	domain_name;
+	std::string	domain;
+	std::string	problem;
+};
+
+struct Result {
+	Result() : ok( false ), parse_secs( 0 ), ground_secs( 0 ), fluents( 0 ), actions( 0 ), rss_kb( 0 ) {}
+
+	bool		ok;
+	std::string	error;
+	double		parse_secs;
+	double		ground_secs;
+	unsigned	fluents;
+	unsigned	actions;
+	long		rss_kb;
+};
+
+std::vector<std::string>	list_pddl( std::string dir ) {
+	std::vector<std::string> names;
+	DIR* d = opendir( dir.c_str() );
+	if ( d == NULL ) return names;
+	for ( struct dirent* e = readdir( d ); e; e = readdir( d ) ) {
+		std::string n( e->d_name );
+		if ( n.size() > 5 && n.compare( n.size() - 5, 5, ".pddl" ) == 0 )
+			names.push_back( n );
+	}
+	closedir( d );
+	std::sort( names.begin(), names.end() );
+	return names;
+}
+
+bool	exists( std::string path ) {
+	return access( path.c_str(), R_OK ) == 0;
+}
+
+// Domains are folders with a domain.pddl and the problems in problems/,
+// or with a domain_pXX.pddl next to each problem pXX.pddl
+void	collect( std::string root, unsigned max_problems, std::vector<Instance>& instances ) {
+	DIR* d = opendir( root.c_str() );
+	if ( d == NULL ) {
+		std::cerr << "Could not open " << root << std::endl;
+		return;
+	}
+	std::vector<std::string> domains;
+	for ( struct dirent* e = readdir( d ); e; e = readdir( d ) )
+		if ( e->d_name[0] != '.' ) domains.push_back( e->d_name );
+	closedir( d );
+	std::sort( domains.begin(), domains.end() );
+
+	for ( unsigned i = 0; i < domains.size(); i++ ) {
+		std::string dir = root + "/" + domains[i];
+		std::vector<Instance> found;
+		if ( exists( dir + "/domain.pddl" ) ) {
+			std::vector<std::string> probs = list_pddl( dir + "/problems" );
+			for ( unsigned k = 0; k < probs.size(); k++ ) {
+				Instance inst = { domains[i], dir + "/domain.pddl", dir + "/problems/" + probs[k] };
+				found.push_back( inst );
+			}
+		}
+		else {
+			std::vector<std::string> files = list_pddl( dir );
+			for ( unsigned k = 0; k < files.size(); k++ ) {
+				if ( files[k].compare( 0, 7, "domain_" ) == 0 ) continue;
+				if ( !exists( dir + "/domain_" + files[k] ) ) continue;
+				Instance inst = { domains[i], dir + "/domain_" + files[k], dir + "/" + files[k] };
+				found.push_back( inst );
+			}
+		}
+		if ( found.size() > max_problems ) found.resize( max_problems );
+		instances.insert( instances.end(), found.begin(), found.end() );
+	}
+}
+
+void	ground_ff( const Instance& inst, Result& r ) {
+	STRIPS_Problem prob;
+	double t0 = aptk::wall_time();
+	aptk::FF_Parser::get_problem_description( inst.domain, inst.problem, prob );
+	r.ground_secs = aptk::wall_time() - t0;
+	r.fluents = prob.num_fluents();
+	r.actions = prob.num_actions();
+}
+
+void	ground_native( const Instance& inst, Result& r ) {
+	Lifted_Task task;
+	STRIPS_Problem prob;
+	double t0 = aptk::wall_time();
+	aptk::FF_Parser::get_lifted_task( inst.domain, inst.problem, task );
+	double t1 = aptk::wall_time();
+	Relaxed_Grounder grounder( task );
+	grounder.ground( prob );
+	r.parse_secs = t1 - t0;
+	r.ground_secs = aptk::wall_time() - t1;
+	r.fluents = prob.num_fluents();
+	r.actions = prob.num_actions();
+}
+
+void	ground_reader( const Instance& inst, Result& r ) {
+	Lifted_Task task;
+	STRIPS_Problem prob;
+	double t0 = aptk::wall_time();
+	PDDL_Reader reader( task );
+	reader.read_domain( inst.domain );
+	reader.read_problem( inst.problem );
+	double t1 = aptk::wall_time();
+	Relaxed_Grounder grounder( task );
+	grounder.ground( prob );
+	r.parse_secs = t1 - t0;
+	r.ground_secs = aptk::wall_time() - t1;
+	r.fluents = prob.num_fluents();
+	r.actions = prob.num_actions();
+}
+
+// Runs f in a child process, which sends back the result through a pipe
+Result	run( void (*f)( const Instance&, Result& ), const Instance& inst ) {
+	Result r;
+	int fds[2];
+	if ( pipe( fds ) != 0 ) {
+		r.error = "pipe failed";
+		return r;
+	}
+	pid_t pid = fork();
+	if ( pid == 0 ) {
+		close( fds[0] );
+		std::ostringstream out;
+		try {
+			// FF writes progress to stdout, keep the table clean
+			if ( freopen( "/dev/null", "w", stdout ) == NULL ) {}
+			f( inst, r );
+			out << "ok " << r.parse_secs << " " << r.ground_secs << " " << r.fluents << " " << r.actions;
+		}
+		catch ( std::exception& e ) {
+			out << "error " << e.what();
+		}
+		std::string msg = out.str();
+		if ( write( fds[1], msg.c_str(), msg.size() ) < 0 ) {}
+		close( fds[1] );
+		_exit( 0 );
+	}
+	close( fds[1] );
+	std::string msg;
+	char buf[512];
+	ssize_t n;
+	while ( ( n = read( fds[0], buf, sizeof(buf) ) ) > 0 )
+		msg.append( buf, n );
+	close( fds[0] );
+
+	int status = 0;
+	struct rusage usage;
+	if ( pid < 0 || wait4( pid, &status, 0, &usage ) < 0 ) {
+		r.error = "fork failed";
+		return r;
+	}
+	r.rss_kb = usage.ru_maxrss;
+
+	std::istringstream in( msg );
+	std::string tag;
+	in >> tag;
+	if ( tag == "ok" ) {
+		in >> r.parse_secs >> r.ground_secs >> r.fluents >> r.actions;
+		r.ok = true;
+	}
+	else if ( tag == "error" ) {
+		std::getline( in, r.error );
+		r.error.erase( 0, r.error.find_first_not_of( ' ' ) );
+	}
+	else
+		r.error = "crashed";
+	return r;
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "domain", po::value<std::string>(), "Input PDDL domain description" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "benchmarks", po::value<std::string>(), "Folder with a subfolder for each domain, e.g. benchmarks/ipc-2006" )
+		( "max-problems", po::value<unsigned>()->default_value(5), "Problems taken from each domain of --benchmarks" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") ) {
+		std::cout << desc << std::endl;
+		return 0;
+	}
+
+	std::vector<Instance> instances;
+	if ( vm.count("benchmarks") )
+		collect( vm["benchmarks"].as<std::string>(), vm["max-problems"].as<unsigned>(), instances );
+	else if ( vm.count("domain") && vm.count("problem") ) {
+		Instance inst = { "-", vm["domain"].as<std::string>(), vm["problem"].as<std::string>() };
+		instances.push_back( inst );
+	}
+	else {
+		std::cerr << "Either --benchmarks or both --domain and --problem are needed" << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	std::ofstream log( "grounding-bench.log" );
+	const char* header = "domain,problem,ff_secs,ff_rss_kb,ff_fluents,ff_actions,native_parse_secs,native_ground_secs,native_rss_kb,native_fluents,native_actions,reader_parse_secs,reader_ground_secs,reader_rss_kb,reader_fluents,reader_actions";
+	std::cout << header << std::endl;
+	log << header << std::endl;
+
+	for ( unsigned i = 0; i < instances.size(); i++ ) {
+		const Instance& inst = instances[i];
+		Result ff = run( ground_ff, inst );
+		Result native = run( ground_native, inst );
+		Result reader = run( ground_reader, inst );
+
+		std::string name = inst.problem.substr( inst.problem.rfind( '/' ) + 1 );
+		std::stringstream row;
+		row << inst.domain_name << "," << name << ",";
+		if ( ff.ok )
+			row << ff.ground_secs << "," << ff.rss_kb << "," << ff.fluents << "," << ff.actions << ",";
+		else
+			row << "-,-,-,-,";
+		if ( native.ok )
+			row << native.parse_secs << "," << native.ground_secs << "," << native.rss_kb << "," << native.fluents << "," << native.actions;
+		else
+			row << "unsupported,-,-,-,-";
+		row << ",";
+		if ( reader.ok )
+			row << reader.parse_secs << "," << reader.ground_secs << "," << reader.rss_kb << "," << reader.fluents << "," << reader.actions;
+		else
+			row << "unsupported,-,-,-,-";
+		std::cout << row.str() << std::endl;
+		log << row.str() << std::endl;
+		if ( !ff.ok )
+			std::cerr << name << ": FF failed: " << ff.error << std::endl;
+		if ( !native.ok )
+			std::cerr << name << ": " << native.error << std::endl;
+		if ( !reader.ok )
+			std::cerr << name << ": " << reader.error << std::endl;
+	}
+
+	return 0;
+}
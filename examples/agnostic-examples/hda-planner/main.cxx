@@ -0,0 +1,204 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Anytime greedy best-first search with h_add relaxed plans, where the
+// search space is distributed among several threads by hashing states
+#include <strips_prob.hxx>
+#include <ff_to_aptk.hxx>
+
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <strips_state.hxx>
+
+#include <fwd_search_prob.hxx>
+#include <h_1.hxx>
+#include <rp_heuristic.hxx>
+#include <aptk/open_list.hxx>
+#include <aptk/at_bfs_dq.hxx>
+#include <aptk/hda.hxx>
+
+#include <iostream>
+#include <iterator>
+#include <fstream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using   aptk::STRIPS_Problem;
+using	aptk::agnostic::Fwd_Search_Problem;
+
+using 	aptk::agnostic::H1_Heuristic;
+using	aptk::agnostic::H_Add_Evaluation_Function;
+using	aptk::agnostic::Relaxed_Plan_Heuristic;
+
+using 	aptk::search::Open_List;
+using	aptk::search::Node_Comparer;
+using 	aptk::search::bfs_dq::Node;
+using	aptk::search::hda::HDA;
+using	aptk::search::hda::Abstraction_Distribution;
+
+typedef		Node< aptk::State >						Search_Node;
+typedef		Node_Comparer< Search_Node >					Tie_Breaking_Algorithm;
+typedef		Open_List< Tie_Breaking_Algorithm, Search_Node >		BFS_Open_List;
+
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Add_Evaluation_Function>	H_Add_Fwd;
+typedef		Relaxed_Plan_Heuristic< Fwd_Search_Problem, H_Add_Fwd >		H_Add_Rp_Fwd;
+
+typedef		HDA< Fwd_Search_Problem, H_Add_Rp_Fwd, BFS_Open_List >		HDA_H_Add_Rp_Fwd;
+typedef		HDA< Fwd_Search_Problem, H_Add_Rp_Fwd, BFS_Open_List,
+			Abstraction_Distribution<Fwd_Search_Problem> >		AHDA_H_Add_Rp_Fwd;
+
+template <typename Search_Engine>
+float do_search( Search_Engine& engine, const STRIPS_Problem& plan_prob, float budget, std::string logfile ) {
+
+	std::ofstream out( logfile.c_str() );
+
+	engine.set_budget( budget );
+	engine.start();
+
+	std::vector< aptk::Action_Idx > plan;
+	float				cost;
+
+	// Wall-clock time, CPU time adds up over all threads
+	float ref = aptk::wall_time();
+	float t0 = aptk::wall_time();
+
+	unsigned expanded_0 = engine.expanded();
+	unsigned generated_0 = engine.generated();
+
+	while ( engine.find_solution( cost, plan ) ) {
+		out << "Plan found with cost: " << cost << std::endl;
+		for ( unsigned k = 0; k < plan.size(); k++ ) {
+			out << k+1 << ". ";
+			const aptk::Action& a = *(plan_prob.actions()[ plan[k] ]);
+			out << a.signature();
+			out << std::endl;
+		}
+		float tf = aptk::wall_time();
+		unsigned expanded_f = engine.expanded();
+		unsigned generated_f = engine.generated();
+		out << "Time: " << tf - t0 << std::endl;
+		out << "Generated: " << generated_f - generated_0 << std::endl;
+		out << "Expanded: " << expanded_f - expanded_0 << std::endl;
+		t0 = tf;
+		expanded_0 = expanded_f;
+		generated_0 = generated_f;
+		plan.clear();
+	}
+	float total_time = aptk::wall_time() - ref;
+	out << "Total time: " << total_time << std::endl;
+	out << "Threads: " << engine.num_threads() << std::endl;
+	out << "Batch size: " << engine.batch_size() << std::endl;
+	out << "Nodes generated during search: " << engine.generated() << std::endl;
+	out << "Nodes expanded during search: " << engine.expanded() << std::endl;
+	out << "Nodes sent to other threads: " << engine.sent() << std::endl;
+	out << "Nodes pruned by bound: " << engine.pruned_by_bound() << std::endl;
+	out << "Dead-end nodes: " << engine.dead_ends() << std::endl;
+	out << "Nodes in OPEN replaced: " << engine.open_repl() << std::endl;
+	for ( unsigned k = 0; k < engine.num_threads(); k++ )
+		out << "Thread " << k << " expanded: " << engine.expanded(k) << std::endl;
+
+	out.close();
+
+	return total_time;
+}
+
+void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
+	po::options_description desc( "Options:" );
+
+	desc.add_options()
+		( "help", "Show help message" )
+		( "domain", po::value<std::string>(), "Input PDDL domain description" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "time", po::value<int>()->default_value(1800), "Time to find a solution (in seconds)")
+		( "threads", po::value<unsigned>()->default_value(2), "Number of search threads" )
+		( "batch-size", po::value<unsigned>()->default_value(32), "Nodes sent to other threads per message" )
+		( "abstraction", po::value<unsigned>()->default_value(0), "Distribute states by hashing their projection on this many fluents (0 hashes the whole state)" )
+	;
+
+	try {
+		po::store( po::parse_command_line( ac, av, desc ), vars );
+		po::notify( vars );
+	}
+	catch ( std::exception& e ) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+	catch ( ... ) {
+		std::cerr << "Exception of unknown type!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( vars.count("help") ) {
+		std::cout << desc << std::endl;
+		std::exit(0);
+	}
+
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+
+	process_command_line_options( argc, argv, vm );
+
+	if ( !vm.count( "domain" ) ) {
+		std::cerr << "No PDDL domain was specified!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( !vm.count( "problem" ) ) {
+		std::cerr << "No PDDL problem was specified!" << std::endl;
+		std::exit(1);
+	}
+
+	STRIPS_Problem	prob;
+
+	aptk::FF_Parser::get_problem_description( vm["domain"].as<std::string>(), vm["problem"].as<std::string>(), prob );
+
+	std::cout << "PDDL problem description loaded: " << std::endl;
+	std::cout << "\tDomain: " << prob.domain_name() << std::endl;
+	std::cout << "\tProblem: " << prob.problem_name() << std::endl;
+	std::cout << "\t#Actions: " << prob.num_actions() << std::endl;
+	std::cout << "\t#Fluents: " << prob.num_fluents() << std::endl;
+
+	Fwd_Search_Problem	search_prob( &prob );
+
+	unsigned threads = vm["threads"].as<unsigned>();
+	unsigned batch_size = vm["batch-size"].as<unsigned>();
+	unsigned abstraction = vm["abstraction"].as<unsigned>();
+	float time = vm["time"].as<int>();
+	float total_time;
+
+	if ( abstraction > 0 ) {
+		AHDA_H_Add_Rp_Fwd engine( search_prob, threads, batch_size );
+		engine.distribution() = Abstraction_Distribution<Fwd_Search_Problem>( search_prob, abstraction );
+		total_time = do_search( engine, prob, time - 0.005f, "hda.log" );
+	}
+	else {
+		HDA_H_Add_Rp_Fwd engine( search_prob, threads, batch_size );
+		total_time = do_search( engine, prob, time - 0.005f, "hda.log" );
+	}
+	std::cout << "Total time: " << total_time << std::endl;
+
+	return 0;
+}
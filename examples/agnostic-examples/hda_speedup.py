@@ -0,0 +1,64 @@
+#!/usr/bin/python
+# Runs hda-planner over a set of instances with an increasing number of
+# threads and reports wall-clock time, expansions and speedup w.r.t. the
+# single thread run as CSV.
+#
+# Usage: hda_speedup.py <benchmark dir> [<max time>] [<threads>] [<abstraction>]
+#
+# <benchmark dir> is a folder such as benchmarks/ipc-2006/TPP, containing
+# domain.pddl and the problems either in problems/ or next to the domain.
+# <threads> is a comma separated list, defaults to 1,2,4,8.
+from	__future__ import print_function
+import 	sys, os, glob, subprocess, time
+
+planner = os.path.abspath( os.path.join( os.path.dirname( sys.argv[0] ), 'hda-planner', 'planner' ) )
+
+def instances( bench_dir ) :
+	domain = os.path.join( bench_dir, 'domain.pddl' )
+	problems = sorted( glob.glob( os.path.join( bench_dir, 'problems', '*.pddl' ) ) )
+	if len(problems) == 0 :
+		problems = sorted( [ p for p in glob.glob( os.path.join( bench_dir, 'p*.pddl' ) ) ] )
+	for p in problems :
+		d = domain
+		if not os.path.exists( d ) :
+			d = os.path.join( bench_dir, 'domain_' + os.path.basename(p) )
+		yield d, p
+
+def read_log( log ) :
+	cost, expanded = None, None
+	for line in open( log ) :
+		if 'Plan found with cost:' in line :
+			cost = float( line.split(':')[1] )
+		elif 'Nodes expanded during search:' in line :
+			expanded = int( line.split(':')[1] )
+	return cost, expanded
+
+def main() :
+	if len(sys.argv) < 2 :
+		print( "Usage: hda_speedup.py <benchmark dir> [<max time>] [<threads>] [<abstraction>]", file=sys.stderr )
+		sys.exit(1)
+	bench_dir = sys.argv[1]
+	max_time = int(sys.argv[2]) if len(sys.argv) > 2 else 300
+	threads = [ int(t) for t in sys.argv[3].split(',') ] if len(sys.argv) > 3 else [ 1, 2, 4, 8 ]
+	abstraction = int(sys.argv[4]) if len(sys.argv) > 4 else 0
+
+	if not os.path.exists( planner ) :
+		print( "Could not find %s, build hda-planner first"%planner, file=sys.stderr )
+		sys.exit(1)
+
+	print( "problem,threads,time,cost,expanded,speedup" )
+	for domain, problem in instances( bench_dir ) :
+		base = None
+		for t in threads :
+			command = [ planner, '--domain', domain, '--problem', problem, '--time', str(max_time),
+					'--threads', str(t), '--abstraction', str(abstraction) ]
+			t0 = time.time()
+			rv = subprocess.call( command, stdout=open( os.devnull, 'w' ) )
+			elapsed = time.time() - t0
+			cost, expanded = read_log( 'hda.log' ) if rv == 0 else ( None, None )
+			if base is None : base = elapsed
+			print( "%s,%d,%.3f,%s,%s,%.2f"%( os.path.basename(problem), t, elapsed, cost, expanded, base / elapsed ) )
+			sys.stdout.flush()
+
+if __name__ == '__main__' :
+	main()
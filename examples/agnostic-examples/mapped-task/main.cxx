@@ -0,0 +1,147 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Grounds a PDDL task once and saves it as a .aptk file, or loads such a
+// file and solves it with BrFS straight from the mapped tables
+#include <iostream>
+#include <fstream>
+
+#include <ff_to_aptk.hxx>
+#include <strips_prob.hxx>
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <strips_state.hxx>
+#include <mapped_task.hxx>
+#include <mapped_search_prob.hxx>
+
+#include <aptk/brfs.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+
+using	aptk::agnostic::Mapped_Task;
+using	aptk::agnostic::Mapped_Search_Problem;
+
+using	aptk::search::brfs::BRFS;
+
+typedef		BRFS< Mapped_Search_Problem >	BRFS_Mapped;
+
+void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
+	po::options_description desc( "Options:" );
+
+	desc.add_options()
+		( "help", "Show help message" )
+		( "domain", po::value<std::string>(), "Input PDDL domain description" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "output", po::value<std::string>(), "Task file to write" )
+		( "task", po::value<std::string>(), "Task file to solve" )
+	;
+
+	try {
+		po::store( po::parse_command_line( ac, av, desc ), vars );
+		po::notify( vars );
+	}
+	catch ( std::exception& e ) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+	catch ( ... ) {
+		std::cerr << "Exception of unknown type!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( vars.count("help") ) {
+		std::cout << desc << std::endl;
+		std::exit(0);
+	}
+
+}
+
+int export_task( std::string domain, std::string problem, std::string output ) {
+	double t0 = aptk::wall_time();
+	STRIPS_Problem	prob;
+	aptk::FF_Parser::get_problem_description( domain, problem, prob );
+	double t1 = aptk::wall_time();
+	std::cout << "PDDL problem description loaded in " << t1 - t0 << " secs: " << std::endl;
+	std::cout << "\tDomain: " << prob.domain_name() << std::endl;
+	std::cout << "\tProblem: " << prob.problem_name() << std::endl;
+	std::cout << "\t#Actions: " << prob.num_actions() << std::endl;
+	std::cout << "\t#Fluents: " << prob.num_fluents() << std::endl;
+
+	Mapped_Task::write( prob, output );
+	std::cout << "Task written to " << output << " in " << aptk::wall_time() - t1 << " secs" << std::endl;
+	return 0;
+}
+
+int solve_task( std::string filename ) {
+	double t0 = aptk::wall_time();
+	Mapped_Task task( filename );
+	Mapped_Search_Problem search_prob( task );
+	std::cout << "Task file mapped in " << aptk::wall_time() - t0 << " secs (" << task.file_size() << " bytes): " << std::endl;
+	std::cout << "\tDomain: " << task.domain_name() << std::endl;
+	std::cout << "\tProblem: " << task.problem_name() << std::endl;
+	std::cout << "\t#Actions: " << task.num_actions() << std::endl;
+	std::cout << "\t#Fluents: " << task.num_fluents() << std::endl;
+
+	BRFS_Mapped engine( search_prob );
+	engine.start();
+
+	std::vector< aptk::Action_Idx > plan;
+	float cost;
+	float t1 = aptk::time_used();
+	if ( engine.find_solution( cost, plan ) ) {
+		std::cout << "Plan found with cost: " << cost << std::endl;
+		for ( unsigned k = 0; k < plan.size(); k++ )
+			std::cout << k+1 << ". " << task.action_signature( plan[k] ) << std::endl;
+	}
+	else
+		std::cout << "No plan found" << std::endl;
+	std::cout << "Total time: " << aptk::time_used() - t1 << std::endl;
+	std::cout << "Nodes generated during search: " << engine.generated() << std::endl;
+	std::cout << "Nodes expanded during search: " << engine.expanded() << std::endl;
+	return 0;
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+
+	process_command_line_options( argc, argv, vm );
+
+	try {
+		if ( vm.count( "task" ) )
+			return solve_task( vm["task"].as<std::string>() );
+
+		if ( !vm.count( "domain" ) || !vm.count( "problem" ) || !vm.count( "output" ) ) {
+			std::cerr << "Either --task, or --domain, --problem and --output have to be given" << std::endl;
+			std::exit(1);
+		}
+		return export_task( vm["domain"].as<std::string>(), vm["problem"].as<std::string>(), vm["output"].as<std::string>() );
+	}
+	catch ( std::runtime_error& e ) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+}
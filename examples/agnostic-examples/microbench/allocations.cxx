@@ -0,0 +1,44 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocations.hxx"
+#include <new>
+#include <cstdlib>
+
+static unsigned long	g_allocations = 0;
+
+unsigned long	allocations() {
+	return g_allocations;
+}
+
+void*	operator new( size_t bytes ) {
+	g_allocations++;
+	void* p = std::malloc( bytes > 0 ? bytes : 1 );
+	if ( p == NULL ) throw std::bad_alloc();
+	return p;
+}
+
+void	operator delete( void* p ) noexcept {
+	std::free( p );
+}
+
+void	operator delete( void* p, size_t ) noexcept {
+	std::free( p );
+}
@@ -0,0 +1,29 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MICROBENCH_ALLOCATIONS__
+#define __MICROBENCH_ALLOCATIONS__
+
+// Calls made to operator new since the program started. The operators are
+// replaced in allocations.cxx, out of sight of the code calling them, so
+// the compiler does not pair the malloc and free in them with new and delete
+unsigned long	allocations();
+
+#endif // allocations.hxx
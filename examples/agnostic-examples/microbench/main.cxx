@@ -0,0 +1,598 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Times the kernels the search spends its time in, each on its own, over
+// states sampled by random walks from the initial state of IPC-2006 tasks.
+// The walks only depend on the seed, so runs over the same tasks time the
+// same states. Each kernel is run over all the states at least once, and
+// then for as long as --min-time, and the time and the allocations made
+// are written per operation, which is one state unless said otherwise:
+//
+//	bit_set.set_unset	sets and unsets the fluents of the state
+//	bit_set.intersection	intersects the state with the next one
+//	bit_set.contains	checks the goal against the state
+//	hash_key.fluent_vec	hashes the fluents of the state
+//	hash_key.bit_array	hashes the bits of the state
+//	jenkins_hash		hashes the bits of the state in one call
+//	succ_gen.iterate	walks over the actions applicable in the state
+//	state.progress_through	makes and deletes a successor
+//	h1.add, h1.max, h2	evaluates the state
+//	rp.extract		evaluates h_add and extracts the relaxed plan
+//	novelty.eval		evaluates the state, clearing the table before
+//				each pass over the states
+//	open_list.insert_pop	puts a node in Open and takes it out
+//	closed_list.put_retrieve	puts a node in Closed and looks another up
+#include <ff_to_aptk.hxx>
+#include <strips_prob.hxx>
+#include <strips_state.hxx>
+#include <action.hxx>
+#include <fwd_search_prob.hxx>
+#include <succ_gen.hxx>
+#include <h_1.hxx>
+#include <h_2.hxx>
+#include <rp_heuristic.hxx>
+#include <novelty.hxx>
+#include <aptk/bit_set.hxx>
+#include <aptk/hash_table.hxx>
+#include <aptk/jenkins_12bit.hxx>
+#include <aptk/open_list.hxx>
+#include <aptk/closed_list.hxx>
+#include <aptk/at_bfs.hxx>
+#include <aptk/resources_control.hxx>
+#include "allocations.hxx"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+using	aptk::State;
+using	aptk::Action;
+using	aptk::Action_Idx;
+using	aptk::Bit_Set;
+using	aptk::Hash_Key;
+using	aptk::Fluent_Vec;
+using	aptk::agnostic::Fwd_Search_Problem;
+using	aptk::agnostic::Successor_Generator;
+using 	aptk::agnostic::H1_Heuristic;
+using	aptk::agnostic::H_Add_Evaluation_Function;
+using	aptk::agnostic::H_Max_Evaluation_Function;
+using	aptk::agnostic::H2_Heuristic;
+using	aptk::agnostic::Relaxed_Plan_Extractor;
+using	aptk::agnostic::Novelty;
+using 	aptk::search::Open_List;
+using	aptk::search::Closed_List;
+using	aptk::search::Node_Comparer;
+
+typedef		aptk::search::bfs::Node< State >				Search_Node;
+typedef		Open_List< Node_Comparer< Search_Node >, Search_Node >		BFS_Open_List;
+typedef		Closed_List< Search_Node >					BFS_Closed_List;
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Add_Evaluation_Function>	H_Add_Fwd;
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Max_Evaluation_Function>	H_Max_Fwd;
+typedef		H2_Heuristic<Fwd_Search_Problem>				H2_Fwd;
+typedef		Relaxed_Plan_Extractor< H_Add_Fwd >				RP_Extractor;
+typedef		Novelty<Fwd_Search_Problem>					H_Novel_Fwd;
+
+struct Random {
+	uint64_t	state;
+
+	unsigned	next( unsigned n ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (unsigned)( ( state >> 33 ) % n );
+	}
+};
+
+// States met along random walks of up to walk actions from the initial
+// state, and the action taken from each
+struct Samples {
+	std::vector< State* >		states;
+	std::vector< Action_Idx >	actions;
+
+	~Samples() {
+		for ( unsigned k = 0; k < states.size(); k++ )
+			delete states[k];
+	}
+
+	bool	make( const Fwd_Search_Problem& prob, unsigned n, unsigned walk, Random& rnd ) {
+		std::vector< Action_Idx > app;
+		State* s = prob.init();
+		prob.applicable_set( *s, app );
+		if ( app.empty() ) {
+			delete s;
+			return false;
+		}
+		unsigned left = 1 + rnd.next( walk );
+		while ( states.size() < n ) {
+			app.clear();
+			prob.applicable_set( *s, app );
+			if ( left == 0 || app.empty() ) {
+				delete s;
+				s = prob.init();
+				left = 1 + rnd.next( walk );
+				continue;
+			}
+			Action_Idx a = app[ rnd.next( app.size() ) ];
+			states.push_back( new State( *s ) );
+			actions.push_back( a );
+			State* succ = prob.next( *s, a );
+			delete s;
+			s = succ;
+			left--;
+		}
+		delete s;
+		return true;
+	}
+
+	unsigned	size() const	{ return states.size(); }
+};
+
+struct Bit_Set_Set_Unset {
+	const Samples&	S;
+	Bit_Set		m_set;
+	size_t		sink;
+
+	Bit_Set_Set_Unset( const Samples& s, unsigned num_fluents ) : S( s ), m_set( num_fluents ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		const Fluent_Vec& fv = S.states[i]->fluent_vec();
+		for ( unsigned k = 0; k < fv.size(); k++ )
+			m_set.set( fv[k] );
+		for ( unsigned k = 0; k < fv.size(); k++ ) {
+			sink += m_set.isset( fv[k] );
+			m_set.unset( fv[k] );
+		}
+	}
+};
+
+struct Bit_Set_Intersection {
+	const Samples&	S;
+	Bit_Set		m_set;
+	size_t		sink;
+
+	Bit_Set_Intersection( const Samples& s, unsigned num_fluents ) : S( s ), m_set( num_fluents ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		unsigned j = i + 1 < S.size() ? i + 1 : 0;
+		m_set.set_intersection( S.states[i]->fluent_set(), S.states[j]->fluent_set() );
+		sink += m_set.bits().packs()[0];
+	}
+};
+
+struct Bit_Set_Contains {
+	const Samples&	S;
+	Bit_Set		m_goal;
+	size_t		sink;
+
+	Bit_Set_Contains( const Samples& s, const STRIPS_Problem& prob ) : S( s ), m_goal( prob.num_fluents() ), sink( 0 ) {
+		for ( unsigned k = 0; k < prob.goal().size(); k++ )
+			m_goal.set( prob.goal()[k] );
+	}
+
+	void	operator()( unsigned i ) {
+		sink += S.states[i]->fluent_set().contains( m_goal );
+	}
+};
+
+// Hash_Key::add() sorts the fluents, so they are copied to a vector kept
+// from one state to the next
+struct Hash_Key_Fluent_Vec {
+	const Samples&	S;
+	Fluent_Vec	m_fluents;
+	size_t		sink;
+
+	Hash_Key_Fluent_Vec( const Samples& s ) : S( s ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		m_fluents.assign( S.states[i]->fluent_vec().begin(), S.states[i]->fluent_vec().end() );
+		Hash_Key h;
+		h.add( m_fluents );
+		sink += (size_t)h;
+	}
+};
+
+struct Hash_Key_Bit_Array {
+	const Samples&	S;
+	size_t		sink;
+
+	Hash_Key_Bit_Array( const Samples& s ) : S( s ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		Hash_Key h;
+		h.add( S.states[i]->fluent_set().bits() );
+		sink += (size_t)h;
+	}
+};
+
+struct Jenkins_Hash {
+	const Samples&	S;
+	size_t		sink;
+
+	Jenkins_Hash( const Samples& s ) : S( s ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		const aptk::Bit_Array& bits = S.states[i]->fluent_set().bits();
+		sink += jenkins_hash( (ub1*)bits.packs(), bits.npacks() * sizeof(unsigned), 0 );
+	}
+};
+
+struct Succ_Gen_Iterate {
+	const Samples&			S;
+	const Successor_Generator&	m_gen;
+	size_t				sink;
+
+	Succ_Gen_Iterate( const Samples& s, const STRIPS_Problem& prob ) : S( s ), m_gen( prob.successor_generator() ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		Successor_Generator::Iterator it( *S.states[i], m_gen.nodes() );
+		for ( int a = it.first(); a != -1; a = it.next() )
+			sink += a;
+	}
+};
+
+struct State_Progress_Through {
+	const Samples&		S;
+	const STRIPS_Problem&	m_prob;
+	size_t			sink;
+
+	State_Progress_Through( const Samples& s, const STRIPS_Problem& prob ) : S( s ), m_prob( prob ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		State* succ = S.states[i]->progress_through( *m_prob.actions()[ S.actions[i] ] );
+		sink += succ->hash();
+		delete succ;
+	}
+};
+
+template <typename Heuristic>
+struct Evaluate {
+	const Samples&	S;
+	Heuristic&	m_h;
+	size_t		sink;
+
+	Evaluate( const Samples& s, Heuristic& h ) : S( s ), m_h( h ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		float h = 0.0f;
+		m_h.eval( *S.states[i], h );
+		sink += (size_t)h;
+	}
+};
+
+struct RP_Extract {
+	const Samples&			S;
+	RP_Extractor&			m_rp;
+	std::vector< Action_Idx >	m_po;
+	size_t				sink;
+
+	RP_Extract( const Samples& s, RP_Extractor& rp ) : S( s ), m_rp( rp ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		float h = 0.0f;
+		m_po.clear();
+		m_rp.compute( *S.states[i], h, m_po );
+		sink += (size_t)h + m_po.size();
+	}
+};
+
+struct Novelty_Eval {
+	const Samples&	S;
+	H_Novel_Fwd&	m_novelty;
+	size_t		sink;
+
+	Novelty_Eval( const Samples& s, H_Novel_Fwd& n ) : S( s ), m_novelty( n ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		if ( i == 0 ) m_novelty.init();
+		float h = 0.0f;
+		m_novelty.eval( *S.states[i], h );
+		sink += (size_t)h;
+	}
+};
+
+// Nodes over the sampled states, with their h_add values, and left
+// without states before they are deleted since the states are not theirs
+struct Sample_Nodes {
+	std::vector< Search_Node* >	nodes;
+
+	Sample_Nodes( const Samples& S, H_Add_Fwd& h ) {
+		for ( unsigned k = 0; k < S.size(); k++ ) {
+			Search_Node* n = new Search_Node( S.states[k], 0.0f, aptk::no_op, NULL );
+			h.eval( *S.states[k], n->hn() );
+			n->fn() = n->hn();
+			nodes.push_back( n );
+		}
+	}
+
+	~Sample_Nodes() {
+		for ( unsigned k = 0; k < nodes.size(); k++ ) {
+			nodes[k]->m_state = NULL;
+			delete nodes[k];
+		}
+	}
+};
+
+// All the nodes are put in before any is taken out
+struct Open_List_Insert_Pop {
+	const Sample_Nodes&	N;
+	BFS_Open_List		m_open;
+	size_t			sink;
+
+	Open_List_Insert_Pop( const Sample_Nodes& n ) : N( n ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		m_open.insert( N.nodes[i] );
+		if ( i + 1 < N.nodes.size() ) return;
+		while ( !m_open.empty() )
+			sink += (size_t)m_open.pop()->hn();
+	}
+};
+
+// Closed is cleared before each pass over the nodes, and looked up for
+// nodes that are in it about half of the time
+struct Closed_List_Put_Retrieve {
+	const Sample_Nodes&	N;
+	BFS_Closed_List		m_closed;
+	size_t			sink;
+
+	Closed_List_Put_Retrieve( const Sample_Nodes& n ) : N( n ), sink( 0 ) {}
+
+	void	operator()( unsigned i ) {
+		if ( i == 0 ) m_closed.clear();
+		m_closed.put( N.nodes[i] );
+		Search_Node* probe = N.nodes[ ( (uint64_t)i * 7919 ) % N.nodes.size() ];
+		sink += m_closed.retrieve( probe ) != NULL;
+	}
+};
+
+struct Measure {
+	std::string			task;
+	double				min_time;
+	std::vector< std::string >	kernels;
+	std::ostream*			log;
+	size_t				sink;
+
+	// Kernels are picked by prefix, so h1 picks both h1.add and h1.max
+	bool	wanted( const std::string& name ) const {
+		if ( kernels.empty() ) return true;
+		for ( unsigned k = 0; k < kernels.size(); k++ )
+			if ( name.compare( 0, kernels[k].size(), kernels[k] ) == 0 )
+				return true;
+		return false;
+	}
+
+	template <typename Kernel>
+	void	operator()( const std::string& name, Kernel& kernel, unsigned n ) {
+		if ( !wanted( name ) ) return;
+		// One pass to warm up caches and make the tables kernels keep
+		for ( unsigned i = 0; i < n; i++ )
+			kernel( i );
+		unsigned long ops = 0, allocs = allocations();
+		double t0 = aptk::wall_time(), secs = 0.0;
+		do {
+			for ( unsigned i = 0; i < n; i++ )
+				kernel( i );
+			ops += n;
+			secs = aptk::wall_time() - t0;
+		} while ( secs < min_time );
+		double ns = secs * 1e9 / ops;
+		double allocs_per_op = (double)( allocations() - allocs ) / ops;
+		sink += kernel.sink;
+
+		std::stringstream row;
+		row << std::left << std::setw(28) << name << std::right
+			<< std::setw(14) << std::fixed << std::setprecision(1) << ns
+			<< std::setw(12) << std::setprecision(2) << allocs_per_op
+			<< std::setw(12) << ops;
+		std::cout << row.str() << std::endl;
+		*log << task << "," << name << "," << ops << "," << ns << "," << allocs_per_op << std::endl;
+	}
+};
+
+bool	exists( const std::string& path ) {
+	struct stat st;
+	return stat( path.c_str(), &st ) == 0;
+}
+
+// Most domains have one domain file and the problems in problems/, while
+// pathways has a domain file for each problem, next to it
+bool	task_files( const std::string& dir, const std::string& domain, const std::string& problem, std::string& dom_file, std::string& prob_file ) {
+	dom_file = dir + "/" + domain + "/domain.pddl";
+	prob_file = dir + "/" + domain + "/problems/" + problem + ".pddl";
+	if ( exists( dom_file ) && exists( prob_file ) ) return true;
+	dom_file = dir + "/" + domain + "/domain_" + problem + ".pddl";
+	prob_file = dir + "/" + domain + "/" + problem + ".pddl";
+	return exists( dom_file ) && exists( prob_file );
+}
+
+void	split( const std::string& list, std::vector< std::string >& out ) {
+	std::stringstream in( list );
+	std::string item;
+	while ( std::getline( in, item, ',' ) )
+		if ( !item.empty() ) out.push_back( item );
+}
+
+void	run_task( STRIPS_Problem& prob, const po::variables_map& vm, Measure& m ) {
+	Fwd_Search_Problem search_prob( &prob );
+	Random rnd;
+	rnd.state = vm["seed"].as<unsigned>();
+	Samples S;
+	if ( !S.make( search_prob, vm["samples"].as<unsigned>(), std::max( 1u, vm["walk"].as<unsigned>() ), rnd ) ) {
+		std::cerr << "No actions applicable in the initial state of " << m.task << std::endl;
+		return;
+	}
+	unsigned n = S.size();
+	double fluents = 0;
+	for ( unsigned k = 0; k < n; k++ )
+		fluents += S.states[k]->fluent_vec().size();
+
+	std::cout << std::endl << m.task << ": " << prob.num_fluents() << " fluents, " << prob.num_actions() << " actions, "
+		<< n << " states with " << fluents / n << " fluents on average" << std::endl;
+	std::cout << std::left << std::setw(28) << "kernel" << std::right << std::setw(14) << "ns/op"
+		<< std::setw(12) << "allocs/op" << std::setw(12) << "ops" << std::endl;
+
+	{
+		Bit_Set_Set_Unset k( S, prob.num_fluents() );
+		m( "bit_set.set_unset", k, n );
+	}
+	{
+		Bit_Set_Intersection k( S, prob.num_fluents() );
+		m( "bit_set.intersection", k, n );
+	}
+	{
+		Bit_Set_Contains k( S, prob );
+		m( "bit_set.contains", k, n );
+	}
+	{
+		Hash_Key_Fluent_Vec k( S );
+		m( "hash_key.fluent_vec", k, n );
+	}
+	{
+		Hash_Key_Bit_Array k( S );
+		m( "hash_key.bit_array", k, n );
+	}
+	{
+		Jenkins_Hash k( S );
+		m( "jenkins_hash", k, n );
+	}
+	{
+		Succ_Gen_Iterate k( S, prob );
+		m( "succ_gen.iterate", k, n );
+	}
+	{
+		State_Progress_Through k( S, prob );
+		m( "state.progress_through", k, n );
+	}
+	H_Add_Fwd h_add( search_prob );
+	{
+		Evaluate< H_Add_Fwd > k( S, h_add );
+		m( "h1.add", k, n );
+	}
+	if ( m.wanted( "h1.max" ) ) {
+		H_Max_Fwd h_max( search_prob );
+		Evaluate< H_Max_Fwd > k( S, h_max );
+		m( "h1.max", k, n );
+	}
+	if ( m.wanted( "h2" ) ) {
+		H2_Fwd h2( search_prob );
+		Evaluate< H2_Fwd > k( S, h2 );
+		m( "h2", k, n );
+	}
+	if ( m.wanted( "rp.extract" ) ) {
+		RP_Extractor rp( prob, h_add );
+		RP_Extract k( S, rp );
+		m( "rp.extract", k, n );
+	}
+	if ( m.wanted( "novelty.eval" ) ) {
+		H_Novel_Fwd novelty( search_prob, vm["arity"].as<unsigned>() );
+		Novelty_Eval k( S, novelty );
+		std::stringstream name;
+		name << "novelty.eval(" << novelty.arity() << ")";
+		m( name.str(), k, n );
+	}
+	if ( m.wanted( "open_list" ) || m.wanted( "closed_list" ) ) {
+		Sample_Nodes nodes( S, h_add );
+		{
+			Open_List_Insert_Pop k( nodes );
+			m( "open_list.insert_pop", k, n );
+		}
+		{
+			Closed_List_Put_Retrieve k( nodes );
+			m( "closed_list.put_retrieve", k, n );
+		}
+	}
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "benchmarks", po::value<std::string>()->default_value("../../../benchmarks/ipc-2006"), "Folder with the IPC-2006 domains" )
+		( "domains", po::value<std::string>()->default_value("TPP,rovers,pipesworld,storage,trucks,openstacks,pathways"), "Domains, separated by commas" )
+		( "problem", po::value<std::string>()->default_value("p01"), "Problem taken from each domain" )
+		( "kernels", po::value<std::string>(), "Kernels timed, separated by commas, all by default. Names are matched by prefix" )
+		( "samples", po::value<unsigned>()->default_value(1000), "States sampled from each task" )
+		( "walk", po::value<unsigned>()->default_value(50), "Most actions in each random walk" )
+		( "seed", po::value<unsigned>()->default_value(1), "Seed for the random walks" )
+		( "min-time", po::value<float>()->default_value(0.25f), "Least time each kernel is run for, in secs" )
+		( "arity", po::value<unsigned>()->default_value(2), "Arity of the novelty table" )
+		( "log", po::value<std::string>()->default_value("microbench.csv"), "CSV file the results are written to" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") ) {
+		std::cout << desc << std::endl;
+		return 0;
+	}
+
+	std::vector< std::string > domains;
+	split( vm["domains"].as<std::string>(), domains );
+
+	std::ofstream log( vm["log"].as<std::string>().c_str() );
+	log << "task,kernel,ops,ns_per_op,allocs_per_op" << std::endl;
+
+	Measure m;
+	m.min_time = vm["min-time"].as<float>();
+	m.log = &log;
+	m.sink = 0;
+	if ( vm.count("kernels") )
+		split( vm["kernels"].as<std::string>(), m.kernels );
+
+	std::string dir = vm["benchmarks"].as<std::string>();
+	std::string problem = vm["problem"].as<std::string>();
+	int failed = 0;
+	for ( unsigned d = 0; d < domains.size(); d++ ) {
+		std::string dom_file, prob_file;
+		m.task = domains[d] + "/" + problem;
+		if ( !task_files( dir, domains[d], problem, dom_file, prob_file ) ) {
+			std::cerr << "No files for " << m.task << " in " << dir << std::endl;
+			failed = 1;
+			continue;
+		}
+		STRIPS_Problem prob;
+		aptk::FF_Parser::get_problem_description( dom_file, prob_file, prob );
+		run_task( prob, vm, m );
+	}
+
+	// Keeps the results of the kernels alive
+	if ( m.sink == 1 ) std::cout << std::endl;
+	return failed;
+}
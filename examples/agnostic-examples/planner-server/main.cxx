@@ -0,0 +1,682 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Long-running planner that keeps grounded tasks in memory. Requests are
+// read one per line, from stdin or from the clients of a Unix socket:
+//
+//	solve id=<id> domain=<path> problem=<path> [engine=brfs|bfs|siw] [budget=<secs>] [bound=<w>]
+//	status
+//	quit
+//
+// and each solve request is answered, tagged with its id, with
+//
+//	task <id> cached=<0|1> fluents=<n> actions=<n> ground_time=<secs>
+//	plan <id> <step> <action>			(one per step, as found)
+//	result <id> solved|unsolved|timeout cost=<c> length=<n> expanded=<n> generated=<n> time=<secs>
+//
+// or error <id> <message>. Paths cannot contain spaces.
+//
+// FF keeps its tables in globals and can only ground one task per process,
+// so every task is grounded in a child process, which hands it back as a
+// .aptk file. Every search runs in a child too, forked from the server
+// after the task is in memory, so it starts with the task already built,
+// its time budget and memory are its own, and a crash only loses that
+// request.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <ff_to_aptk.hxx>
+#include <strips_prob.hxx>
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <strips_state.hxx>
+#include <fwd_search_prob.hxx>
+#include <mapped_task.hxx>
+#include <h_1.hxx>
+#include <h_2.hxx>
+#include <rp_heuristic.hxx>
+#include <novelty.hxx>
+#include <simple_landmarks.hxx>
+
+#include <aptk/open_list.hxx>
+#include <aptk/at_bfs_dq.hxx>
+#include <aptk/brfs.hxx>
+#include <aptk/siw.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+using	aptk::agnostic::Fwd_Search_Problem;
+using	aptk::agnostic::Mapped_Task;
+
+using 	aptk::agnostic::H1_Heuristic;
+using	aptk::agnostic::H_Add_Evaluation_Function;
+using	aptk::agnostic::Relaxed_Plan_Heuristic;
+using 	aptk::agnostic::H2_Heuristic;
+using 	aptk::agnostic::Landmarks_Graph_Generator;
+using 	aptk::agnostic::Landmarks_Graph;
+
+using 	aptk::search::Open_List;
+using	aptk::search::Node_Comparer;
+using	aptk::search::bfs_dq::AT_BFS_DQ_SH;
+using	aptk::search::brfs::BRFS;
+using	aptk::search::SIW;
+
+typedef		aptk::search::bfs_dq::Node< aptk::State >			Search_Node;
+typedef		Node_Comparer< Search_Node >					Tie_Breaking_Algorithm;
+typedef		Open_List< Tie_Breaking_Algorithm, Search_Node >		BFS_Open_List;
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Add_Evaluation_Function>	H_Add_Fwd;
+typedef		Relaxed_Plan_Heuristic< Fwd_Search_Problem, H_Add_Fwd >		H_Add_Rp_Fwd;
+typedef		AT_BFS_DQ_SH< Fwd_Search_Problem, H_Add_Rp_Fwd, BFS_Open_List >	BFS_H_Add_Rp_Fwd;
+typedef		BRFS< Fwd_Search_Problem >					BRFS_Fwd;
+typedef		SIW< Fwd_Search_Problem >					SIW_Fwd;
+typedef         H2_Heuristic<Fwd_Search_Problem>				H2_Fwd;
+typedef         Landmarks_Graph_Generator<Fwd_Search_Problem>			Gen_Lms_Fwd;
+
+// Writes the whole buffer, giving up if the other end went away
+bool	write_all( int fd, const std::string& s ) {
+	size_t done = 0;
+	while ( done < s.size() ) {
+		ssize_t n = write( fd, s.data() + done, s.size() - done );
+		if ( n < 0 && errno == EINTR ) continue;
+		if ( n <= 0 ) return false;
+		done += n;
+	}
+	return true;
+}
+
+class Line_Reader {
+public:
+	Line_Reader( int fd ) : m_fd( fd ) {}
+
+	// Returns false at end of file
+	bool	next( std::string& line ) {
+		while ( true ) {
+			size_t eol = m_buffer.find( '\n' );
+			if ( eol != std::string::npos ) {
+				line = m_buffer.substr( 0, eol );
+				m_buffer.erase( 0, eol + 1 );
+				return true;
+			}
+			char chunk[4096];
+			ssize_t n = read( m_fd, chunk, sizeof(chunk) );
+			if ( n < 0 && errno == EINTR ) continue;
+			if ( n <= 0 ) {
+				if ( m_buffer.empty() ) return false;
+				line.swap( m_buffer );
+				m_buffer.clear();
+				return true;
+			}
+			m_buffer.append( chunk, n );
+		}
+	}
+
+	std::string&	buffer()	{ return m_buffer; }
+
+protected:
+	int		m_fd;
+	std::string	m_buffer;
+};
+
+// A client, lines from different workers are never interleaved
+class Connection {
+public:
+	Connection( int in, int out ) : m_in( in ), m_out( out ) {}
+	~Connection() {
+		if ( m_in > 2 ) close( m_in );
+		if ( m_out > 2 && m_out != m_in ) close( m_out );
+	}
+
+	int	in() const	{ return m_in; }
+
+	void	send( const std::string& line ) {
+		std::lock_guard< std::mutex > guard( m_lock );
+		write_all( m_out, line + "\n" );
+	}
+
+protected:
+	int		m_in;
+	int		m_out;
+	std::mutex	m_lock;
+};
+
+typedef	std::shared_ptr< Connection >	Connection_Ptr;
+
+struct Request {
+	Connection_Ptr	conn;
+	std::string	id;
+	std::string	domain;
+	std::string	problem;
+	std::string	engine;
+	float		budget;
+	int		bound;
+};
+
+// Grounded tasks, keyed by the paths of the domain and problem files, and
+// grounded again when either file changes. Least recently used tasks are
+// dropped once there are more than the capacity, searches still running
+// on them keep them alive until they finish.
+class Task_Cache {
+public:
+	struct Entry {
+		Entry() : ready( false ), task( NULL ), last_used( 0 ), ground_time( 0 ) {}
+		~Entry() { delete task; }
+
+		std::mutex		lock;
+		bool			ready;
+		STRIPS_Problem*		task;
+		time_t			domain_mtime;
+		time_t			problem_mtime;
+		unsigned long		last_used;
+		double			ground_time;
+	};
+	typedef	std::shared_ptr< Entry >	Entry_Ptr;
+
+	Task_Cache( unsigned capacity, std::string scratch )
+	: m_capacity( capacity == 0 ? 1 : capacity ), m_clock( 0 ), m_scratch( scratch ) {
+	}
+
+	// Throws std::runtime_error if the task cannot be grounded
+	Entry_Ptr	get( const std::string& domain, const std::string& problem, bool& cached ) {
+		time_t dm = mtime( domain ), pm = mtime( problem );
+		std::string key = domain + "\n" + problem;
+		Entry_Ptr e;
+		{
+			std::lock_guard< std::mutex > guard( m_lock );
+			std::map< std::string, Entry_Ptr >::iterator it = m_entries.find( key );
+			if ( it != m_entries.end() && it->second->domain_mtime == dm && it->second->problem_mtime == pm )
+				e = it->second;
+			else {
+				e.reset( new Entry );
+				e->domain_mtime = dm;
+				e->problem_mtime = pm;
+				m_entries[key] = e;
+			}
+			e->last_used = ++m_clock;
+			evict();
+		}
+
+		std::lock_guard< std::mutex > guard( e->lock );
+		cached = e->ready;
+		if ( e->ready ) return e;
+		try {
+			double t0 = aptk::wall_time();
+			e->task = ground( domain, problem );
+			e->ground_time = aptk::wall_time() - t0;
+			e->ready = true;
+		}
+		catch ( std::runtime_error& ) {
+			std::lock_guard< std::mutex > guard( m_lock );
+			std::map< std::string, Entry_Ptr >::iterator it = m_entries.find( key );
+			if ( it != m_entries.end() && it->second == e ) m_entries.erase( it );
+			throw;
+		}
+		return e;
+	}
+
+	unsigned	size() {
+		std::lock_guard< std::mutex > guard( m_lock );
+		return m_entries.size();
+	}
+
+protected:
+
+	static time_t	mtime( const std::string& path ) {
+		struct stat st;
+		if ( stat( path.c_str(), &st ) != 0 )
+			throw std::runtime_error( "cannot read " + path );
+		return st.st_mtime;
+	}
+
+	void	evict() {
+		while ( m_entries.size() > m_capacity ) {
+			std::map< std::string, Entry_Ptr >::iterator oldest = m_entries.begin();
+			for ( std::map< std::string, Entry_Ptr >::iterator it = m_entries.begin(); it != m_entries.end(); it++ )
+				if ( it->second->last_used < oldest->second->last_used ) oldest = it;
+			m_entries.erase( oldest );
+		}
+	}
+
+	STRIPS_Problem*	ground( const std::string& domain, const std::string& problem ) {
+		std::string path = m_scratch + "/aptk-task-XXXXXX";
+		std::vector<char> name( path.begin(), path.end() );
+		name.push_back( '\0' );
+		int fd = mkstemp( &name[0] );
+		if ( fd < 0 ) throw std::runtime_error( "cannot create a file in " + m_scratch );
+		close( fd );
+		path = &name[0];
+
+		pid_t pid = fork();
+		if ( pid < 0 ) {
+			unlink( path.c_str() );
+			throw std::runtime_error( "cannot fork" );
+		}
+		if ( pid == 0 ) {
+			int null = open( "/dev/null", O_WRONLY );
+			dup2( null, 1 );
+			try {
+				STRIPS_Problem prob;
+				aptk::FF_Parser::get_problem_description( domain, problem, prob );
+				Mapped_Task::write( prob, path );
+			}
+			catch ( ... ) {
+				_exit( 1 );
+			}
+			_exit( 0 );
+		}
+
+		int status;
+		while ( waitpid( pid, &status, 0 ) < 0 && errno == EINTR );
+		if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) {
+			unlink( path.c_str() );
+			throw std::runtime_error( "grounding of " + problem + " failed" );
+		}
+		STRIPS_Problem* task = new STRIPS_Problem;
+		try {
+			Mapped_Task mapped( path );
+			unlink( path.c_str() );
+			mapped.make_problem( *task );
+		}
+		catch ( std::runtime_error& ) {
+			unlink( path.c_str() );
+			delete task;
+			throw;
+		}
+		return task;
+	}
+
+	std::mutex				m_lock;
+	std::map< std::string, Entry_Ptr >	m_entries;
+	unsigned				m_capacity;
+	unsigned long				m_clock;
+	std::string				m_scratch;
+};
+
+class Request_Queue {
+public:
+	Request_Queue() : m_closed( false ), m_running( 0 ) {}
+
+	void	push( const Request& r ) {
+		std::lock_guard< std::mutex > guard( m_lock );
+		m_queue.push_back( r );
+		m_ready.notify_one();
+	}
+
+	// Returns false once the queue is closed and empty
+	bool	pop( Request& r ) {
+		std::unique_lock< std::mutex > guard( m_lock );
+		while ( m_queue.empty() && !m_closed )
+			m_ready.wait( guard );
+		if ( m_queue.empty() ) return false;
+		r = m_queue.front();
+		m_queue.pop_front();
+		m_running++;
+		return true;
+	}
+
+	void	done() {
+		std::lock_guard< std::mutex > guard( m_lock );
+		m_running--;
+	}
+
+	void	close() {
+		std::lock_guard< std::mutex > guard( m_lock );
+		m_closed = true;
+		m_ready.notify_all();
+	}
+
+	void	counts( unsigned& queued, unsigned& running ) {
+		std::lock_guard< std::mutex > guard( m_lock );
+		queued = m_queue.size();
+		running = m_running;
+	}
+
+protected:
+	std::mutex			m_lock;
+	std::condition_variable		m_ready;
+	std::deque< Request >		m_queue;
+	bool				m_closed;
+	unsigned			m_running;
+};
+
+// Runs in the search process, results go to fd as protocol lines
+template <typename Search_Engine>
+void	report( Search_Engine& engine, const STRIPS_Problem& prob, const Request& r, int fd ) {
+	std::vector< aptk::Action_Idx > plan;
+	float cost = 0;
+	float t0 = aptk::time_used();
+	bool solved = engine.find_solution( cost, plan );
+	float t = aptk::time_used() - t0;
+
+	std::stringstream out;
+	for ( unsigned k = 0; solved && k < plan.size(); k++ )
+		out << "plan " << r.id << " " << k+1 << " " << prob.actions()[ plan[k] ]->signature() << "\n";
+	out << "result " << r.id << ( solved ? " solved" : " unsolved" );
+	if ( solved ) out << " cost=" << cost << " length=" << plan.size();
+	out << " expanded=" << engine.expanded() << " generated=" << engine.generated() << " time=" << t;
+	write_all( fd, out.str() + "\n" );
+}
+
+void	search( STRIPS_Problem& prob, const Request& r, int fd ) {
+	Fwd_Search_Problem search_prob( &prob );
+
+	if ( r.engine == "brfs" ) {
+		BRFS_Fwd engine( search_prob );
+		engine.start();
+		report( engine, prob, r, fd );
+	}
+	else if ( r.engine == "bfs" ) {
+		BFS_H_Add_Rp_Fwd engine( search_prob );
+		engine.set_schedule( 10, 1 );
+		engine.set_budget( r.budget );
+		engine.start();
+		report( engine, prob, r, fd );
+	}
+	else if ( r.engine == "siw" ) {
+		// These change the task, but only this process' copy of it
+		H2_Fwd h2( search_prob );
+		h2.compute_edeletes( prob );
+		Gen_Lms_Fwd gen_lms( search_prob );
+		Landmarks_Graph graph( prob );
+		gen_lms.set_only_goals( true );
+		gen_lms.compute_lm_graph_set_additive( graph );
+		SIW_Fwd engine( search_prob );
+		engine.set_goal_agenda( &graph );
+		engine.set_bound( r.bound );
+		engine.start();
+		report( engine, prob, r, fd );
+	}
+	else
+		write_all( fd, "error " + r.id + " unknown engine " + r.engine + "\n" );
+}
+
+void	run_search( Task_Cache::Entry& task, const Request& r ) {
+	int fds[2];
+	if ( pipe( fds ) != 0 ) {
+		r.conn->send( "error " + r.id + " cannot create pipe" );
+		return;
+	}
+	pid_t pid = fork();
+	if ( pid < 0 ) {
+		close( fds[0] ); close( fds[1] );
+		r.conn->send( "error " + r.id + " cannot fork" );
+		return;
+	}
+	if ( pid == 0 ) {
+		close( fds[0] );
+		int null = open( "/dev/null", O_WRONLY );
+		dup2( null, 1 );
+		try {
+			search( *task.task, r, fds[1] );
+		}
+		catch ( std::exception& e ) {
+			write_all( fds[1], "error " + r.id + " " + e.what() + "\n" );
+		}
+		_exit( 0 );
+	}
+	close( fds[1] );
+
+	// Lines are passed on as they come, and the search process is killed
+	// if it runs past its budget
+	Line_Reader reader( fds[0] );
+	double deadline = aptk::wall_time() + r.budget;
+	bool answered = false, timeout = false;
+	while ( true ) {
+		double left = deadline - aptk::wall_time();
+		if ( left <= 0 ) {
+			timeout = true;
+			break;
+		}
+		struct pollfd p = { fds[0], POLLIN, 0 };
+		int n = poll( &p, 1, (int)( left * 1000 ) + 1 );
+		if ( n < 0 && errno == EINTR ) continue;
+		if ( n == 0 ) continue;
+		char chunk[4096];
+		ssize_t got = read( fds[0], chunk, sizeof(chunk) );
+		if ( got < 0 && errno == EINTR ) continue;
+		if ( got <= 0 ) break;
+		reader.buffer().append( chunk, got );
+		size_t eol;
+		while ( ( eol = reader.buffer().find( '\n' ) ) != std::string::npos ) {
+			std::string line = reader.buffer().substr( 0, eol );
+			reader.buffer().erase( 0, eol + 1 );
+			if ( line.compare( 0, 7, "result " ) == 0 || line.compare( 0, 6, "error " ) == 0 )
+				answered = true;
+			r.conn->send( line );
+		}
+		// Other search processes may hold the pipe open too, so do not
+		// wait for end of file once the answer is in
+		if ( answered ) break;
+	}
+	close( fds[0] );
+	if ( timeout ) kill( pid, SIGKILL );
+	int status;
+	while ( waitpid( pid, &status, 0 ) < 0 && errno == EINTR );
+
+	std::stringstream msg;
+	if ( timeout )
+		msg << "result " << r.id << " timeout time=" << r.budget;
+	else if ( !answered ) {
+		msg << "error " << r.id << " search process failed";
+		if ( WIFSIGNALED( status ) ) msg << " with signal " << WTERMSIG( status );
+	}
+	if ( !msg.str().empty() ) r.conn->send( msg.str() );
+}
+
+void	worker( Request_Queue& queue, Task_Cache& cache ) {
+	Request r;
+	while ( queue.pop( r ) ) {
+		try {
+			bool cached;
+			Task_Cache::Entry_Ptr task = cache.get( r.domain, r.problem, cached );
+			std::stringstream msg;
+			msg << "task " << r.id << " cached=" << ( cached ? 1 : 0 ) << " fluents=" << task->task->num_fluents()
+				<< " actions=" << task->task->num_actions() << " ground_time=" << task->ground_time;
+			r.conn->send( msg.str() );
+			run_search( *task, r );
+		}
+		catch ( std::runtime_error& e ) {
+			r.conn->send( "error " + r.id + " " + e.what() );
+		}
+		r = Request();
+		queue.done();
+	}
+}
+
+struct Server_Options {
+	float		budget;
+	std::string	engine;
+};
+
+// Reads requests from a client until it sends quit or goes away
+void	serve( Connection_Ptr conn, Request_Queue& queue, Task_Cache& cache, const Server_Options& opt ) {
+	static std::mutex ids_lock;
+	static unsigned long next_id = 0;
+
+	Line_Reader reader( conn->in() );
+	std::string line;
+	while ( reader.next( line ) ) {
+		std::stringstream in( line );
+		std::string cmd;
+		if ( !( in >> cmd ) ) continue;
+		if ( cmd == "quit" ) break;
+		if ( cmd == "status" ) {
+			unsigned queued, running;
+			queue.counts( queued, running );
+			std::stringstream msg;
+			msg << "status cached=" << cache.size() << " queued=" << queued << " running=" << running;
+			conn->send( msg.str() );
+			continue;
+		}
+		if ( cmd != "solve" ) {
+			conn->send( "error - unknown command " + cmd );
+			continue;
+		}
+
+		Request r;
+		r.conn = conn;
+		r.engine = opt.engine;
+		r.budget = opt.budget;
+		r.bound = 1;
+		std::string field;
+		bool valid = true;
+		while ( in >> field ) {
+			size_t eq = field.find( '=' );
+			std::string key = field.substr( 0, eq );
+			std::string value = eq == std::string::npos ? "" : field.substr( eq + 1 );
+			if ( key == "id" ) r.id = value;
+			else if ( key == "domain" ) r.domain = value;
+			else if ( key == "problem" ) r.problem = value;
+			else if ( key == "engine" ) r.engine = value;
+			else if ( key == "budget" ) r.budget = atof( value.c_str() );
+			else if ( key == "bound" ) r.bound = atoi( value.c_str() );
+			else valid = false;
+		}
+		if ( r.id.empty() ) {
+			std::lock_guard< std::mutex > guard( ids_lock );
+			std::stringstream id;
+			id << "r" << ++next_id;
+			r.id = id.str();
+		}
+		if ( !valid || r.domain.empty() || r.problem.empty() || r.budget <= 0 ) {
+			conn->send( "error " + r.id + " malformed request" );
+			continue;
+		}
+		queue.push( r );
+	}
+}
+
+void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
+	po::options_description desc( "Options:" );
+
+	desc.add_options()
+		( "help", "Show help message" )
+		( "socket", po::value<std::string>(), "Listen on this Unix socket instead of reading stdin" )
+		( "workers", po::value<unsigned>()->default_value(2), "Requests solved at the same time" )
+		( "cache-size", po::value<unsigned>()->default_value(16), "Grounded tasks kept in memory" )
+		( "budget", po::value<float>()->default_value(60.0f), "Default time budget of each request, in seconds" )
+		( "engine", po::value<std::string>()->default_value("bfs"), "Default engine: brfs, bfs or siw" )
+		( "scratch", po::value<std::string>()->default_value("/tmp"), "Directory for the grounded task files" )
+	;
+
+	try {
+		po::store( po::parse_command_line( ac, av, desc ), vars );
+		po::notify( vars );
+	}
+	catch ( std::exception& e ) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+	catch ( ... ) {
+		std::cerr << "Exception of unknown type!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( vars.count("help") ) {
+		std::cout << desc << std::endl;
+		std::exit(0);
+	}
+
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+
+	process_command_line_options( argc, argv, vm );
+
+	signal( SIGPIPE, SIG_IGN );
+
+	Server_Options opt;
+	opt.budget = vm["budget"].as<float>();
+	opt.engine = vm["engine"].as<std::string>();
+
+	Request_Queue queue;
+	Task_Cache cache( vm["cache-size"].as<unsigned>(), vm["scratch"].as<std::string>() );
+	std::vector< std::thread > workers;
+	for ( unsigned k = 0; k < std::max( 1u, vm["workers"].as<unsigned>() ); k++ )
+		workers.push_back( std::thread( worker, std::ref( queue ), std::ref( cache ) ) );
+
+	if ( !vm.count( "socket" ) ) {
+		// The protocol gets stdout for itself, anything the library prints
+		// goes to stderr
+		int out = dup( 1 );
+		dup2( 2, 1 );
+		Connection_Ptr conn( new Connection( 0, out ) );
+		serve( conn, queue, cache, opt );
+		queue.close();
+		for ( unsigned k = 0; k < workers.size(); k++ )
+			workers[k].join();
+		return 0;
+	}
+
+	std::string path = vm["socket"].as<std::string>();
+	struct sockaddr_un addr;
+	std::memset( &addr, 0, sizeof(addr) );
+	addr.sun_family = AF_UNIX;
+	if ( path.size() >= sizeof(addr.sun_path) ) {
+		std::cerr << "Socket path too long: " << path << std::endl;
+		return 1;
+	}
+	std::strcpy( addr.sun_path, path.c_str() );
+	int listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+	unlink( path.c_str() );
+	if ( listener < 0 || bind( listener, (struct sockaddr*)&addr, sizeof(addr) ) != 0 || listen( listener, 16 ) != 0 ) {
+		std::cerr << "Cannot listen on " << path << ": " << strerror( errno ) << std::endl;
+		return 1;
+	}
+	std::cerr << "Listening on " << path << std::endl;
+	dup2( 2, 1 );
+
+	while ( true ) {
+		int fd = accept( listener, NULL, NULL );
+		if ( fd < 0 ) {
+			if ( errno == EINTR ) continue;
+			break;
+		}
+		Connection_Ptr conn( new Connection( fd, fd ) );
+		std::thread( serve, conn, std::ref( queue ), std::ref( cache ), std::cref( opt ) ).detach();
+	}
+	return 1;
+}
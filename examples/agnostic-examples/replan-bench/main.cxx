@@ -0,0 +1,211 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Executes the plan found for a task one action at a time, replacing
+// the action with a random applicable one now and then, and replans
+// from each state reached. Replanning is timed with replan() on the
+// engine used so far, and with a new engine started from the state, and
+// the times, nodes expanded and plan lengths are written for each step.
+#include <strips_prob.hxx>
+#include <strips_state.hxx>
+#include <action.hxx>
+#include <fwd_search_prob.hxx>
+#include <lifted_task.hxx>
+#include <relaxed_grounder.hxx>
+#include <pddl_reader.hxx>
+#include <h_1.hxx>
+#include <rp_heuristic.hxx>
+#include <aptk/open_list.hxx>
+#include <aptk/at_bfs.hxx>
+#include <aptk/brfs.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <stdint.h>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+using	aptk::State;
+using	aptk::Action_Idx;
+using	aptk::agnostic::Fwd_Search_Problem;
+using	aptk::agnostic::Lifted_Task;
+using	aptk::agnostic::Relaxed_Grounder;
+using	aptk::agnostic::PDDL_Reader;
+using 	aptk::agnostic::H1_Heuristic;
+using	aptk::agnostic::H_Add_Evaluation_Function;
+using	aptk::agnostic::Relaxed_Plan_Heuristic;
+using 	aptk::search::Open_List;
+using	aptk::search::Node_Comparer;
+using	aptk::search::bfs::AT_BFS_SQ_SH;
+using	aptk::search::brfs::BRFS;
+
+typedef		aptk::search::bfs::Node< State >				Search_Node;
+typedef		Open_List< Node_Comparer< Search_Node >, Search_Node >		BFS_Open_List;
+typedef		H1_Heuristic<Fwd_Search_Problem, H_Add_Evaluation_Function>	H_Add_Fwd;
+typedef		Relaxed_Plan_Heuristic< Fwd_Search_Problem, H_Add_Fwd >		H_Add_Rp_Fwd;
+typedef		AT_BFS_SQ_SH< Fwd_Search_Problem, H_Add_Rp_Fwd, BFS_Open_List >	BFS_H_Add_Rp_Fwd;
+typedef		BRFS< Fwd_Search_Problem >					BRFS_Fwd;
+
+struct Random {
+	uint64_t	state;
+
+	unsigned	next( unsigned n ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (unsigned)( ( state >> 33 ) % n );
+	}
+};
+
+unsigned	reused_h( const BFS_H_Add_Rp_Fwd& engine )	{ return engine.reused_h(); }
+unsigned	reused_h( const BRFS_Fwd& )			{ return 0; }
+
+template <typename Search_Engine>
+int	run( Fwd_Search_Problem& search_prob, const po::variables_map& vm, std::ostream& log ) {
+	float budget = vm["budget"].as<float>();
+	float perturb = vm["perturb"].as<float>();
+	unsigned steps = vm["steps"].as<unsigned>();
+	Random rnd;
+	rnd.state = vm["seed"].as<unsigned>();
+
+	Search_Engine warm( search_prob );
+	warm.set_budget( budget );
+	warm.start();
+	std::vector< Action_Idx > plan;
+	float cost = 0;
+	if ( !warm.find_solution( cost, plan ) ) {
+		std::cerr << "No plan found from the initial state" << std::endl;
+		return 1;
+	}
+
+	const char* header = "step,perturbed,known,plan_length,warm_secs,warm_expanded,reused_h,fresh_secs,fresh_expanded,fresh_plan_length";
+	std::cout << header << std::endl;
+	log << header << std::endl;
+
+	double warm_total = 0, fresh_total = 0;
+	unsigned num_known = 0, step = 0;
+	State* current = search_prob.init();
+	while ( step < steps && !plan.empty() ) {
+		Action_Idx a = plan[0];
+		bool perturbed = false;
+		if ( rnd.next( 1000 ) < perturb * 1000 ) {
+			std::vector< Action_Idx > app;
+			search_prob.applicable_set( *current, app );
+			if ( !app.empty() ) {
+				a = app[ rnd.next( app.size() ) ];
+				perturbed = true;
+			}
+		}
+		State* next = search_prob.next( *current, a );
+		delete current;
+		current = next;
+		step++;
+		if ( search_prob.goal( *current ) ) break;
+
+		unsigned expanded_0 = warm.expanded();
+		unsigned reused_0 = reused_h( warm );
+		plan.clear();
+		double t0 = aptk::wall_time();
+		bool known = warm.replan( new State( *current ) );
+		bool solved = warm.find_solution( cost, plan );
+		double warm_secs = aptk::wall_time() - t0;
+		warm_total += warm_secs;
+		if ( known ) num_known++;
+
+		Search_Engine fresh( search_prob );
+		fresh.set_budget( budget );
+		std::vector< Action_Idx > fresh_plan;
+		float fresh_cost = 0;
+		t0 = aptk::wall_time();
+		fresh.start( new State( *current ) );
+		bool fresh_solved = fresh.find_solution( fresh_cost, fresh_plan );
+		double fresh_secs = aptk::wall_time() - t0;
+		fresh_total += fresh_secs;
+
+		std::stringstream row;
+		row << step << "," << perturbed << "," << known << "," << ( solved ? (int)plan.size() : -1 ) << ","
+			<< warm_secs << "," << warm.expanded() - expanded_0 << "," << reused_h( warm ) - reused_0 << ","
+			<< fresh_secs << "," << fresh.expanded() << "," << ( fresh_solved ? (int)fresh_plan.size() : -1 );
+		std::cout << row.str() << std::endl;
+		log << row.str() << std::endl;
+		if ( !solved ) break;
+	}
+	delete current;
+
+	std::cout << "Steps: " << step << ", states known: " << num_known << std::endl;
+	std::cout << "Replanning time, warm: " << warm_total << " secs, fresh: " << fresh_total << " secs" << std::endl;
+	return 0;
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "domain", po::value<std::string>(), "Input PDDL domain description" )
+		( "problem", po::value<std::string>(), "Input PDDL problem description" )
+		( "engine", po::value<std::string>()->default_value("bfs"), "Search engine, bfs or brfs" )
+		( "perturb", po::value<float>()->default_value(0.2f), "Chance of executing a random action instead of the planned one" )
+		( "steps", po::value<unsigned>()->default_value(50), "Most actions executed" )
+		( "budget", po::value<float>()->default_value(60.0f), "Time budget for each search" )
+		( "seed", po::value<unsigned>()->default_value(1), "Seed for the perturbations" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") || !vm.count("domain") || !vm.count("problem") ) {
+		std::cout << desc << std::endl;
+		return vm.count("help") ? 0 : 1;
+	}
+
+	STRIPS_Problem prob;
+	Lifted_Task task;
+	PDDL_Reader reader( task );
+	reader.read_domain( vm["domain"].as<std::string>() );
+	reader.read_problem( vm["problem"].as<std::string>() );
+	Relaxed_Grounder grounder( task );
+	grounder.ground( prob );
+
+	Fwd_Search_Problem search_prob( &prob );
+	std::ofstream log( "replan-bench.log" );
+	std::string engine = vm["engine"].as<std::string>();
+	if ( engine == "bfs" )
+		return run< BFS_H_Add_Rp_Fwd >( search_prob, vm, log );
+	if ( engine == "brfs" )
+		return run< BRFS_Fwd >( search_prob, vm, log );
+	std::cerr << "Unknown engine " << engine << std::endl;
+	return 1;
+}
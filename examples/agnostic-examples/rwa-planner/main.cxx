@@ -35,10 +35,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <simple_landmarks.hxx>
 #include <aptk/open_list.hxx>
 #include <aptk/at_rwbfs_dq_mh.hxx>
+#include <aptk/stats_reporter.hxx>
+#include <aptk/solution_sink.hxx>
 
 #include <iostream>
 #include <iterator>
 #include <fstream>
+#include <thread>
 
 #include <boost/program_options.hpp>
 
@@ -124,6 +127,27 @@ float do_search( Search_Engine& engine, const STRIPS_Problem& plan_prob, float b
 	return total_time;
 }
 
+// MRJ: Prints the plans queued by the engine as soon as they are found, while
+// the search goes on in another thread
+void print_plans( aptk::Solution_Queue& plans, const STRIPS_Problem& plan_prob ) {
+	std::vector< aptk::Solution > found;
+	while ( true ) {
+		// Read before popping, so that the last plans are not left behind
+		bool over = plans.has_ended();
+		plans.pop( found );
+		for ( unsigned i = 0; i < found.size(); i++ ) {
+			const aptk::Solution& s = found[i];
+			std::cout << "Plan found with cost " << s.cost << " after " << s.time << " secs, ";
+			std::cout << s.stats.expanded << " expanded, " << s.stats.generated << " generated" << std::endl;
+			for ( unsigned k = 0; k < s.plan.size(); k++ )
+				std::cout << k+1 << ". " << plan_prob.actions()[ s.plan[k] ]->signature() << std::endl;
+		}
+		found.clear();
+		if ( over ) break;
+		plans.wait( 1.0 );
+	}
+}
+
 void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
 	po::options_description desc( "Options:" );
 	
@@ -132,6 +156,10 @@ void process_command_line_options( int ac, char** av, po::variables_map& vars )
 		( "domain", po::value<std::string>(), "Input PDDL domain description" )
 		( "problem", po::value<std::string>(), "Input PDDL problem description" )
 		( "time", po::value<int>(), "Time to find a solution (in seconds)")
+		( "stats", po::value<std::string>(), "File to write search statistics to while searching" )
+		( "stats-format", po::value<std::string>()->default_value("json"), "Format of the statistics, json or csv" )
+		( "stats-interval", po::value<float>()->default_value(1.0f), "Secs between statistics samples" )
+		( "stream", "Print each plan as soon as it is found, the search goes on meanwhile" )
 	;
 	
 	try {
@@ -189,8 +217,30 @@ int main( int argc, char** argv ) {
 
 	Anytime_RWBFS_H_Add_Rp_Fwd wbfs_engine( search_prob, 5.0f, 0.75f);
 	wbfs_engine.set_schedule( 10, 5, 1 );
+
+	std::ofstream stats_out;
+	aptk::Stats_Reporter* reporter = NULL;
+	if ( vm.count( "stats" ) ) {
+		stats_out.open( vm["stats"].as<std::string>().c_str() );
+		aptk::Stats_Reporter::Format format = vm["stats-format"].as<std::string>() == "csv" ? aptk::Stats_Reporter::CSV : aptk::Stats_Reporter::JSON;
+		reporter = new aptk::Stats_Reporter( stats_out, format, vm["stats-interval"].as<float>() );
+		wbfs_engine.set_reporter( reporter );
+	}
 	
-	do_search( wbfs_engine, prob, time - 0.005f, "rwbfs-dq-mh.log" );
+	if ( vm.count( "stream" ) ) {
+		aptk::Solution_Queue plans;
+		wbfs_engine.set_solution_sink( &plans );
+		std::thread searcher( [&]() { do_search( wbfs_engine, prob, time - 0.005f, "rwbfs-dq-mh.log" ); } );
+		print_plans( plans, prob );
+		searcher.join();
+	}
+	else
+		do_search( wbfs_engine, prob, time - 0.005f, "rwbfs-dq-mh.log" );
+
+	if ( reporter != NULL ) {
+		reporter->sample( wbfs_engine );
+		delete reporter;
+	}
 
 	return 0;
 }
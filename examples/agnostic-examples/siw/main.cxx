@@ -38,6 +38,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/siw.hxx>
 #include <aptk/serialized_search.hxx>
 #include <aptk/string_conversions.hxx>
+#include <aptk/stats_reporter.hxx>
+#include <aptk/memory.hxx>
 
 #include <boost/program_options.hpp>
 
@@ -121,6 +123,10 @@ void process_command_line_options( int ac, char** av, po::variables_map& vars )
 		( "domain", po::value<std::string>(), "Input PDDL domain description" )
 		( "problem", po::value<std::string>(), "Input PDDL problem description" )
 		( "bound", po::value<int>()->default_value(1), "Max width w for IW(w)")
+		( "stats", po::value<std::string>(), "File to write search statistics to while searching" )
+		( "stats-format", po::value<std::string>()->default_value("json"), "Format of the statistics, json or csv" )
+		( "stats-interval", po::value<float>()->default_value(1.0f), "Secs between statistics samples" )
+		( "memory", po::value<float>(), "Memory limit in MB, the search gives up memory as it gets close to it (the address space limit by default)" )
 	;
 	
 	try {
@@ -191,7 +197,25 @@ int main( int argc, char** argv ) {
 	
 	float iw_bound = vm["bound"].as<int>();
 
+	std::ofstream stats_out;
+	aptk::Stats_Reporter* reporter = NULL;
+	if ( vm.count( "stats" ) ) {
+		stats_out.open( vm["stats"].as<std::string>().c_str() );
+		aptk::Stats_Reporter::Format format = vm["stats-format"].as<std::string>() == "csv" ? aptk::Stats_Reporter::CSV : aptk::Stats_Reporter::JSON;
+		reporter = new aptk::Stats_Reporter( stats_out, format, vm["stats-interval"].as<float>() );
+		siw_engine.set_reporter( reporter );
+	}
+
+	aptk::Memory_Budget& memory = aptk::Memory_Budget::instance();
+	memory.set_limit( vm.count( "memory" ) ? vm["memory"].as<float>() : aptk::Memory_Budget::address_space_limit() );
+
 	float iw_t = do_search( siw_engine, prob, iw_bound, "iw.log" );
+	memory.report( std::cout );
+
+	if ( reporter != NULL ) {
+		reporter->sample( siw_engine );
+		delete reporter;
+	}
 	
 	std::cout << "IW search completed in " << iw_t << " secs, check 'iw.log' for details" << std::endl;
 
@@ -0,0 +1,182 @@
+// Contention benchmark for the concurrent state table. Every thread inserts
+// a stream of packed states, part of them shared with all the other threads
+// and the rest its own, looks each one up and tries to lower its g value.
+// The same workload is run on a hash map guarded by a single mutex, for
+// reference.
+#include <aptk/concurrent_state_table.hxx>
+#include <aptk/resources_control.hxx>
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <unordered_map>
+#include <sstream>
+#include <cstdlib>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::Concurrent_State_Table;
+
+typedef	Concurrent_State_Table::Word		Word;
+typedef	Concurrent_State_Table::State_ID	State_ID;
+
+struct Workload {
+	unsigned	words;
+	unsigned	per_thread;
+	unsigned	shared;
+
+	// Key i of thread t, shared keys are the same for all threads
+	uint64_t	key( unsigned t, unsigned i ) const {
+		return i < shared ? i : shared + (uint64_t)t * per_thread + i;
+	}
+
+	void	make_state( uint64_t key, Word* out ) const {
+		uint64_t x = key * 0x9E3779B97F4A7C15ULL + 1;
+		for ( unsigned j = 0; j < words; j++ ) {
+			x ^= x >> 29; x *= 0xBF58476D1CE4E5B9ULL; x ^= x >> 32;
+			out[j] = (Word)x;
+		}
+	}
+
+	// Threads start at different points of the stream, so they do not
+	// all hit the same shared key at once
+	unsigned	item( unsigned t, unsigned step ) const {
+		return (unsigned)( ( step + (uint64_t)t * 7919 ) % per_thread );
+	}
+
+	size_t	distinct( unsigned threads ) const {
+		return shared + (size_t)threads * ( per_thread - shared );
+	}
+};
+
+void	run_table( Concurrent_State_Table& table, const Workload& w, unsigned t, std::vector<State_ID>& shared_ids ) {
+	std::vector<Word> s( w.words );
+	shared_ids.assign( w.shared, Concurrent_State_Table::no_state );
+	for ( unsigned step = 0; step < w.per_thread; step++ ) {
+		unsigned i = w.item( t, step );
+		w.make_state( w.key( t, i ), &s[0] );
+		uint64_t fp = Concurrent_State_Table::hash( &s[0], w.words );
+		State_ID id = table.insert( fp, &s[0], (float)( w.per_thread - step ) ).first;
+		if ( table.find( fp, &s[0] ) != id ) {
+			std::cerr << "Lookup of a state just inserted failed" << std::endl;
+			std::exit( 1 );
+		}
+		table.update_g( id, (float)( step % 17 ) );
+		if ( i < w.shared ) shared_ids[i] = id;
+	}
+}
+
+struct Locked_Table {
+	std::mutex					lock;
+	std::unordered_map< uint64_t, unsigned >	index;
+	std::vector< Word >				payloads;
+	std::vector< float >				g;
+};
+
+void	run_locked( Locked_Table& table, const Workload& w, unsigned t ) {
+	std::vector<Word> s( w.words );
+	for ( unsigned step = 0; step < w.per_thread; step++ ) {
+		unsigned i = w.item( t, step );
+		w.make_state( w.key( t, i ), &s[0] );
+		uint64_t fp = Concurrent_State_Table::hash( &s[0], w.words );
+		std::lock_guard< std::mutex > guard( table.lock );
+		std::unordered_map< uint64_t, unsigned >::iterator it = table.index.find( fp );
+		unsigned id;
+		if ( it == table.index.end() ) {
+			id = table.g.size();
+			table.index[fp] = id;
+			table.payloads.insert( table.payloads.end(), s.begin(), s.end() );
+			table.g.push_back( (float)( w.per_thread - step ) );
+		}
+		else
+			id = it->second;
+		float g = (float)( step % 17 );
+		if ( g < table.g[id] ) table.g[id] = g;
+	}
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "max-threads", po::value<unsigned>()->default_value(64), "Largest number of threads, runs are done for every power of two up to it" )
+		( "states", po::value<unsigned>()->default_value(200000), "States inserted by each thread" )
+		( "words", po::value<unsigned>()->default_value(8), "Words in each packed state" )
+		( "shared", po::value<float>()->default_value(0.5f), "Fraction of the states every thread inserts" )
+		( "capacity", po::value<unsigned>()->default_value(1024), "Initial capacity of the table" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") ) {
+		std::cout << desc << std::endl;
+		return 0;
+	}
+
+	Workload w;
+	w.words = vm["words"].as<unsigned>();
+	w.per_thread = vm["states"].as<unsigned>();
+	w.shared = (unsigned)( vm["shared"].as<float>() * w.per_thread );
+	unsigned max_threads = vm["max-threads"].as<unsigned>();
+
+	std::ofstream log( "state-table-bench.log" );
+	std::cout << "threads,ops,table_secs,table_mops,resizes,locked_secs,locked_mops" << std::endl;
+	log << "threads,ops,table_secs,table_mops,resizes,locked_secs,locked_mops" << std::endl;
+
+	for ( unsigned n = 1; n <= max_threads; n *= 2 ) {
+		Concurrent_State_Table table( w.words, vm["capacity"].as<unsigned>() );
+		std::vector< std::vector<State_ID> > shared_ids( n );
+		std::vector< std::thread > threads;
+
+		double t0 = aptk::wall_time();
+		for ( unsigned k = 0; k < n; k++ )
+			threads.push_back( std::thread( run_table, std::ref( table ), std::cref( w ), k, std::ref( shared_ids[k] ) ) );
+		for ( unsigned k = 0; k < n; k++ )
+			threads[k].join();
+		double table_secs = aptk::wall_time() - t0;
+
+		// Every thread has to agree on the IDs of the shared states
+		if ( table.size() != w.distinct( n ) ) {
+			std::cerr << "Table holds " << table.size() << " states, expected " << w.distinct( n ) << std::endl;
+			return 1;
+		}
+		for ( unsigned k = 1; k < n; k++ )
+			if ( shared_ids[k] != shared_ids[0] ) {
+				std::cerr << "Threads 0 and " << k << " got different IDs for the same state" << std::endl;
+				return 1;
+			}
+
+		Locked_Table locked;
+		threads.clear();
+		t0 = aptk::wall_time();
+		for ( unsigned k = 0; k < n; k++ )
+			threads.push_back( std::thread( run_locked, std::ref( locked ), std::cref( w ), k ) );
+		for ( unsigned k = 0; k < n; k++ )
+			threads[k].join();
+		double locked_secs = aptk::wall_time() - t0;
+
+		double ops = (double)n * w.per_thread;
+		std::stringstream row;
+		row << n << "," << (size_t)ops << "," << table_secs << "," << ops / table_secs / 1e6 << ","
+			<< table.resizes() << "," << locked_secs << "," << ops / locked_secs / 1e6;
+		std::cout << row.str() << std::endl;
+		log << row.str() << std::endl;
+	}
+
+	return 0;
+}
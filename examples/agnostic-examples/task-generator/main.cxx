@@ -0,0 +1,140 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Builds a synthetic task of the given family and size, see
+// common/synthetic.hxx, and writes it as a .aptk task file, as PDDL or both
+#include <iostream>
+
+#include <strips_prob.hxx>
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <mapped_task.hxx>
+#include <common/synthetic.hxx>
+
+#include <aptk/resources_control.hxx>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::STRIPS_Problem;
+
+using	aptk::agnostic::Mapped_Task;
+
+void process_command_line_options( int ac, char** av, po::variables_map& vars ) {
+	po::options_description desc( "Options:" );
+
+	desc.add_options()
+		( "help", "Show help message" )
+		( "family", po::value<std::string>()->default_value( "grid" ), "Task family: grid, logistics or bitflip" )
+		( "size", po::value<unsigned>()->default_value( 10 ), "Grid side, cities or bits" )
+		( "branching", po::value<unsigned>()->default_value( 4 ), "Moves from each cell, locations of each city or bits of each group" )
+		( "length", po::value<unsigned>()->default_value( 4 ), "Items, packages or bit flips to the goal" )
+		( "ceffs", po::value<unsigned>()->default_value( 0 ), "Items or packages moved by conditional effects, or bits toggled by each flip" )
+		( "seed", po::value<int>()->default_value( 2381 ), "Random seed" )
+		( "output", po::value<std::string>(), "Task file to write" )
+		( "domain", po::value<std::string>(), "PDDL domain file to write" )
+		( "problem", po::value<std::string>(), "PDDL problem file to write" )
+	;
+
+	try {
+		po::store( po::parse_command_line( ac, av, desc ), vars );
+		po::notify( vars );
+	}
+	catch ( std::exception& e ) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		std::exit(1);
+	}
+	catch ( ... ) {
+		std::cerr << "Exception of unknown type!" << std::endl;
+		std::exit(1);
+	}
+
+	if ( vars.count("help") ) {
+		std::cout << desc << std::endl;
+		std::exit(0);
+	}
+
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+
+	process_command_line_options( argc, argv, vm );
+
+	if ( vm.count( "domain" ) != vm.count( "problem" ) ) {
+		std::cerr << "--domain and --problem have to be given together" << std::endl;
+		std::exit(1);
+	}
+
+	Synthetic_Task::Params params;
+	params.size = vm["size"].as<unsigned>();
+	params.branching = vm["branching"].as<unsigned>();
+	params.length = vm["length"].as<unsigned>();
+	params.ceffs = vm["ceffs"].as<unsigned>();
+	params.seed = vm["seed"].as<int>();
+
+	Synthetic_Task* generator = Synthetic_Task::create( vm["family"].as<std::string>(), params );
+	if ( generator == NULL ) {
+		std::cerr << "Unknown task family " << vm["family"].as<std::string>() << std::endl;
+		std::exit(1);
+	}
+
+	try {
+		double t0 = aptk::wall_time();
+		STRIPS_Problem	prob;
+		generator->build( prob );
+		delete generator;
+		unsigned num_ceffs = 0;
+		for ( unsigned a = 0; a < prob.num_actions(); a++ )
+			num_ceffs += prob.actions()[a]->ceff_vec().size();
+		double t1 = aptk::wall_time();
+		std::cout << "Task built in " << t1 - t0 << " secs: " << std::endl;
+		std::cout << "\tDomain: " << prob.domain_name() << std::endl;
+		std::cout << "\tProblem: " << prob.problem_name() << std::endl;
+		std::cout << "\t#Actions: " << prob.num_actions() << std::endl;
+		std::cout << "\t#Fluents: " << prob.num_fluents() << std::endl;
+		std::cout << "\t#Conditional effects: " << num_ceffs << std::endl;
+		std::cout << "\t#Goals: " << prob.goal().size() << std::endl;
+
+		if ( vm.count( "output" ) ) {
+			prob.make_action_tables();
+			double t2 = aptk::wall_time();
+			std::cout << "Action tables made in " << t2 - t1 << " secs" << std::endl;
+			Mapped_Task::write( prob, vm["output"].as<std::string>() );
+			t1 = aptk::wall_time();
+			std::cout << "Task written to " << vm["output"].as<std::string>() << " in " << t1 - t2 << " secs" << std::endl;
+		}
+
+		if ( vm.count( "domain" ) ) {
+			write_pddl( prob, vm["domain"].as<std::string>(), vm["problem"].as<std::string>() );
+			std::cout << "PDDL written to " << vm["domain"].as<std::string>() << " and "
+				<< vm["problem"].as<std::string>() << " in " << aptk::wall_time() - t1 << " secs" << std::endl;
+		}
+	}
+	catch ( std::runtime_error& e ) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
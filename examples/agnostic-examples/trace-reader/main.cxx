@@ -0,0 +1,242 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Reads a trace written by aptk::Trace_Writer, writes its records as CSV
+// and reports, for the expansions in the trace, how long the search stays
+// on plateaus, how far the heuristic is from the cost to reach the goals
+// found along their paths, and how the expansions alternate between the
+// open lists.
+#include <aptk/trace.hxx>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+using	aptk::Trace_Header;
+using	aptk::Trace_Record;
+using	aptk::Trace_Writer;
+
+const char*	event_names[] = { "expand", "goal", "duplicate", "reopen", "replace", "prune" };
+const unsigned	num_events = sizeof( event_names ) / sizeof( event_names[0] );
+const unsigned	num_queues = 3;
+
+// Records are returned oldest first
+bool	read_trace( std::string filename, std::vector< Trace_Record >& records ) {
+	std::ifstream in( filename.c_str(), std::ios::binary );
+	Trace_Header header;
+	if ( !in.read( (char*)&header, sizeof(header) ) ) {
+		std::cerr << "Could not read the header of " << filename << std::endl;
+		return false;
+	}
+	if ( std::strncmp( header.magic, Trace_Writer::magic(), sizeof(header.magic) ) != 0
+		|| header.record_size != sizeof(Trace_Record) ) {
+		std::cerr << filename << " is not a trace of this version" << std::endl;
+		return false;
+	}
+	uint64_t n = std::min( header.written, header.capacity );
+	std::vector< Trace_Record > ring( n );
+	if ( n > 0 && !in.read( (char*)&ring[0], n * sizeof(Trace_Record) ) ) {
+		std::cerr << filename << " is truncated" << std::endl;
+		return false;
+	}
+	if ( header.written > header.capacity )
+		std::cout << "Trace wrapped around, first " << header.written - header.capacity << " records were lost" << std::endl;
+	uint64_t first = header.written > header.capacity ? header.written % header.capacity : 0;
+	records.clear();
+	records.reserve( n );
+	records.insert( records.end(), ring.begin() + first, ring.end() );
+	records.insert( records.end(), ring.begin(), ring.begin() + first );
+	return true;
+}
+
+void	write_csv( const std::vector< Trace_Record >& records, std::ostream& out ) {
+	out << "index,event,queue,action,g,h,hash,parent" << std::endl;
+	for ( unsigned k = 0; k < records.size(); k++ ) {
+		const Trace_Record& r = records[k];
+		out << k << "," << ( r.type < num_events ? event_names[r.type] : "unknown" ) << ","
+			<< (unsigned)r.queue << "," << r.action << "," << r.g << "," << r.h << ","
+			<< r.hash << "," << r.parent << std::endl;
+	}
+}
+
+struct Summary {
+	unsigned	count;
+	double		total;
+	double		max;
+
+	Summary() : count(0), total(0), max(0) {}
+
+	void	add( double v ) {
+		if ( count == 0 || v > max ) max = v;
+		count++;
+		total += v;
+	}
+	double	mean() const	{ return count > 0 ? total / count : 0; }
+};
+
+// A plateau is the run of expansions after the lowest h seen so far
+// improves, until it improves again
+void	plateaus( const std::vector< Trace_Record >& records ) {
+	Summary s;
+	float best = 0;
+	unsigned length = 0;
+	bool first = true;
+	for ( unsigned k = 0; k < records.size(); k++ ) {
+		const Trace_Record& r = records[k];
+		if ( r.type != Trace_Writer::EXPAND ) continue;
+		if ( first || r.h < best ) {
+			if ( !first ) s.add( length );
+			best = r.h;
+			length = 0;
+			first = false;
+		}
+		length++;
+	}
+	if ( !first ) s.add( length );
+	std::cout << "Plateaus: " << s.count << ", mean length: " << s.mean() << ", longest: " << s.max << std::endl;
+}
+
+// The path of each goal is followed back through the expansions of its
+// parents, where h* is the cost left to the goal from each of them. States
+// expanded more than once are taken at their lowest g, so g decreases
+// along the path, and the path is cut where it does not
+void	heuristic_error( const std::vector< Trace_Record >& records ) {
+	std::map< uint64_t, const Trace_Record* > expanded;
+	unsigned num_goals = 0;
+	for ( unsigned k = 0; k < records.size(); k++ ) {
+		const Trace_Record& r = records[k];
+		if ( r.type == Trace_Writer::EXPAND ) {
+			const Trace_Record*& e = expanded[ r.hash ];
+			if ( e == NULL || r.g < e->g ) e = &r;
+			continue;
+		}
+		if ( r.type != Trace_Writer::GOAL ) continue;
+		Summary abs_err, over;
+		double signed_err = 0;
+		unsigned steps = 0;
+		uint64_t parent = r.parent;
+		float g = r.g;
+		while ( parent != 0 ) {
+			std::map< uint64_t, const Trace_Record* >::iterator it = expanded.find( parent );
+			if ( it == expanded.end() || it->second->g >= g ) break;
+			const Trace_Record& p = *(it->second);
+			g = p.g;
+			double err = p.h - ( r.g - p.g );
+			abs_err.add( std::fabs( err ) );
+			if ( err > 0 ) over.add( err );
+			signed_err += err;
+			parent = p.parent;
+			steps++;
+		}
+		std::cout << "Goal " << ++num_goals << ": cost " << r.g << ", nodes on path found: " << steps
+			<< ( parent != 0 ? " (path incomplete)" : "" ) << std::endl;
+		if ( steps == 0 ) continue;
+		std::cout << "\tMean error: " << signed_err / steps << ", mean absolute error: " << abs_err.mean()
+			<< ", overestimated: " << over.count << " (max " << over.max << ")" << std::endl;
+	}
+	if ( num_goals == 0 )
+		std::cout << "No goals in the trace" << std::endl;
+}
+
+void	queue_alternation( const std::vector< Trace_Record >& records ) {
+	unsigned expansions[num_queues] = { 0, 0, 0 };
+	Summary runs[num_queues];
+	unsigned switches = 0, run = 0, last = num_queues;
+	for ( unsigned k = 0; k < records.size(); k++ ) {
+		const Trace_Record& r = records[k];
+		if ( r.type != Trace_Writer::EXPAND || r.queue >= num_queues ) continue;
+		expansions[ r.queue ]++;
+		if ( r.queue != last ) {
+			if ( last < num_queues ) {
+				runs[last].add( run );
+				switches++;
+			}
+			last = r.queue;
+			run = 0;
+		}
+		run++;
+	}
+	if ( last < num_queues ) runs[last].add( run );
+	const char* names[num_queues] = { "open", "preferred", "both" };
+	std::cout << "Queue switches: " << switches << std::endl;
+	for ( unsigned q = 0; q < num_queues; q++ ) {
+		if ( expansions[q] == 0 ) continue;
+		std::cout << "\t" << names[q] << ": " << expansions[q] << " expanded, " << runs[q].count
+			<< " runs, mean run: " << runs[q].mean() << ", longest run: " << runs[q].max << std::endl;
+	}
+}
+
+int main( int argc, char** argv ) {
+
+	po::variables_map vm;
+	po::options_description desc( "Options" );
+
+	desc.add_options()
+		( "help", "Show help message. " )
+		( "trace", po::value<std::string>(), "Trace file to read" )
+		( "csv", po::value<std::string>(), "Write the records into this CSV file" )
+	;
+
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	}
+	catch ( po::error& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cout << desc << std::endl;
+		return 1;
+	}
+
+	if ( vm.count("help") || !vm.count("trace") ) {
+		std::cout << desc << std::endl;
+		return vm.count("help") ? 0 : 1;
+	}
+
+	std::vector< Trace_Record > records;
+	if ( !read_trace( vm["trace"].as<std::string>(), records ) )
+		return 1;
+
+	if ( vm.count("csv") ) {
+		std::ofstream out( vm["csv"].as<std::string>().c_str() );
+		write_csv( records, out );
+	}
+
+	unsigned counts[num_events] = { 0, 0, 0, 0, 0, 0 };
+	for ( unsigned k = 0; k < records.size(); k++ )
+		if ( records[k].type < num_events )
+			counts[ records[k].type ]++;
+	std::cout << "Records: " << records.size() << std::endl;
+	for ( unsigned e = 0; e < num_events; e++ )
+		std::cout << "\t" << event_names[e] << ": " << counts[e] << std::endl;
+
+	plateaus( records );
+	heuristic_error( records );
+	queue_alternation( records );
+	return 0;
+}
@@ -132,6 +132,7 @@ void process_command_line_options( int ac, char** av, po::variables_map& vars )
 		( "domain", po::value<std::string>(), "Input PDDL domain description" )
 		( "problem", po::value<std::string>(), "Input PDDL problem description" )
 		( "time", po::value<int>(), "Time to find a solution (in seconds)")
+		( "trace", po::value<std::string>(), "Write the nodes expanded, duplicates and reopenings into this file" )
 	;
 	
 	try {
@@ -185,8 +186,18 @@ int main( int argc, char** argv ) {
 
 	Anytime_WBFS_H_Add_Rp_Fwd wbfs_engine( search_prob, 5.0f, 0.75f);
 	wbfs_engine.set_schedule( 10, 5, 1 );
+	aptk::Trace_Writer* trace = NULL;
+	if ( vm.count( "trace" ) ) {
+		trace = new aptk::Trace_Writer( vm["trace"].as<std::string>() );
+		if ( !trace->good() ) {
+			std::cerr << "Could not open trace file " << vm["trace"].as<std::string>() << std::endl;
+			std::exit(1);
+		}
+		wbfs_engine.set_trace( trace );
+	}
 	float time = vm["time"].as<int>();
 	do_search( wbfs_engine, prob, time - 0.005f, "wbfs-dq-mh.log" );
+	delete trace;
 
 	return 0;
 }
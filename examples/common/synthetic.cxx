@@ -0,0 +1,470 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <common/synthetic.hxx>
+#include <fluent.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <set>
+
+using	aptk::STRIPS_Problem;
+using	aptk::Fluent_Vec;
+using	aptk::Conditional_Effect;
+using	aptk::Conditional_Effect_Vec;
+
+Synthetic_Task*	Synthetic_Task::create( std::string family, const Params& params ) {
+	if ( family == "grid" ) return new Grid_Items_Task( params );
+	if ( family == "logistics" ) return new Logistics_Task( params );
+	if ( family == "bitflip" ) return new Bit_Flip_Task( params );
+	return NULL;
+}
+
+Synthetic_Task::Synthetic_Task( const Params& params )
+	: m_params( params ) {
+	srandom( params.seed );
+}
+
+Synthetic_Task::~Synthetic_Task() {
+}
+
+unsigned	Synthetic_Task::fluent( STRIPS_Problem& prob, const std::string& signature ) {
+	return STRIPS_Problem::add_fluent( prob, signature );
+}
+
+void	Synthetic_Task::action( STRIPS_Problem& prob, const std::string& signature,
+				Fluent_Vec pre, Fluent_Vec add, Fluent_Vec del ) {
+	Conditional_Effect_Vec ceffs;
+	STRIPS_Problem::add_action( prob, signature, pre, add, del, ceffs );
+}
+
+void	Synthetic_Task::action( STRIPS_Problem& prob, const std::string& signature,
+				Fluent_Vec pre, Fluent_Vec add, Fluent_Vec del, Conditional_Effect_Vec& ceffs ) {
+	STRIPS_Problem::add_action( prob, signature, pre, add, del, ceffs );
+}
+
+Conditional_Effect*	Synthetic_Task::ceff( STRIPS_Problem& prob, Fluent_Vec pre, Fluent_Vec add, Fluent_Vec del ) {
+	Conditional_Effect* ce = new Conditional_Effect( prob );
+	ce->define( pre, add, del );
+	return ce;
+}
+
+unsigned	Synthetic_Task::random( unsigned n ) {
+	return ::random() % n;
+}
+
+std::string	Grid_Items_Task::cell( unsigned c ) const {
+	return "cell_" + std::to_string( c / m_params.size ) + "_" + std::to_string( c % m_params.size );
+}
+
+void	Grid_Items_Task::build( STRIPS_Problem& prob ) {
+	unsigned w = std::max( m_params.size, 2u );
+	m_params.size = w;
+	unsigned n = w * w;
+	unsigned n_items = m_params.length;
+	unsigned n_bagged = std::min( m_params.ceffs, n_items );
+
+	prob.set_domain_name( "synthetic-grid" );
+	prob.set_problem_name( "grid-" + std::to_string( w ) + "-" + std::to_string( m_params.branching )
+				+ "-" + std::to_string( n_items ) + "-" + std::to_string( n_bagged ) );
+
+	// MRJ: Moves along the snake path through the rows, or along the grid,
+	// and then the random jumps
+	std::vector< std::vector< unsigned > >	adj( n );
+	unsigned base = 2;
+	if ( m_params.branching >= 4 ) {
+		base = 4;
+		for ( unsigned c = 0; c < n; c++ ) {
+			unsigned i = c / w, j = c % w;
+			if ( j > 0 ) adj[c].push_back( c - 1 );
+			if ( j + 1 < w ) adj[c].push_back( c + 1 );
+			if ( i > 0 ) adj[c].push_back( c - w );
+			if ( i + 1 < w ) adj[c].push_back( c + w );
+		}
+	}
+	else {
+		std::vector< unsigned > path( n );
+		for ( unsigned c = 0; c < n; c++ ) {
+			unsigned i = c / w, j = c % w;
+			path[c] = i * w + ( i % 2 == 0 ? j : w - 1 - j );
+		}
+		for ( unsigned k = 0; k + 1 < n; k++ ) {
+			adj[ path[k] ].push_back( path[k+1] );
+			adj[ path[k+1] ].push_back( path[k] );
+		}
+	}
+	unsigned jumps = m_params.branching > base ? m_params.branching - base : 0;
+	for ( unsigned c = 0; c < n; c++ )
+		for ( unsigned k = 0; k < jumps; k++ ) {
+			unsigned d = random( n );
+			if ( d == c || std::find( adj[c].begin(), adj[c].end(), d ) != adj[c].end() ) continue;
+			adj[c].push_back( d );
+		}
+
+	std::vector< unsigned >	agent_at( n );
+	for ( unsigned c = 0; c < n; c++ )
+		agent_at[c] = fluent( prob, "(agent-at " + cell( c ) + ")" );
+
+	std::vector< std::vector< unsigned > >	item_at( n_items );
+	std::vector< unsigned >			carried( n_items ), out( n_bagged );
+	for ( unsigned i = 0; i < n_items; i++ ) {
+		std::string item = "item_" + std::to_string( i );
+		item_at[i].resize( n );
+		for ( unsigned c = 0; c < n; c++ )
+			item_at[i][c] = fluent( prob, "(at " + item + " " + cell( c ) + ")" );
+		carried[i] = fluent( prob, ( i < n_bagged ? "(in-bag " : "(holding " ) + item + ")" );
+		if ( i < n_bagged )
+			out[i] = fluent( prob, "(out-of-bag " + item + ")" );
+	}
+
+	for ( unsigned c = 0; c < n; c++ )
+		for ( unsigned k = 0; k < adj[c].size(); k++ ) {
+			unsigned d = adj[c][k];
+			Conditional_Effect_Vec ceffs;
+			for ( unsigned i = 0; i < n_bagged; i++ )
+				ceffs.push_back( ceff( prob, { carried[i] }, { item_at[i][d] }, { item_at[i][c] } ) );
+			action( prob, "(move " + cell( c ) + " " + cell( d ) + ")",
+				{ agent_at[c] }, { agent_at[d] }, { agent_at[c] }, ceffs );
+		}
+
+	for ( unsigned i = 0; i < n_items; i++ ) {
+		std::string item = "item_" + std::to_string( i );
+		if ( i < n_bagged ) {
+			// MRJ: The item keeps its location while in the bag
+			for ( unsigned c = 0; c < n; c++ )
+				action( prob, "(put-in " + item + " " + cell( c ) + ")",
+					{ agent_at[c], item_at[i][c], out[i] }, { carried[i] }, { out[i] } );
+			action( prob, "(take-out " + item + ")", { carried[i] }, { out[i] }, { carried[i] } );
+			continue;
+		}
+		for ( unsigned c = 0; c < n; c++ ) {
+			action( prob, "(pick " + item + " " + cell( c ) + ")",
+				{ agent_at[c], item_at[i][c] }, { carried[i] }, { item_at[i][c] } );
+			action( prob, "(drop " + item + " " + cell( c ) + ")",
+				{ agent_at[c], carried[i] }, { item_at[i][c] }, { carried[i] } );
+		}
+	}
+
+	Fluent_Vec I, G;
+	I.push_back( agent_at[ random( n ) ] );
+	for ( unsigned i = 0; i < n_items; i++ ) {
+		unsigned from = random( n ), to = random( n - 1 );
+		if ( to >= from ) to++;
+		I.push_back( item_at[i][from] );
+		if ( i < n_bagged ) I.push_back( out[i] );
+		G.push_back( item_at[i][to] );
+	}
+	STRIPS_Problem::set_init( prob, I );
+	STRIPS_Problem::set_goal( prob, G );
+}
+
+void	Logistics_Task::build( STRIPS_Problem& prob ) {
+	unsigned n_cities = std::max( m_params.size, 1u );
+	unsigned n_locs = std::max( m_params.branching, 1u );
+	unsigned n_planes = ( n_cities + 9 ) / 10;
+	unsigned n_pkgs = m_params.length;
+	unsigned n_moved = std::min( m_params.ceffs, n_pkgs );
+	unsigned n = n_cities * n_locs;
+
+	prob.set_domain_name( "synthetic-logistics" );
+	prob.set_problem_name( "logistics-" + std::to_string( n_cities ) + "-" + std::to_string( n_locs )
+				+ "-" + std::to_string( n_pkgs ) + "-" + std::to_string( n_moved ) );
+
+	// MRJ: Location l of city c is c * n_locs + l, the airport is the first
+	std::vector< std::string >	loc( n );
+	for ( unsigned l = 0; l < n; l++ )
+		loc[l] = "loc_" + std::to_string( l / n_locs ) + "_" + std::to_string( l % n_locs );
+
+	// MRJ: Trucks first, truck c is vehicle c, then airplanes
+	unsigned n_vehicles = n_cities + n_planes;
+	std::vector< std::string >	vehicle( n_vehicles );
+	for ( unsigned c = 0; c < n_cities; c++ )
+		vehicle[c] = "truck_" + std::to_string( c );
+	for ( unsigned a = 0; a < n_planes; a++ )
+		vehicle[ n_cities + a ] = "plane_" + std::to_string( a );
+
+	// MRJ: Locations a vehicle can be at, and its fluents at each
+	std::vector< std::vector< unsigned > >	stops( n_vehicles );
+	std::vector< std::vector< unsigned > >	vehicle_at( n_vehicles );
+	for ( unsigned v = 0; v < n_vehicles; v++ ) {
+		if ( v < n_cities )
+			for ( unsigned l = 0; l < n_locs; l++ )
+				stops[v].push_back( v * n_locs + l );
+		else
+			for ( unsigned c = 0; c < n_cities; c++ )
+				stops[v].push_back( c * n_locs );
+		for ( unsigned k = 0; k < stops[v].size(); k++ )
+			vehicle_at[v].push_back( fluent( prob, "(at " + vehicle[v] + " " + loc[ stops[v][k] ] + ")" ) );
+	}
+
+	std::vector< std::string >		pkg( n_pkgs );
+	std::vector< std::vector< unsigned > >	pkg_at( n_pkgs );
+	std::vector< std::vector< unsigned > >	pkg_in( n_pkgs );
+	std::vector< unsigned >			pkg_out( n_pkgs );
+	for ( unsigned p = 0; p < n_pkgs; p++ ) {
+		pkg[p] = "pkg_" + std::to_string( p );
+		for ( unsigned l = 0; l < n; l++ )
+			pkg_at[p].push_back( fluent( prob, "(at " + pkg[p] + " " + loc[l] + ")" ) );
+		for ( unsigned v = 0; v < n_vehicles; v++ )
+			pkg_in[p].push_back( fluent( prob, "(in " + pkg[p] + " " + vehicle[v] + ")" ) );
+		if ( p < n_moved )
+			pkg_out[p] = fluent( prob, "(out " + pkg[p] + ")" );
+	}
+
+	for ( unsigned v = 0; v < n_vehicles; v++ ) {
+		std::string verb = v < n_cities ? "(drive " : "(fly ";
+		for ( unsigned k1 = 0; k1 < stops[v].size(); k1++ )
+			for ( unsigned k2 = 0; k2 < stops[v].size(); k2++ ) {
+				if ( k1 == k2 ) continue;
+				unsigned l1 = stops[v][k1], l2 = stops[v][k2];
+				Conditional_Effect_Vec ceffs;
+				for ( unsigned p = 0; p < n_moved; p++ )
+					ceffs.push_back( ceff( prob, { pkg_in[p][v] }, { pkg_at[p][l2] }, { pkg_at[p][l1] } ) );
+				action( prob, verb + vehicle[v] + " " + loc[l1] + " " + loc[l2] + ")",
+					{ vehicle_at[v][k1] }, { vehicle_at[v][k2] }, { vehicle_at[v][k1] }, ceffs );
+			}
+	}
+
+	for ( unsigned p = 0; p < n_pkgs; p++ )
+		for ( unsigned v = 0; v < n_vehicles; v++ )
+			for ( unsigned k = 0; k < stops[v].size(); k++ ) {
+				unsigned l = stops[v][k];
+				std::string args = pkg[p] + " " + vehicle[v] + " " + loc[l] + ")";
+				if ( p < n_moved ) {
+					// MRJ: The package keeps its location while loaded
+					action( prob, "(load " + args, { vehicle_at[v][k], pkg_at[p][l], pkg_out[p] },
+						{ pkg_in[p][v] }, { pkg_out[p] } );
+					action( prob, "(unload " + args, { vehicle_at[v][k], pkg_in[p][v] },
+						{ pkg_out[p] }, { pkg_in[p][v] } );
+					continue;
+				}
+				action( prob, "(load " + args, { vehicle_at[v][k], pkg_at[p][l] },
+					{ pkg_in[p][v] }, { pkg_at[p][l] } );
+				action( prob, "(unload " + args, { vehicle_at[v][k], pkg_in[p][v] },
+					{ pkg_at[p][l] }, { pkg_in[p][v] } );
+			}
+
+	Fluent_Vec I, G;
+	for ( unsigned v = 0; v < n_vehicles; v++ )
+		I.push_back( vehicle_at[v][ random( stops[v].size() ) ] );
+	for ( unsigned p = 0; p < n_pkgs; p++ ) {
+		unsigned from = random( n ), to = n > 1 ? random( n - 1 ) : 0;
+		if ( n > 1 && to >= from ) to++;
+		I.push_back( pkg_at[p][from] );
+		if ( p < n_moved ) I.push_back( pkg_out[p] );
+		G.push_back( pkg_at[p][to] );
+	}
+	STRIPS_Problem::set_init( prob, I );
+	STRIPS_Problem::set_goal( prob, G );
+}
+
+void	Bit_Flip_Task::build( STRIPS_Problem& prob ) {
+	unsigned n_bits = std::max( m_params.size, 1u );
+	unsigned width = std::max( m_params.branching, 1u );
+	unsigned n_groups = ( n_bits + width - 1 ) / width;
+	unsigned window = m_params.ceffs;
+
+	prob.set_domain_name( "synthetic-bitflip" );
+	prob.set_problem_name( "bitflip-" + std::to_string( n_bits ) + "-" + std::to_string( width )
+				+ "-" + std::to_string( m_params.length ) + "-" + std::to_string( window ) );
+
+	std::vector< unsigned >	on( n_bits ), off( n_bits ), unlocked( n_groups );
+	for ( unsigned i = 0; i < n_bits; i++ ) {
+		std::string bit = "bit_" + std::to_string( i );
+		on[i] = fluent( prob, "(on " + bit + ")" );
+		off[i] = fluent( prob, "(off " + bit + ")" );
+	}
+	for ( unsigned g = 0; g < n_groups; g++ )
+		unlocked[g] = fluent( prob, "(unlocked group_" + std::to_string( g ) + ")" );
+
+	for ( unsigned i = 0; i < n_bits; i++ ) {
+		std::string bit = "bit_" + std::to_string( i );
+		unsigned g = unlocked[ i / width ];
+		if ( window == 0 ) {
+			action( prob, "(set " + bit + ")", { g, off[i] }, { on[i] }, { off[i] } );
+			action( prob, "(reset " + bit + ")", { g, on[i] }, { off[i] }, { on[i] } );
+			continue;
+		}
+		// MRJ: Toggles the bits from i on, the toggles of the bits that
+		// follow make every configuration reachable
+		Conditional_Effect_Vec ceffs;
+		for ( unsigned j = i; j < std::min( i + window, n_bits ); j++ ) {
+			ceffs.push_back( ceff( prob, { on[j] }, { off[j] }, { on[j] } ) );
+			ceffs.push_back( ceff( prob, { off[j] }, { on[j] }, { off[j] } ) );
+		}
+		action( prob, "(flip " + bit + ")", { g }, {}, {}, ceffs );
+	}
+	for ( unsigned g = 0; g + 1 < n_groups; g++ )
+		action( prob, "(unlock group_" + std::to_string( g + 1 ) + ")",
+			{ unlocked[g] }, { unlocked[g+1] }, { unlocked[g] } );
+
+	// MRJ: The goal results from flipping length distinct bits
+	std::vector< bool >	value( n_bits ), target;
+	for ( unsigned i = 0; i < n_bits; i++ )
+		value[i] = random( 2 ) == 1;
+	target = value;
+	std::vector< unsigned >	flips( n_bits );
+	for ( unsigned i = 0; i < n_bits; i++ ) flips[i] = i;
+	unsigned n_flips = std::min( m_params.length, n_bits );
+	for ( unsigned k = 0; k < n_flips; k++ ) {
+		std::swap( flips[k], flips[ k + random( n_bits - k ) ] );
+		unsigned i = flips[k];
+		unsigned last = window == 0 ? i + 1 : std::min( i + window, n_bits );
+		for ( unsigned j = i; j < last; j++ )
+			target[j] = !target[j];
+	}
+
+	Fluent_Vec I, G;
+	I.push_back( unlocked[0] );
+	for ( unsigned i = 0; i < n_bits; i++ ) {
+		I.push_back( value[i] ? on[i] : off[i] );
+		G.push_back( target[i] ? on[i] : off[i] );
+	}
+	STRIPS_Problem::set_init( prob, I );
+	STRIPS_Problem::set_goal( prob, G );
+}
+
+// Tokens between the parentheses of a signature, or the whole signature
+// as a single token when it has none
+static std::vector< std::string >	pddl_tokens( const std::string& signature ) {
+	std::vector< std::string > tokens;
+	if ( signature.size() < 2 || signature[0] != '(' || signature[ signature.size() - 1 ] != ')' ) {
+		std::string name = signature;
+		std::replace( name.begin(), name.end(), ' ', '_' );
+		tokens.push_back( name );
+		return tokens;
+	}
+	std::istringstream in( signature.substr( 1, signature.size() - 2 ) );
+	std::string t;
+	while ( in >> t ) tokens.push_back( t );
+	if ( tokens.empty() ) tokens.push_back( "nil" );
+	return tokens;
+}
+
+static void	write_atoms( std::ostream& os, const std::vector< std::string >& atoms, const Fluent_Vec& v, bool negated ) {
+	for ( unsigned k = 0; k < v.size(); k++ ) {
+		if ( negated ) os << " (not " << atoms[ v[k] ] << ")";
+		else os << " " << atoms[ v[k] ];
+	}
+}
+
+void	write_pddl( const STRIPS_Problem& prob, std::string domain_file, std::string problem_file ) {
+	std::vector< std::string >		atoms( prob.num_fluents() );
+	std::map< std::string, unsigned >	arity;
+	std::set< std::string >			constants;
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ ) {
+		std::vector< std::string > tokens = pddl_tokens( prob.fluents()[f]->signature() );
+		std::map< std::string, unsigned >::iterator it = arity.find( tokens[0] );
+		if ( it == arity.end() )
+			arity[ tokens[0] ] = tokens.size() - 1;
+		else if ( it->second != tokens.size() - 1 )
+			throw std::runtime_error( "Predicate " + tokens[0] + " is used with different arities" );
+		std::string atom = "(" + tokens[0];
+		for ( unsigned k = 1; k < tokens.size(); k++ ) {
+			constants.insert( tokens[k] );
+			atom += " " + tokens[k];
+		}
+		atoms[f] = atom + ")";
+	}
+
+	bool has_ceffs = false, has_costs = false;
+	for ( unsigned a = 0; a < prob.num_actions(); a++ ) {
+		if ( !prob.actions()[a]->ceff_vec().empty() ) has_ceffs = true;
+		if ( prob.actions()[a]->cost() != 1.0f ) has_costs = true;
+	}
+
+	std::ofstream domain( domain_file.c_str() );
+	if ( !domain )
+		throw std::runtime_error( "Could not open " + domain_file );
+
+	domain << "(define (domain " << prob.domain_name() << ")" << std::endl;
+	domain << "\t(:requirements :strips" << ( has_ceffs ? " :conditional-effects" : "" )
+		<< ( has_costs ? " :action-costs" : "" ) << ")" << std::endl;
+	if ( !constants.empty() ) {
+		domain << "\t(:constants";
+		for ( std::set< std::string >::iterator it = constants.begin(); it != constants.end(); it++ )
+			domain << " " << *it;
+		domain << ")" << std::endl;
+	}
+	domain << "\t(:predicates";
+	for ( std::map< std::string, unsigned >::iterator it = arity.begin(); it != arity.end(); it++ ) {
+		domain << " (" << it->first;
+		for ( unsigned k = 0; k < it->second; k++ )
+			domain << " ?x" << k;
+		domain << ")";
+	}
+	domain << ")" << std::endl;
+	if ( has_costs )
+		domain << "\t(:functions (total-cost))" << std::endl;
+
+	for ( unsigned a = 0; a < prob.num_actions(); a++ ) {
+		const aptk::Action& act = *prob.actions()[a];
+		std::vector< std::string > tokens = pddl_tokens( act.signature() );
+		std::string name = tokens[0];
+		for ( unsigned k = 1; k < tokens.size(); k++ )
+			name += "_" + tokens[k];
+		domain << "\t(:action " << name << std::endl;
+		domain << "\t\t:parameters ()" << std::endl;
+		domain << "\t\t:precondition (and";
+		write_atoms( domain, atoms, act.prec_vec(), false );
+		domain << ")" << std::endl;
+		domain << "\t\t:effect (and";
+		write_atoms( domain, atoms, act.add_vec(), false );
+		write_atoms( domain, atoms, act.del_vec(), true );
+		for ( unsigned i = 0; i < act.ceff_vec().size(); i++ ) {
+			const Conditional_Effect& ce = *act.ceff_vec()[i];
+			if ( !ce.prec_vec().empty() ) {
+				domain << " (when (and";
+				write_atoms( domain, atoms, ce.prec_vec(), false );
+				domain << ") (and";
+			}
+			write_atoms( domain, atoms, ce.add_vec(), false );
+			write_atoms( domain, atoms, ce.del_vec(), true );
+			if ( !ce.prec_vec().empty() )
+				domain << "))";
+		}
+		if ( has_costs )
+			domain << " (increase (total-cost) " << act.cost() << ")";
+		domain << "))" << std::endl;
+	}
+	domain << ")" << std::endl;
+
+	std::ofstream problem( problem_file.c_str() );
+	if ( !problem )
+		throw std::runtime_error( "Could not open " + problem_file );
+
+	problem << "(define (problem " << prob.problem_name() << ")" << std::endl;
+	problem << "\t(:domain " << prob.domain_name() << ")" << std::endl;
+	problem << "\t(:init";
+	write_atoms( problem, atoms, prob.init(), false );
+	if ( has_costs )
+		problem << " (= (total-cost) 0)";
+	problem << ")" << std::endl;
+	problem << "\t(:goal (and";
+	write_atoms( problem, atoms, prob.goal(), false );
+	problem << "))" << std::endl;
+	if ( has_costs )
+		problem << "\t(:metric minimize (total-cost))" << std::endl;
+	problem << ")" << std::endl;
+}
@@ -0,0 +1,139 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SYNTHETIC_HXX__
+#define __SYNTHETIC_HXX__
+
+#include <strips_prob.hxx>
+#include <string>
+
+// Parameterized families of STRIPS tasks, built straight into a
+// STRIPS_Problem with add_fluent() and add_action(), to stress engines and
+// data structures with tasks far larger than the IPC ones. Every family
+// reads the parameters in its own way:
+//
+// grid       Agent moving over a size x size grid and relocating items.
+//            branching - moves from each cell, 2 or 3 follow a snake
+//                        path through the grid, 4 or more the grid itself,
+//                        the ones beyond 2 or 4 jump to random cells
+//            length    - items to relocate
+//            ceffs     - items carried in a bag, which move along with the
+//                        agent through a conditional effect of each move
+//
+// logistics  Packages carried by trucks within cities and airplanes
+//            between their airports, one truck per city and one airplane
+//            every 10 cities.
+//            size      - cities
+//            branching - locations of each city, the first is the airport
+//            length    - packages to deliver
+//            ceffs     - packages that move with the vehicle carrying them
+//                        through conditional effects of drive and fly
+//
+// bitflip    Bits to be set to a goal configuration. Bits are split in
+//            groups of branching bits, only those of the unlocked group
+//            can be flipped and groups are unlocked in order.
+//            size      - bits
+//            branching - bits in each group
+//            length    - flips that lead from the initial to the goal
+//                        configuration
+//            ceffs     - bits toggled by each flip, starting with its own,
+//                        two conditional effects each, 0 for plain
+//                        set and reset actions
+//
+// All the tasks are solvable, with unit costs. There are about
+// size^2 * ( branching + 2 * length ) actions for grid, and
+// 2 * length * size * ( branching + size / 10 ) for logistics, so both get
+// past 10^6 actions with sizes in the hundreds, as bitflip does with
+// 10^6 bits.
+class Synthetic_Task {
+public:
+
+	struct Params {
+		Params()
+		: size( 10 ), branching( 4 ), length( 4 ), ceffs( 0 ), seed( 2381 ) {
+		}
+
+		unsigned	size;
+		unsigned	branching;
+		unsigned	length;
+		unsigned	ceffs;
+		int		seed;
+	};
+
+	// NULL if there is no family with that name
+	static Synthetic_Task*	create( std::string family, const Params& params );
+
+	Synthetic_Task( const Params& params );
+	virtual ~Synthetic_Task();
+
+	// Sets the fluents, actions, initial state and goal of prob, but
+	// does not make its action tables
+	virtual void	build( aptk::STRIPS_Problem& prob ) = 0;
+
+protected:
+
+	unsigned	fluent( aptk::STRIPS_Problem& prob, const std::string& signature );
+	void		action( aptk::STRIPS_Problem& prob, const std::string& signature,
+				aptk::Fluent_Vec pre, aptk::Fluent_Vec add, aptk::Fluent_Vec del );
+	void		action( aptk::STRIPS_Problem& prob, const std::string& signature,
+				aptk::Fluent_Vec pre, aptk::Fluent_Vec add, aptk::Fluent_Vec del,
+				aptk::Conditional_Effect_Vec& ceffs );
+	aptk::Conditional_Effect*
+			ceff( aptk::STRIPS_Problem& prob, aptk::Fluent_Vec pre, aptk::Fluent_Vec add, aptk::Fluent_Vec del );
+	unsigned	random( unsigned n );
+
+protected:
+
+	Params		m_params;
+};
+
+class Grid_Items_Task : public Synthetic_Task {
+public:
+	Grid_Items_Task( const Params& params ) : Synthetic_Task( params ) {}
+
+	virtual void	build( aptk::STRIPS_Problem& prob );
+
+protected:
+
+	std::string	cell( unsigned c ) const;
+};
+
+class Logistics_Task : public Synthetic_Task {
+public:
+	Logistics_Task( const Params& params ) : Synthetic_Task( params ) {}
+
+	virtual void	build( aptk::STRIPS_Problem& prob );
+};
+
+class Bit_Flip_Task : public Synthetic_Task {
+public:
+	Bit_Flip_Task( const Params& params ) : Synthetic_Task( params ) {}
+
+	virtual void	build( aptk::STRIPS_Problem& prob );
+};
+
+// Writes prob as a PDDL domain with one action without parameters for each
+// action of prob, and the matching problem. Fluent signatures (p a b) are
+// written as the atom (p a b), with a and b declared as constants, so that
+// parsing the files back gives the same fluents. Throws std::runtime_error
+// when a predicate is used with different arities.
+void	write_pddl( const aptk::STRIPS_Problem& prob, std::string domain_file, std::string problem_file );
+
+#endif // synthetic.hxx
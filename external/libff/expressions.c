@@ -475,13 +475,13 @@ void print_lnf_representation( void )
 /* local globals.
  */
 
-Comparator lcomp;
+#define lcomp (ff_ctx->expressions.lcomp)
 
-int lF[MAX_LNF_F];
-float lC[MAX_LNF_F];
-int lnum_F;
+#define lF (ff_ctx->expressions.lF)
+#define lC (ff_ctx->expressions.lC)
+#define lnum_F (ff_ctx->expressions.lnum_F)
 
-float lc;
+#define lc (ff_ctx->expressions.lc)
 
 
 
@@ -684,9 +684,9 @@ void normalize_expressions( void )
     for ( i = 0; i < a->num_effects; i++ ) {
       e = &(a->effects[i]);
 
-      e->lnf_conditions_comp = ( Comparator * ) calloc( MAX_LNF_COMPS, sizeof( Comparator ) );
-      e->lnf_conditions_lh = ( LnfExpNode_pointer * ) calloc( MAX_LNF_COMPS, sizeof( LnfExpNode_pointer ) );
-      e->lnf_conditions_rh = ( float * ) calloc( MAX_LNF_COMPS, sizeof( float ) );
+      e->lnf_conditions_comp = ( Comparator * ) ff_calloc( MAX_LNF_COMPS, sizeof( Comparator ) );
+      e->lnf_conditions_lh = ( LnfExpNode_pointer * ) ff_calloc( MAX_LNF_COMPS, sizeof( LnfExpNode_pointer ) );
+      e->lnf_conditions_rh = ( float * ) ff_calloc( MAX_LNF_COMPS, sizeof( float ) );
       e->num_lnf_conditions = 0;
       for ( j = 0; j < e->num_numeric_conditions; j++ ) {
 	if ( e->num_lnf_conditions == MAX_LNF_COMPS ) {
@@ -754,9 +754,9 @@ void normalize_expressions( void )
 	continue;
       }
       
-      e->lnf_effects_neft = ( NumericEffectType * ) calloc( MAX_LNF_EFFS, sizeof( NumericEffectType ) );
-      e->lnf_effects_fl = ( int * ) calloc( MAX_LNF_EFFS, sizeof( int ) );
-      e->lnf_effects_rh = ( LnfExpNode_pointer * ) calloc( MAX_LNF_EFFS, sizeof( LnfExpNode_pointer ) );
+      e->lnf_effects_neft = ( NumericEffectType * ) ff_calloc( MAX_LNF_EFFS, sizeof( NumericEffectType ) );
+      e->lnf_effects_fl = ( int * ) ff_calloc( MAX_LNF_EFFS, sizeof( int ) );
+      e->lnf_effects_rh = ( LnfExpNode_pointer * ) ff_calloc( MAX_LNF_EFFS, sizeof( LnfExpNode_pointer ) );
       e->num_lnf_effects = 0;
       for ( j = 0; j < e->num_numeric_effects; j++ ) {
 	if ( e->num_lnf_effects == MAX_LNF_EFFS ) {
@@ -793,9 +793,9 @@ void normalize_expressions( void )
 
   /* goal condition also...
    */
-  glnf_goal_comp = ( Comparator * ) calloc( MAX_LNF_COMPS, sizeof( Comparator ) );
-  glnf_goal_lh = ( LnfExpNode_pointer * ) calloc( MAX_LNF_COMPS, sizeof( LnfExpNode_pointer ) );
-  glnf_goal_rh = ( float * ) calloc( MAX_LNF_COMPS, sizeof( float ) );
+  glnf_goal_comp = ( Comparator * ) ff_calloc( MAX_LNF_COMPS, sizeof( Comparator ) );
+  glnf_goal_lh = ( LnfExpNode_pointer * ) ff_calloc( MAX_LNF_COMPS, sizeof( LnfExpNode_pointer ) );
+  glnf_goal_rh = ( float * ) ff_calloc( MAX_LNF_COMPS, sizeof( float ) );
   gnum_lnf_goal = 0;
   for ( i = 0; i < gnum_numeric_goal; i++ ) {
     if ( gnum_lnf_goal == MAX_LNF_COMPS ) {
@@ -1058,7 +1058,7 @@ void put_comp_into_normalized_locals( Comparator comp,
      * side.
      */
     lc *= (-1);
-    free( tmp );
+    ff_free( tmp );
     return;
   }
   if ( lcomp == LEQ ) {
@@ -1067,7 +1067,7 @@ void put_comp_into_normalized_locals( Comparator comp,
     collect_normalized_locals( tmp, TRUE );
     lcomp = GEQ;
     lc *= (-1);
-    free( tmp );
+    ff_free( tmp );
     return;
   }
 
@@ -1077,7 +1077,7 @@ void put_comp_into_normalized_locals( Comparator comp,
   tmp->rightson = rh;
   collect_normalized_locals( tmp, TRUE );
   lc *= (-1);
-  free( tmp );
+  ff_free( tmp );
 
 }
 
@@ -1180,7 +1180,7 @@ void collect_normalized_locals( ExpNode *n, Bool positive )
 /* local globals.
  */
 
-int lminus_fluent[MAX_RELEVANT_FLUENTS];
+#define lminus_fluent (ff_ctx->expressions.lminus_fluent)
 
 
 
@@ -1318,7 +1318,7 @@ void introduce_minus_fluent( int fl )
   }
   grelevant_fluents[gnum_relevant_fluents].function = -1;
   grelevant_fluents_name[gnum_relevant_fluents] = 
-    ( char * ) calloc( MAX_LENGTH, sizeof( char ) );
+    ( char * ) ff_calloc( MAX_LENGTH, sizeof( char ) );
   strcpy( grelevant_fluents_name[gnum_relevant_fluents], "MINUS-" );
   strcat( grelevant_fluents_name[gnum_relevant_fluents],
 	  grelevant_fluents_name[fl] );
@@ -1594,8 +1594,10 @@ void introduce_minus_fl_effects( int fl )
 
 
 
-int *lA, *lD;
-int lnum_A, lnum_D;
+#define lA (ff_ctx->expressions.lA)
+#define lD (ff_ctx->expressions.lD)
+#define lnum_A (ff_ctx->expressions.lnum_A)
+#define lnum_D (ff_ctx->expressions.lnum_D)
 
 
 
@@ -1670,7 +1672,7 @@ void summarize_effects( void )
 	  }
 	  /* we also get here if we have two identical assigns.
 	   */
-	  free( e->lnf_effects_rh[k] );
+	  ff_free( e->lnf_effects_rh[k] );
 	  for ( l = k; l < e->num_lnf_effects - 1; l++ ) {
 	    e->lnf_effects_neft[l] = e->lnf_effects_neft[l+1];
 	    e->lnf_effects_fl[l] = e->lnf_effects_fl[l+1];
@@ -1737,7 +1739,7 @@ void summarize_effects( void )
        * e's capabilities.
        */
       if ( lnum_A > e->num_adds ) {
-	free( e->adds );
+	ff_free( e->adds );
 	e->adds = SAFE_CALLOC( int*, int, lnum_A );
       }
       for ( j = 0; j < lnum_A; j++ ) {
@@ -1745,7 +1747,7 @@ void summarize_effects( void )
       }
       e->num_adds = lnum_A;
       if ( lnum_D > e->num_dels ) {
-	free( e->dels );
+	ff_free( e->dels );
 	e->dels = SAFE_CALLOC( int*, int, lnum_D );
       }
       for ( j = 0; j < lnum_D; j++ ) {
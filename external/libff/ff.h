@@ -339,7 +339,7 @@ typedef unsigned char Bool;
  * in the code
  */
 
-#define SAFE_CALLOC( cast_type, type, nelems ) (nelems == 0 ? NULL : (cast_type)calloc( nelems, sizeof(type) ) )
+#define SAFE_CALLOC( cast_type, type, nelems ) (nelems == 0 ? NULL : (cast_type)ff_calloc( nelems, sizeof(type) ) )
 
 
 /*
@@ -1547,454 +1547,662 @@ Bool process_command_line( int argc, char *argv[] );
 
 
 
-/*******************
- * GENERAL HELPERS *
- *******************/
-
-
-
-
-
-
-
-
-
-/* used to time the different stages of the planner
- */
-extern float gtempl_time, greach_time, grelev_time, gconn_time;
-extern float gLNF_time, gsearch_time;
-
-/* the command line inputs
- */
-extern struct _command_line gcmd_line;
-
-/* number of states that got heuristically evaluated
- */
-extern int gevaluated_states;
-
-/* maximal depth of breadth first search
- */
-extern int gmax_search_depth;
-
-
-
-
-
-
-
-
-
-/***********
- * PARSING *
- ***********/
-
-
-
-
-
-
-
-
-
-
-
-/* used for pddl parsing, flex only allows global variables
- */
-extern int gbracket_count;
-extern char *gproblem_name;
-
-/* The current input line number
- */
-extern int lineno;
-
-/* The current input filename
- */
-extern char *gact_filename;
-
-/* The pddl domain name
- */
-extern char *gdomain_name;
-
-/* loaded, uninstantiated operators
- */
-extern PlOperator *gloaded_ops;
-
-/* stores initials as fact_list 
- */
-extern PlNode *gorig_initial_facts;
-
-/* not yet preprocessed goal facts
- */
-extern PlNode *gorig_goal_facts;
-
-/* the types, as defined in the domain file
- */
-extern TypedList *gparse_types;
-
-/* the constants, as defined in domain file
- */
-extern TypedList *gparse_constants;
-
-/* the predicates and their arg types, as defined in the domain file
- */
-extern TypedListList *gparse_predicates;
-
-/* the functions and their arg types, as defined in the domain file
- */
-extern TypedListList *gparse_functions;
-
-/* the objects, declared in the problem file
- */
-extern TypedList *gparse_objects;
-
-/* the metric
- */
-extern Token gparse_optimization;
-extern ParseExpNode *gparse_metric;
-
-
-/* connection to instantiation ( except ops, goal, initial )
- */
-
-/* all typed objects 
- */
-extern FactList *gorig_constant_list;
-
-/* the predicates and their types
- */
-extern FactList *gpredicates_and_types;
-
-/* the functions and their types
- */
-extern FactList *gfunctions_and_types;
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-/*****************
- * INSTANTIATING *
- *****************/
-
-
-
-
-
-
-
-
-
-
-/* global arrays of constant names,
- *               type names (with their constants),
- *               predicate names,
- *               predicate aritys,
- *               defined types of predicate args
- */
-extern Token gconstants[MAX_CONSTANTS];
-extern int gnum_constants;
-extern Token gtype_names[MAX_TYPES];
-extern int gtype_consts[MAX_TYPES][MAX_TYPE];
-extern Bool gis_member[MAX_CONSTANTS][MAX_TYPES];
-extern int gtype_size[MAX_TYPES];
-extern int gnum_types;
-extern Token gpredicates[MAX_PREDICATES];
-extern int garity[MAX_PREDICATES];
-extern int gpredicates_args_type[MAX_PREDICATES][MAX_ARITY];
-extern int gnum_predicates;
-extern Token gfunctions[MAX_FUNCTIONS];
-extern int gf_arity[MAX_FUNCTIONS];
-extern int gfunctions_args_type[MAX_FUNCTIONS][MAX_ARITY];
-extern int gnum_functions;
-
-
-
-
-/* the domain in first step integer representation
+/* FF keeps everything it knows about a task in the variables below.
+ * They are the fields of an FF_Context rather than true globals, so
+ * that several tasks can be parsed and instantiated at the same time,
+ * each one in its own context, and be released at once when done.
  */
-extern PDDLOperator_pointer goperators[MAX_OPERATORS];
-extern int gnum_operators;
-extern Fact *gfull_initial;
-extern int gnum_full_initial;
-extern FluentValue *gfull_fluents_initial;
-extern int gnum_full_fluents_initial;
-extern WffNode *ggoal;
+typedef struct _FF_Context {
 
-extern ExpNode *gmetric;
+  /*******************
+   * GENERAL HELPERS *
+   *******************/
 
 
+  /* used to time the different stages of the planner
+   */
+  float gtempl_time, greach_time, grelev_time, gconn_time;
+  float gLNF_time, gsearch_time;
 
-/* stores inertia - information: is any occurence of the predicate
- * added / deleted in the uninstantiated ops ?
- */
-extern Bool gis_added[MAX_PREDICATES];
-extern Bool gis_deleted[MAX_PREDICATES];
-
-/* for functions we *might* want to say, symmetrically, whether it is
- * increased resp. decreased at all.
- *
- * that is, however, somewhat involved because the right hand
- * sides can be arbirtray expressions, so we have no guarantee
- * that increasing really does adds to a functions value...
- *
- * thus (for the time being), we settle for "is the function changed at all?"
- */
-extern Bool gis_changed[MAX_FUNCTIONS];
-
-
-
-/* splitted initial state:
- * initial non static facts,
- * initial static facts, divided into predicates
- * (will be two dimensional array, allocated directly before need)
- */
-extern Facts *ginitial;
-extern int gnum_initial;
-extern Fact **ginitial_predicate;
-extern int *gnum_initial_predicate;
-
-/* same thing for functions
- */
-extern FluentValues *gf_initial;
-extern int gnum_f_initial;
-extern FluentValue **ginitial_function;
-extern int *gnum_initial_function;
-
-
-
-/* the type numbers corresponding to any unary inertia
- */
-extern int gtype_to_predicate[MAX_PREDICATES];
-extern int gpredicate_to_type[MAX_TYPES];
-
-/* (ordered) numbers of types that new type is intersection of
- */
-extern TypeArray gintersected_types[MAX_TYPES];
-extern int gnum_intersected_types[MAX_TYPES];
-
-
+  /* the command line inputs
+   */
+  struct _command_line gcmd_line;
 
-/* splitted domain: hard n easy ops
- */
-extern PDDLOperator_pointer *ghard_operators;
-extern int gnum_hard_operators;
-extern NormOperator_pointer *geasy_operators;
-extern int gnum_easy_operators;
+  /* number of states that got heuristically evaluated
+   */
+  int gevaluated_states;
 
+  /* maximal depth of breadth first search
+   */
+  int gmax_search_depth;
 
 
-/* so called Templates for easy ops: possible inertia constrained
- * instantiation constants
- */
-extern EasyTemplate *geasy_templates;
-extern int gnum_easy_templates;
+  /***********
+   * PARSING *
+   ***********/
 
 
+  /* used for pddl parsing, flex only allows global variables
+   */
+  int gbracket_count;
+  char *gproblem_name;
 
-/* first step for hard ops: create mixed operators, with conjunctive
- * precondition and arbitrary effects
- */
-extern MixedOperator *ghard_mixed_operators;
-extern int gnum_hard_mixed_operators;
+  /* The current input line number
+   */
+  int lineno;
 
+  /* The current input filename
+   */
+  char *gact_filename;
 
+  /* The pddl domain name
+   */
+  char *gdomain_name;
 
-/* hard ''templates'' : pseudo actions
- */
-extern PseudoAction_pointer *ghard_templates;
-extern int gnum_hard_templates;
+  /* loaded, uninstantiated operators
+   */
+  PlOperator *gloaded_ops;
 
+  /* stores initials as fact_list 
+   */
+  PlNode *gorig_initial_facts;
 
+  /* not yet preprocessed goal facts
+   */
+  PlNode *gorig_goal_facts;
 
-/* store the final "relevant facts"
- */
-extern Fact grelevant_facts[MAX_RELEVANT_FACTS];
-extern int gnum_relevant_facts;
-extern int gnum_pp_facts;
-/* store the "relevant fluents"
- */
-extern Fluent grelevant_fluents[MAX_RELEVANT_FLUENTS];
-extern int gnum_relevant_fluents;
-extern Token grelevant_fluents_name[MAX_RELEVANT_FLUENTS];
-/* this is NULL for normal, and the LNF for
- * artificial fluents.
- */
-extern LnfExpNode_pointer grelevant_fluents_lnf[MAX_RELEVANT_FLUENTS];
+  /* the types, as defined in the domain file
+   */
+  TypedList *gparse_types;
 
+  /* the constants, as defined in domain file
+   */
+  TypedList *gparse_constants;
 
+  /* the predicates and their arg types, as defined in the domain file
+   */
+  TypedListList *gparse_predicates;
 
-/* the final actions and problem representation
- */
-extern Action *gactions;
-extern int gnum_actions;
-extern State ginitial_state;
-extern int *glogic_goal;
-extern int gnum_logic_goal;
-extern Comparator *gnumeric_goal_comp;
-extern ExpNode_pointer *gnumeric_goal_lh, *gnumeric_goal_rh;
-extern int gnum_numeric_goal;
+  /* the functions and their arg types, as defined in the domain file
+   */
+  TypedListList *gparse_functions;
 
+  /* the objects, declared in the problem file
+   */
+  TypedList *gparse_objects;
 
+  /* the metric
+   */
+  Token gparse_optimization;
+  ParseExpNode *gparse_metric;
 
-/* to avoid memory leaks; too complicated to identify
- * the exact state of the action to throw away (during construction),
- * memory gain not worth the implementation effort.
- */
-extern Action *gtrash_actions;
 
+  /* connection to instantiation ( except ops, goal, initial )
+   */
 
+  /* all typed objects 
+   */
+  FactList *gorig_constant_list;
 
-/* additional lnf step between finalized inst and
- * conn graph
- */
-extern Comparator *glnf_goal_comp;
-extern LnfExpNode_pointer *glnf_goal_lh;
-extern float *glnf_goal_rh;
-extern int gnum_lnf_goal;
+  /* the predicates and their types
+   */
+  FactList *gpredicates_and_types;
 
-extern LnfExpNode glnf_metric;
-extern Bool goptimization_established;
+  /* the functions and their types
+   */
+  FactList *gfunctions_and_types;
 
 
+  /*****************
+   * INSTANTIATING *
+   *****************/
 
-/**********************
- * CONNECTIVITY GRAPH *
- **********************/
 
+  /* global arrays of constant names,
+   *               type names (with their constants),
+   *               predicate names,
+   *               predicate aritys,
+   *               defined types of predicate args
+   */
+  Token gconstants[MAX_CONSTANTS];
+  int gnum_constants;
+  Token gtype_names[MAX_TYPES];
+  int gtype_consts[MAX_TYPES][MAX_TYPE];
+  Bool gis_member[MAX_CONSTANTS][MAX_TYPES];
+  int gtype_size[MAX_TYPES];
+  int gnum_types;
+  Token gpredicates[MAX_PREDICATES];
+  int garity[MAX_PREDICATES];
+  int gpredicates_args_type[MAX_PREDICATES][MAX_ARITY];
+  int gnum_predicates;
+  Token gfunctions[MAX_FUNCTIONS];
+  int gf_arity[MAX_FUNCTIONS];
+  int gfunctions_args_type[MAX_FUNCTIONS][MAX_ARITY];
+  int gnum_functions;
 
 
+  /* the domain in first step integer representation
+   */
+  PDDLOperator_pointer goperators[MAX_OPERATORS];
+  int gnum_operators;
+  Fact *gfull_initial;
+  int gnum_full_initial;
+  FluentValue *gfull_fluents_initial;
+  int gnum_full_fluents_initial;
+  WffNode *ggoal;
 
+  ExpNode *gmetric;
 
-/* one ops (actions) array ...
- */
-extern OpConn *gop_conn;
-extern int gnum_op_conn;
 
+  /* stores inertia - information: is any occurence of the predicate
+   * added / deleted in the uninstantiated ops ?
+   */
+  Bool gis_added[MAX_PREDICATES];
+  Bool gis_deleted[MAX_PREDICATES];
 
+  /* for functions we *might* want to say, symmetrically, whether it is
+   * increased resp. decreased at all.
+   *
+   * that is, however, somewhat involved because the right hand
+   * sides can be arbirtray expressions, so we have no guarantee
+   * that increasing really does adds to a functions value...
+   *
+   * thus (for the time being), we settle for "is the function changed at all?"
+   */
+  Bool gis_changed[MAX_FUNCTIONS];
 
-/* one effects array ...
- */
-extern EfConn *gef_conn;
-extern int gnum_ef_conn;
 
+  /* splitted initial state:
+   * initial non static facts,
+   * initial static facts, divided into predicates
+   * (will be two dimensional array, allocated directly before need)
+   */
+  Facts *ginitial;
+  int gnum_initial;
+  Fact **ginitial_predicate;
+  int *gnum_initial_predicate;
 
+  /* same thing for functions
+   */
+  FluentValues *gf_initial;
+  int gnum_f_initial;
+  FluentValue **ginitial_function;
+  int *gnum_initial_function;
 
-/* one facts array.
- */
-extern FtConn *gft_conn;
-extern int gnum_ft_conn;
 
+  /* the type numbers corresponding to any unary inertia
+   */
+  int gtype_to_predicate[MAX_PREDICATES];
+  int gpredicate_to_type[MAX_TYPES];
 
+  /* (ordered) numbers of types that new type is intersection of
+   */
+  TypeArray gintersected_types[MAX_TYPES];
+  int gnum_intersected_types[MAX_TYPES];
 
-/* and: one fluents array.
- */
-extern FlConn *gfl_conn;
-extern int gnum_fl_conn;
-extern int gnum_real_fl_conn;/* number of non-artificial ones */
 
+  /* splitted domain: hard n easy ops
+   */
+  PDDLOperator_pointer *ghard_operators;
+  int gnum_hard_operators;
+  NormOperator_pointer *geasy_operators;
+  int gnum_easy_operators;
 
 
-/* final goal is also transformed one more step.
- */
-extern int *gflogic_goal;
-extern int gnum_flogic_goal;
-extern Comparator *gfnumeric_goal_comp;
-extern int *gfnumeric_goal_fl;
-extern float *gfnumeric_goal_c;
-extern int gnum_fnumeric_goal;
-
-/* direct access (by relevant fluents)
- */
-extern Comparator *gfnumeric_goal_direct_comp;
-extern float *gfnumeric_goal_direct_c;
+  /* so called Templates for easy ops: possible inertia constrained
+   * instantiation constants
+   */
+  EasyTemplate *geasy_templates;
+  int gnum_easy_templates;
 
 
+  /* first step for hard ops: create mixed operators, with conjunctive
+   * precondition and arbitrary effects
+   */
+  MixedOperator *ghard_mixed_operators;
+  int gnum_hard_mixed_operators;
 
 
+  /* hard ''templates'' : pseudo actions
+   */
+  PseudoAction_pointer *ghard_templates;
+  int gnum_hard_templates;
 
 
+  /* store the final "relevant facts"
+   */
+  Fact grelevant_facts[MAX_RELEVANT_FACTS];
+  int gnum_relevant_facts;
+  int gnum_pp_facts;
+  /* store the "relevant fluents"
+   */
+  Fluent grelevant_fluents[MAX_RELEVANT_FLUENTS];
+  int gnum_relevant_fluents;
+  Token grelevant_fluents_name[MAX_RELEVANT_FLUENTS];
+  /* this is NULL for normal, and the LNF for
+   * artificial fluents.
+   */
+  LnfExpNode_pointer grelevant_fluents_lnf[MAX_RELEVANT_FLUENTS];
 
 
+  /* the final actions and problem representation
+   */
+  Action *gactions;
+  int gnum_actions;
+  State ginitial_state;
+  int *glogic_goal;
+  int gnum_logic_goal;
+  Comparator *gnumeric_goal_comp;
+  ExpNode_pointer *gnumeric_goal_lh, *gnumeric_goal_rh;
+  int gnum_numeric_goal;
 
-/*******************
- * SEARCHING NEEDS *
- *******************/
 
+  /* to avoid memory leaks; too complicated to identify
+   * the exact state of the action to throw away (during construction),
+   * memory gain not worth the implementation effort.
+   */
+  Action *gtrash_actions;
 
 
+  /* additional lnf step between finalized inst and
+   * conn graph
+   */
+  Comparator *glnf_goal_comp;
+  LnfExpNode_pointer *glnf_goal_lh;
+  float *glnf_goal_rh;
+  int gnum_lnf_goal;
 
+  LnfExpNode glnf_metric;
+  Bool goptimization_established;
 
 
+  /**********************
+   * CONNECTIVITY GRAPH *
+   **********************/
 
 
+  /* one ops (actions) array ...
+   */
+  OpConn *gop_conn;
+  int gnum_op_conn;
 
 
+  /* one effects array ...
+   */
+  EfConn *gef_conn;
+  int gnum_ef_conn;
 
 
-/* applicable actions
- */
-extern int *gA;
-extern int gnum_A;
+  /* one facts array.
+   */
+  FtConn *gft_conn;
+  int gnum_ft_conn;
 
 
+  /* and: one fluents array.
+   */
+  FlConn *gfl_conn;
+  int gnum_fl_conn;
+  int gnum_real_fl_conn;/* number of non-artificial ones */
 
-/* communication from extract 1.P. to search engine:
- * 1P action choice
- */
-extern int *gH;
-extern int gnum_H;
-/* cost of relaxed plan
- */
-extern float gcost;
 
+  /* final goal is also transformed one more step.
+   */
+  int *gflogic_goal;
+  int gnum_flogic_goal;
+  Comparator *gfnumeric_goal_comp;
+  int *gfnumeric_goal_fl;
+  float *gfnumeric_goal_c;
+  int gnum_fnumeric_goal;
 
+  /* direct access (by relevant fluents)
+   */
+  Comparator *gfnumeric_goal_direct_comp;
+  float *gfnumeric_goal_direct_c;
 
-/* to store plan
- */
-extern int gplan_ops[MAX_PLAN_LENGTH];
-extern int gnum_plan_ops;
 
+  /*******************
+   * SEARCHING NEEDS *
+   *******************/
 
 
-/* stores the states that the current plan goes through
- */
-extern State gplan_states[MAX_PLAN_LENGTH + 1];
+  /* applicable actions
+   */
+  int *gA;
+  int gnum_A;
 
 
+  /* communication from extract 1.P. to search engine:
+   * 1P action choice
+   */
+  int *gH;
+  int gnum_H;
+  /* cost of relaxed plan
+   */
+  float gcost;
 
-/* dirty: multiplic. of total-time in final metric LNF
- */
-extern float gtt;
 
-/* the mneed structures
- *
- * assign propagation pairs i, j, and transitive such pairs.
- */
-extern Bool **gassign_influence;
-extern Bool **gTassign_influence;
+  /* to store plan
+   */
+  int gplan_ops[MAX_PLAN_LENGTH];
+  int gnum_plan_ops;
 
 
-/* the real var input to the mneed computation.
- */
-extern Bool *gmneed_start_D;
-extern float *gmneed_start_V;
+  /* stores the states that the current plan goes through
+   */
+  State gplan_states[MAX_PLAN_LENGTH + 1];
 
 
+  /* dirty: multiplic. of total-time in final metric LNF
+   */
+  float gtt;
 
-/* does this contain conditional effects?
- * (if it does then the state hashing has to be made more
- *  cautiously)
- */
-extern Bool gconditional_effects;
+  /* the mneed structures
+   *
+   * assign propagation pairs i, j, and transitive such pairs.
+   */
+  Bool **gassign_influence;
+  Bool **gTassign_influence;
+
+
+  /* the real var input to the mneed computation.
+   */
+  Bool *gmneed_start_D;
+  float *gmneed_start_V;
+
+
+  /* does this contain conditional effects?
+   * (if it does then the state hashing has to be made more
+   *  cautiously)
+   */
+  Bool gconditional_effects;
+
+
+  /* loaded, uninstantiated axioms, and how many were named so far
+   */
+  PlOperator *gloaded_axioms;
+  int gnum_axiom_names;
+
+  /* the metric contains total-time
+   */
+  Bool artificial_gtt;
+
+
+
+  /*********************
+   * MODULE LOCALS     *
+   *********************/
+
+
+  /* state private to the single source files; the files
+   * reach these through macros, under the names they always had
+   */
+
+  struct {
+    Token ltype_names[MAX_TYPES];
+    int lnum_types;
+    int leither_ty[MAX_TYPES][MAX_TYPES];
+    int lnum_either_ty[MAX_TYPES];
+  } parse;
+
+  struct {
+    Comparator lcomp;
+    int lF[MAX_LNF_F];
+    float lC[MAX_LNF_F];
+    int lnum_F;
+    float lc;
+    int lminus_fluent[MAX_RELEVANT_FLUENTS];
+    int *lA, *lD;
+    int lnum_A, lnum_D;
+  } expressions;
+
+  struct {
+    char *lvar_names[MAX_VARS];
+    int lvar_types[MAX_VARS];
+    int lconsts[MAX_ARITY];
+    WffNode *lhitting_sets;
+    WffNode_pointer *lset;
+    int lmax_set;
+    Bool dnf_called;
+  } inst_pre;
+
+  struct {
+    int linertia_conds[MAX_VARS];
+    int lnum_inertia_conds;
+    int lmultiply_parameters[MAX_VARS];
+    int lnum_multiply_parameters;
+    NormOperator *lo;
+    NormEffect *le;
+    NormEffect *lres;
+  } inst_easy;
+
+  struct {
+    int linst_table[MAX_VARS];
+    int_pointer lini[MAX_PREDICATES];
+  } inst_hard;
+
+  struct {
+    int_pointer lpos[MAX_PREDICATES];
+    int_pointer lneg[MAX_PREDICATES];
+    int_pointer luse[MAX_PREDICATES];
+    int_pointer lindex[MAX_PREDICATES];
+    int lp;
+    int largs[MAX_VARS];
+    int_pointer lf_def[MAX_FUNCTIONS];
+    int_pointer lf_index[MAX_FUNCTIONS];
+    int lf;
+    int lf_args[MAX_VARS];
+    int lnum_effects;
+  } inst_final;
+
+  struct {
+    int *lF;
+    int lnum_F;
+    int *lE;
+    int lnum_E;
+    int *lch_E;
+    int lnum_ch_E;
+    int *l0P_E;
+    int lnum_0P_E;
+    int **lgoals_at;
+    int *lnum_goals_at;
+    float **lf_goals_c_at;
+    Comparator **lf_goals_comp_at;
+    int lh;
+    int *lch_F;
+    int lnum_ch_F;
+    int *lused_O;
+    int lnum_used_O;
+    int *lin_plan_E;
+    int lnum_in_plan_E;
+    Comparator *lHcomp;
+    float *lHc;
+    Bool A_info_called;
+    Bool fixpoint_called;
+    int fluent_levels_seen;
+    Bool extract_1P_called;
+    Bool goals_called;
+    int goals_seen;
+    Bool H_info_called;
+  } relax;
+
+  struct {
+    EhcNode *lehc_space_head, *lehc_space_end, *lehc_current_start, *lehc_current_end;
+    EhcHashEntry_pointer lehc_hash_entry[EHC_HASH_SIZE];
+    int lnum_ehc_hash_entry[EHC_HASH_SIZE];
+    int lchanged_ehc_entrys[EHC_HASH_SIZE];
+    int lnum_changed_ehc_entrys;
+    Bool lchanged_ehc_entry[EHC_HASH_SIZE];
+    PlanHashEntry_pointer lplan_hash_entry[PLAN_HASH_SIZE];
+    BfsNode *lbfs_space_head, *lbfs_space_had;
+    BfsHashEntry_pointer lbfs_hash_entry[BFS_HASH_SIZE];
+    Bool lH;
+    Bool better_state_called;
+    State better_S__;
+    Bool first_node_called;
+    State first_node_S_;
+    Bool result_called;
+    Bool *in_source, *in_dest, *in_del, *true_ef, *assigned;
+    int *del, num_del;
+  } search;
+
+
+
+  /* every block handed out by ff_calloc(), so that destroying the
+   * context gives back all the memory FF used for the task
+   */
+  struct _FF_Block *blocks;
+
+} FF_Context;
+
+
+
+
+/* the context of the calling thread; FF_create_context() makes a
+ * new one, which has to be installed here before calling into FF
+ */
+extern __thread FF_Context *ff_ctx;
+
+FF_Context *FF_create_context( void );
+void FF_destroy_context( FF_Context *ctx );
+
+void *ff_calloc( size_t nmemb, size_t size );
+void ff_free( void *ptr );
+
+
+
+#define gtempl_time                (ff_ctx->gtempl_time)
+#define greach_time                (ff_ctx->greach_time)
+#define grelev_time                (ff_ctx->grelev_time)
+#define gconn_time                 (ff_ctx->gconn_time)
+#define gLNF_time                  (ff_ctx->gLNF_time)
+#define gsearch_time               (ff_ctx->gsearch_time)
+#define gcmd_line                  (ff_ctx->gcmd_line)
+#define gevaluated_states          (ff_ctx->gevaluated_states)
+#define gmax_search_depth          (ff_ctx->gmax_search_depth)
+#define gbracket_count             (ff_ctx->gbracket_count)
+#define gproblem_name              (ff_ctx->gproblem_name)
+#define lineno                     (ff_ctx->lineno)
+#define gact_filename              (ff_ctx->gact_filename)
+#define gdomain_name               (ff_ctx->gdomain_name)
+#define gloaded_ops                (ff_ctx->gloaded_ops)
+#define gorig_initial_facts        (ff_ctx->gorig_initial_facts)
+#define gorig_goal_facts           (ff_ctx->gorig_goal_facts)
+#define gparse_types               (ff_ctx->gparse_types)
+#define gparse_constants           (ff_ctx->gparse_constants)
+#define gparse_predicates          (ff_ctx->gparse_predicates)
+#define gparse_functions           (ff_ctx->gparse_functions)
+#define gparse_objects             (ff_ctx->gparse_objects)
+#define gparse_optimization        (ff_ctx->gparse_optimization)
+#define gparse_metric              (ff_ctx->gparse_metric)
+#define gorig_constant_list        (ff_ctx->gorig_constant_list)
+#define gpredicates_and_types      (ff_ctx->gpredicates_and_types)
+#define gfunctions_and_types       (ff_ctx->gfunctions_and_types)
+#define gconstants                 (ff_ctx->gconstants)
+#define gnum_constants             (ff_ctx->gnum_constants)
+#define gtype_names                (ff_ctx->gtype_names)
+#define gtype_consts               (ff_ctx->gtype_consts)
+#define gis_member                 (ff_ctx->gis_member)
+#define gtype_size                 (ff_ctx->gtype_size)
+#define gnum_types                 (ff_ctx->gnum_types)
+#define gpredicates                (ff_ctx->gpredicates)
+#define garity                     (ff_ctx->garity)
+#define gpredicates_args_type      (ff_ctx->gpredicates_args_type)
+#define gnum_predicates            (ff_ctx->gnum_predicates)
+#define gfunctions                 (ff_ctx->gfunctions)
+#define gf_arity                   (ff_ctx->gf_arity)
+#define gfunctions_args_type       (ff_ctx->gfunctions_args_type)
+#define gnum_functions             (ff_ctx->gnum_functions)
+#define goperators                 (ff_ctx->goperators)
+#define gnum_operators             (ff_ctx->gnum_operators)
+#define gfull_initial              (ff_ctx->gfull_initial)
+#define gnum_full_initial          (ff_ctx->gnum_full_initial)
+#define gfull_fluents_initial      (ff_ctx->gfull_fluents_initial)
+#define gnum_full_fluents_initial  (ff_ctx->gnum_full_fluents_initial)
+#define ggoal                      (ff_ctx->ggoal)
+#define gmetric                    (ff_ctx->gmetric)
+#define gis_added                  (ff_ctx->gis_added)
+#define gis_deleted                (ff_ctx->gis_deleted)
+#define gis_changed                (ff_ctx->gis_changed)
+#define ginitial                   (ff_ctx->ginitial)
+#define gnum_initial               (ff_ctx->gnum_initial)
+#define ginitial_predicate         (ff_ctx->ginitial_predicate)
+#define gnum_initial_predicate     (ff_ctx->gnum_initial_predicate)
+#define gf_initial                 (ff_ctx->gf_initial)
+#define gnum_f_initial             (ff_ctx->gnum_f_initial)
+#define ginitial_function          (ff_ctx->ginitial_function)
+#define gnum_initial_function      (ff_ctx->gnum_initial_function)
+#define gtype_to_predicate         (ff_ctx->gtype_to_predicate)
+#define gpredicate_to_type         (ff_ctx->gpredicate_to_type)
+#define gintersected_types         (ff_ctx->gintersected_types)
+#define gnum_intersected_types     (ff_ctx->gnum_intersected_types)
+#define ghard_operators            (ff_ctx->ghard_operators)
+#define gnum_hard_operators        (ff_ctx->gnum_hard_operators)
+#define geasy_operators            (ff_ctx->geasy_operators)
+#define gnum_easy_operators        (ff_ctx->gnum_easy_operators)
+#define geasy_templates            (ff_ctx->geasy_templates)
+#define gnum_easy_templates        (ff_ctx->gnum_easy_templates)
+#define ghard_mixed_operators      (ff_ctx->ghard_mixed_operators)
+#define gnum_hard_mixed_operators  (ff_ctx->gnum_hard_mixed_operators)
+#define ghard_templates            (ff_ctx->ghard_templates)
+#define gnum_hard_templates        (ff_ctx->gnum_hard_templates)
+#define grelevant_facts            (ff_ctx->grelevant_facts)
+#define gnum_relevant_facts        (ff_ctx->gnum_relevant_facts)
+#define gnum_pp_facts              (ff_ctx->gnum_pp_facts)
+#define grelevant_fluents          (ff_ctx->grelevant_fluents)
+#define gnum_relevant_fluents      (ff_ctx->gnum_relevant_fluents)
+#define grelevant_fluents_name     (ff_ctx->grelevant_fluents_name)
+#define grelevant_fluents_lnf      (ff_ctx->grelevant_fluents_lnf)
+#define gactions                   (ff_ctx->gactions)
+#define gnum_actions               (ff_ctx->gnum_actions)
+#define ginitial_state             (ff_ctx->ginitial_state)
+#define glogic_goal                (ff_ctx->glogic_goal)
+#define gnum_logic_goal            (ff_ctx->gnum_logic_goal)
+#define gnumeric_goal_comp         (ff_ctx->gnumeric_goal_comp)
+#define gnumeric_goal_lh           (ff_ctx->gnumeric_goal_lh)
+#define gnumeric_goal_rh           (ff_ctx->gnumeric_goal_rh)
+#define gnum_numeric_goal          (ff_ctx->gnum_numeric_goal)
+#define gtrash_actions             (ff_ctx->gtrash_actions)
+#define glnf_goal_comp             (ff_ctx->glnf_goal_comp)
+#define glnf_goal_lh               (ff_ctx->glnf_goal_lh)
+#define glnf_goal_rh               (ff_ctx->glnf_goal_rh)
+#define gnum_lnf_goal              (ff_ctx->gnum_lnf_goal)
+#define glnf_metric                (ff_ctx->glnf_metric)
+#define goptimization_established  (ff_ctx->goptimization_established)
+#define gop_conn                   (ff_ctx->gop_conn)
+#define gnum_op_conn               (ff_ctx->gnum_op_conn)
+#define gef_conn                   (ff_ctx->gef_conn)
+#define gnum_ef_conn               (ff_ctx->gnum_ef_conn)
+#define gft_conn                   (ff_ctx->gft_conn)
+#define gnum_ft_conn               (ff_ctx->gnum_ft_conn)
+#define gfl_conn                   (ff_ctx->gfl_conn)
+#define gnum_fl_conn               (ff_ctx->gnum_fl_conn)
+#define gnum_real_fl_conn          (ff_ctx->gnum_real_fl_conn)
+#define gflogic_goal               (ff_ctx->gflogic_goal)
+#define gnum_flogic_goal           (ff_ctx->gnum_flogic_goal)
+#define gfnumeric_goal_comp        (ff_ctx->gfnumeric_goal_comp)
+#define gfnumeric_goal_fl          (ff_ctx->gfnumeric_goal_fl)
+#define gfnumeric_goal_c           (ff_ctx->gfnumeric_goal_c)
+#define gnum_fnumeric_goal         (ff_ctx->gnum_fnumeric_goal)
+#define gfnumeric_goal_direct_comp (ff_ctx->gfnumeric_goal_direct_comp)
+#define gfnumeric_goal_direct_c    (ff_ctx->gfnumeric_goal_direct_c)
+#define gA                         (ff_ctx->gA)
+#define gnum_A                     (ff_ctx->gnum_A)
+#define gH                         (ff_ctx->gH)
+#define gnum_H                     (ff_ctx->gnum_H)
+#define gcost                      (ff_ctx->gcost)
+#define gplan_ops                  (ff_ctx->gplan_ops)
+#define gnum_plan_ops              (ff_ctx->gnum_plan_ops)
+#define gplan_states               (ff_ctx->gplan_states)
+#define gtt                        (ff_ctx->gtt)
+#define gassign_influence          (ff_ctx->gassign_influence)
+#define gTassign_influence         (ff_ctx->gTassign_influence)
+#define gmneed_start_D             (ff_ctx->gmneed_start_D)
+#define gmneed_start_V             (ff_ctx->gmneed_start_V)
+#define gconditional_effects       (ff_ctx->gconditional_effects)
+#define gloaded_axioms             (ff_ctx->gloaded_axioms)
+#define gnum_axiom_names           (ff_ctx->gnum_axiom_names)
+#define artificial_gtt             (ff_ctx->artificial_gtt)
 
 
 
@@ -703,16 +703,16 @@ int find_intersected_type( TypeArray T, int num_T )
 /* local globals for multiplying
  */
 
-int linertia_conds[MAX_VARS];
-int lnum_inertia_conds;
+#define linertia_conds (ff_ctx->inst_easy.linertia_conds)
+#define lnum_inertia_conds (ff_ctx->inst_easy.lnum_inertia_conds)
 
-int lmultiply_parameters[MAX_VARS];
-int lnum_multiply_parameters;
+#define lmultiply_parameters (ff_ctx->inst_easy.lmultiply_parameters)
+#define lnum_multiply_parameters (ff_ctx->inst_easy.lnum_multiply_parameters)
 
-NormOperator *lo;
-NormEffect *le;
+#define lo (ff_ctx->inst_easy.lo)
+#define le (ff_ctx->inst_easy.le)
 
-NormEffect *lres;
+#define lres (ff_ctx->inst_easy.lres)
 
 
 
@@ -101,23 +101,23 @@
 /* local globals for this part
  */
 
-int_pointer lpos[MAX_PREDICATES];
-int_pointer lneg[MAX_PREDICATES];
-int_pointer luse[MAX_PREDICATES];
-int_pointer lindex[MAX_PREDICATES];
+#define lpos (ff_ctx->inst_final.lpos)
+#define lneg (ff_ctx->inst_final.lneg)
+#define luse (ff_ctx->inst_final.luse)
+#define lindex (ff_ctx->inst_final.lindex)
 
-int lp;
-int largs[MAX_VARS];
+#define lp (ff_ctx->inst_final.lp)
+#define largs (ff_ctx->inst_final.largs)
 
 
 
 /* for collecting poss. defined fluents
  */
-int_pointer lf_def[MAX_FUNCTIONS];
-int_pointer lf_index[MAX_FUNCTIONS];
+#define lf_def (ff_ctx->inst_final.lf_def)
+#define lf_index (ff_ctx->inst_final.lf_index)
 
-int lf;
-int lf_args[MAX_VARS];
+#define lf (ff_ctx->inst_final.lf)
+#define lf_args (ff_ctx->inst_final.lf_args)
 
 
 
@@ -341,7 +341,7 @@ void perform_reachability_analysis( void )
     }
   }
 
-  free( had_hard_template );
+  ff_free( had_hard_template );
 
   gnum_pp_facts = gnum_initial + gnum_relevant_facts;
 
@@ -489,7 +489,7 @@ void make_name_inst_table_from_PseudoAction( Action *a, PseudoAction *pa )
 
 /* counts effects for later allocation
  */
-int lnum_effects;
+#define lnum_effects (ff_ctx->inst_final.lnum_effects)
 
 
 
@@ -842,10 +842,10 @@ void create_final_goal_state( void )
 	  if ( ww->connective == ATOM ) m++;
 	  if ( ww->connective == COMP ) mn++;
 	}
-	tmp->preconds = ( m == 0 ? NULL : ( int * ) calloc( m, sizeof( int ) ) );
-	tmp->numeric_preconds_comp = ( mn == 0 ? NULL : ( Comparator * ) calloc( mn, sizeof( Comparator ) ) );
-	tmp->numeric_preconds_lh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) );
-	tmp->numeric_preconds_rh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) );
+	tmp->preconds = ( m == 0 ? NULL : ( int * ) ff_calloc( m, sizeof( int ) ) );
+	tmp->numeric_preconds_comp = ( mn == 0 ? NULL : ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) ) );
+	tmp->numeric_preconds_lh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) );
+	tmp->numeric_preconds_rh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) );
 	tmp->num_preconds = m;
 	tmp->num_numeric_preconds = mn;
 	m = 0; mn = 0;
@@ -868,7 +868,7 @@ void create_final_goal_state( void )
 	}
       } else {
 	if ( w->connective == ATOM ) {
-	  tmp->preconds = ( int * ) calloc( 1, sizeof( int ) );
+	  tmp->preconds = ( int * ) ff_calloc( 1, sizeof( int ) );
 	  tmp->num_preconds = 1;
 	  lp = w->fact->predicate;
 	  for ( i = 0; i < garity[lp]; i++ ) {
@@ -878,22 +878,22 @@ void create_final_goal_state( void )
 	  tmp->preconds[0] = lindex[lp][adr];
 	}
 	if ( w->connective == COMP ) {
-	  tmp->numeric_preconds_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-	  tmp->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-	  tmp->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp->numeric_preconds_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+	  tmp->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
 	  tmp->numeric_preconds_comp[0] = w->comp;
 	  tmp->numeric_preconds_lh[0] = copy_Exp( w->lh );
 	  tmp->numeric_preconds_rh[0] = copy_Exp( w->rh );
 	  tmp->num_numeric_preconds = 1;
 	}
       }
-      tmp->effects = ( ActionEffect * ) calloc( 1, sizeof( ActionEffect ) );
+      tmp->effects = ( ActionEffect * ) ff_calloc( 1, sizeof( ActionEffect ) );
       tmp->num_effects = 1;
       tmp->effects[0].conditions = NULL;
       tmp->effects[0].num_conditions = 0;
       tmp->effects[0].dels = NULL;
       tmp->effects[0].num_dels = 0;
-      tmp->effects[0].adds = ( int * ) calloc( 1, sizeof( int ) );
+      tmp->effects[0].adds = ( int * ) ff_calloc( 1, sizeof( int ) );
       tmp->effects[0].adds[0] = gnum_relevant_facts - 1;
       tmp->effects[0].num_adds = 1;
       tmp->effects[0].numeric_conditions_comp = NULL;
@@ -910,7 +910,7 @@ void create_final_goal_state( void )
       gnum_actions++;
       lnum_effects++;
     }
-    glogic_goal = ( int * ) calloc( 1, sizeof( int ) );
+    glogic_goal = ( int * ) ff_calloc( 1, sizeof( int ) );
     glogic_goal[0] = gnum_relevant_facts - 1;
     gnum_logic_goal = 1;
     break;
@@ -920,10 +920,10 @@ void create_final_goal_state( void )
       if ( w->connective == ATOM ) m++;
       if ( w->connective == COMP ) mn++;
     }
-    glogic_goal = ( m == 0 ? NULL : ( int * ) calloc( m, sizeof( int ) ) );
-    gnumeric_goal_comp = (mn == 0 ? NULL : ( Comparator * ) calloc( mn, sizeof( Comparator ) ) );
-    gnumeric_goal_lh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) );
-    gnumeric_goal_rh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) );
+    glogic_goal = ( m == 0 ? NULL : ( int * ) ff_calloc( m, sizeof( int ) ) );
+    gnumeric_goal_comp = (mn == 0 ? NULL : ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) ) );
+    gnumeric_goal_lh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) );
+    gnumeric_goal_rh = ( mn == 0 ? NULL : ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) );
     gnum_logic_goal = m;
     gnum_numeric_goal = mn;
     m = 0; mn = 0;
@@ -946,7 +946,7 @@ void create_final_goal_state( void )
     }
     break;
   case ATOM:
-    glogic_goal = ( int * ) calloc( 1, sizeof( int ) );
+    glogic_goal = ( int * ) ff_calloc( 1, sizeof( int ) );
     gnum_logic_goal = 1;
     lp = ggoal->fact->predicate;
     for ( i = 0; i < garity[lp]; i++ ) {
@@ -956,9 +956,9 @@ void create_final_goal_state( void )
     glogic_goal[0] = lindex[lp][adr];
     break;
   case COMP:
-    gnumeric_goal_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-    gnumeric_goal_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-    gnumeric_goal_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+    gnumeric_goal_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+    gnumeric_goal_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+    gnumeric_goal_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
     gnum_numeric_goal = 1;
     gnumeric_goal_comp[0] = ggoal->comp;
     gnumeric_goal_lh[0] = copy_Exp( ggoal->lh ); 
@@ -1000,13 +1000,13 @@ Bool set_relevants_in_wff( WffNode **w )
 
     if ( !lneg[lp][adr] ) {
       (*w)->connective = TRU;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
     if ( !lpos[lp][adr] ) {
       (*w)->connective = FAL;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
@@ -1120,7 +1120,7 @@ Bool set_relevants_in_exp( ExpNode **n )
     }
     adr = fluent_adress();
     (*n)->fl = lf_index[lf][adr];
-    free( (*n)->fluent );
+    ff_free( (*n)->fluent );
     (*n)->fluent = NULL;
     if ( lf_index[lf][adr] == -1 ) {
       if ( lf == 0 ) {
@@ -1210,7 +1210,7 @@ void create_final_actions( void )
       no = a->norm_operator;
 
       if ( no->num_preconds > 0 ) {
-	a->preconds = ( no->num_preconds == 0 ? NULL : ( int * ) calloc( no->num_preconds, sizeof( int ) ) );
+	a->preconds = ( no->num_preconds == 0 ? NULL : ( int * ) ff_calloc( no->num_preconds, sizeof( int ) ) );
       }
       a->num_preconds = 0;
       for ( i = 0; i < no->num_preconds; i++ ) {
@@ -1231,11 +1231,11 @@ void create_final_actions( void )
       /**************************NUMERIC PRECOND*************************/
       if ( no->num_numeric_preconds > 0 ) {
 	a->numeric_preconds_comp = ( no->num_numeric_preconds == 0 ? NULL : 
-		( Comparator * )  calloc( no->num_numeric_preconds, sizeof( Comparator ) ) );
+		( Comparator * )  ff_calloc( no->num_numeric_preconds, sizeof( Comparator ) ) );
 	a->numeric_preconds_lh = ( no->num_numeric_preconds == 0 ? NULL :
-		( ExpNode_pointer * )  calloc( no->num_numeric_preconds, sizeof( ExpNode_pointer ) ) );
+		( ExpNode_pointer * )  ff_calloc( no->num_numeric_preconds, sizeof( ExpNode_pointer ) ) );
 	a->numeric_preconds_rh = ( no->num_numeric_preconds == 0 ? NULL :
-		( ExpNode_pointer * ) calloc( no->num_numeric_preconds, sizeof( ExpNode_pointer ) ) );
+		( ExpNode_pointer * ) ff_calloc( no->num_numeric_preconds, sizeof( ExpNode_pointer ) ) );
 	a->num_numeric_preconds = 0;
       }
       for ( i = 0; i < no->num_numeric_preconds; i++ ) {
@@ -1290,7 +1290,7 @@ void create_final_actions( void )
       /* and now for the effects
        */
       if ( a->num_effects > 0 ) {
-	a->effects = ( ActionEffect * ) calloc( a->num_effects, sizeof( ActionEffect ) );
+	a->effects = ( ActionEffect * ) ff_calloc( a->num_effects, sizeof( ActionEffect ) );
 	for ( i = 0; i < a->num_effects; i++ ) {
 	  a->effects[i].illegal = FALSE;
 	  a->effects[i].removed = FALSE;
@@ -1301,7 +1301,7 @@ void create_final_actions( void )
 	aa = &(a->effects[a->num_effects]);
 
 	if ( ne->num_conditions > 0 ) {
-	  aa->conditions = ( int * ) calloc( ne->num_conditions, sizeof( int ) );
+	  aa->conditions = ( int * ) ff_calloc( ne->num_conditions, sizeof( int ) );
 	}
 	aa->num_conditions = 0;
 	for ( i = 0; i < ne->num_conditions; i++ ) {
@@ -1320,18 +1320,18 @@ void create_final_actions( void )
 	  aa->conditions[aa->num_conditions++] = lindex[lp][adr];
 	}
 	if ( i < ne->num_conditions ) {/* found unreachable condition: free condition space */
-	  free( aa->conditions );
+	  ff_free( aa->conditions );
 	  continue;
 	}
 
 	/**************************NUMERIC COND*************************/
 	if ( ne->num_numeric_conditions > 0 ) {
 	  aa->numeric_conditions_comp = ( Comparator * ) 
-	    calloc( ne->num_numeric_conditions, sizeof( Comparator ) );
+	    ff_calloc( ne->num_numeric_conditions, sizeof( Comparator ) );
 	  aa->numeric_conditions_lh = ( ExpNode_pointer * )
-	    calloc( ne->num_numeric_conditions, sizeof( ExpNode_pointer ) );
+	    ff_calloc( ne->num_numeric_conditions, sizeof( ExpNode_pointer ) );
 	  aa->numeric_conditions_rh = ( ExpNode_pointer * )
-	    calloc( ne->num_numeric_conditions, sizeof( ExpNode_pointer ) );
+	    ff_calloc( ne->num_numeric_conditions, sizeof( ExpNode_pointer ) );
 	  for ( i = 0; i < ne->num_numeric_conditions; i++ ) {
 	    aa->numeric_conditions_lh[i] = NULL;
 	    aa->numeric_conditions_rh[i] = NULL;
@@ -1378,9 +1378,9 @@ void create_final_actions( void )
 	      free_ExpNode( aa->numeric_conditions_lh[i] );
 	      free_ExpNode( aa->numeric_conditions_rh[i] );
 	    }
-	    free( aa->numeric_conditions_comp );
-	    free( aa->numeric_conditions_lh );
-	    free( aa->numeric_conditions_rh );
+	    ff_free( aa->numeric_conditions_comp );
+	    ff_free( aa->numeric_conditions_lh );
+	    ff_free( aa->numeric_conditions_rh );
 	    continue;/* next effect, without incrementing action counter */
 	  } else {
 	    /* numeric effect uses undefined fluent in condition -->
@@ -1396,7 +1396,7 @@ void create_final_actions( void )
 	/* now create the add and del effects.
 	 */
 	if ( ne->num_adds > 0 ) {
-	  aa->adds = ( int * ) calloc( ne->num_adds, sizeof( int ) );
+	  aa->adds = ( int * ) ff_calloc( ne->num_adds, sizeof( int ) );
 	}
 	aa->num_adds = 0;
 	for ( i = 0; i < ne->num_adds; i++ ) {
@@ -1413,7 +1413,7 @@ void create_final_actions( void )
 	}
 
 	if ( ne->num_dels > 0 ) {
-	  aa->dels = ( int * ) calloc( ne->num_dels, sizeof( int ) );
+	  aa->dels = ( int * ) ff_calloc( ne->num_dels, sizeof( int ) );
 	}
 	aa->num_dels = 0;
 	for ( i = 0; i < ne->num_dels; i++ ) {
@@ -1435,11 +1435,11 @@ void create_final_actions( void )
 	/**************************NUMERIC EFFECTS*************************/
 	if ( ne->num_numeric_effects > 0 ) {
 	  aa->numeric_effects_neft = ( NumericEffectType * ) 
-	    calloc( ne->num_numeric_effects, sizeof( NumericEffectType ) );
+	    ff_calloc( ne->num_numeric_effects, sizeof( NumericEffectType ) );
 	  aa->numeric_effects_fl = ( int * )
-	    calloc( ne->num_numeric_effects, sizeof( int ) );
+	    ff_calloc( ne->num_numeric_effects, sizeof( int ) );
 	  aa->numeric_effects_rh = ( ExpNode_pointer * )
-	    calloc( ne->num_numeric_effects, sizeof( ExpNode_pointer ) );
+	    ff_calloc( ne->num_numeric_effects, sizeof( ExpNode_pointer ) );
 	  aa->num_numeric_effects = 0;
 	}
 	for ( i = 0; i < ne->num_numeric_effects; i++ ) {
@@ -1511,7 +1511,7 @@ void create_final_actions( void )
        */
       pa = a->pseudo_action;
       if ( pa->num_preconds > 0 ) {
-	a->preconds = ( int * ) calloc( pa->num_preconds, sizeof( int ) );
+	a->preconds = ( int * ) ff_calloc( pa->num_preconds, sizeof( int ) );
       }
       a->num_preconds = 0;
       for ( i = 0; i < pa->num_preconds; i++ ) {
@@ -1531,11 +1531,11 @@ void create_final_actions( void )
       /**************************NUMERIC PRECOND*************************/
       if ( pa->num_numeric_preconds > 0 ) {
 	a->numeric_preconds_comp = ( Comparator * ) 
-	  calloc( pa->num_numeric_preconds, sizeof( Comparator ) );
+	  ff_calloc( pa->num_numeric_preconds, sizeof( Comparator ) );
 	a->numeric_preconds_lh = ( ExpNode_pointer * )
-	  calloc( pa->num_numeric_preconds, sizeof( ExpNode_pointer ) );
+	  ff_calloc( pa->num_numeric_preconds, sizeof( ExpNode_pointer ) );
 	a->numeric_preconds_rh = ( ExpNode_pointer * )
-	  calloc( pa->num_numeric_preconds, sizeof( ExpNode_pointer ) );
+	  ff_calloc( pa->num_numeric_preconds, sizeof( ExpNode_pointer ) );
 	a->num_numeric_preconds = 0;
       }
       for ( i = 0; i < pa->num_numeric_preconds; i++ ) {
@@ -1570,7 +1570,7 @@ void create_final_actions( void )
       /* and now for the effects
        */
       if ( a->num_effects > 0 ) {
-	a->effects = ( ActionEffect * ) calloc( a->num_effects, sizeof( ActionEffect ) );
+	a->effects = ( ActionEffect * ) ff_calloc( a->num_effects, sizeof( ActionEffect ) );
 	for ( i = 0; i < a->num_effects; i++ ) {
 	  a->effects[i].illegal = FALSE;
 	  a->effects[i].removed = FALSE;
@@ -1581,7 +1581,7 @@ void create_final_actions( void )
 	aa = &(a->effects[a->num_effects]);
 
 	if ( pae->num_conditions > 0 ) {
-	  aa->conditions = ( int * ) calloc( pae->num_conditions, sizeof( int ) );
+	  aa->conditions = ( int * ) ff_calloc( pae->num_conditions, sizeof( int ) );
 	}
 	aa->num_conditions = 0;
 	for ( i = 0; i < pae->num_conditions; i++ ) {
@@ -1599,18 +1599,18 @@ void create_final_actions( void )
 	  aa->conditions[aa->num_conditions++] = lindex[lp][adr];
 	}
 	if ( i < pae->num_conditions ) {/* found unreachable condition: free condition space */
-	  free( aa->conditions );
+	  ff_free( aa->conditions );
 	  continue;
 	}
 
 	/**************************NUMERIC COND*************************/
 	if ( pae->num_numeric_conditions > 0 ) {
 	  aa->numeric_conditions_comp = ( Comparator * ) 
-	    calloc( pae->num_numeric_conditions, sizeof( Comparator ) );
+	    ff_calloc( pae->num_numeric_conditions, sizeof( Comparator ) );
 	  aa->numeric_conditions_lh = ( ExpNode_pointer * )
-	    calloc( pae->num_numeric_conditions, sizeof( ExpNode_pointer ) );
+	    ff_calloc( pae->num_numeric_conditions, sizeof( ExpNode_pointer ) );
 	  aa->numeric_conditions_rh = ( ExpNode_pointer * )
-	    calloc( pae->num_numeric_conditions, sizeof( ExpNode_pointer ) );
+	    ff_calloc( pae->num_numeric_conditions, sizeof( ExpNode_pointer ) );
 	  for ( i = 0; i < pae->num_numeric_conditions; i++ ) {
 	    aa->numeric_conditions_lh[i] = NULL;
 	    aa->numeric_conditions_rh[i] = NULL;
@@ -1638,7 +1638,7 @@ void create_final_actions( void )
 	/* now create the add and del effects.
 	 */
 	if ( pae->num_adds > 0 ) {
-	  aa->adds = ( int * ) calloc( pae->num_adds, sizeof( int ) );
+	  aa->adds = ( int * ) ff_calloc( pae->num_adds, sizeof( int ) );
 	}
 	aa->num_adds = 0;
 	for ( i = 0; i < pae->num_adds; i++ ) {
@@ -1654,7 +1654,7 @@ void create_final_actions( void )
 	}
 
 	if ( pae->num_dels > 0 ) {
-	  aa->dels = ( int * ) calloc( pae->num_dels, sizeof( int ) );
+	  aa->dels = ( int * ) ff_calloc( pae->num_dels, sizeof( int ) );
 	}
 	aa->num_dels = 0;
 	for ( i = 0; i < pae->num_dels; i++ ) {
@@ -1673,11 +1673,11 @@ void create_final_actions( void )
 	/**************************NUMERIC EFFECTS*************************/
 	if ( pae->num_numeric_effects > 0 ) {
 	  aa->numeric_effects_neft = ( NumericEffectType * ) 
-	    calloc( pae->num_numeric_effects, sizeof( NumericEffectType ) );
+	    ff_calloc( pae->num_numeric_effects, sizeof( NumericEffectType ) );
 	  aa->numeric_effects_fl = ( int * )
-	    calloc( pae->num_numeric_effects, sizeof( int ) );
+	    ff_calloc( pae->num_numeric_effects, sizeof( int ) );
 	  aa->numeric_effects_rh = ( ExpNode_pointer * )
-	    calloc( pae->num_numeric_effects, sizeof( ExpNode_pointer ) );
+	    ff_calloc( pae->num_numeric_effects, sizeof( ExpNode_pointer ) );
 	  aa->num_numeric_effects = 0;
 	}
 	for ( i = 0; i < pae->num_numeric_effects; i++ ) {
@@ -1934,10 +1934,10 @@ void build_connectivity_graph( void )
   gnum_ft_conn = gnum_relevant_facts;
   gnum_fl_conn = gnum_relevant_fluents;
   gnum_op_conn = gnum_actions;
-  gft_conn = ( gnum_ft_conn ? ( FtConn * ) calloc( gnum_ft_conn, sizeof( FtConn ) ) : NULL );
-  gfl_conn = ( gnum_fl_conn ? ( FlConn * ) calloc( gnum_fl_conn, sizeof( FlConn ) ) : NULL );
-  gop_conn = ( gnum_op_conn ? ( OpConn * ) calloc( gnum_op_conn, sizeof( OpConn ) ) : NULL );
-  gef_conn = ( lnum_effects ? ( EfConn * ) calloc( lnum_effects, sizeof( EfConn ) ) : NULL );
+  gft_conn = ( gnum_ft_conn ? ( FtConn * ) ff_calloc( gnum_ft_conn, sizeof( FtConn ) ) : NULL );
+  gfl_conn = ( gnum_fl_conn ? ( FlConn * ) ff_calloc( gnum_fl_conn, sizeof( FlConn ) ) : NULL );
+  gop_conn = ( gnum_op_conn ? ( OpConn * ) ff_calloc( gnum_op_conn, sizeof( OpConn ) ) : NULL );
+  gef_conn = ( lnum_effects ? ( EfConn * ) ff_calloc( lnum_effects, sizeof( EfConn ) ) : NULL );
   gnum_ef_conn = 0;
 
   for ( i = 0; i < gnum_ft_conn; i++ ) {
@@ -1964,9 +1964,9 @@ void build_connectivity_graph( void )
        */
       gfl_conn[i].artificial = TRUE;
       gfl_conn[i].lnf_F = ( int * ) 
-	calloc( grelevant_fluents_lnf[i]->num_pF, sizeof( int ) );
+	ff_calloc( grelevant_fluents_lnf[i]->num_pF, sizeof( int ) );
       gfl_conn[i].lnf_C = ( float * ) 
-	calloc( grelevant_fluents_lnf[i]->num_pF, sizeof( float ) );
+	ff_calloc( grelevant_fluents_lnf[i]->num_pF, sizeof( float ) );
       for ( j = 0; j < grelevant_fluents_lnf[i]->num_pF; j++ ) {
 	gfl_conn[i].lnf_F[j] = grelevant_fluents_lnf[i]->pF[j];
 	gfl_conn[i].lnf_C[j] = grelevant_fluents_lnf[i]->pC[j];
@@ -1978,8 +1978,8 @@ void build_connectivity_graph( void )
 
   /* why not do this here?
    */
-  gmneed_start_D = ( gnum_real_fl_conn ? ( Bool * ) calloc( gnum_real_fl_conn, sizeof( Bool ) ) : NULL );
-  gmneed_start_V = ( gnum_real_fl_conn ? ( float * ) calloc( gnum_real_fl_conn, sizeof( float ) ) : NULL );
+  gmneed_start_D = ( gnum_real_fl_conn ? ( Bool * ) ff_calloc( gnum_real_fl_conn, sizeof( Bool ) ) : NULL );
+  gmneed_start_V = ( gnum_real_fl_conn ? ( float * ) ff_calloc( gnum_real_fl_conn, sizeof( float ) ) : NULL );
 
 
   for ( i = 0; i < gnum_op_conn; i++ ) {
@@ -2028,7 +2028,7 @@ void build_connectivity_graph( void )
       continue;
     }
 
-    gop_conn[n_op].E = ( int * ) calloc( a->num_effects, sizeof( int ) );
+    gop_conn[n_op].E = ( int * ) ff_calloc( a->num_effects, sizeof( int ) );
     for ( i = 0; i < a->num_effects; i++ ) {
       e = &(a->effects[i]);
       gef_conn[n_ef].cost = e->cost;
@@ -2045,7 +2045,7 @@ void build_connectivity_graph( void )
 
       /*****************************CONDS********************************/
       gef_conn[n_ef].PC = ( int * ) 
-	calloc( e->num_conditions + a->num_preconds, sizeof( int ) );
+	ff_calloc( e->num_conditions + a->num_preconds, sizeof( int ) );
       for ( j = 0; j < a->num_preconds; j++ ) {
 	for ( k = 0; k < gef_conn[n_ef].num_PC; k++ ) {
 	  if ( gef_conn[n_ef].PC[k] == a->preconds[j] ) break;
@@ -2065,16 +2065,16 @@ void build_connectivity_graph( void )
       int n_lcond_lpreconds = e->num_lnf_conditions + a->num_lnf_preconds;
 
       gef_conn[n_ef].f_PC_comp = ( n_lcond_lpreconds ? 
-		( Comparator * ) calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( Comparator ) ) : NULL );
+		( Comparator * ) ff_calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( Comparator ) ) : NULL );
       gef_conn[n_ef].f_PC_fl = ( n_lcond_lpreconds ? 
-		( int * )  calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( int ) ) : NULL );
+		( int * )  ff_calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( int ) ) : NULL );
       gef_conn[n_ef].f_PC_c = ( n_lcond_lpreconds ? 
-		( float * ) calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( float ) ) : NULL );
-      gef_conn[n_ef].f_PC_direct_comp = ( gnum_fl_conn ? ( Comparator * ) calloc( gnum_fl_conn, sizeof( Comparator ) ) : NULL );
+		( float * ) ff_calloc( e->num_lnf_conditions + a->num_lnf_preconds, sizeof( float ) ) : NULL );
+      gef_conn[n_ef].f_PC_direct_comp = ( gnum_fl_conn ? ( Comparator * ) ff_calloc( gnum_fl_conn, sizeof( Comparator ) ) : NULL );
       for ( j = 0; j < gnum_fl_conn; j++ ) {
 	gef_conn[n_ef].f_PC_direct_comp[j] = IGUAL;
       }
-      gef_conn[n_ef].f_PC_direct_c = ( gnum_fl_conn ? ( float * ) calloc( gnum_fl_conn, sizeof( float ) ) : NULL );
+      gef_conn[n_ef].f_PC_direct_c = ( gnum_fl_conn ? ( float * ) ff_calloc( gnum_fl_conn, sizeof( float ) ) : NULL );
       for ( j = 0; j < a->num_lnf_preconds; j++ ) {
 	if ( a->lnf_preconds_lh[j]->num_pF != 1 ) {
 	  printf("\n\nnon 1 card. in comp lh final pre copyover.\n\n");
@@ -2151,14 +2151,14 @@ void build_connectivity_graph( void )
 	continue;
       }
       /*****************************EFFECTS********************************/
-      gef_conn[n_ef].A = ( e->num_adds ? ( int * ) calloc( e->num_adds, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].D = ( e->num_dels ? ( int * ) calloc( e->num_dels, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].IN_fl = ( e-> num_lnf_effects ? ( int * ) calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].IN_fl_ = ( e->num_lnf_effects ? ( int * ) calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].IN_c = ( e->num_lnf_effects ? ( float * ) calloc( e->num_lnf_effects, sizeof( float ) ) : NULL );
-      gef_conn[n_ef].AS_fl = ( e->num_lnf_effects ? ( int * ) calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].AS_fl_ = (e ->num_lnf_effects ? ( int * ) calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
-      gef_conn[n_ef].AS_c = ( e->num_lnf_effects ? ( float * ) calloc( e->num_lnf_effects, sizeof( float ) ) : NULL );
+      gef_conn[n_ef].A = ( e->num_adds ? ( int * ) ff_calloc( e->num_adds, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].D = ( e->num_dels ? ( int * ) ff_calloc( e->num_dels, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].IN_fl = ( e-> num_lnf_effects ? ( int * ) ff_calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].IN_fl_ = ( e->num_lnf_effects ? ( int * ) ff_calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].IN_c = ( e->num_lnf_effects ? ( float * ) ff_calloc( e->num_lnf_effects, sizeof( float ) ) : NULL );
+      gef_conn[n_ef].AS_fl = ( e->num_lnf_effects ? ( int * ) ff_calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].AS_fl_ = (e ->num_lnf_effects ? ( int * ) ff_calloc( e->num_lnf_effects, sizeof( int ) ) : NULL );
+      gef_conn[n_ef].AS_c = ( e->num_lnf_effects ? ( float * ) ff_calloc( e->num_lnf_effects, sizeof( float ) ) : NULL );
 
       /* duplicates removed in summarize already.
        *
@@ -2319,7 +2319,7 @@ void build_connectivity_graph( void )
     if ( gop_conn[n_op].num_E > 1 ) {
       for ( i = 0; i < gop_conn[n_op].num_E; i++ ) {
 	ef = gop_conn[n_op].E[i];
-	gef_conn[ef].I = ( int * ) calloc( gop_conn[n_op].num_E, sizeof( int ) );
+	gef_conn[ef].I = ( int * ) ff_calloc( gop_conn[n_op].num_E, sizeof( int ) );
 	gef_conn[ef].num_I = 0;
       }    
       for ( i = 0; i < gop_conn[n_op].num_E - 1; i++ ) {
@@ -2405,15 +2405,15 @@ void build_connectivity_graph( void )
   /*****************************FLCONN********************************/
   for ( i = 0; i < gnum_ft_conn; i++ ) {
     if ( gft_conn[i].num_PC > 0 ) {
-      gft_conn[i].PC = ( int * ) calloc( gft_conn[i].num_PC, sizeof( int ) );
+      gft_conn[i].PC = ( int * ) ff_calloc( gft_conn[i].num_PC, sizeof( int ) );
     }
     gft_conn[i].num_PC = 0;
     if ( gft_conn[i].num_A > 0 ) {
-      gft_conn[i].A = ( int * ) calloc( gft_conn[i].num_A, sizeof( int ) );
+      gft_conn[i].A = ( int * ) ff_calloc( gft_conn[i].num_A, sizeof( int ) );
     }
     gft_conn[i].num_A = 0;
     if ( gft_conn[i].num_D > 0 ) {
-      gft_conn[i].D = ( int * ) calloc( gft_conn[i].num_D, sizeof( int ) );
+      gft_conn[i].D = ( int * ) ff_calloc( gft_conn[i].num_D, sizeof( int ) );
     }
     gft_conn[i].num_D = 0;
   }
@@ -2437,19 +2437,19 @@ void build_connectivity_graph( void )
    */
   for ( i = 0; i < gnum_fl_conn; i++ ) {
     if ( gfl_conn[i].num_PC > 0 ) {
-      gfl_conn[i].PC = ( int * ) calloc( gfl_conn[i].num_PC, sizeof( int ) );
+      gfl_conn[i].PC = ( int * ) ff_calloc( gfl_conn[i].num_PC, sizeof( int ) );
     }
     gfl_conn[i].num_PC = 0;
     if ( gfl_conn[i].num_IN > 0 ) {
-      gfl_conn[i].IN = ( int * ) calloc( gfl_conn[i].num_IN, sizeof( int ) );
-      gfl_conn[i].IN_fl_ = ( int * ) calloc( gfl_conn[i].num_IN, sizeof( int ) );
-      gfl_conn[i].IN_c = ( float * ) calloc( gfl_conn[i].num_IN, sizeof( float ) );
+      gfl_conn[i].IN = ( int * ) ff_calloc( gfl_conn[i].num_IN, sizeof( int ) );
+      gfl_conn[i].IN_fl_ = ( int * ) ff_calloc( gfl_conn[i].num_IN, sizeof( int ) );
+      gfl_conn[i].IN_c = ( float * ) ff_calloc( gfl_conn[i].num_IN, sizeof( float ) );
     }
     gfl_conn[i].num_IN = 0;
     if ( gfl_conn[i].num_AS > 0 ) {
-      gfl_conn[i].AS = ( int * ) calloc( gfl_conn[i].num_AS, sizeof( int ) );
-      gfl_conn[i].AS_fl_ = ( int * ) calloc( gfl_conn[i].num_AS, sizeof( int ) );
-      gfl_conn[i].AS_c = ( float * ) calloc( gfl_conn[i].num_AS, sizeof( float ) );
+      gfl_conn[i].AS = ( int * ) ff_calloc( gfl_conn[i].num_AS, sizeof( int ) );
+      gfl_conn[i].AS_fl_ = ( int * ) ff_calloc( gfl_conn[i].num_AS, sizeof( int ) );
+      gfl_conn[i].AS_c = ( float * ) ff_calloc( gfl_conn[i].num_AS, sizeof( float ) );
     }
     gfl_conn[i].num_AS = 0;
   }
@@ -2504,7 +2504,7 @@ void build_connectivity_graph( void )
 
 
   /*****************************GOAL********************************/
-  gflogic_goal = ( int * ) calloc( gnum_logic_goal, sizeof( int ) );
+  gflogic_goal = ( int * ) ff_calloc( gnum_logic_goal, sizeof( int ) );
   for ( j = 0; j < gnum_logic_goal; j++ ) {
     for ( k = 0; k < gnum_flogic_goal; k++ ) {
       if ( gflogic_goal[k] == glogic_goal[j] ) break;
@@ -2514,9 +2514,9 @@ void build_connectivity_graph( void )
   }
   /* numeric part
    */
-  gfnumeric_goal_comp = ( gnum_lnf_goal ? ( Comparator * ) calloc( gnum_lnf_goal, sizeof( Comparator ) ) : NULL );
-  gfnumeric_goal_fl = ( gnum_lnf_goal ? ( int * ) calloc( gnum_lnf_goal, sizeof( int ) ) : NULL );
-  gfnumeric_goal_c = ( gnum_lnf_goal ? ( float * ) calloc( gnum_lnf_goal, sizeof( float ) ) : NULL );
+  gfnumeric_goal_comp = ( gnum_lnf_goal ? ( Comparator * ) ff_calloc( gnum_lnf_goal, sizeof( Comparator ) ) : NULL );
+  gfnumeric_goal_fl = ( gnum_lnf_goal ? ( int * ) ff_calloc( gnum_lnf_goal, sizeof( int ) ) : NULL );
+  gfnumeric_goal_c = ( gnum_lnf_goal ? ( float * ) ff_calloc( gnum_lnf_goal, sizeof( float ) ) : NULL );
   for ( j = 0; j < gnum_lnf_goal; j++ ) {
     if ( glnf_goal_lh[j]->num_pF != 1 ) {
       printf("\n\nnon 1 card. in comp lh final goal copyover.\n\n");
@@ -2541,11 +2541,11 @@ void build_connectivity_graph( void )
       gfnumeric_goal_c[gnum_fnumeric_goal++] = glnf_goal_rh[j];
     }
   }
-  gfnumeric_goal_direct_comp = ( gnum_fl_conn ? ( Comparator * ) calloc( gnum_fl_conn, sizeof( Comparator ) ) : NULL );
+  gfnumeric_goal_direct_comp = ( gnum_fl_conn ? ( Comparator * ) ff_calloc( gnum_fl_conn, sizeof( Comparator ) ) : NULL );
   for ( j = 0; j < gnum_fl_conn; j++ ) {
     gfnumeric_goal_direct_comp[j] = IGUAL;
   }
-  gfnumeric_goal_direct_c = ( gnum_fl_conn ? ( float * ) calloc( gnum_fl_conn, sizeof( float ) ) : NULL );
+  gfnumeric_goal_direct_c = ( gnum_fl_conn ? ( float * ) ff_calloc( gnum_fl_conn, sizeof( float ) ) : NULL );
   for ( k = 0; k < gnum_fnumeric_goal; k++ ) {
     gfnumeric_goal_direct_comp[gfnumeric_goal_fl[k]] = gfnumeric_goal_comp[k];
     gfnumeric_goal_direct_c[gfnumeric_goal_fl[k]] = gfnumeric_goal_c[k];
@@ -85,8 +85,8 @@
 
 /* used in multiplying routines
  */
-int linst_table[MAX_VARS];
-int_pointer lini[MAX_PREDICATES];
+#define linst_table (ff_ctx->inst_hard.linst_table)
+#define lini (ff_ctx->inst_hard.lini)
 
 
 
@@ -124,7 +124,7 @@ void build_hard_action_templates( void )
     for ( j = 0; j < garity[i]; j++ ) {
       size *= gnum_constants;
     }
-    lini[i] = ( int_pointer ) calloc( size, sizeof( int ) );
+    lini[i] = ( int_pointer ) ff_calloc( size, sizeof( int ) );
     for ( j = 0; j < size; j++ ) {
       lini[i][j] = 0;
     }
@@ -247,7 +247,7 @@ void cleanup_hard_domain( void )
 	}
 
 	if ( e->var_names[j] ) {
-	  free( e->var_names[j] );
+	  ff_free( e->var_names[j] );
 	}
 	for ( k = j; k < e->num_vars - 1; k++ ) {
 	  e->var_names[k] = e->var_names[k+1];
@@ -471,10 +471,10 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
 	  if ( ww->connective == ATOM ) m++;
 	  if ( ww->connective == COMP ) mn++;
 	}
-	tmp2->preconds = ( Fact * ) calloc( m, sizeof( Fact ) );
-	tmp2->numeric_preconds_comp = ( Comparator * ) calloc( mn, sizeof( Comparator ) );
-	tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-	tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp2->preconds = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
+	tmp2->numeric_preconds_comp = ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) );
+	tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
 	tmp2->num_preconds = m;
 	tmp2->num_numeric_preconds = mn;
 	m = 0; mn = 0;
@@ -495,7 +495,7 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
 	}
       } else {
 	if ( w->connective == ATOM ) {
-	  tmp2->preconds = ( Fact * ) calloc( 1, sizeof( Fact ) );
+	  tmp2->preconds = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
 	  tmp2->num_preconds = 1;
 	  tmp2->preconds[0].predicate = w->fact->predicate;
 	  for ( i = 0; i < garity[w->fact->predicate]; i++ ) {
@@ -503,9 +503,9 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
 	  }
 	}
 	if ( w->connective == COMP ) {
-	  tmp2->numeric_preconds_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-	  tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-	  tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_preconds_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+	  tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
 	  tmp2->numeric_preconds_comp[0] = w->comp;
 	  tmp2->numeric_preconds_lh[0] = copy_Exp( w->lh );
 	  tmp2->numeric_preconds_rh[0] = copy_Exp( w->rh );
@@ -529,12 +529,12 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
       if ( w->connective == ATOM ) m++;
       if ( w->connective == COMP ) mn++;
     }
-    tmp2->preconds = ( Fact * ) calloc( m, sizeof( Fact ) );
+    tmp2->preconds = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
     if(mn!=0)
 	{
-	  tmp2->numeric_preconds_comp = ( Comparator * ) calloc( mn, sizeof( Comparator ) );
-	  tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-	  tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_preconds_comp = ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) );
+	  tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
 	}
     else
 	{
@@ -571,7 +571,7 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
     for ( i = 0; i < o->num_vars; i++ ) {
       tmp2->inst_table[i] = linst_table[i];
     }
-    tmp2->preconds = ( Fact * ) calloc( 1, sizeof( Fact ) );
+    tmp2->preconds = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
     tmp2->num_preconds = 1;
     tmp2->preconds[0].predicate = tmp1->fact->predicate;
     for ( i = 0; i < garity[tmp1->fact->predicate]; i++ ) {
@@ -587,9 +587,9 @@ void create_hard_mixed_operators( PDDLOperator *o, int curr_var )
     for ( i = 0; i < o->num_vars; i++ ) {
       tmp2->inst_table[i] = linst_table[i];
     }
-    tmp2->numeric_preconds_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-    tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-    tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+    tmp2->numeric_preconds_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+    tmp2->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+    tmp2->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
     tmp2->numeric_preconds_comp[0] = tmp1->comp;
     tmp2->numeric_preconds_lh[0] = copy_Exp( tmp1->lh );
     tmp2->numeric_preconds_rh[0] = copy_Exp( tmp1->rh );
@@ -715,7 +715,7 @@ WffNode *instantiate_wff( WffNode *w )
 	return tmp;
       }
       if ( tmp->connective == TRU ) {
-	free( tmp );
+	ff_free( tmp );
 	i = i->next;
 	continue;
       }
@@ -748,7 +748,7 @@ WffNode *instantiate_wff( WffNode *w )
 	return tmp;
       }
       if ( tmp->connective == FAL ) {
-	free( tmp );
+	ff_free( tmp );
 	i = i->next;
 	continue;
       }
@@ -790,13 +790,13 @@ WffNode *instantiate_wff( WffNode *w )
       break;
     }
     if ( !full_possibly_negative( res->fact ) ) {
-      free( res->fact );
+      ff_free( res->fact );
       res->fact = NULL;
       res->connective = TRU;
       break;
     }
     if ( !full_possibly_positive( res->fact ) ) {
-      free( res->fact );
+      ff_free( res->fact );
       res->fact = NULL;
       res->connective = FAL;
       break;
@@ -1076,7 +1076,7 @@ void multiply_hard_effect_parameters( void )
 	}
 	
   ghard_templates = ( PseudoAction_pointer * ) 
-    calloc( gnum_hard_mixed_operators, sizeof ( PseudoAction_pointer ) );
+    ff_calloc( gnum_hard_mixed_operators, sizeof ( PseudoAction_pointer ) );
   gnum_hard_templates = 0;
 
   for ( o = ghard_mixed_operators; o; o = o->next ) {
@@ -1147,10 +1147,10 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
 	  if ( ww->connective == ATOM ) m++;
 	  if ( ww->connective == COMP ) mn++;
 	}
-	tmp2->conditions = ( Fact * ) calloc( m, sizeof( Fact ) );
-	tmp2->numeric_conditions_comp = ( Comparator * ) calloc( mn, sizeof( Comparator ) );
-	tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-	tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp2->conditions = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
+	tmp2->numeric_conditions_comp = ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) );
+	tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
 	tmp2->num_conditions = m;
 	tmp2->num_numeric_conditions = mn;
 	m = 0; mn = 0;
@@ -1171,7 +1171,7 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
 	}
       } else {
 	if ( w->connective == ATOM ) {
-	  tmp2->conditions = ( Fact * ) calloc( 1, sizeof( Fact ) );
+	  tmp2->conditions = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
 	  tmp2->num_conditions = 1;
 	  tmp2->conditions[0].predicate = w->fact->predicate;
 	  for ( i = 0; i < garity[w->fact->predicate]; i++ ) {
@@ -1179,9 +1179,9 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
 	  }
 	}
  	if ( w->connective == COMP ) {
-	  tmp2->numeric_conditions_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-	  tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-	  tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_conditions_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+	  tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+	  tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
 	  tmp2->numeric_conditions_comp[0] = w->comp;
 	  tmp2->numeric_conditions_lh[0] = copy_Exp( w->lh );
 	  tmp2->numeric_conditions_rh[0] = copy_Exp( w->rh );
@@ -1203,10 +1203,10 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
       if ( w->connective == ATOM ) m++;
       if ( w->connective == COMP ) mn++;
     }
-    tmp2->conditions = ( Fact * ) calloc( m, sizeof( Fact ) );
-    tmp2->numeric_conditions_comp = ( Comparator * ) calloc( mn, sizeof( Comparator ) );
-    tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-    tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+    tmp2->conditions = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
+    tmp2->numeric_conditions_comp = ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) );
+    tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+    tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
     tmp2->num_conditions = m;
     tmp2->num_numeric_conditions = mn;
     m = 0; mn = 0;
@@ -1233,7 +1233,7 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
     break;
   case ATOM:
     tmp2 = new_PseudoActionEffect();
-    tmp2->conditions = ( Fact * ) calloc( 1, sizeof( Fact ) );
+    tmp2->conditions = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
     tmp2->num_conditions = 1;
     tmp2->conditions[0].predicate = tmp1->fact->predicate;
     for ( i = 0; i < garity[tmp1->fact->predicate]; i++ ) {
@@ -1247,9 +1247,9 @@ void create_hard_pseudo_effects( PseudoAction *a, Effect *e, int curr_var )
     break;
   case COMP:
     tmp2 = new_PseudoActionEffect();
-    tmp2->numeric_conditions_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-    tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-    tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+    tmp2->numeric_conditions_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+    tmp2->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+    tmp2->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
     tmp2->numeric_conditions_comp[0] = tmp1->comp;
     tmp2->numeric_conditions_lh[0] = copy_Exp( tmp1->lh );
     tmp2->numeric_conditions_rh[0] = copy_Exp( tmp1->rh );
@@ -1295,8 +1295,8 @@ void make_instantiate_literals( PseudoActionEffect *e, Literal *ll )
     }
   }
 
-  e->adds = ( Fact * ) calloc( ma, sizeof( Fact ) );
-  e->dels = ( Fact * ) calloc( md, sizeof( Fact ) );
+  e->adds = ( Fact * ) ff_calloc( ma, sizeof( Fact ) );
+  e->dels = ( Fact * ) ff_calloc( md, sizeof( Fact ) );
 
   for ( l = ll; l; l = l->next ) {
     if ( l->negated ) {
@@ -1331,9 +1331,9 @@ void make_instantiate_numeric_effects( PseudoActionEffect *e, NumericEffect *ne
 
   if(m!=0)
     {
-	e->numeric_effects_neft = ( NumericEffectType * ) calloc( m, sizeof( NumericEffectType ) );
-	e->numeric_effects_fluent = ( Fluent * ) calloc( m, sizeof( Fluent ) );
-	e->numeric_effects_rh = ( ExpNode_pointer * ) calloc( m, sizeof( ExpNode_pointer ) );
+	e->numeric_effects_neft = ( NumericEffectType * ) ff_calloc( m, sizeof( NumericEffectType ) );
+	e->numeric_effects_fluent = ( Fluent * ) ff_calloc( m, sizeof( Fluent ) );
+	e->numeric_effects_rh = ( ExpNode_pointer * ) ff_calloc( m, sizeof( ExpNode_pointer ) );
     }
   else
     {
@@ -113,8 +113,8 @@
 
 
 
-char *lvar_names[MAX_VARS];
-int lvar_types[MAX_VARS];
+#define lvar_names (ff_ctx->inst_pre.lvar_names)
+#define lvar_types (ff_ctx->inst_pre.lvar_types)
 
 
 
@@ -445,9 +445,9 @@ void create_integer_representation( void )
     sum = 0;
     for ( n = gorig_initial_facts->sons; n; n = n->next ) sum++;
     sum += gnum_constants;/* space for equalities */
-    gfull_initial = ( Fact * ) calloc( sum, sizeof( Fact ) );
+    gfull_initial = ( Fact * ) ff_calloc( sum, sizeof( Fact ) );
     gfull_fluents_initial = ( FluentValue * ) 
-      calloc( sum, sizeof( FluentValue ));
+      ff_calloc( sum, sizeof( FluentValue ));
 
     for ( n = gorig_initial_facts->sons; n; n = n->next ) {
       if ( n->connective == ATOM ) {
@@ -1158,8 +1158,8 @@ void split_initial_state( void )
   /* double size of predicates table as each predicate might need
    * to be translated to NOT-p
    */
-  ginitial_predicate = ( Fact ** ) calloc( gnum_predicates * 2, sizeof( Fact * ) );
-  gnum_initial_predicate = ( int * ) calloc( gnum_predicates * 2, sizeof( int ) );
+  ginitial_predicate = ( Fact ** ) ff_calloc( gnum_predicates * 2, sizeof( Fact * ) );
+  gnum_initial_predicate = ( int * ) ff_calloc( gnum_predicates * 2, sizeof( int ) );
   for ( i = 0; i < gnum_predicates * 2; i++ ) {
     gnum_initial_predicate[i] = 0;
   }
@@ -1168,7 +1168,7 @@ void split_initial_state( void )
     gnum_initial_predicate[p]++;
   }
   for ( i = 0; i < gnum_predicates; i++ ) {
-    ginitial_predicate[i] = ( gnum_initial_predicate[i] ? ( Fact * ) calloc( gnum_initial_predicate[i], sizeof( Fact ) ) : NULL );
+    ginitial_predicate[i] = ( gnum_initial_predicate[i] ? ( Fact * ) ff_calloc( gnum_initial_predicate[i], sizeof( Fact ) ) : NULL );
     gnum_initial_predicate[i] = 0;
   }
   ginitial = NULL;
@@ -1211,8 +1211,8 @@ void split_initial_state( void )
   }
 
   ginitial_function = ( FluentValue ** ) 
-    calloc( gnum_functions, sizeof( FluentValue * ) );
-  gnum_initial_function = ( int * ) calloc( gnum_functions, sizeof( int ) );
+    ff_calloc( gnum_functions, sizeof( FluentValue * ) );
+  gnum_initial_function = ( int * ) ff_calloc( gnum_functions, sizeof( int ) );
   for ( i = 0; i < gnum_functions; i++ ) {
     gnum_initial_function[i] = 0;
   }
@@ -1222,7 +1222,7 @@ void split_initial_state( void )
   }
   for ( i = 0; i < gnum_functions; i++ ) {
     ginitial_function[i] = ( gnum_initial_function[i] ? ( FluentValue * ) 
-      calloc( gnum_initial_function[i], sizeof( FluentValue ) ) : NULL);
+      ff_calloc( gnum_initial_function[i], sizeof( FluentValue ) ) : NULL);
     gnum_initial_function[i] = 0;
   }
   gf_initial = NULL;
@@ -1370,12 +1370,12 @@ void remove_unused_vars_in_wff( WffNode **w )
       (*w)->var = (*w)->son->var;
       (*w)->var_type = (*w)->son->var_type;
       if ( (*w)->var_name ) {
-	free( (*w)->var_name );
+	ff_free( (*w)->var_name );
       }
       (*w)->var_name = (*w)->son->var_name;
       (*w)->sons = (*w)->son->sons;
       if ( (*w)->fact ) {
-	free( (*w)->fact );
+	ff_free( (*w)->fact );
       }
       (*w)->fact = (*w)->son->fact;
       (*w)->comp = (*w)->son->comp;
@@ -1386,7 +1386,7 @@ void remove_unused_vars_in_wff( WffNode **w )
 
       tmp = (*w)->son;
       (*w)->son = (*w)->son->son;
-      free( tmp );
+      ff_free( tmp );
     }
     break;
   case AND:
@@ -1624,10 +1624,10 @@ void simplify_wff( WffNode **w )
     if ( (*w)->son->connective == TRU ||
 	 (*w)->son->connective == FAL ) {
       (*w)->connective = (*w)->son->connective;
-      free( (*w)->son );
+      ff_free( (*w)->son );
       (*w)->son = NULL;
       if ( (*w)->var_name ) {
-	free( (*w)->var_name );
+	ff_free( (*w)->var_name );
       }
     }
     break;
@@ -1653,7 +1653,7 @@ void simplify_wff( WffNode **w )
 	}
 	tmp = i;
 	i = i->next;
-	free( tmp );
+	ff_free( tmp );
 	continue;
       }
       i = i->next;
@@ -1669,12 +1669,12 @@ void simplify_wff( WffNode **w )
       (*w)->var = (*w)->sons->var;
       (*w)->var_type = (*w)->sons->var_type;
       if ( (*w)->var_name ) {
-	free( (*w)->var_name );
+	ff_free( (*w)->var_name );
       }
       (*w)->var_name = (*w)->sons->var_name;
       (*w)->son = (*w)->sons->son;
       if ( (*w)->fact ) {
-	free( (*w)->fact );
+	ff_free( (*w)->fact );
       }
       (*w)->fact = (*w)->sons->fact;
       (*w)->comp = (*w)->sons->comp;
@@ -1685,7 +1685,7 @@ void simplify_wff( WffNode **w )
 
       tmp = (*w)->sons;
       (*w)->sons = (*w)->sons->sons;
-      free( tmp );
+      ff_free( tmp );
     }
     break;
   case OR:
@@ -1710,7 +1710,7 @@ void simplify_wff( WffNode **w )
 	}
 	tmp = i;
 	i = i->next;
-	free( tmp );
+	ff_free( tmp );
 	continue;
       }
       i = i->next;
@@ -1726,12 +1726,12 @@ void simplify_wff( WffNode **w )
       (*w)->var = (*w)->sons->var;
       (*w)->var_type = (*w)->sons->var_type;
       if ( (*w)->var_name ) {
-	free( (*w)->var_name );
+	ff_free( (*w)->var_name );
       }
       (*w)->var_name = (*w)->sons->var_name;
       (*w)->son = (*w)->sons->son;
       if ( (*w)->fact ) {
-	free( (*w)->fact );
+	ff_free( (*w)->fact );
       }
       (*w)->fact = (*w)->sons->fact;
       (*w)->comp = (*w)->sons->comp;
@@ -1742,7 +1742,7 @@ void simplify_wff( WffNode **w )
 
       tmp = (*w)->sons;
       (*w)->sons = (*w)->sons->sons;
-      free( tmp );
+      ff_free( tmp );
     }
     break;
   case NOT:
@@ -1750,7 +1750,7 @@ void simplify_wff( WffNode **w )
     if ( (*w)->son->connective == TRU ||
 	 (*w)->son->connective == FAL ) {
       (*w)->connective = ( (*w)->son->connective == TRU ) ? FAL : TRU;
-      free( (*w)->son );
+      ff_free( (*w)->son );
       (*w)->son = NULL;
     }
     break;
@@ -1762,13 +1762,13 @@ void simplify_wff( WffNode **w )
     }
     if ( !possibly_negative( (*w)->fact ) ) {
       (*w)->connective = TRU;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
     if ( !possibly_positive( (*w)->fact ) ) {
       (*w)->connective = FAL;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
@@ -1972,7 +1972,7 @@ void expand_quantifiers_in_wff( WffNode **w, int var, int constant )
     (*w)->var = -1;
     (*w)->var_type = -1;
     if ( (*w)->var_name ) {
-      free( (*w)->var_name );
+      ff_free( (*w)->var_name );
     }
     (*w)->var_name = NULL;
 
@@ -2011,13 +2011,13 @@ void expand_quantifiers_in_wff( WffNode **w, int var, int constant )
     }
     if ( !possibly_negative( (*w)->fact ) ) {
       (*w)->connective = TRU;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
     if ( !possibly_positive( (*w)->fact ) ) {
       (*w)->connective = FAL;
-      free( (*w)->fact );
+      ff_free( (*w)->fact );
       (*w)->fact = NULL;
       break;
     }
@@ -2413,9 +2413,9 @@ void detect_tautologies_in_wff( WffNode **w )
 	  tmp = j;
 	  j = j->next;
 	  if ( tmp->fact ) {
-	    free( tmp->fact );
+	    ff_free( tmp->fact );
 	  }
-	  free( tmp );
+	  ff_free( tmp );
 	  continue;
 	}
 	if ( i->connective == NOT &&
@@ -2509,7 +2509,7 @@ void merge_ANDs_and_ORs_in_wff( WffNode **w )
 	  }
 	  tmp = i;
 	  i = i->next;
-	  free( tmp );
+	  ff_free( tmp );
 	  continue;
 	}
 	for ( j = i->sons; j->next; j = j->next );
@@ -2525,7 +2525,7 @@ void merge_ANDs_and_ORs_in_wff( WffNode **w )
 	}
 	tmp = i;
 	i = i->next;
-	free( tmp );
+	ff_free( tmp );
 	continue;
       }
       i = i->next;
@@ -2582,8 +2582,8 @@ void NOTs_down_in_wff( WffNode **w )
        * otherwise the resp. father, (*w)->son, would have been an
        * AND or OR
        */
-      free( tmp1 );
-      free( tmp2 );
+      ff_free( tmp1 );
+      ff_free( tmp2 );
       NOTs_down_in_wff( w );
       break;
     }
@@ -2591,7 +2591,7 @@ void NOTs_down_in_wff( WffNode **w )
 	 (*w)->son->connective == OR ) {
       (*w)->connective = ( (*w)->son->connective == AND ) ? OR : AND;
       (*w)->sons = (*w)->son->sons;
-      free( (*w)->son );
+      ff_free( (*w)->son );
       (*w)->son = NULL;
       for ( i = (*w)->sons; i; i = i->next ) {
 	tmp1 = new_WffNode( i->connective );
@@ -2635,7 +2635,7 @@ void NOTs_down_in_wff( WffNode **w )
 		 (*w)->son->comp);
 	  exit( 1 );
 	}
-	free( (*w)->son );
+	ff_free( (*w)->son );
 	(*w)->son = NULL;
       } else {
 	(*w)->connective = OR;
@@ -2686,7 +2686,7 @@ void NOTs_down_in_wff( WffNode **w )
 
 
 
-int lconsts[MAX_ARITY];
+#define lconsts (ff_ctx->inst_pre.lconsts)
 
 
 
@@ -2829,7 +2829,7 @@ Bool translate_one_negative_cond( WffNode *w )
   for ( j = 0; j < garity[gnum_predicates]; j++ ) {
     m *= gtype_size[gpredicates_args_type[gnum_predicates][j]];
   }
-  ginitial_predicate[gnum_predicates] = ( Fact * ) calloc( m, sizeof( Fact ) );
+  ginitial_predicate[gnum_predicates] = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
   gnum_predicates++;
 
 
@@ -2901,7 +2901,7 @@ void replace_not_p_with_n_in_wff( int p, int n, WffNode **w )
       (*w)->NOT_p = p;
       (*w)->fact = (*w)->son->fact;
       (*w)->fact->predicate = n;
-      free( (*w)->son );
+      ff_free( (*w)->son );
       (*w)->son = NULL;
     }
     break;
@@ -3026,9 +3026,9 @@ void split_domain( void )
     }
   }
 
-  ghard_operators = ( PDDLOperator_pointer * ) calloc( MAX_OPERATORS, sizeof( PDDLOperator ) );
+  ghard_operators = ( PDDLOperator_pointer * ) ff_calloc( MAX_OPERATORS, sizeof( PDDLOperator ) );
   gnum_hard_operators = 0; 
-  geasy_operators = ( NormOperator_pointer * ) calloc( s, sizeof( NormOperator_pointer ) );
+  geasy_operators = ( NormOperator_pointer * ) ff_calloc( s, sizeof( NormOperator_pointer ) );
   gnum_easy_operators = 0;
 
   for ( i = 0; i < gnum_operators; i++ ) {
@@ -3048,10 +3048,10 @@ void split_domain( void )
 	    if ( www->connective == ATOM ) m++;
 	    if ( www->connective == COMP ) mn++;
 	  }
-	  tmp_op->preconds = ( Fact * ) calloc( m, sizeof( Fact ) );
-	  tmp_op->numeric_preconds_comp = ( Comparator * ) calloc( mn, sizeof( Comparator ) );
-	  tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-	  tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+	  tmp_op->preconds = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
+	  tmp_op->numeric_preconds_comp = ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) );
+	  tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+	  tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
 	  for ( www = ww->sons; www; www = www->next ) {
 	    if ( www->connective == ATOM ) {
 	      tmp_ft = &(tmp_op->preconds[tmp_op->num_preconds]);
@@ -3070,7 +3070,7 @@ void split_domain( void )
 	  }
 	} else {
 	  if ( ww->connective == ATOM ) {
-	    tmp_op->preconds = ( Fact * ) calloc( 1, sizeof( Fact ) );
+	    tmp_op->preconds = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
 	    tmp_ft = &(tmp_op->preconds[0]);
 	    tmp_ft->predicate = ww->fact->predicate;
 	    for ( j = 0; j < garity[tmp_ft->predicate]; j++ ) {
@@ -3079,9 +3079,9 @@ void split_domain( void )
 	    tmp_op->num_preconds = 1;
 	  }
 	  if ( ww->connective == COMP ) {
-	    tmp_op->numeric_preconds_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-	    tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-	    tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+	    tmp_op->numeric_preconds_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+	    tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+	    tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
 	    tmp_op->numeric_preconds_comp[0] = ww->comp;
 	    tmp_op->numeric_preconds_lh[0] = copy_Exp( ww->lh );
 	    tmp_op->numeric_preconds_rh[0] = copy_Exp( ww->rh );
@@ -3101,11 +3101,11 @@ void split_domain( void )
 	if ( ww->connective == COMP ) mn++;
       }
 	
-      if ( m ) tmp_op->preconds = ( Fact * ) calloc( m, sizeof( Fact ) );
+      if ( m ) tmp_op->preconds = ( Fact * ) ff_calloc( m, sizeof( Fact ) );
       if ( mn ) {
-	tmp_op->numeric_preconds_comp = (Comparator * ) calloc( mn, sizeof( Comparator ));
-	tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
-	tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp_op->numeric_preconds_comp = (Comparator * ) ff_calloc( mn, sizeof( Comparator ));
+	tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
+	tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) );
       }
       for ( ww = w->sons; ww; ww = ww->next ) {
 	if ( ww->connective == ATOM ) {
@@ -3128,7 +3128,7 @@ void split_domain( void )
       break;
     case ATOM:
       tmp_op = new_NormOperator( goperators[i] );
-      tmp_op->preconds = ( Fact * ) calloc( 1, sizeof( Fact ) );
+      tmp_op->preconds = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
       tmp_ft = &(tmp_op->preconds[0]);
       tmp_ft->predicate = w->fact->predicate;
       for ( j = 0; j < garity[tmp_ft->predicate]; j++ ) {
@@ -3140,9 +3140,9 @@ void split_domain( void )
       break;
     case COMP:
       tmp_op = new_NormOperator( goperators[i] );
-      tmp_op->numeric_preconds_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-      tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-      tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+      tmp_op->numeric_preconds_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+      tmp_op->numeric_preconds_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+      tmp_op->numeric_preconds_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
       tmp_op->numeric_preconds_comp[0] = w->comp;
       tmp_op->numeric_preconds_lh[0] = copy_Exp( w->lh );
       tmp_op->numeric_preconds_rh[0] = copy_Exp( w->rh );
@@ -3258,10 +3258,10 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	    if ( www->connective == ATOM ) m++;
 	    if ( www->connective == COMP ) mn++;
 	  }
-	  tmp_ef->conditions = ( m ? ( Fact * ) calloc( m, sizeof( Fact ) ) : NULL );
-	  tmp_ef->numeric_conditions_comp = ( mn ? ( Comparator * ) calloc( mn, sizeof( Comparator ) ) : NULL);
-	  tmp_ef->numeric_conditions_lh = ( mn ? ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) : NULL);
-	  tmp_ef->numeric_conditions_rh = ( mn ? ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) : NULL);
+	  tmp_ef->conditions = ( m ? ( Fact * ) ff_calloc( m, sizeof( Fact ) ) : NULL );
+	  tmp_ef->numeric_conditions_comp = ( mn ? ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) ) : NULL);
+	  tmp_ef->numeric_conditions_lh = ( mn ? ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) : NULL);
+	  tmp_ef->numeric_conditions_rh = ( mn ? ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) : NULL);
 	  for ( www = ww->sons; www; www = www->next ) {
 	    if ( www->connective == ATOM ) {
 	      tmp_ft = &(tmp_ef->conditions[tmp_ef->num_conditions]);
@@ -3280,7 +3280,7 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	  }
 	} else {
 	  if ( ww->connective == ATOM ) {
-	    tmp_ef->conditions = ( Fact * ) calloc( 1, sizeof( Fact ) );
+	    tmp_ef->conditions = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
 	    tmp_ft = &(tmp_ef->conditions[0]);
 	    tmp_ft->predicate = ww->fact->predicate;
 	    for ( j = 0; j < garity[tmp_ft->predicate]; j++ ) {
@@ -3289,9 +3289,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	    tmp_ef->num_conditions = 1;
 	  }
 	  if ( ww->connective == COMP ) {
-	    tmp_ef->numeric_conditions_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-	    tmp_ef->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-	    tmp_ef->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+	    tmp_ef->numeric_conditions_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+	    tmp_ef->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+	    tmp_ef->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
 	    tmp_ef->numeric_conditions_comp[0] = ww->comp;
 	    tmp_ef->numeric_conditions_lh[0] = copy_Exp( ww->lh );
 	    tmp_ef->numeric_conditions_rh[0] = copy_Exp( ww->rh );
@@ -3302,8 +3302,8 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	for ( l = e->effects; l; l = l->next ) {
 	  if ( l->negated ) { md++; } else { ma++; }
 	}
-	tmp_ef->adds = ( ma ? ( Fact * ) calloc( ma, sizeof( Fact ) ) : NULL );
-	tmp_ef->dels = ( md ? ( Fact * ) calloc( md, sizeof( Fact ) ) : NULL );
+	tmp_ef->adds = ( ma ? ( Fact * ) ff_calloc( ma, sizeof( Fact ) ) : NULL );
+	tmp_ef->dels = ( md ? ( Fact * ) ff_calloc( md, sizeof( Fact ) ) : NULL );
 	for ( l = e->effects; l; l = l->next ) {
 	  if ( l->negated ) {
 	    tmp_ft = &(tmp_ef->dels[tmp_ef->num_dels++]);
@@ -3317,9 +3317,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	}
 	ma = 0;
 	for ( ll = e->numeric_effects; ll; ll = ll->next ) ma++;
-	tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) calloc( ma, sizeof( NumericEffectType ) ) : NULL);
-	tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) calloc( ma, sizeof( Fluent ) ) : NULL );
-	tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
+	tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) ff_calloc( ma, sizeof( NumericEffectType ) ) : NULL);
+	tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) ff_calloc( ma, sizeof( Fluent ) ) : NULL );
+	tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) ff_calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
 	for ( ll = e->numeric_effects; ll; ll = ll->next ) {
 	  tmp_ef->numeric_effects_neft[tmp_ef->num_numeric_effects] = ll->neft;
 	  tmp_fl = &(tmp_ef->numeric_effects_fluent[tmp_ef->num_numeric_effects]);
@@ -3345,10 +3345,10 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 	if ( ww->connective == ATOM ) m++;
 	if ( ww->connective == COMP ) mn++;
       }
-      tmp_ef->conditions = ( m ? ( Fact * ) calloc( m, sizeof( Fact ) ) : NULL );
-      tmp_ef->numeric_conditions_comp = ( mn ? ( Comparator * ) calloc( mn, sizeof( Comparator ) ) : NULL );
-      tmp_ef->numeric_conditions_lh = ( mn ? ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) : NULL );
-      tmp_ef->numeric_conditions_rh = ( mn ? ( ExpNode_pointer * ) calloc( mn, sizeof( ExpNode_pointer ) ) : NULL );
+      tmp_ef->conditions = ( m ? ( Fact * ) ff_calloc( m, sizeof( Fact ) ) : NULL );
+      tmp_ef->numeric_conditions_comp = ( mn ? ( Comparator * ) ff_calloc( mn, sizeof( Comparator ) ) : NULL );
+      tmp_ef->numeric_conditions_lh = ( mn ? ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) : NULL );
+      tmp_ef->numeric_conditions_rh = ( mn ? ( ExpNode_pointer * ) ff_calloc( mn, sizeof( ExpNode_pointer ) ) : NULL );
       for ( ww = w->sons; ww; ww = ww->next ) {
 	if ( ww->connective == ATOM ) {
 	  tmp_ft = &(tmp_ef->conditions[tmp_ef->num_conditions]);
@@ -3369,8 +3369,8 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) { md++; } else { ma++; }
       }
-      tmp_ef->adds = ( ma ? ( Fact * ) calloc( ma, sizeof( Fact ) ) : NULL);
-      tmp_ef->dels = ( md ? ( Fact * ) calloc( md, sizeof( Fact ) ) : NULL);
+      tmp_ef->adds = ( ma ? ( Fact * ) ff_calloc( ma, sizeof( Fact ) ) : NULL);
+      tmp_ef->dels = ( md ? ( Fact * ) ff_calloc( md, sizeof( Fact ) ) : NULL);
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) {
 	  tmp_ft = &(tmp_ef->dels[tmp_ef->num_dels++]);
@@ -3384,9 +3384,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       }
       ma = 0;
       for ( ll = e->numeric_effects; ll; ll = ll->next ) ma++;
-      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) calloc( ma, sizeof( NumericEffectType ) ) : NULL );
-      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) calloc( ma, sizeof( Fluent ) ) : NULL );
-      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
+      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) ff_calloc( ma, sizeof( NumericEffectType ) ) : NULL );
+      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) ff_calloc( ma, sizeof( Fluent ) ) : NULL );
+      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) ff_calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
       for ( ll = e->numeric_effects; ll; ll = ll->next ) {
 	tmp_ef->numeric_effects_neft[tmp_ef->num_numeric_effects] = ll->neft;
 	tmp_fl = &(tmp_ef->numeric_effects_fluent[tmp_ef->num_numeric_effects]);
@@ -3405,7 +3405,7 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       break;
     case ATOM:
       tmp_ef = new_NormEffect1( e );
-      tmp_ef->conditions = ( Fact * ) calloc( 1, sizeof( Fact ) );
+      tmp_ef->conditions = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
       tmp_ft = &(tmp_ef->conditions[0]);
       tmp_ft->predicate = w->fact->predicate;
       for ( j = 0; j < garity[tmp_ft->predicate]; j++ ) {
@@ -3416,8 +3416,8 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) { md++; } else { ma++; }
       }
-      tmp_ef->adds = ( ma ? ( Fact * ) calloc( ma, sizeof( Fact ) ) : NULL);
-      tmp_ef->dels = ( md ? ( Fact * ) calloc( md, sizeof( Fact ) ) : NULL );
+      tmp_ef->adds = ( ma ? ( Fact * ) ff_calloc( ma, sizeof( Fact ) ) : NULL);
+      tmp_ef->dels = ( md ? ( Fact * ) ff_calloc( md, sizeof( Fact ) ) : NULL );
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) {
 	  tmp_ft = &(tmp_ef->dels[tmp_ef->num_dels++]);
@@ -3431,9 +3431,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       }
       ma = 0;
       for ( ll = e->numeric_effects; ll; ll = ll->next ) ma++;
-      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) calloc( ma, sizeof( NumericEffectType ) ) : NULL);
-      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) calloc( ma, sizeof( Fluent ) ) : NULL );
-      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) calloc( ma, sizeof( ExpNode_pointer ) ) : NULL);
+      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) ff_calloc( ma, sizeof( NumericEffectType ) ) : NULL);
+      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) ff_calloc( ma, sizeof( Fluent ) ) : NULL );
+      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) ff_calloc( ma, sizeof( ExpNode_pointer ) ) : NULL);
       for ( ll = e->numeric_effects; ll; ll = ll->next ) {
 	tmp_ef->numeric_effects_neft[tmp_ef->num_numeric_effects] = ll->neft;
 	tmp_fl = &(tmp_ef->numeric_effects_fluent[tmp_ef->num_numeric_effects]);
@@ -3452,9 +3452,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       break;     
     case COMP:
       tmp_ef = new_NormEffect1( e );
-      tmp_ef->numeric_conditions_comp = ( Comparator * ) calloc( 1, sizeof( Comparator ) );
-      tmp_ef->numeric_conditions_lh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
-      tmp_ef->numeric_conditions_rh = ( ExpNode_pointer * ) calloc( 1, sizeof( ExpNode_pointer ) );
+      tmp_ef->numeric_conditions_comp = ( Comparator * ) ff_calloc( 1, sizeof( Comparator ) );
+      tmp_ef->numeric_conditions_lh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
+      tmp_ef->numeric_conditions_rh = ( ExpNode_pointer * ) ff_calloc( 1, sizeof( ExpNode_pointer ) );
       tmp_ef->numeric_conditions_comp[0] = w->comp;
       tmp_ef->numeric_conditions_lh[0] = copy_Exp( w->lh );
       tmp_ef->numeric_conditions_rh[0] = copy_Exp( w->rh );
@@ -3463,8 +3463,8 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) { md++; } else { ma++; }
       }
-      tmp_ef->adds = ( ma ? ( Fact * ) calloc( ma, sizeof( Fact ) ) : NULL );
-      tmp_ef->dels = ( ma ? ( Fact * ) calloc( md, sizeof( Fact ) ) : NULL );
+      tmp_ef->adds = ( ma ? ( Fact * ) ff_calloc( ma, sizeof( Fact ) ) : NULL );
+      tmp_ef->dels = ( ma ? ( Fact * ) ff_calloc( md, sizeof( Fact ) ) : NULL );
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) {
 	  tmp_ft = &(tmp_ef->dels[tmp_ef->num_dels++]);
@@ -3478,9 +3478,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       }
       ma = 0;
       for ( ll = e->numeric_effects; ll; ll = ll->next ) ma++;
-      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) calloc( ma, sizeof( NumericEffectType ) ) : NULL );
-      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) calloc( ma, sizeof( Fluent ) ) : NULL );
-      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
+      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) ff_calloc( ma, sizeof( NumericEffectType ) ) : NULL );
+      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) ff_calloc( ma, sizeof( Fluent ) ) : NULL );
+      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) ff_calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
       for ( ll = e->numeric_effects; ll; ll = ll->next ) {
 	tmp_ef->numeric_effects_neft[tmp_ef->num_numeric_effects] = ll->neft;
 	tmp_fl = &(tmp_ef->numeric_effects_fluent[tmp_ef->num_numeric_effects]);
@@ -3503,8 +3503,8 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) { md++; } else { ma++; }
       }
-      tmp_ef->adds = ( ma ? ( Fact * ) calloc( ma, sizeof( Fact ) ) : NULL );
-	tmp_ef->dels = ( md ? ( Fact * ) calloc( md, sizeof( Fact ) ) : NULL );
+      tmp_ef->adds = ( ma ? ( Fact * ) ff_calloc( ma, sizeof( Fact ) ) : NULL );
+	tmp_ef->dels = ( md ? ( Fact * ) ff_calloc( md, sizeof( Fact ) ) : NULL );
       for ( l = e->effects; l; l = l->next ) {
 	if ( l->negated ) {
 	  tmp_ft = &(tmp_ef->dels[tmp_ef->num_dels++]);
@@ -3518,9 +3518,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
       }
       ma = 0;
       for ( ll = e->numeric_effects; ll; ll = ll->next ) ma++;
-      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) calloc( ma, sizeof( NumericEffectType ) ) : NULL );
-      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) calloc( ma, sizeof( Fluent ) ) : NULL );
-      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
+      tmp_ef->numeric_effects_neft = ( ma ? ( NumericEffectType * ) ff_calloc( ma, sizeof( NumericEffectType ) ) : NULL );
+      tmp_ef->numeric_effects_fluent = ( ma ? ( Fluent * ) ff_calloc( ma, sizeof( Fluent ) ) : NULL );
+      tmp_ef->numeric_effects_rh = ( ma ? ( ExpNode_pointer * ) ff_calloc( ma, sizeof( ExpNode_pointer ) ) : NULL );
       for ( ll = e->numeric_effects; ll; ll = ll->next ) {
 	tmp_ef->numeric_effects_neft[tmp_ef->num_numeric_effects] = ll->neft;
 	tmp_fl = &(tmp_ef->numeric_effects_fluent[tmp_ef->num_numeric_effects]);
@@ -3571,9 +3571,9 @@ void make_normal_effects( NormOperator **nop, PDDLOperator *op )
 /* dnf
  */
 
-WffNode *lhitting_sets;
-WffNode_pointer *lset;
-int lmax_set;
+#define lhitting_sets (ff_ctx->inst_pre.lhitting_sets)
+#define lset (ff_ctx->inst_pre.lset)
+#define lmax_set (ff_ctx->inst_pre.lmax_set)
 
 
 
@@ -3584,13 +3584,11 @@ void dnf( WffNode **w )
 
 {
 
-  static Bool first_call = TRUE;
-
-  if ( first_call ) {
+  if ( !ff_ctx->inst_pre.dnf_called ) {
     lset = ( WffNode_pointer * ) 
-      calloc( MAX_HITTING_SET_DEFAULT, sizeof( WffNode_pointer ) );
+      ff_calloc( MAX_HITTING_SET_DEFAULT, sizeof( WffNode_pointer ) );
     lmax_set = MAX_HITTING_SET_DEFAULT;
-    first_call = FALSE;
+    ff_ctx->inst_pre.dnf_called = TRUE;
   }
 
   ANDs_below_ORs_in_wff( w );
@@ -3636,8 +3634,8 @@ void ANDs_below_ORs_in_wff( WffNode **w )
      */
     lhitting_sets = NULL;
     if ( m > lmax_set ) {
-      free( lset );
-      lset = ( WffNode_pointer * ) calloc( m, sizeof( WffNode_pointer ) );
+      ff_free( lset );
+      lset = ( WffNode_pointer * ) ff_calloc( m, sizeof( WffNode_pointer ) );
       lmax_set = m;
     }
     collect_hitting_sets( (*w)->sons, 0 );
@@ -3729,7 +3727,7 @@ void merge_next_step_ANDs_and_ORs_in_wff( WffNode **w )
 	}
 	tmp = i;
 	i = i->next;
-	free( tmp );
+	ff_free( tmp );
 	continue;
       }
       for ( j = i->sons; j->next; j = j->next );
@@ -3745,7 +3743,7 @@ void merge_next_step_ANDs_and_ORs_in_wff( WffNode **w )
       }
       tmp = i;
       i = i->next;
-      free( tmp );
+      ff_free( tmp );
       continue;
     }
     i = i->next;
@@ -626,7 +626,6 @@ int fct_pddlwrap() {
 return 1;
 }
 
-int gbracket_count = 0;
 
 
 #line 633 "lex.fct_pddl.c"
@@ -9,6 +9,15 @@
 #define EXTERN extern
 #endif
 
+struct _FF_Context;
+
+/* FF keeps the task it works on in the context of the calling thread
+ * (ff_ctx), and FF_parse_problem() makes one if there is none yet.
+ * Destroying a context releases all the memory FF used for its task.
+ */
+EXTERN struct _FF_Context*	FF_create_context( void );
+EXTERN void			FF_destroy_context( struct _FF_Context* ctx );
+
 #include "ff.h"
 
 EXTERN int	FF_parse_problem( const char* domain_file, const char* instance_file );
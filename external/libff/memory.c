@@ -69,6 +69,127 @@
 
 
 
+/**********************
+ * CONTEXT            *
+ **********************/
+
+
+
+
+
+
+
+
+
+
+
+/* header in front of every block handed out by ff_calloc(); the blocks
+ * of a context form a doubly linked list, so single ones can still be
+ * given back with ff_free(), and all the rest with the context.
+ */
+typedef struct _FF_Block {
+
+  struct _FF_Block *prev;
+  struct _FF_Block *next;
+
+} FF_Block;
+
+
+
+__thread FF_Context *ff_ctx = NULL;
+
+
+
+FF_Context *FF_create_context( void )
+
+{
+
+  FF_Context *ctx = ( FF_Context * ) calloc( 1, sizeof( FF_Context ) );
+  CHECK_PTR(ctx);
+
+  return ctx;
+
+}
+
+
+
+void FF_destroy_context( FF_Context *ctx )
+
+{
+
+  FF_Block *b, *next;
+
+  if ( !ctx ) return;
+
+  for ( b = ctx->blocks; b; b = next ) {
+    next = b->next;
+    free( b );
+  }
+  if ( ff_ctx == ctx ) {
+    ff_ctx = NULL;
+  }
+  free( ctx );
+
+}
+
+
+
+void *ff_calloc( size_t nmemb, size_t size )
+
+{
+
+  FF_Block *b;
+
+  if ( size && nmemb > ( ( size_t ) -1 - sizeof( FF_Block ) ) / size ) {
+    return NULL;
+  }
+  b = ( FF_Block * ) calloc( 1, sizeof( FF_Block ) + nmemb * size );
+  if ( !b ) {
+    return NULL;
+  }
+
+  b->prev = NULL;
+  b->next = ff_ctx->blocks;
+  if ( b->next ) {
+    b->next->prev = b;
+  }
+  ff_ctx->blocks = b;
+
+  return ( void * ) ( b + 1 );
+
+}
+
+
+
+void ff_free( void *ptr )
+
+{
+
+  FF_Block *b;
+
+  if ( !ptr ) return;
+
+  b = ( ( FF_Block * ) ptr ) - 1;
+  if ( b->prev ) {
+    b->prev->next = b->next;
+  } else {
+    ff_ctx->blocks = b->next;
+  }
+  if ( b->next ) {
+    b->next->prev = b->prev;
+  }
+  free( b );
+
+}
+
+
+
+
+
+
+
+
+
 /**********************
  * CREATION FUNCTIONS *
  **********************/
@@ -98,7 +219,7 @@ char *new_Token( int len )
 
 {
 
-  char *tok = ( char * ) calloc( len, sizeof( char ) );
+  char *tok = ( char * ) ff_calloc( len, sizeof( char ) );
   CHECK_PTR(tok);
 
   return tok;
@@ -111,7 +232,7 @@ TokenList *new_TokenList( void )
 
 {
 
-  TokenList *result = ( TokenList * ) calloc( 1, sizeof( TokenList ) );
+  TokenList *result = ( TokenList * ) ff_calloc( 1, sizeof( TokenList ) );
   CHECK_PTR(result);
 
   result->item = NULL; 
@@ -127,7 +248,7 @@ FactList *new_FactList( void )
 
 {
 
-  FactList *result = ( FactList * ) calloc( 1, sizeof( FactList ) );
+  FactList *result = ( FactList * ) ff_calloc( 1, sizeof( FactList ) );
   CHECK_PTR(result);
 
   result->item = NULL; 
@@ -143,7 +264,7 @@ TypedList *new_TypedList( void )
 
 {
 
-  TypedList *result = ( TypedList * ) calloc( 1, sizeof( TypedList ) );
+  TypedList *result = ( TypedList * ) ff_calloc( 1, sizeof( TypedList ) );
   CHECK_PTR(result);
 
   result->name = NULL; 
@@ -160,7 +281,7 @@ TypedListList *new_TypedListList( void )
 
 {
 
-  TypedListList *result = ( TypedListList * ) calloc( 1, sizeof( TypedListList ) );
+  TypedListList *result = ( TypedListList * ) ff_calloc( 1, sizeof( TypedListList ) );
   CHECK_PTR(result);
 
   result->predicate = NULL; 
@@ -176,7 +297,7 @@ ParseExpNode *new_ParseExpNode( ExpConnective c )
 
 {
 
-  ParseExpNode *result = ( ParseExpNode * ) calloc( 1, sizeof( ParseExpNode ) );
+  ParseExpNode *result = ( ParseExpNode * ) ff_calloc( 1, sizeof( ParseExpNode ) );
   CHECK_PTR(result);
 
   result->connective = c;
@@ -194,7 +315,7 @@ PlNode *new_PlNode( Connective c )
 
 {
 
-  PlNode *result = ( PlNode * ) calloc( 1, sizeof( PlNode ) );
+  PlNode *result = ( PlNode * ) ff_calloc( 1, sizeof( PlNode ) );
   CHECK_PTR(result);
 
   result->connective = c;
@@ -218,7 +339,7 @@ PlOperator *new_PlOperator( char *name )
 
 {
 
-  PlOperator *result = ( PlOperator * ) calloc( 1, sizeof( PlOperator ) );
+  PlOperator *result = ( PlOperator * ) ff_calloc( 1, sizeof( PlOperator ) );
   CHECK_PTR(result);
 
   if ( name ) {
@@ -245,22 +366,21 @@ PlOperator *new_axiom_op_list( void )
 
 {
 
-  static int count;
   char *name;
   PlOperator *ret;
 
   /* WARNING: count should not exceed 999 
    */
-  count++;
-  if ( count == 10000 ) {
+  gnum_axiom_names++;
+  if ( gnum_axiom_names == 10000 ) {
     printf("\ntoo many axioms! look into memory.c, line 157\n\n");
     exit( 1 );
   }
   name = new_Token(strlen(HIDDEN_STR)+strlen(AXIOM_STR)+4+1);
-  sprintf(name, "%s%s%4d", HIDDEN_STR, AXIOM_STR, count);
+  sprintf(name, "%s%s%4d", HIDDEN_STR, AXIOM_STR, gnum_axiom_names);
 
   ret = new_PlOperator(name);
-  free(name);
+  ff_free(name);
 
   return ret;
 
@@ -296,7 +416,7 @@ Fact *new_Fact( void )
 
 {
 
-  Fact *result = ( Fact * ) calloc( 1, sizeof( Fact ) );
+  Fact *result = ( Fact * ) ff_calloc( 1, sizeof( Fact ) );
   CHECK_PTR(result);
 
   return result;
@@ -309,7 +429,7 @@ Fluent *new_Fluent( void )
 
 {
 
-  Fluent *result = ( Fluent * ) calloc( 1, sizeof( Fluent ) );
+  Fluent *result = ( Fluent * ) ff_calloc( 1, sizeof( Fluent ) );
   CHECK_PTR(result);
 
   return result;
@@ -322,7 +442,7 @@ FluentValue *new_FluentValue( void )
 
 {
 
-  FluentValue *result = ( FluentValue * ) calloc( 1, sizeof( FluentValue ) );
+  FluentValue *result = ( FluentValue * ) ff_calloc( 1, sizeof( FluentValue ) );
   CHECK_PTR(result);
 
   return result;
@@ -335,7 +455,7 @@ Facts *new_Facts( void )
 
 {
 
-  Facts *result = ( Facts * ) calloc( 1, sizeof( Facts ) );
+  Facts *result = ( Facts * ) ff_calloc( 1, sizeof( Facts ) );
   CHECK_PTR(result);
 
   result->fact = new_Fact();
@@ -352,7 +472,7 @@ FluentValues *new_FluentValues( void )
 
 {
 
-  FluentValues *result = ( FluentValues * ) calloc( 1, sizeof( FluentValues ) );
+  FluentValues *result = ( FluentValues * ) ff_calloc( 1, sizeof( FluentValues ) );
   CHECK_PTR(result);
 
   result->next = NULL;
@@ -367,7 +487,7 @@ ExpNode *new_ExpNode( ExpConnective c )
 
 {
 
-  ExpNode *result = ( ExpNode * ) calloc( 1, sizeof( ExpNode ) );
+  ExpNode *result = ( ExpNode * ) ff_calloc( 1, sizeof( ExpNode ) );
   CHECK_PTR(result);
 
   result->connective = c;
@@ -388,7 +508,7 @@ WffNode *new_WffNode( Connective c )
 
 {
 
-  WffNode *result = ( WffNode * ) calloc( 1, sizeof( WffNode ) );
+  WffNode *result = ( WffNode * ) ff_calloc( 1, sizeof( WffNode ) );
   CHECK_PTR(result);
 
   result->connective = c;
@@ -422,7 +542,7 @@ Literal *new_Literal( void )
 
 {
 
-  Literal *result = ( Literal * ) calloc( 1, sizeof( Literal ) );
+  Literal *result = ( Literal * ) ff_calloc( 1, sizeof( Literal ) );
   CHECK_PTR(result);
 
   result->next = NULL;
@@ -438,7 +558,7 @@ NumericEffect *new_NumericEffect( void )
 
 {
 
-  NumericEffect *result = ( NumericEffect * ) calloc( 1, sizeof( NumericEffect ) );
+  NumericEffect *result = ( NumericEffect * ) ff_calloc( 1, sizeof( NumericEffect ) );
   CHECK_PTR(result);
 
   result->rh = NULL;
@@ -456,7 +576,7 @@ Effect *new_Effect( void )
 
 {
 
-  Effect *result = ( Effect * ) calloc( 1, sizeof( Effect ) );
+  Effect *result = ( Effect * ) ff_calloc( 1, sizeof( Effect ) );
   CHECK_PTR(result);
 
   result->num_vars = 0;
@@ -481,7 +601,7 @@ PDDLOperator *new_Operator( char *name, int norp )
 
   int i;
 
-  PDDLOperator *result = ( PDDLOperator * ) calloc( 1, sizeof( PDDLOperator ) );
+  PDDLOperator *result = ( PDDLOperator * ) ff_calloc( 1, sizeof( PDDLOperator ) );
   CHECK_PTR(result);
 
   if ( name ) {
@@ -517,7 +637,7 @@ NormEffect *new_NormEffect1( Effect *e )
 
   int i;
 
-  NormEffect *result = ( NormEffect * ) calloc( 1, sizeof( NormEffect ) );
+  NormEffect *result = ( NormEffect * ) ff_calloc( 1, sizeof( NormEffect ) );
   CHECK_PTR(result);
 
   result->num_vars = e->num_vars;
@@ -559,12 +679,12 @@ NormEffect *new_NormEffect2( NormEffect *e )
 
   int i, j;
 
-  NormEffect *result = ( NormEffect * ) calloc( 1, sizeof( NormEffect ) );
+  NormEffect *result = ( NormEffect * ) ff_calloc( 1, sizeof( NormEffect ) );
   CHECK_PTR(result);
 
   result->num_vars = 0;
 
-  result->conditions = ( e->num_conditions ? ( Fact * ) calloc( e->num_conditions, sizeof( Fact ) ) : NULL );
+  result->conditions = ( e->num_conditions ? ( Fact * ) ff_calloc( e->num_conditions, sizeof( Fact ) ) : NULL );
   result->num_conditions = e->num_conditions;
   for ( i = 0; i < e->num_conditions; i++ ) {
     result->conditions[i].predicate = e->conditions[i].predicate;
@@ -572,7 +692,7 @@ NormEffect *new_NormEffect2( NormEffect *e )
       result->conditions[i].args[j] = e->conditions[i].args[j];
     }
   }
-  result->adds = ( e->num_adds ? ( Fact * ) calloc( e->num_adds, sizeof( Fact ) ) : NULL );
+  result->adds = ( e->num_adds ? ( Fact * ) ff_calloc( e->num_adds, sizeof( Fact ) ) : NULL );
   result->num_adds = e->num_adds;
   for ( i = 0; i < e->num_adds; i++ ) {
     result->adds[i].predicate = e->adds[i].predicate;
@@ -580,7 +700,7 @@ NormEffect *new_NormEffect2( NormEffect *e )
       result->adds[i].args[j] = e->adds[i].args[j];
     }
   }
-  result->dels = ( e->num_dels ? ( Fact * ) calloc( e->num_dels, sizeof( Fact ) ) : NULL );
+  result->dels = ( e->num_dels ? ( Fact * ) ff_calloc( e->num_dels, sizeof( Fact ) ) : NULL );
   result->num_dels = e->num_dels;
   for ( i = 0; i < e->num_dels; i++ ) {
     result->dels[i].predicate = e->dels[i].predicate;
@@ -590,11 +710,11 @@ NormEffect *new_NormEffect2( NormEffect *e )
   }
 
   result->numeric_conditions_comp = ( e->num_numeric_conditions ? 
-	( Comparator * ) calloc( e->num_numeric_conditions, sizeof( Comparator ) ) : NULL );
+	( Comparator * ) ff_calloc( e->num_numeric_conditions, sizeof( Comparator ) ) : NULL );
   result->numeric_conditions_lh = ( e->num_numeric_conditions ? 
-	( ExpNode_pointer * ) calloc( e->num_numeric_conditions, sizeof( ExpNode_pointer ) ) : NULL );
+	( ExpNode_pointer * ) ff_calloc( e->num_numeric_conditions, sizeof( ExpNode_pointer ) ) : NULL );
   result->numeric_conditions_rh = ( e->num_numeric_conditions ? 
-	( ExpNode_pointer * ) calloc( e->num_numeric_conditions, sizeof( ExpNode_pointer ) ) : NULL );
+	( ExpNode_pointer * ) ff_calloc( e->num_numeric_conditions, sizeof( ExpNode_pointer ) ) : NULL );
 
   for ( i = 0; i < e->num_numeric_conditions; i++ ) {
     result->numeric_conditions_comp[i] = e->numeric_conditions_comp[i];
@@ -605,11 +725,11 @@ NormEffect *new_NormEffect2( NormEffect *e )
   result->num_numeric_conditions = e->num_numeric_conditions;
 
   result->numeric_effects_neft = ( e->num_numeric_effects ? 
-	( NumericEffectType * ) calloc( e->num_numeric_effects, sizeof( NumericEffectType ) ) : NULL );
+	( NumericEffectType * ) ff_calloc( e->num_numeric_effects, sizeof( NumericEffectType ) ) : NULL );
   result->numeric_effects_fluent = ( e->num_numeric_effects ? 
-	( Fluent * ) calloc( e->num_numeric_effects, sizeof( Fluent ) ) : NULL);
+	( Fluent * ) ff_calloc( e->num_numeric_effects, sizeof( Fluent ) ) : NULL);
   result->numeric_effects_rh = ( e->num_numeric_effects ? 
-	( ExpNode_pointer * ) calloc( e->num_numeric_effects, sizeof( ExpNode_pointer ) ) : NULL );
+	( ExpNode_pointer * ) ff_calloc( e->num_numeric_effects, sizeof( ExpNode_pointer ) ) : NULL );
 
   for ( i = 0; i < e->num_numeric_effects; i++ ) {
     result->numeric_effects_neft[i] = e->numeric_effects_neft[i];
@@ -636,7 +756,7 @@ NormOperator *new_NormOperator( PDDLOperator *op )
 
   int i;
 
-  NormOperator *result = ( NormOperator * ) calloc( 1, sizeof( NormOperator ) );
+  NormOperator *result = ( NormOperator * ) ff_calloc( 1, sizeof( NormOperator ) );
   CHECK_PTR(result);
 
   result->pddloperator = op;
@@ -669,7 +789,7 @@ EasyTemplate *new_EasyTemplate( NormOperator *op )
 
 {
 
-  EasyTemplate *result = ( EasyTemplate * ) calloc( 1, sizeof( EasyTemplate ) );
+  EasyTemplate *result = ( EasyTemplate * ) ff_calloc( 1, sizeof( EasyTemplate ) );
   CHECK_PTR(result);
 
   result->op = op;
@@ -687,7 +807,7 @@ MixedOperator *new_MixedOperator( PDDLOperator *op )
 
 {
 
-  MixedOperator *result = ( MixedOperator * ) calloc( 1, sizeof( MixedOperator ) );
+  MixedOperator *result = ( MixedOperator * ) ff_calloc( 1, sizeof( MixedOperator ) );
   CHECK_PTR(result);
 
   result->pddloperator = op;
@@ -708,7 +828,7 @@ PseudoActionEffect *new_PseudoActionEffect( void )
 {
 
   PseudoActionEffect *result = 
-    ( PseudoActionEffect * ) calloc( 1, sizeof( PseudoActionEffect ) );
+    ( PseudoActionEffect * ) ff_calloc( 1, sizeof( PseudoActionEffect ) );
   CHECK_PTR(result);
 
   result->conditions = NULL;
@@ -743,7 +863,7 @@ PseudoAction *new_PseudoAction( MixedOperator *op )
 
   int i;
 
-  PseudoAction *result = ( PseudoAction * ) calloc( 1, sizeof( PseudoAction ) );
+  PseudoAction *result = ( PseudoAction * ) ff_calloc( 1, sizeof( PseudoAction ) );
   CHECK_PTR(result);
 
   result->pddloperator = op->pddloperator;
@@ -772,7 +892,7 @@ LnfExpNode *new_LnfExpNode( void )
 
 {
 
-  LnfExpNode *result = ( LnfExpNode * ) calloc( 1, sizeof( LnfExpNode ) );
+  LnfExpNode *result = ( LnfExpNode * ) ff_calloc( 1, sizeof( LnfExpNode ) );
   CHECK_PTR(result);
 
   result->num_pF = 0;
@@ -790,7 +910,7 @@ Action *new_Action( void )
 
 {
 
-  Action *result = ( Action * ) calloc( 1, sizeof( Action ) );
+  Action *result = ( Action * ) ff_calloc( 1, sizeof( Action ) );
   CHECK_PTR(result);
 
   result->norm_operator = NULL;
@@ -810,9 +930,9 @@ void make_state( State *pointer, int ft, int fl )
 
   int i;
 
-  pointer->F = ( int * ) calloc( ft, sizeof( int ) ); 
-  pointer->f_D = ( Bool * ) calloc( fl, sizeof( Bool ) ); 
-  pointer->f_V = ( float * ) calloc( fl, sizeof( float ) );
+  pointer->F = ( int * ) ff_calloc( ft, sizeof( int ) ); 
+  pointer->f_D = ( Bool * ) ff_calloc( fl, sizeof( Bool ) ); 
+  pointer->f_V = ( float * ) ff_calloc( fl, sizeof( float ) );
 
   for ( i = 0; i < fl; i++ ) {
     pointer->f_D[i] = FALSE;
@@ -828,7 +948,7 @@ EhcNode *new_EhcNode( void )
 
 {
 
-  EhcNode *result = ( EhcNode * ) calloc( 1, sizeof( EhcNode ) );
+  EhcNode *result = ( EhcNode * ) ff_calloc( 1, sizeof( EhcNode ) );
   CHECK_PTR(result);
 
   make_state( &(result->S), gnum_ft_conn, gnum_fl_conn );
@@ -846,7 +966,7 @@ EhcHashEntry *new_EhcHashEntry( void )
 
 {
 
-  EhcHashEntry *result = ( EhcHashEntry * ) calloc( 1, sizeof( EhcHashEntry ) );
+  EhcHashEntry *result = ( EhcHashEntry * ) ff_calloc( 1, sizeof( EhcHashEntry ) );
   CHECK_PTR(result);
 
   result->ehc_node = NULL;
@@ -863,7 +983,7 @@ PlanHashEntry *new_PlanHashEntry( void )
 
 {
 
-  PlanHashEntry *result = ( PlanHashEntry * ) calloc( 1, sizeof( PlanHashEntry ) );
+  PlanHashEntry *result = ( PlanHashEntry * ) ff_calloc( 1, sizeof( PlanHashEntry ) );
   CHECK_PTR(result);
 
   result->next_step = NULL;
@@ -880,7 +1000,7 @@ BfsNode *new_BfsNode( void )
 
 {
 
-  BfsNode *result = ( BfsNode * ) calloc( 1, sizeof( BfsNode ) );
+  BfsNode *result = ( BfsNode * ) ff_calloc( 1, sizeof( BfsNode ) );
   CHECK_PTR(result);
 
   result->father = NULL;
@@ -898,7 +1018,7 @@ BfsHashEntry *new_BfsHashEntry( void )
 
 {
 
-  BfsHashEntry *result = ( BfsHashEntry * ) calloc( 1, sizeof( BfsHashEntry ) );
+  BfsHashEntry *result = ( BfsHashEntry * ) ff_calloc( 1, sizeof( BfsHashEntry ) );
   CHECK_PTR(result);
 
   result->bfs_node = NULL;
@@ -941,9 +1061,9 @@ void free_TokenList( TokenList *source )
   if ( source ) {
     free_TokenList( source->next );
     if ( source->item ) {
-      free( source->item );
+      ff_free( source->item );
     }
-    free( source );
+    ff_free( source );
   }
 
 }
@@ -957,7 +1077,7 @@ void free_FactList( FactList *source )
   if ( source ) {
     free_FactList( source->next );
     free_TokenList( source->item );
-    free( source );
+    ff_free( source );
   }
 
 }
@@ -972,7 +1092,7 @@ void free_ParseExpNode( ParseExpNode *n )
     free_TokenList( n->atom );
     free_ParseExpNode( n->leftson );
     free_ParseExpNode( n->rightson );
-    free( n );
+    ff_free( n );
   }
 
 }
@@ -989,7 +1109,7 @@ void free_PlNode( PlNode *node )
     free_PlNode( node->sons );
     free_PlNode( node->next );
     free_TokenList( node->atom );
-    free( node );
+    ff_free( node );
   }
 
 }
@@ -1004,14 +1124,14 @@ void free_PlOperator( PlOperator *o )
     free_PlOperator( o->next );
 
     if ( o->name ) {
-      free( o->name );
+      ff_free( o->name );
     }
     
     free_FactList( o->params );
     free_PlNode( o->preconds );
     free_PlNode( o->effects );
 
-    free( o );
+    ff_free( o );
   }
 
 }
@@ -1028,10 +1148,10 @@ void free_Operator( PDDLOperator *o )
      */
 
     if ( o->name ) {
-      free( o->name );
+      ff_free( o->name );
     }
 
-    free( o );
+    ff_free( o );
   } 
 
 }
@@ -1043,11 +1163,11 @@ void free_ExpNode( ExpNode *n )
 {
 
   if ( n ) {
-    if ( n->fluent ) free( n->fluent );
+    if ( n->fluent ) ff_free( n->fluent );
     free_ExpNode( n->son );
     free_ExpNode( n->leftson );
     free_ExpNode( n->rightson );
-    free( n );
+    ff_free( n );
   }
 
 }
@@ -1063,12 +1183,12 @@ void free_WffNode( WffNode *w )
     free_WffNode( w->sons );
     free_WffNode( w->next );
     if ( w->var_name ) {
-      free( w->var_name );
+      ff_free( w->var_name );
     }
-    if ( w->fact ) free( w->fact );
+    if ( w->fact ) ff_free( w->fact );
     free_ExpNode( w->lh );
     free_ExpNode( w->rh );
-    free( w );
+    ff_free( w );
   }
 
 }
@@ -1085,43 +1205,43 @@ void free_NormEffect( NormEffect *e )
     free_NormEffect( e->next );
 
     if ( e->conditions ) {
-      free( e->conditions );
+      ff_free( e->conditions );
     }
     if ( e->adds ) {
-      free( e->adds );
+      ff_free( e->adds );
     }
     if ( e->dels ) {
-      free( e->dels );
+      ff_free( e->dels );
     }
 
     if ( e->numeric_conditions_comp ) {
-      free( e->numeric_conditions_comp );
+      ff_free( e->numeric_conditions_comp );
     }
     for ( i = 0; i < e->num_numeric_conditions; i++ ) {
       free_ExpNode( e->numeric_conditions_lh[i] );
       free_ExpNode( e->numeric_conditions_rh[i] );
     }
     if ( e->numeric_conditions_lh ) {
-      free( e->numeric_conditions_lh );
+      ff_free( e->numeric_conditions_lh );
     }
     if ( e->numeric_conditions_rh ) {
-      free( e->numeric_conditions_rh );
+      ff_free( e->numeric_conditions_rh );
     }
 
     if ( e->numeric_effects_neft ) {
-      free( e->numeric_effects_neft );
+      ff_free( e->numeric_effects_neft );
     }
     if ( e->numeric_effects_fluent ) {
-      free( e->numeric_effects_fluent );
+      ff_free( e->numeric_effects_fluent );
     }
     for ( i = 0; i < e->num_numeric_effects; i++ ) {
       free_ExpNode( e->numeric_effects_rh[i] );
     }
     if ( e->numeric_effects_rh ) {
-      free( e->numeric_effects_rh );
+      ff_free( e->numeric_effects_rh );
     }
 
-    free( e );
+    ff_free( e );
   }
 
 }
@@ -1137,7 +1257,7 @@ void free_partial_Effect( Effect *e )
 
     free_WffNode( e->conditions );
 
-    free( e );
+    ff_free( e );
   }
 
 }
@@ -1153,24 +1273,24 @@ void free_NormOperator( NormOperator *o )
   if ( o ) {
 
     if ( o->preconds ) {
-      free( o->preconds );
+      ff_free( o->preconds );
     }
     if ( o->numeric_preconds_comp ) {
-      free( o->numeric_preconds_comp );
+      ff_free( o->numeric_preconds_comp );
     }
     for ( i = 0; i < o->num_numeric_preconds; i++ ) {
       free_ExpNode( o->numeric_preconds_lh[i] );
       free_ExpNode( o->numeric_preconds_rh[i] );
     }
     if ( o->numeric_preconds_lh ) {
-      free( o->numeric_preconds_lh );
+      ff_free( o->numeric_preconds_lh );
     }
     if ( o->numeric_preconds_rh ) {
-      free( o->numeric_preconds_rh );
+      ff_free( o->numeric_preconds_rh );
     }
     free_NormEffect( o->effects );
 
-    free( o );
+    ff_free( o );
   }
 
 }
@@ -1185,43 +1305,43 @@ void free_single_NormEffect( NormEffect *e )
 
   if ( e ) {
     if ( e->conditions ) {
-      free( e->conditions );
+      ff_free( e->conditions );
     }
     if ( e->adds ) {
-      free( e->adds );
+      ff_free( e->adds );
     }
     if ( e->dels ) {
-      free( e->dels );
+      ff_free( e->dels );
     }
 
     if ( e->numeric_conditions_comp ) {
-      free( e->numeric_conditions_comp );
+      ff_free( e->numeric_conditions_comp );
     }
     for ( i = 0; i < e->num_numeric_conditions; i++ ) {
       free_ExpNode( e->numeric_conditions_lh[i] );
       free_ExpNode( e->numeric_conditions_rh[i] );
     }
     if ( e->numeric_conditions_lh ) {
-      free( e->numeric_conditions_lh );
+      ff_free( e->numeric_conditions_lh );
     }
     if ( e->numeric_conditions_rh ) {
-      free( e->numeric_conditions_rh );
+      ff_free( e->numeric_conditions_rh );
     }
 
     if ( e->numeric_effects_neft ) {
-      free( e->numeric_effects_neft );
+      ff_free( e->numeric_effects_neft );
     }
     if ( e->numeric_effects_fluent ) {
-      free( e->numeric_effects_fluent );
+      ff_free( e->numeric_effects_fluent );
     }
     for ( i = 0; i < e->num_numeric_effects; i++ ) {
       free_ExpNode( e->numeric_effects_rh[i] );
     }
     if ( e->numeric_effects_rh ) {
-      free( e->numeric_effects_rh );
+      ff_free( e->numeric_effects_rh );
     }
 
-    free( e );
+    ff_free( e );
   }
 
 }
@@ -1233,7 +1353,7 @@ void free_single_EasyTemplate( EasyTemplate *t )
 {
 
   if ( t ) {
-    free( t );
+    ff_free( t );
   }
 
 }
@@ -1246,7 +1366,7 @@ void free_TypedList( TypedList *t )
 
   if ( t ) {
     if ( t->name ) {
-      free( t->name );
+      ff_free( t->name );
       t->name = NULL;
     }
     if ( t->type ) {
@@ -1255,7 +1375,7 @@ void free_TypedList( TypedList *t )
     }
     free_TypedList( t->next );
 
-    free( t );
+    ff_free( t );
   }
 
 }
@@ -1268,7 +1388,7 @@ void free_TypedListList( TypedListList *t )
 
   if ( t ) {
     if ( t->predicate ) {
-      free( t->predicate );
+      ff_free( t->predicate );
       t->predicate = NULL;
     }
     if ( t->args ) {
@@ -1277,7 +1397,7 @@ void free_TypedListList( TypedListList *t )
     }
     free_TypedListList( t->next );
 
-    free( t );
+    ff_free( t );
   }
 
 }
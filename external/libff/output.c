@@ -1482,7 +1482,6 @@ void print_State( State S )
 
 
 
-extern Bool artificial_gtt;
 
 void print_plan( void )
 
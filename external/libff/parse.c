@@ -165,12 +165,12 @@ char *rmdash( char *s )
 
 
 
-Token ltype_names[MAX_TYPES];
-int lnum_types;
+#define ltype_names (ff_ctx->parse.ltype_names)
+#define lnum_types (ff_ctx->parse.lnum_types)
 
 
-int leither_ty[MAX_TYPES][MAX_TYPES];
-int lnum_either_ty[MAX_TYPES];
+#define leither_ty (ff_ctx->parse.leither_ty)
+#define lnum_either_ty (ff_ctx->parse.lnum_either_ty)
 
 
 
@@ -213,7 +213,7 @@ void build_orig_constant_list( void )
     } else {
       tyl->n = n;
     }
-    free( tmp );
+    ff_free( tmp );
     tmp = NULL;
   }
      
@@ -234,7 +234,7 @@ void build_orig_constant_list( void )
     } else {
       tyl->n = n;
     }
-    free( tmp );
+    ff_free( tmp );
     tmp = NULL;
   }
   
@@ -255,7 +255,7 @@ void build_orig_constant_list( void )
     } else {
       tyl->n = n;
     }
-    free( tmp );
+    ff_free( tmp );
     tmp = NULL;
   }
 
@@ -277,7 +277,7 @@ void build_orig_constant_list( void )
       } else {
 	tyl->n = n;
       }
-      free( tmp );
+      ff_free( tmp );
       tmp = NULL;
     }
   }
@@ -304,7 +304,7 @@ void build_orig_constant_list( void )
       } else {
 	tyl->n = n;
       }
-      free( tmp );
+      ff_free( tmp );
       tmp = NULL;
     }
   }
@@ -673,7 +673,7 @@ void collect_type_names_in_pl( PlNode *n )
       } else {
 	tyl->n = nn;
       }
-      free( tmp );
+      ff_free( tmp );
       tmp = NULL;
     }
     collect_type_names_in_pl( n->sons );
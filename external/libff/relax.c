@@ -100,16 +100,16 @@
 
 /* fixpoint
  */
-int *lF;
-int lnum_F;
-int *lE;
-int lnum_E;
+#define lF (ff_ctx->relax.lF)
+#define lnum_F (ff_ctx->relax.lnum_F)
+#define lE (ff_ctx->relax.lE)
+#define lnum_E (ff_ctx->relax.lnum_E)
 
-int *lch_E;
-int lnum_ch_E;
+#define lch_E (ff_ctx->relax.lch_E)
+#define lnum_ch_E (ff_ctx->relax.lnum_ch_E)
 
-int *l0P_E;
-int lnum_0P_E;
+#define l0P_E (ff_ctx->relax.l0P_E)
+#define lnum_0P_E (ff_ctx->relax.lnum_0P_E)
 
 
 
@@ -117,28 +117,28 @@ int lnum_0P_E;
 
 /* 1P extraction
  */
-int **lgoals_at;
-int *lnum_goals_at;
+#define lgoals_at (ff_ctx->relax.lgoals_at)
+#define lnum_goals_at (ff_ctx->relax.lnum_goals_at)
 
-float **lf_goals_c_at;
-Comparator **lf_goals_comp_at;
+#define lf_goals_c_at (ff_ctx->relax.lf_goals_c_at)
+#define lf_goals_comp_at (ff_ctx->relax.lf_goals_comp_at)
 
-int lh;
+#define lh (ff_ctx->relax.lh)
 
-int *lch_F;
-int lnum_ch_F;
+#define lch_F (ff_ctx->relax.lch_F)
+#define lnum_ch_F (ff_ctx->relax.lnum_ch_F)
 
-int *lused_O;
-int lnum_used_O;
+#define lused_O (ff_ctx->relax.lused_O)
+#define lnum_used_O (ff_ctx->relax.lnum_used_O)
 
-int *lin_plan_E;
-int lnum_in_plan_E;
+#define lin_plan_E (ff_ctx->relax.lin_plan_E)
+#define lnum_in_plan_E (ff_ctx->relax.lnum_in_plan_E)
 
 
 /* helpful actions numerical helpers
  */
-Comparator *lHcomp;
-float *lHc;
+#define lHcomp (ff_ctx->relax.lHcomp)
+#define lHc (ff_ctx->relax.lHc)
 
 
 
@@ -347,14 +347,12 @@ void collect_A_info( void )
 
 {
 
-  static Bool first_call = TRUE;
-
   int i;
 
-  if ( first_call ) {
-    gA = ( int * ) calloc( gnum_op_conn, sizeof( int ) );
+  if ( !ff_ctx->relax.A_info_called ) {
+    gA = ( int * ) ff_calloc( gnum_op_conn, sizeof( int ) );
     gnum_A = 0;
-    first_call = FALSE;
+    ff_ctx->relax.A_info_called = TRUE;
   }
 
   for ( i = 0; i < gnum_A; i++ ) {
@@ -623,21 +621,19 @@ void initialize_fixpoint( State *S )
 
 {
 
-  static Bool first_call = TRUE;
-
   int i;
 
-  if ( first_call ) {
+  if ( !ff_ctx->relax.fixpoint_called ) {
     /* make initial space for fluent levels
      */
     extend_fluent_levels( -1 );
 
     /* get memory for local globals
      */
-    lF = ( int * ) calloc( gnum_ft_conn, sizeof( int ) );
-    lE = ( int * ) calloc( gnum_ef_conn, sizeof( int ) );
-    lch_E = ( int * ) calloc( gnum_ef_conn, sizeof( int ) );
-    l0P_E = ( int * ) calloc( gnum_ef_conn, sizeof( int ) );
+    lF = ( int * ) ff_calloc( gnum_ft_conn, sizeof( int ) );
+    lE = ( int * ) ff_calloc( gnum_ef_conn, sizeof( int ) );
+    lch_E = ( int * ) ff_calloc( gnum_ef_conn, sizeof( int ) );
+    l0P_E = ( int * ) ff_calloc( gnum_ef_conn, sizeof( int ) );
     
     /* initialize connectivity graph members for
      * relaxed planning
@@ -668,7 +664,7 @@ void initialize_fixpoint( State *S )
     for ( i = 0; i < gnum_fl_conn; i++ ) {
       gfl_conn[i].curr_assigned = FALSE;
     }
-    first_call = FALSE;
+    ff_ctx->relax.fixpoint_called = TRUE;
   }
 
   lnum_E = 0;
@@ -731,53 +727,51 @@ void extend_fluent_levels( int time )
 
 {
 
-  static int highest_seen;
-
   Bool *b;
   float *f1;
 
   int i, j;
 
   if ( time == -1 ) {
-    highest_seen = RELAXED_STEPS_DEFAULT;
+    ff_ctx->relax.fluent_levels_seen = RELAXED_STEPS_DEFAULT;
     for ( i = 0; i < gnum_fl_conn; i++ ) {
-      gfl_conn[i].def = ( Bool * ) calloc( highest_seen, sizeof( Bool ) );
-      for ( j = 0; j < highest_seen; j++ ) {
+      gfl_conn[i].def = ( Bool * ) ff_calloc( ff_ctx->relax.fluent_levels_seen, sizeof( Bool ) );
+      for ( j = 0; j < ff_ctx->relax.fluent_levels_seen; j++ ) {
 	gfl_conn[i].def[j] = FALSE;
       }
-      gfl_conn[i].level = ( float * ) calloc( highest_seen, sizeof( float ) );
+      gfl_conn[i].level = ( float * ) ff_calloc( ff_ctx->relax.fluent_levels_seen, sizeof( float ) );
     }
     return;
   }
 
-  if ( time + 1 < highest_seen ) return;
+  if ( time + 1 < ff_ctx->relax.fluent_levels_seen ) return;
 
-  b = ( Bool * ) calloc( time + 1, sizeof( Bool ) );
-  f1 = ( float * ) calloc( time + 1, sizeof( float ) );
+  b = ( Bool * ) ff_calloc( time + 1, sizeof( Bool ) );
+  f1 = ( float * ) ff_calloc( time + 1, sizeof( float ) );
 
-  highest_seen = time + 10;
+  ff_ctx->relax.fluent_levels_seen = time + 10;
   for ( i = 0; i < gnum_fl_conn; i++ ) {
     for ( j = 0; j <= time; j++ ) {
       b[j] = gfl_conn[i].def[j];
       f1[j] = gfl_conn[i].level[j];
     }
 
-    free( gfl_conn[i].def );
-    free( gfl_conn[i].level );
-    gfl_conn[i].def = ( Bool * ) calloc( highest_seen, sizeof( Bool ) );
-    gfl_conn[i].level = ( float * ) calloc( highest_seen, sizeof( float ) );
+    ff_free( gfl_conn[i].def );
+    ff_free( gfl_conn[i].level );
+    gfl_conn[i].def = ( Bool * ) ff_calloc( ff_ctx->relax.fluent_levels_seen, sizeof( Bool ) );
+    gfl_conn[i].level = ( float * ) ff_calloc( ff_ctx->relax.fluent_levels_seen, sizeof( float ) );
 
     for ( j = 0; j <= time; j++ ) {
       gfl_conn[i].def[j] = b[j];
       gfl_conn[i].level[j] = f1[j];
     }
-    for ( j = time + 1; j < highest_seen; j++ ) {
+    for ( j = time + 1; j < ff_ctx->relax.fluent_levels_seen; j++ ) {
       gfl_conn[i].def[j] = FALSE;
     }
   }
 
-  free( b );
-  free( f1 );
+  ff_free( b );
+  ff_free( f1 );
 
 }
 
@@ -1447,10 +1441,9 @@ int extract_1P( int max )
 
 {
 
-  static Bool first_call = TRUE;
   int i, max_goal_level, time;
 
-  if ( first_call ) {
+  if ( !ff_ctx->relax.extract_1P_called ) {
     for ( i = 0; i < gnum_ft_conn; i++ ) {
       gft_conn[i].is_true = INFINITY;
       gft_conn[i].is_goal = FALSE;
@@ -1462,13 +1455,13 @@ int extract_1P( int max )
     for ( i = 0; i < gnum_ef_conn; i++ ) {
       gef_conn[i].in_plan = INFINITY;
     }
-    lch_F = ( int * ) calloc( gnum_ft_conn, sizeof( int ) );
+    lch_F = ( int * ) ff_calloc( gnum_ft_conn, sizeof( int ) );
     lnum_ch_F = 0;
-    lused_O = ( int * ) calloc( gnum_op_conn, sizeof( int ) );
+    lused_O = ( int * ) ff_calloc( gnum_op_conn, sizeof( int ) );
     lnum_used_O = 0;
-    lin_plan_E = ( int * ) calloc( gnum_ef_conn, sizeof( int ) );
+    lin_plan_E = ( int * ) ff_calloc( gnum_ef_conn, sizeof( int ) );
     lnum_in_plan_E = 0;
-    first_call = FALSE;
+    ff_ctx->relax.extract_1P_called = TRUE;
   }
 
   reset_search_info();
@@ -1497,49 +1490,46 @@ int initialize_goals( int max )
 
 {
 
-  static Bool first_call = TRUE;
-  static int highest_seen;
-
   int i, j, max_goal_level, ft, fl;
   Comparator comp;
   float val;
 
-  if ( first_call ) {
-    lgoals_at = ( int ** ) calloc( RELAXED_STEPS_DEFAULT, sizeof( int * ) );
-    lnum_goals_at = ( int * ) calloc( RELAXED_STEPS_DEFAULT, sizeof( int ) );
-    lf_goals_c_at = ( float ** ) calloc( RELAXED_STEPS_DEFAULT, sizeof( float * ) );
-    lf_goals_comp_at = ( Comparator ** ) calloc( RELAXED_STEPS_DEFAULT, sizeof( Comparator * ) );
+  if ( !ff_ctx->relax.goals_called ) {
+    lgoals_at = ( int ** ) ff_calloc( RELAXED_STEPS_DEFAULT, sizeof( int * ) );
+    lnum_goals_at = ( int * ) ff_calloc( RELAXED_STEPS_DEFAULT, sizeof( int ) );
+    lf_goals_c_at = ( float ** ) ff_calloc( RELAXED_STEPS_DEFAULT, sizeof( float * ) );
+    lf_goals_comp_at = ( Comparator ** ) ff_calloc( RELAXED_STEPS_DEFAULT, sizeof( Comparator * ) );
     for ( i = 0; i < RELAXED_STEPS_DEFAULT; i++ ) {
-      lgoals_at[i] = ( int * ) calloc( gnum_ft_conn, sizeof( int ) );
-      lf_goals_c_at[i] = ( float * ) calloc( gnum_fl_conn, sizeof( float ) );
-      lf_goals_comp_at[i] = ( Comparator * ) calloc( gnum_fl_conn, sizeof( Comparator ) );
+      lgoals_at[i] = ( int * ) ff_calloc( gnum_ft_conn, sizeof( int ) );
+      lf_goals_c_at[i] = ( float * ) ff_calloc( gnum_fl_conn, sizeof( float ) );
+      lf_goals_comp_at[i] = ( Comparator * ) ff_calloc( gnum_fl_conn, sizeof( Comparator ) );
     }
-    highest_seen = RELAXED_STEPS_DEFAULT;
+    ff_ctx->relax.goals_seen = RELAXED_STEPS_DEFAULT;
 
-    lHcomp = ( Comparator * ) calloc( gnum_fl_conn, sizeof( Comparator ) );
-    lHc = ( float * ) calloc( gnum_fl_conn, sizeof( float ) );
-    first_call = FALSE;
+    lHcomp = ( Comparator * ) ff_calloc( gnum_fl_conn, sizeof( Comparator ) );
+    lHc = ( float * ) ff_calloc( gnum_fl_conn, sizeof( float ) );
+    ff_ctx->relax.goals_called = TRUE;
   }
 
-  if ( max + 1 > highest_seen ) {
-    for ( i = 0; i < highest_seen; i++ ) {
-      free( lgoals_at[i] );
-      free( lf_goals_c_at[i] );
-      free( lf_goals_comp_at[i] );
+  if ( max + 1 > ff_ctx->relax.goals_seen ) {
+    for ( i = 0; i < ff_ctx->relax.goals_seen; i++ ) {
+      ff_free( lgoals_at[i] );
+      ff_free( lf_goals_c_at[i] );
+      ff_free( lf_goals_comp_at[i] );
     }
-    free( lgoals_at );
-    free( lnum_goals_at );
-    free( lf_goals_c_at );
-    free( lf_goals_comp_at );
-    highest_seen = max + 10;
-    lgoals_at = ( int ** ) calloc( highest_seen, sizeof( int * ) );
-    lnum_goals_at = ( int * ) calloc( highest_seen, sizeof( int ) );
-    lf_goals_c_at = ( float ** ) calloc( highest_seen, sizeof( float * ) );
-    lf_goals_comp_at = ( Comparator ** ) calloc( highest_seen, sizeof( Comparator * ) );
-    for ( i = 0; i < highest_seen; i++ ) {
-      lgoals_at[i] = ( int * ) calloc( gnum_ft_conn, sizeof( int ) );
-      lf_goals_c_at[i] = ( float * ) calloc( gnum_fl_conn, sizeof( float ) );
-      lf_goals_comp_at[i] = ( Comparator * ) calloc( gnum_fl_conn, sizeof( Comparator ) );
+    ff_free( lgoals_at );
+    ff_free( lnum_goals_at );
+    ff_free( lf_goals_c_at );
+    ff_free( lf_goals_comp_at );
+    ff_ctx->relax.goals_seen = max + 10;
+    lgoals_at = ( int ** ) ff_calloc( ff_ctx->relax.goals_seen, sizeof( int * ) );
+    lnum_goals_at = ( int * ) ff_calloc( ff_ctx->relax.goals_seen, sizeof( int ) );
+    lf_goals_c_at = ( float ** ) ff_calloc( ff_ctx->relax.goals_seen, sizeof( float * ) );
+    lf_goals_comp_at = ( Comparator ** ) ff_calloc( ff_ctx->relax.goals_seen, sizeof( Comparator * ) );
+    for ( i = 0; i < ff_ctx->relax.goals_seen; i++ ) {
+      lgoals_at[i] = ( int * ) ff_calloc( gnum_ft_conn, sizeof( int ) );
+      lf_goals_c_at[i] = ( float * ) ff_calloc( gnum_fl_conn, sizeof( float ) );
+      lf_goals_comp_at[i] = ( Comparator * ) ff_calloc( gnum_fl_conn, sizeof( Comparator ) );
     }
   }
 
@@ -2189,15 +2179,13 @@ void collect_H_info( void )
 
 {
 
-  static Bool first_call = TRUE;
-
   int i, j, ft, ef, op;
   float val;
 
-  if ( first_call ) {
-    gH = ( int * ) calloc( gnum_op_conn, sizeof( int ) );
+  if ( !ff_ctx->relax.H_info_called ) {
+    gH = ( int * ) ff_calloc( gnum_op_conn, sizeof( int ) );
     gnum_H = 0;
-    first_call = FALSE;
+    ff_ctx->relax.H_info_called = TRUE;
   }
 
   for ( i = 0; i < gnum_H; i++ ) {
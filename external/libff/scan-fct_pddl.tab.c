@@ -1742,7 +1742,7 @@ yyreduce:
   }
 
   /* duh */
-  gparse_optimization = malloc(10);
+  gparse_optimization = ff_calloc( 10, sizeof( char ) );
 
   strcpy(gparse_optimization, (yyvsp[(3) - (5)].string));
   gparse_metric = (yyvsp[(4) - (5)].pParseExpNode);
@@ -2744,6 +2744,11 @@ void load_fct_file( char *filename )
 
   yyparse();
 
+  /* the scanner is shared by all contexts, so leave it
+   * as new for whoever reads the next file
+   */
+  fct_pddllex_destroy();
+
   fclose( fp );/* and close file again */
 
 }
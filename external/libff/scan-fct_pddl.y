@@ -289,7 +289,7 @@ OPEN_PAREN  METRIC_TOK  NAME ground_f_exp CLOSE_PAREN
   }
 
   /* duh */
-  gparse_optimization = malloc(10);
+  gparse_optimization = ff_calloc( 10, sizeof( char ) );
 
   strcpy(gparse_optimization, $3);
   gparse_metric = $4;
@@ -942,6 +942,11 @@ void load_fct_file( char *filename )
 
   yyparse();
 
+  /* the scanner is shared by all contexts, so leave it
+   * as new for whoever reads the next file
+   */
+  fct_pddllex_destroy();
+
   fclose( fp );/* and close file again */
 
 }
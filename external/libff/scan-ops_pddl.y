@@ -1063,6 +1063,11 @@ void load_ops_file( char *filename )
 
   yyparse();
 
+  /* the scanner is shared by all contexts, so leave it
+   * as new for whoever reads the next file
+   */
+  ops_pddllex_destroy();
+
   fclose( fp );/* and close file again */
 
 }
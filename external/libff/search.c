@@ -111,38 +111,42 @@
 
 /* search space for EHC
  */
-EhcNode *lehc_space_head, *lehc_space_end, *lehc_current_start, *lehc_current_end;
+#define lehc_space_head (ff_ctx->search.lehc_space_head)
+#define lehc_space_end (ff_ctx->search.lehc_space_end)
+#define lehc_current_start (ff_ctx->search.lehc_current_start)
+#define lehc_current_end (ff_ctx->search.lehc_current_end)
 
 
 
 /* memory (hash table) for states that are already members
  * of the breadth - first search space in EHC
  */
-EhcHashEntry_pointer lehc_hash_entry[EHC_HASH_SIZE];
-int lnum_ehc_hash_entry[EHC_HASH_SIZE];
-int lchanged_ehc_entrys[EHC_HASH_SIZE];
-int lnum_changed_ehc_entrys;
-Bool lchanged_ehc_entry[EHC_HASH_SIZE];
+#define lehc_hash_entry (ff_ctx->search.lehc_hash_entry)
+#define lnum_ehc_hash_entry (ff_ctx->search.lnum_ehc_hash_entry)
+#define lchanged_ehc_entrys (ff_ctx->search.lchanged_ehc_entrys)
+#define lnum_changed_ehc_entrys (ff_ctx->search.lnum_changed_ehc_entrys)
+#define lchanged_ehc_entry (ff_ctx->search.lchanged_ehc_entry)
 
 
 
 /* memory (hash table) for states that are already 
  * encountered by current serial plan
  */
-PlanHashEntry_pointer lplan_hash_entry[PLAN_HASH_SIZE];
+#define lplan_hash_entry (ff_ctx->search.lplan_hash_entry)
 
 
 
 /* search space
  */
-BfsNode *lbfs_space_head, *lbfs_space_had;
+#define lbfs_space_head (ff_ctx->search.lbfs_space_head)
+#define lbfs_space_had (ff_ctx->search.lbfs_space_had)
 
 
 
 /* memory (hash table) for states that are already members
  * of the best first search space
  */
-BfsHashEntry_pointer lbfs_hash_entry[BFS_HASH_SIZE];
+#define lbfs_hash_entry (ff_ctx->search.lbfs_hash_entry)
 
 
 
@@ -161,7 +165,7 @@ BfsHashEntry_pointer lbfs_hash_entry[BFS_HASH_SIZE];
 
 
 
-Bool lH;
+#define lH (ff_ctx->search.lH)
 
 
 
@@ -272,15 +276,12 @@ Bool search_for_better_state( State *S, int h, State *S_, int *h_ )
 
 {
 
-  static Bool fc = TRUE;
-  static State S__;
-
   int i, h__, depth = 0;
   EhcNode *tmp;
 
-  if ( fc ) {
-    make_state( &S__, gnum_ft_conn, gnum_fl_conn );
-    fc = FALSE;
+  if ( !ff_ctx->search.better_state_called ) {
+    make_state( &ff_ctx->search.better_S__, gnum_ft_conn, gnum_fl_conn );
+    ff_ctx->search.better_state_called = TRUE;
   }
 
   /* don't hash states, but search nodes.
@@ -293,14 +294,14 @@ Bool search_for_better_state( State *S, int h, State *S_, int *h_ )
   lehc_current_end = lehc_space_head->next;
   if ( lH ) {
     for ( i = 0; i < gnum_H; i++ ) {
-      if ( result_to_dest( &S__, S, gH[i] ) ) {
-	add_to_ehc_space( &S__, gH[i], NULL );
+      if ( result_to_dest( &ff_ctx->search.better_S__, S, gH[i] ) ) {
+	add_to_ehc_space( &ff_ctx->search.better_S__, gH[i], NULL );
       }
     }
   } else {
     for ( i = 0; i < gnum_A; i++ ) {
-      if ( result_to_dest( &S__, S, gA[i] ) ) {
-	add_to_ehc_space( &S__, gA[i], NULL );
+      if ( result_to_dest( &ff_ctx->search.better_S__, S, gA[i] ) ) {
+	add_to_ehc_space( &ff_ctx->search.better_S__, gA[i], NULL );
       }
     }
   }
@@ -310,7 +311,7 @@ Bool search_for_better_state( State *S, int h, State *S_, int *h_ )
   while ( TRUE ) {  
     if ( lehc_current_start == lehc_current_end ) {
       reset_ehc_hash_entrys();
-      free( tmp );
+      ff_free( tmp );
       return FALSE;
     }
     if ( lehc_current_start->depth > depth ) {
@@ -330,7 +331,7 @@ Bool search_for_better_state( State *S, int h, State *S_, int *h_ )
   }
 
   reset_ehc_hash_entrys();
-  free( tmp );
+  ff_free( tmp );
 
   extract_plan_fragment( S );
 
@@ -381,14 +382,11 @@ int expand_first_node( int h )
 
 {
 
-  static Bool fc = TRUE;
-  static State S_;
-
   int h_, i;
 
-  if ( fc ) {
-    make_state( &S_, gnum_ft_conn, gnum_fl_conn );
-    fc = FALSE;
+  if ( !ff_ctx->search.first_node_called ) {
+    make_state( &ff_ctx->search.first_node_S_, gnum_ft_conn, gnum_fl_conn );
+    ff_ctx->search.first_node_called = TRUE;
   }
 
   if ( lH ) {
@@ -408,14 +406,14 @@ int expand_first_node( int h )
 
   if ( lH ) {
     for ( i = 0; i < gnum_H; i++ ) {
-      if ( result_to_dest( &S_, &(lehc_current_start->S), gH[i] ) ) {
-	add_to_ehc_space( &S_, gH[i], lehc_current_start );
+      if ( result_to_dest( &ff_ctx->search.first_node_S_, &(lehc_current_start->S), gH[i] ) ) {
+	add_to_ehc_space( &ff_ctx->search.first_node_S_, gH[i], lehc_current_start );
       }
     }
   } else {
     for ( i = 0; i < gnum_A; i++ ) {
-      if ( result_to_dest( &S_, &(lehc_current_start->S), gA[i] ) ) {
-	add_to_ehc_space( &S_, gA[i], lehc_current_start );
+      if ( result_to_dest( &ff_ctx->search.first_node_S_, &(lehc_current_start->S), gA[i] ) ) {
+	add_to_ehc_space( &ff_ctx->search.first_node_S_, gA[i], lehc_current_start );
       }
     }
   }
@@ -1014,7 +1012,7 @@ void add_to_bfs_space( State *S, int op, BfsNode *father )
   new->father = father;
   new->g = intg;
 
-  new->H = ( int * ) calloc( gnum_A, sizeof( int ) );
+  new->H = ( int * ) ff_calloc( gnum_A, sizeof( int ) );
   for ( j = 0; j < gnum_A; j++ ) {
     new->H[j] = gA[j];
   }
@@ -1261,27 +1259,31 @@ int state_sum( State *S )
  * appearing effect and is legal, i.e. if
  * no illegal numeric effects occur.
  */
+#define in_source (ff_ctx->search.in_source)
+#define in_dest (ff_ctx->search.in_dest)
+#define in_del (ff_ctx->search.in_del)
+#define true_ef (ff_ctx->search.true_ef)
+#define assigned (ff_ctx->search.assigned)
+#define del (ff_ctx->search.del)
+#define num_del (ff_ctx->search.num_del)
+
 Bool result_to_dest( State *dest, State *source, int op )
 
 {
 
-  static Bool first_call = TRUE;
-  static Bool *in_source, *in_dest, *in_del, *true_ef, *assigned;
-  static int *del, num_del;
-
   int i, j, ef, fl;
   float val, source_val;
   Comparator comp;
 
   Bool one_appeared = FALSE;
   
-  if ( first_call ) {
-    in_source = ( Bool * ) calloc( gnum_ft_conn, sizeof( Bool ) );
-    in_dest = ( Bool * ) calloc( gnum_ft_conn, sizeof( Bool ) );
-    in_del = ( Bool * ) calloc( gnum_ft_conn, sizeof( Bool ) );
-    true_ef = ( Bool * ) calloc( gnum_ef_conn, sizeof( Bool ) );
-    assigned = ( Bool * ) calloc( gnum_fl_conn, sizeof( Bool ) );
-    del = ( int * ) calloc( gnum_ft_conn, sizeof( int ) );
+  if ( !ff_ctx->search.result_called ) {
+    in_source = ( Bool * ) ff_calloc( gnum_ft_conn, sizeof( Bool ) );
+    in_dest = ( Bool * ) ff_calloc( gnum_ft_conn, sizeof( Bool ) );
+    in_del = ( Bool * ) ff_calloc( gnum_ft_conn, sizeof( Bool ) );
+    true_ef = ( Bool * ) ff_calloc( gnum_ef_conn, sizeof( Bool ) );
+    assigned = ( Bool * ) ff_calloc( gnum_fl_conn, sizeof( Bool ) );
+    del = ( int * ) ff_calloc( gnum_ft_conn, sizeof( int ) );
     for ( i = 0; i < gnum_ft_conn; i++ ) {
       in_source[i] = FALSE;
       in_dest[i] = FALSE;
@@ -1293,7 +1295,7 @@ Bool result_to_dest( State *dest, State *source, int op )
     for ( i = 0; i < gnum_fl_conn; i++ ) {
       assigned[i] = FALSE;
     }
-    first_call = FALSE;
+    ff_ctx->search.result_called = TRUE;
   }
 
   /* setup true facts for effect cond evaluation
@@ -1534,6 +1536,14 @@ Bool result_to_dest( State *dest, State *source, int op )
 
 }
 
+#undef in_source
+#undef in_dest
+#undef in_del
+#undef true_ef
+#undef assigned
+#undef del
+#undef num_del
+
 
 
 Bool determine_source_val( State *source, int fl, float *val )
@@ -4,7 +4,6 @@
 #include "ff.h"
 #include "output.h"
 
-extern Bool artificial_gtt;
 
 float MAX( float a, float b) {
 
@@ -23,10 +23,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
+#include <aptk/budget.hxx>
+#include <aptk/probes.hxx>
+#include <aptk/stats_reporter.hxx>
+#include <aptk/trace.hxx>
+#include <aptk/solution_sink.hxx>
 #include <aptk/closed_list.hxx>
 #include <vector>
+#include <string>
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace aptk {
 
@@ -35,7 +43,7 @@ namespace search {
 namespace bfs {
 
 template <typename State>
-class Node {
+class Node : public Tracked< Memory_Budget::NODES > {
 public:
 
 	typedef State State_Type;
@@ -96,7 +104,7 @@ public:
 // Anytime best-first search, with one single open list and one single
 // heuristic estimator, with delayed evaluation of states generated
 template <typename Search_Model, typename Abstract_Heuristic, typename Open_List_Type >
-class AT_BFS_SQ_SH {
+class AT_BFS_SQ_SH : public Degradable {
 
 public:
 
@@ -105,13 +113,21 @@ public:
 	typedef 	Closed_List< Search_Node >			Closed_List_Type;
 
 	AT_BFS_SQ_SH( 	const Search_Model& search_problem ) 
-	: m_problem( search_problem ), m_heuristic_func(NULL), 
+	: m_problem( search_problem ), m_heuristic_func(NULL), m_open_hash( Memory_Budget::OPEN ),
 	m_exp_count(0), m_gen_count(0), m_pruned_B_count(0), m_dead_end_count(0), m_open_repl_count(0),
-	m_B( infty ), m_time_budget(infty) {
+	m_reused_h_count(0), m_B( infty ), m_root( NULL ), m_goal( NULL ), m_reused_goal( NULL ),
+	m_h_cache( Memory_Budget::HEURISTIC ), m_reporter( NULL ), m_best_h( infty ),
+	m_trace( NULL ), m_queue( 0 ), m_sink( NULL ), m_compacted( false ) {
 		m_heuristic_func = new Abstract_Heuristic( search_problem );
+		m_budget.set_degradable( this );
 	}
 
 	virtual ~AT_BFS_SQ_SH() {
+		reset();
+		delete m_heuristic_func;
+	}
+
+	void	reset() {
 		for ( typename Closed_List_Type::iterator i = m_closed.begin();
 			i != m_closed.end(); i++ ) {
 			delete i->second;
@@ -123,12 +139,15 @@ public:
 		}
 		m_closed.clear();
 		m_open_hash.clear();
-		delete m_heuristic_func;
+		drop_h_cache();
+		m_root = m_goal = m_reused_goal = NULL;
+		m_compacted = false;
 	}
 
-	void	start() {
+	void	start( State* s = NULL ) {
+		reset();
 		m_B = infty;
-		m_root = new Search_Node( m_problem.init(), 0.0f, no_op, NULL );	
+		m_root = new Search_Node( s == NULL ? m_problem.init() : s, 0.0f, no_op, NULL );	
 		eval(m_root);
 		#ifdef DEBUG
 		std::cout << "Initial search node: ";
@@ -142,15 +161,64 @@ public:
 		inc_gen();
 	}
 
-	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
-		m_t0 = time_used();
-		Search_Node* end = do_search();
-		if ( end == NULL ) return false;
-		extract_plan( m_root, end, plan, cost );	
-		
+	// Starts the search again from s, which the engine takes. When s was
+	// generated by the search so far, the nodes below it are kept, with
+	// their g(n) made relative to s, and are put back into open, so those
+	// expanded before are expanded again without evaluating them. The
+	// heuristic values of the other states evaluated are kept until the
+	// next replan(). If the last solution found goes through s, the first
+	// call to find_solution() returns the rest of it. Otherwise, or when
+	// s is unknown, this is the same as start( s ), and false is returned.
+	//
+	// Values are reused as they are, so the task must not have changed
+	// since the search began, call start( s ) after changing it. Once the
+	// states in closed have been dropped under memory pressure, this is
+	// always the same as start( s ).
+	bool	replan( State* s ) {
+		if ( m_compacted ) {
+			start( s );
+			return false;
+		}
+		Search_Node probe( s, 0.0f, no_op, NULL );
+		Search_Node* r = m_closed.retrieve_shallowest( &probe );
+		Search_Node* o = m_open_hash.retrieve_shallowest( &probe );
+		if ( r == NULL || ( o != NULL && o->gn() < r->gn() ) ) r = o;
+		probe.m_state = NULL;
+		if ( r == NULL ) {
+			start( s );
+			return false;
+		}
+		delete s;
+		reroot( r );
 		return true;
 	}
 
+	// With a solution sink set, each plan is passed to it as soon as it is
+	// found and the search goes on under its cost, until open is empty or
+	// the budget runs out. The last plan found is returned then.
+	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
+		m_budget.start();
+		Search_Node* end = m_reused_goal;
+		m_reused_goal = NULL;
+		if ( end != NULL )
+			set_bound( end->gn() );
+		else
+			end = do_search();
+		bool solved = false;
+		while ( end != NULL ) {
+			trace( Trace_Writer::GOAL, end, end->hn() );
+			m_goal = end;
+			if ( solved ) plan.clear();
+			extract_plan( m_root, end, plan, cost );	
+			solved = true;
+			if ( m_sink == NULL ) break;
+			m_sink->found( *this, plan, cost, m_budget.elapsed() );
+			end = do_search();
+		}
+		if ( m_sink != NULL ) m_sink->finished( *this, m_budget.elapsed() );
+		return solved;
+	}
+
 	float			bound() const			{ return m_B; }
 	void			set_bound( float v ) 		{ m_B = v; }
 
@@ -164,11 +232,56 @@ public:
 	unsigned		dead_ends() const		{ return m_dead_end_count; }
 	void			inc_replaced_open()		{ m_open_repl_count++; }
 	unsigned		open_repl() const		{ return m_open_repl_count; }
+	void			inc_reused_h()			{ m_reused_h_count++; }
+	unsigned		reused_h() const		{ return m_reused_h_count; }
+
+	void			set_budget( float v ) 		{ m_budget.set_time( v ); }
+	float			time_budget() const		{ return m_budget.time(); }
+	Budget&			budget()			{ return m_budget; }
+	void			set_reporter( Stats_Reporter* r )	{ m_reporter = r; }
+	void			set_trace( Trace_Writer* t )	{ m_trace = t; }
+	void			set_solution_sink( Solution_Sink* s )	{ m_sink = s; }
+	float			best_h() const			{ return m_best_h; }
+
+	virtual void		stats( Search_Stats& s ) const {
+		s.expanded = expanded();
+		s.generated = generated();
+		s.dead_ends = dead_ends();
+		s.open_repl = open_repl();
+		s.pruned_bound = pruned_by_bound();
+		s.open = m_open_hash.size();
+		s.closed = m_closed.size();
+		s.best_h = m_best_h;
+		s.bound = bound();
+	}
 
-	void			set_budget( float v ) 		{ m_time_budget = v; }
-	float			time_budget() const		{ return m_time_budget; }
+	// Called on each expansion
+	void			report( Search_Node* n ) {
+		if ( n->hn() < m_best_h ) m_best_h = n->hn();
+		if ( m_reporter != NULL ) m_reporter->tick( *this );
+		if ( m_trace != NULL ) m_trace->record( Trace_Writer::EXPAND, n, n->hn(), m_queue );
+	}
 
-	float			t0() const			{ return m_t0; }
+	void			trace( Trace_Writer::Event e, Search_Node* n, float h ) {
+		if ( m_trace != NULL ) m_trace->record( e, n, h, m_queue );
+	}
+
+	// Drops the heuristic values kept by replan() first, then the states
+	// of the nodes in closed
+	virtual bool		degrade( Memory_Budget& m ) {
+		double before = m.used();
+		if ( !m_h_cache.empty() || !m_known_h.empty() ) {
+			size_t n = m_h_cache.size() + m_known_h.size();
+			drop_h_cache();
+			m.degraded( "dropped " + std::to_string( n ) + " heuristic values kept by replan()", before - m.used() );
+			return true;
+		}
+		size_t n = m_closed.compact();
+		if ( n == 0 ) return false;
+		m_compacted = true;
+		m.degraded( "dropped the states of " + std::to_string( n ) + " nodes in closed, telling them apart by hash", before - m.used() );
+		return true;
+	}
 
 	void 			close( Search_Node* n ) 	{  m_closed.put(n); }
 	Closed_List_Type&	closed() 			{ return m_closed; }
@@ -177,6 +290,7 @@ public:
 	const	Search_Model&	problem() const			{ return m_problem; }
 
 	void			eval( Search_Node* candidate ) {
+		if ( ( !m_known_h.empty() || !m_h_cache.empty() ) && reuse_h( candidate ) ) return;
 		m_heuristic_func->eval( *(candidate->state()), candidate->hn() );
 	}
 
@@ -187,11 +301,13 @@ public:
 			if ( n2->gn() <= n->gn() ) {
 				// The node we generated is a worse path than
 				// the one we already found
+				trace( Trace_Writer::DUPLICATE, n, n2->hn() );
 				return true;
 			}
+			trace( Trace_Writer::REOPEN, n, n2->hn() );
 			// Otherwise, we put it into Open and remove
 			// n2 from closed
-			this->closed().erase( this->closed().retrieve_iterator( n2 ) );
+			this->closed().erase( this->closed().retrieve_iterator( n ) );
 		}
 		return false;
 	}
@@ -218,6 +334,7 @@ public:
 	}
 
 	virtual void 			process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
 		#ifdef DEBUG
 		std::cout << "Expanding:" << std::endl;
 		head->print(std::cout);
@@ -267,11 +384,13 @@ public:
 	}
 
 	virtual Search_Node*	 	do_search() {
+		APTK_PHASE( SEARCH );
 		Search_Node *head = get_node();
 		int counter =0;
 		while(head) {
 			if ( head->gn() >= bound() )  {
 				inc_pruned_bound();
+				trace( Trace_Writer::PRUNE, head, head->hn() );
 				close(head);
 				head = get_node();
 				continue;
@@ -282,12 +401,13 @@ public:
 				set_bound( head->gn() );	
 				return head;
 			}
-			if ( (time_used() - m_t0 ) > m_time_budget )
+			if ( m_budget.exhausted() )
 				return NULL;
 	
 			eval( head );
 
 			process(head);
+			report(head);
 			close(head);
 			counter++;
 			head = get_node();
@@ -307,7 +427,10 @@ public:
 				previous_copy->m_g = n->m_g;
 				previous_copy->m_f = previous_copy->m_h + previous_copy->m_g;
 				inc_replaced_open();
+				trace( Trace_Writer::REPLACE, n, previous_copy->hn() );
 			}
+			else
+				trace( Trace_Writer::DUPLICATE, n, previous_copy->hn() );
 			return true;
 		}
 
@@ -316,11 +439,108 @@ public:
 
 protected:
 
+	// Takes h(n) from before the last replan(), if it is known
+	bool	reuse_h( Search_Node* n ) {
+		if ( m_known_h.erase( n ) > 0 ) {
+			inc_reused_h();
+			return true;
+		}
+		typename Closed_List_Type::iterator it = m_h_cache.retrieve_iterator( n );
+		if ( it == m_h_cache.end() ) return false;
+		n->hn() = it->second->hn();
+		delete it->second;
+		m_h_cache.erase( it );
+		inc_reused_h();
+		return true;
+	}
+
+	void	drop_h_cache() {
+		for ( typename Closed_List_Type::iterator i = m_h_cache.begin(); i != m_h_cache.end(); i++ )
+			delete i->second;
+		m_h_cache.clear();
+		m_known_h.clear();
+	}
+
+	// Nodes in closed were evaluated when expanded, but for those closed
+	// because of the bound, the last solution among them
+	void	reroot( Search_Node* r ) {
+		std::vector< Search_Node* >	nodes;
+		std::vector< bool >		evaluated;
+		for ( typename Closed_List_Type::iterator i = m_closed.begin(); i != m_closed.end(); i++ ) {
+			nodes.push_back( i->second );
+			evaluated.push_back( i->second->gn() < bound() );
+		}
+		while ( !m_open.empty() ) {
+			Search_Node* n = m_open.pop();
+			nodes.push_back( n );
+			evaluated.push_back( m_known_h.count( n ) > 0 );
+		}
+		m_closed.clear();
+		m_open_hash.clear();
+		drop_h_cache();
+
+		// Whether each node is r or below it, following parents up to a
+		// node already seen
+		std::unordered_map< Search_Node*, bool >	below( 2 * nodes.size() );
+		std::vector< Search_Node* >			path;
+		below[ r ] = true;
+		std::vector< bool >	kept( nodes.size() );
+		for ( unsigned k = 0; k < nodes.size(); k++ ) {
+			Search_Node* n = nodes[k];
+			bool found = false;
+			path.clear();
+			while ( n != NULL ) {
+				typename std::unordered_map< Search_Node*, bool >::iterator it = below.find( n );
+				if ( it != below.end() ) {
+					found = it->second;
+					break;
+				}
+				path.push_back( n );
+				n = n->parent();
+			}
+			for ( unsigned i = 0; i < path.size(); i++ )
+				below[ path[i] ] = found;
+			kept[k] = found;
+		}
+
+		float g_r = r->gn();
+		Search_Node* goal = NULL;
+		for ( unsigned k = 0; k < nodes.size(); k++ ) {
+			Search_Node* n = nodes[k];
+			if ( !kept[k] ) {
+				if ( evaluated[k] ) {
+					n->m_parent = NULL;
+					m_h_cache.put( n );
+				}
+				else
+					delete n;
+				continue;
+			}
+			n->gn() -= g_r;
+			n->fn() -= g_r;
+			if ( n == m_goal && m_problem.goal( *(n->state()) ) ) {
+				goal = n;
+				close( n );
+				continue;
+			}
+			if ( evaluated[k] ) m_known_h.insert( n );
+			m_open.insert( n );
+			m_open_hash.put( n );
+		}
+		r->m_parent = NULL;
+		r->m_action = no_op;
+		m_root = r;
+		m_goal = NULL;
+		m_reused_goal = goal;
+		m_B = infty;
+	}
+
 	void	extract_plan( Search_Node* s, Search_Node* t, std::vector<Action_Idx>& plan, float& cost ) {
 		Search_Node *tmp = t;
 		cost = 0.0f;
 		while( tmp != s) {
-			cost += m_problem.cost( *(tmp->state()), tmp->action() );
+			// States in closed may have been dropped
+			cost += tmp->state() != NULL ? m_problem.cost( *(tmp->state()), tmp->action() ) : tmp->gn() - tmp->parent()->gn();
 			plan.push_back(tmp->action());
 			tmp = tmp->parent();
 		}
@@ -349,11 +569,26 @@ protected:
 	unsigned				m_pruned_B_count;
 	unsigned				m_dead_end_count;
 	unsigned				m_open_repl_count;
+	unsigned				m_reused_h_count;
 	float					m_B;
-	float					m_time_budget;
-	float					m_t0;
+	Budget					m_budget;
 	Search_Node*				m_root;
+	// Last solution returned, and the rest of it kept by replan()
+	Search_Node*				m_goal;
+	Search_Node*				m_reused_goal;
+	// States evaluated before the last replan(), those kept in the search
+	// and those left out of it
+	std::unordered_set< Search_Node* >	m_known_h;
+	Closed_List_Type			m_h_cache;
 	std::vector<Action_Idx> 		m_app_set;
+	Stats_Reporter*				m_reporter;
+	float					m_best_h;
+	Trace_Writer*				m_trace;
+	// Open list the last node was taken from
+	unsigned				m_queue;
+	Solution_Sink*				m_sink;
+	// Whether the states in closed have been dropped
+	bool					m_compacted;
 };
 
 }
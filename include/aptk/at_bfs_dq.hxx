@@ -23,8 +23,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
+#include <aptk/budget.hxx>
+#include <aptk/probes.hxx>
+#include <aptk/stats_reporter.hxx>
+#include <aptk/trace.hxx>
+#include <aptk/solution_sink.hxx>
 #include <aptk/closed_list.hxx>
+#include <aptk/parallel_eval.hxx>
 #include <vector>
+#include <string>
 #include <algorithm>
 #include <iostream>
 
@@ -35,7 +42,7 @@ namespace search {
 namespace bfs_dq {
 
 template <typename State>
-class Node {
+class Node : public Tracked< Memory_Budget::NODES > {
 public:
 
 	typedef State State_Type;
@@ -102,9 +109,10 @@ public:
 
 
 // Anytime best-first search, with one single open list and one single
-// heuristic estimator, with delayed evaluation of states generated
-template <typename Search_Model, typename Abstract_Heuristic, typename Open_List_Type >
-class AT_BFS_DQ_SH {
+// heuristic estimator, with delayed evaluation of states generated (see
+// parallel_eval.hxx for evaluating successors in batches instead)
+template <typename Search_Model, typename Abstract_Heuristic, typename Open_List_Type, typename Evaluation_Policy = Sequential_Evaluation >
+class AT_BFS_DQ_SH : public Degradable {
 
 public:
 
@@ -113,16 +121,22 @@ public:
 	typedef 	Closed_List< Search_Node >			Closed_List_Type;
 
 	AT_BFS_DQ_SH( 	const Search_Model& search_problem ) 
-	: m_problem( search_problem ), m_heuristic_func(NULL), 
+	: m_problem( search_problem ), m_heuristic_func(NULL), m_open_hash( Memory_Budget::OPEN ),
 	m_exp_count(0), m_gen_count(0), m_pruned_B_count(0), m_dead_end_count(0), m_open_repl_count(0),
-	m_B( infty ), m_time_budget(infty), m_po_exp_left( 100 ), m_non_po_exp_left(0), m_po_exp_max(100), m_non_po_exp_max(0) {
+	m_B( infty ), m_po_exp_left( 100 ), m_non_po_exp_left(0), m_po_exp_max(100), m_non_po_exp_max(0),
+	m_eval_policy( search_problem ), m_reporter( NULL ), m_best_h( infty ),
+	m_trace( NULL ), m_queue( 0 ), m_sink( NULL ) {
 		m_heuristic_func = new Abstract_Heuristic( search_problem );
+		m_budget.set_degradable( this );
 	}
 	
 	AT_BFS_DQ_SH( 	const Search_Model& search_problem, Abstract_Heuristic& h ) 
-	: m_problem( search_problem ), m_heuristic_func(&h), 
+	: m_problem( search_problem ), m_heuristic_func(&h), m_open_hash( Memory_Budget::OPEN ),
 	m_exp_count(0), m_gen_count(0), m_pruned_B_count(0), m_dead_end_count(0), m_open_repl_count(0),
-	m_B( infty ), m_time_budget(infty), m_po_exp_left( 100 ), m_non_po_exp_left(0), m_po_exp_max(100), m_non_po_exp_max(0) {
+	m_B( infty ), m_po_exp_left( 100 ), m_non_po_exp_left(0), m_po_exp_max(100), m_non_po_exp_max(0),
+	m_eval_policy( search_problem ), m_reporter( NULL ), m_best_h( infty ),
+	m_trace( NULL ), m_queue( 0 ), m_sink( NULL ) {
+		m_budget.set_degradable( this );
 	}
 
 	virtual ~AT_BFS_DQ_SH() {
@@ -154,14 +168,26 @@ public:
 		inc_gen();
 	}
 
+	// With a solution sink set, each plan is passed to it as soon as it is
+	// found and the search goes on under its cost, until open is empty or
+	// the budget runs out. The last plan found is returned then.
 	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
 		cost = infty;
-		m_t0 = time_used();
+		m_budget.start();
 		Search_Node* end = do_search();
-		if ( end == NULL ) return false;
-		extract_plan( m_root, end, plan, cost );	
-		float t2 = time_used();
-		m_time_budget -= ( t2 - m_t0 );		
+		bool solved = false;
+		while ( end != NULL ) {
+			trace( Trace_Writer::GOAL, end, end->hn() );
+			if ( solved ) plan.clear();
+			extract_plan( m_root, end, plan, cost );	
+			solved = true;
+			if ( m_sink == NULL ) break;
+			m_sink->found( *this, plan, cost, m_budget.elapsed() );
+			end = do_search();
+		}
+		if ( m_sink != NULL ) m_sink->finished( *this, m_budget.elapsed() );
+		if ( !solved ) return false;
+		m_budget.set_time( m_budget.time() - m_budget.elapsed() );
 		return true;
 	}
 
@@ -184,10 +210,45 @@ public:
 	void			inc_replaced_open()		{ m_open_repl_count++; }
 	unsigned		open_repl() const		{ return m_open_repl_count; }
 
-	void			set_budget( float v ) 		{ m_time_budget = v; }
-	float			time_budget() const		{ return m_time_budget; }
+	void			set_budget( float v ) 		{ m_budget.set_time( v ); }
+	float			time_budget() const		{ return m_budget.time(); }
+	Budget&			budget()			{ return m_budget; }
+	void			set_reporter( Stats_Reporter* r )	{ m_reporter = r; }
+	void			set_trace( Trace_Writer* t )	{ m_trace = t; }
+	void			set_solution_sink( Solution_Sink* s )	{ m_sink = s; }
+	float			best_h() const			{ return m_best_h; }
+
+	virtual void		stats( Search_Stats& s ) const {
+		s.expanded = expanded();
+		s.generated = generated();
+		s.dead_ends = dead_ends();
+		s.open_repl = open_repl();
+		s.pruned_bound = pruned_by_bound();
+		s.open = m_open_hash.size();
+		s.closed = m_closed.size();
+		s.best_h = m_best_h;
+		s.bound = bound();
+	}
+
+	// Called on each expansion
+	void			report( Search_Node* n ) {
+		if ( n->hn() < m_best_h ) m_best_h = n->hn();
+		if ( m_reporter != NULL ) m_reporter->tick( *this );
+		if ( m_trace != NULL ) m_trace->record( Trace_Writer::EXPAND, n, n->hn(), m_queue );
+	}
+
+	void			trace( Trace_Writer::Event e, Search_Node* n, float h ) {
+		if ( m_trace != NULL ) m_trace->record( e, n, h, m_queue );
+	}
 
-	float			t0() const			{ return m_t0; }
+	// Drops the states of the nodes in closed
+	virtual bool		degrade( Memory_Budget& m ) {
+		double before = m.used();
+		size_t n = m_closed.compact();
+		if ( n == 0 ) return false;
+		m.degraded( "dropped the states of " + std::to_string( n ) + " nodes in closed, telling them apart by hash", before - m.used() );
+		return true;
+	}
 
 	void 			close( Search_Node* n ) 	{  m_closed.put(n); }
 
@@ -198,6 +259,7 @@ public:
 	Closed_List_Type&	closed() 			{ return m_closed; }
 	Closed_List_Type&	open_hash() 			{ return m_open_hash; }
 	Abstract_Heuristic&	heuristic()			{ return *m_heuristic_func; }
+	Evaluation_Policy&	evaluation_policy()		{ return m_eval_policy; }
 
 	virtual void	eval( Search_Node* candidate ) {
 		std::vector<Action_Idx>	po;
@@ -210,6 +272,7 @@ public:
 		if ( open.empty() ) return NULL;
 
 		Search_Node* next = open.pop();
+		m_queue = ( &open == &m_open_po ? 1 : 0 );
 		if ( !m_open_hash.empty() )
 		m_open_hash.erase( m_open_hash.retrieve_iterator( next) );
 		return next;				
@@ -267,6 +330,11 @@ public:
 	
 
 	virtual void 	process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
+		process( head, typename Evaluation_Policy::Batched() );
+	}
+
+	void	process( Search_Node *head, std::false_type ) {
 		typedef typename Search_Model::Action_Iterator Iterator;
 		Iterator it( this->problem() );
 		int a = it.start( *(head->state()) );
@@ -291,12 +359,56 @@ public:
 		inc_eval();
 	}
 
+	// Successors are evaluated in batches when generated
+	void	process( Search_Node *head, std::true_type ) {
+		typedef typename Search_Model::Action_Iterator Iterator;
+		Iterator it( this->problem() );
+		int a = it.start( *(head->state()) );
+		while ( a != no_op ) {
+			State *succ = m_problem.next( *(head->state()), a );
+			Search_Node* n = new Search_Node( succ, m_problem.cost( *(head->state()), a ), a, head, m_problem.num_actions() );
+			if ( is_closed( n ) || is_open( n ) ) {
+				delete n;
+				a = it.next();
+				continue;
+			}
+			m_batch.push_back( n );
+			if ( m_batch.size() >= m_eval_policy.batch_size() )
+				open_batch( head );
+			a = it.next();
+		}
+		open_batch( head );
+		inc_eval();
+	}
+
+	void	open_batch( Search_Node* head ) {
+		if ( m_batch.empty() ) return;
+		m_eval_policy.evaluate( m_batch, true );
+		for ( unsigned i = 0; i < m_batch.size(); i++ ) {
+			Search_Node* n = m_batch[i];
+			n->hn() = m_eval_policy.h(i);
+			const std::vector<Action_Idx>& po = m_eval_policy.preferred(i);
+			for ( unsigned k = 0; k < po.size(); k++ )
+				n->add_po( po[k] );
+			n->fn() = n->hn() + n->gn();
+			// Two successors in the same batch can be the same state
+			if ( is_closed( n ) || is_open( n ) ) {
+				delete n;
+				continue;
+			}
+			open_node( n, head->is_po( n->action() ) );
+		}
+		m_batch.clear();
+	}
+
 	virtual Search_Node*	 do_search() {
+		APTK_PHASE( SEARCH );
 		Search_Node *head = get_node();
 		int counter =0;
 		while(head) {
 			if ( head->gn() >= bound() )  {
 				inc_pruned_bound();
+				trace( Trace_Writer::PRUNE, head, head->hn() );
 				close(head);
 				head = get_node();
 				continue;
@@ -307,12 +419,14 @@ public:
 				set_bound( head->gn() );	
 				return head;
 			}
-			if ( (time_used() - m_t0 ) > m_time_budget )
+			if ( m_budget.exhausted() )
 				return NULL;
 	
-			eval( head );
+			if ( !Evaluation_Policy::Batched::value )
+				eval( head );
 
 			process(head);
+			report(head);
 			close(head);
 			counter++;
 			head = get_node();
@@ -332,7 +446,10 @@ public:
 				previous_copy->m_g = n->m_g;
 				previous_copy->m_f = previous_copy->m_h + previous_copy->m_g;
 				inc_replaced_open();
+				trace( Trace_Writer::REPLACE, n, previous_copy->hn() );
 			}
+			else
+				trace( Trace_Writer::DUPLICATE, n, previous_copy->hn() );
 			return true;
 		}
 
@@ -346,11 +463,13 @@ public:
 			if ( n2->gn() <= n->gn() ) {
 				// The node we generated is a worse path than
 				// the one we already found
+				trace( Trace_Writer::DUPLICATE, n, n2->hn() );
 				return true;
 			}
+			trace( Trace_Writer::REOPEN, n, n2->hn() );
 			// Otherwise, we put it into Open and remove
 			// n2 from closed
-			closed().erase( closed().retrieve_iterator( n2 ) );
+			closed().erase( closed().retrieve_iterator( n ) );
 		}
 		return false;
 	}
@@ -361,7 +480,8 @@ protected:
 		Search_Node *tmp = t;
 		cost = 0.0f;
 		while( tmp != s) {
-			cost += m_problem.cost( *(tmp->state()), tmp->action() );
+			// States in closed may have been dropped
+			cost += tmp->state() != NULL ? m_problem.cost( *(tmp->state()), tmp->action() ) : tmp->gn() - tmp->parent()->gn();
 			plan.push_back(tmp->action());
 			tmp = tmp->parent();
 		}
@@ -392,14 +512,21 @@ protected:
 	unsigned				m_dead_end_count;
 	unsigned				m_open_repl_count;
 	float					m_B;
-	float					m_time_budget;
-	float					m_t0;
+	Budget					m_budget;
 	Search_Node*				m_root;
 	unsigned				m_po_exp_left;
 	unsigned				m_non_po_exp_left;
 	unsigned				m_po_exp_max;
 	unsigned				m_non_po_exp_max;
+	Evaluation_Policy			m_eval_policy;
+	std::vector<Search_Node*>		m_batch;
 	std::vector<Action_Idx>			m_app_set;
+	Stats_Reporter*				m_reporter;
+	float					m_best_h;
+	Trace_Writer*				m_trace;
+	// Open list the last node was taken from
+	unsigned				m_queue;
+	Solution_Sink*				m_sink;
 };
 
 }
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
 #include <aptk/closed_list.hxx>
+#include <aptk/probes.hxx>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -95,6 +96,7 @@ public:
 	}
 
 	virtual void 	process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
 
 		typedef typename Search_Model::Action_Iterator Iterator;
 		Iterator it( this->problem() );
@@ -187,12 +189,14 @@ public:
 	}
 
 	virtual Search_Node*	 	do_search() {
+		APTK_PHASE( SEARCH );
 		if ( !this->closed().empty() )
 			restart_search();	
 		Search_Node *head = this->get_node();
 		while(head) {
 			if ( head->gn() >= this->bound() )  {
 				this->inc_pruned_bound();
+				this->trace( Trace_Writer::PRUNE, head, head->hn() );
 				this->close(head);
 				head = this->get_node();
 				continue;
@@ -205,12 +209,13 @@ public:
 				if ( m_W < 1.0f ) m_W = 1.0f;
 				return head;
 			}
-			if ( (time_used() - this->t0() ) > this->time_budget() )
+			if ( this->budget().exhausted() )
 				return NULL;
 	
 			this->eval( head );
 
 			this->process(head);
+			this->report(head);
 			this->close(head);
 			
 			head = this->get_node();
@@ -218,6 +223,10 @@ public:
 		return NULL;
 	}
 
+	// Nodes in closed are expanded again after a restart, so their
+	// states are kept
+	virtual bool	degrade( Memory_Budget& ) { return false; }
+
 	void	restart_search() {
 		// MRJ: Move Closed to Seen
 		for ( typename Closed_List_Type::iterator it = this->closed().begin();
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
 #include <aptk/closed_list.hxx>
+#include <aptk/probes.hxx>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -58,6 +59,7 @@ public:
 	}
 
 	virtual void 			process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
 
 		typedef typename Search_Model::Action_Iterator Iterator;
 		Iterator it( this->problem() );
@@ -87,10 +89,12 @@ public:
 	}
 
 	virtual Search_Node*	 	do_search() {
+		APTK_PHASE( SEARCH );
 		Search_Node *head = this->get_node();
 		while(head) {
 			if ( head->gn() >= this->bound() )  {
 				this->inc_pruned_bound();
+				this->trace( Trace_Writer::PRUNE, head, head->hn() );
 				this->close(head);
 				head = this->get_node();
 				continue;
@@ -103,12 +107,13 @@ public:
 				if ( m_W < 1.0f ) m_W = 1.0f;	
 				return head;
 			}
-			if ( (time_used() - this->t0() ) > this->time_budget() )
+			if ( this->budget().exhausted() )
 				return NULL;
 	
 			this->eval( head );
 
 			this->process(head);
+			this->report(head);
 			this->close(head);
 			head = this->get_node();
 		}
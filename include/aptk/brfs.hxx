@@ -23,12 +23,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
+#include <aptk/budget.hxx>
+#include <aptk/probes.hxx>
+#include <aptk/stats_reporter.hxx>
 #include <aptk/closed_list.hxx>
 
 #include <queue>
+#include <deque>
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 namespace aptk {
 
@@ -37,7 +42,7 @@ namespace search {
 namespace brfs {
 
 template <typename State>
-class Node {
+class Node : public Tracked< Memory_Budget::NODES > {
 public:
 
 	typedef State State_Type;
@@ -92,33 +97,24 @@ public:
 };
 
 template <typename Search_Model>
-class BRFS {
+class BRFS : public Degradable {
 
 public:
 
 	typedef		typename Search_Model::State_Type		State;
 	typedef  	Node< State >					Search_Node;
 	typedef 	Closed_List< Search_Node >      		Closed_List_Type;
+	typedef		std::deque< Search_Node*, Tracking_Allocator< Search_Node* > >	Open_Queue;
 
 	BRFS( 	const Search_Model& search_problem ) 
-	: m_problem( search_problem ), m_exp_count(0), m_gen_count(0), m_cl_count(0), m_max_depth(0) {		
+	: m_problem( search_problem ), m_open( Open_Queue( Tracking_Allocator< Search_Node* >( Memory_Budget::OPEN ) ) ),
+	m_open_hash( Memory_Budget::OPEN ), m_exp_count(0), m_gen_count(0), m_cl_count(0), m_max_depth(0),
+	m_root( NULL ), m_goal( NULL ), m_reused_goal( NULL ), m_reporter( NULL ) {		
+		m_budget.set_degradable( this );
 	}
 
 	virtual ~BRFS() {
-		for ( typename Closed_List_Type::iterator i = m_closed.begin();
-			i != m_closed.end(); i++ ) {
-			delete i->second;
-		}
-		
-		while	(!m_open.empty() ) 
-		{	
-			Search_Node* n = m_open.front();
-			m_open.pop();
-			delete n;
-		}
-		
-		m_closed.clear();
-		m_open_hash.clear();
+		reset();
 	}
 
 	void reset() {
@@ -133,9 +129,13 @@ public:
 			m_open.pop();
 			delete n;
 		}
+		for ( unsigned k = 0; k < m_kept.size(); k++ )
+			delete m_kept[k];
 		
 		m_closed.clear();
 		m_open_hash.clear();
+		m_kept.clear();
+		m_goal = m_reused_goal = NULL;
 		m_max_depth=0;
 	}
 	
@@ -159,9 +159,36 @@ public:
 		inc_gen();
 	}
 
+	// Starts the search again from s, which the engine takes. When s was
+	// generated by the search so far, the nodes below it are kept, as
+	// their depths below s are still the shortest, and are expanded again
+	// in order of depth along with the nodes generated from them. If the
+	// last solution found goes through s, its rest is a shortest plan
+	// from s, and the first call to find_solution() returns it. Otherwise,
+	// or when s is unknown, this is the same as start( s ), and false is
+	// returned. The task must not have changed since the search began.
+	bool	replan( State* s ) {
+		Search_Node probe( s, no_op, NULL );
+		Search_Node* r = m_closed.retrieve_shallowest( &probe );
+		Search_Node* o = m_open_hash.retrieve_shallowest( &probe );
+		if ( r == NULL || ( o != NULL && o->gn() < r->gn() ) ) r = o;
+		probe.set_state( NULL );
+		if ( r == NULL ) {
+			start( s );
+			return false;
+		}
+		delete s;
+		reroot( r );
+		return true;
+	}
+
 	virtual bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
-		Search_Node* end = do_search();
+		Search_Node* end = m_reused_goal;
+		m_reused_goal = NULL;
+		m_budget.start();
+		if ( end == NULL ) end = do_search();
 		if ( end == NULL ) return false;
+		m_goal = end;
 		extract_plan( m_root, end, plan, cost );	
 		
 		return true;
@@ -175,6 +202,28 @@ public:
 	void			inc_closed()			{ m_cl_count++; }
 	unsigned		pruned_closed() const		{ return m_cl_count; }
 
+	void			set_budget( float v )		{ m_budget.set_time( v ); }
+	float			time_budget() const		{ return m_budget.time(); }
+	Budget&			budget()			{ return m_budget; }
+	// Depths reached are not printed when there is a reporter
+	void			set_reporter( Stats_Reporter* r )	{ m_reporter = r; }
+
+	virtual void		stats( Search_Stats& s ) const {
+		s.expanded = expanded();
+		s.generated = generated();
+		s.open = m_open_hash.size();
+		s.closed = m_closed.size();
+		s.depth = m_max_depth;
+	}
+
+	// Called on each expansion
+	void			report() {
+		if ( m_reporter != NULL ) m_reporter->tick( *this );
+	}
+
+	// Nothing is given up here, see IW
+	virtual bool		degrade( Memory_Budget& ) { return false; }
+
 	void 			close( Search_Node* n ) 	{  m_closed.put(n); }
 	Closed_List_Type&	closed() 			{ return m_closed; }
 	Closed_List_Type&	open_hash() 			{ return m_open_hash; }
@@ -190,9 +239,17 @@ public:
 		return false;
 	}
 
+	// Nodes kept by replan() are merged with open by depth, after those
+	// generated since at the same depth
 	Search_Node* 		get_node() {
+		APTK_PHASE( OPEN_LIST );
 		Search_Node *next = NULL;
-		if(! m_open.empty() ) {
+		if ( !m_kept.empty() && ( m_open.empty() || m_kept.front()->gn() < m_open.front()->gn() ) ) {
+			next = m_kept.front();
+			m_kept.pop_front();
+			m_open_hash.erase( m_open_hash.retrieve_iterator( next) );
+		}
+		else if(! m_open.empty() ) {
 			next = m_open.front();
 			m_open.pop();
 			m_open_hash.erase( m_open_hash.retrieve_iterator( next) );
@@ -201,18 +258,21 @@ public:
 	}
 
 	void	 	open_node( Search_Node *n ) {		
+		APTK_PHASE( OPEN_LIST );
 		m_open.push(n);
 		m_open_hash.put(n);
 		inc_gen();
 		if(n->gn() + 1 > m_max_depth){
-			if( m_max_depth == 0 ) std::cout << std::endl;  
+			if( m_max_depth == 0 && m_reporter == NULL ) std::cout << std::endl;  
 			m_max_depth = n->gn() + 1 ;
-			std::cout << "[" << m_max_depth << "]" << std::flush;
+			if ( m_reporter == NULL )
+				std::cout << "[" << m_max_depth << "]" << std::flush;
 		}
 
 	}
 
 	virtual Search_Node*   process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
 		typedef typename Search_Model::Action_Iterator Iterator;
 		Iterator it( this->problem() );
 		
@@ -245,6 +305,7 @@ public:
 	}
 
 	virtual Search_Node*	 	do_search() {
+		APTK_PHASE( SEARCH );
 		Search_Node *head = get_node();
 		if( is_goal( head->state() ) )
 			return head;
@@ -254,6 +315,8 @@ public:
 			Search_Node* goal = process(head);
 			close(head);
 			if( goal ) return goal;
+			if ( m_budget.exhausted() ) return NULL;
+			report();
 			counter++;
 			head = get_node();
 		}
@@ -271,6 +334,72 @@ public:
 
 protected:
 
+	static bool	shallower( const Search_Node* a, const Search_Node* b ) { return a->gn() < b->gn(); }
+
+	void	reroot( Search_Node* r ) {
+		std::vector< Search_Node* >	nodes;
+		for ( typename Closed_List_Type::iterator i = m_closed.begin(); i != m_closed.end(); i++ )
+			nodes.push_back( i->second );
+		while ( !m_open.empty() ) {
+			nodes.push_back( m_open.front() );
+			m_open.pop();
+		}
+		nodes.insert( nodes.end(), m_kept.begin(), m_kept.end() );
+		m_closed.clear();
+		m_open_hash.clear();
+		m_kept.clear();
+
+		// Whether each node is r or below it, following parents up to a
+		// node already seen
+		std::unordered_map< Search_Node*, bool >	below( 2 * nodes.size() );
+		std::vector< Search_Node* >			path;
+		below[ r ] = true;
+		std::vector< bool >	kept( nodes.size() );
+		for ( unsigned k = 0; k < nodes.size(); k++ ) {
+			Search_Node* n = nodes[k];
+			bool found = false;
+			path.clear();
+			while ( n != NULL ) {
+				typename std::unordered_map< Search_Node*, bool >::iterator it = below.find( n );
+				if ( it != below.end() ) {
+					found = it->second;
+					break;
+				}
+				path.push_back( n );
+				n = n->parent();
+			}
+			for ( unsigned i = 0; i < path.size(); i++ )
+				below[ path[i] ] = found;
+			kept[k] = found;
+		}
+
+		// The root has depth 1
+		unsigned g_r = r->gn() - 1;
+		Search_Node* goal = NULL;
+		for ( unsigned k = 0; k < nodes.size(); k++ ) {
+			Search_Node* n = nodes[k];
+			if ( !kept[k] ) {
+				delete n;
+				continue;
+			}
+			n->gn() -= g_r;
+			if ( n == m_goal && is_goal( n->state() ) ) {
+				goal = n;
+				close( n );
+				continue;
+			}
+			m_kept.push_back( n );
+			m_open_hash.put( n );
+		}
+		std::stable_sort( m_kept.begin(), m_kept.end(), shallower );
+		r->m_parent = NULL;
+		r->m_action = no_op;
+		m_root = r;
+		m_goal = NULL;
+		m_reused_goal = goal;
+		m_max_depth = 0;
+	}
+
 	void	extract_plan( Search_Node* s, Search_Node* t, std::vector<Action_Idx>& plan, float& cost ) {
 		Search_Node *tmp = t;
 		cost = 0.0f;
@@ -296,14 +425,21 @@ protected:
 protected:
 
 	const Search_Model&			m_problem;
-	std::queue<Search_Node*>		m_open;
+	std::queue<Search_Node*, Open_Queue>	m_open;
 	Closed_List_Type			m_closed, m_open_hash;
 	unsigned				m_exp_count;
 	unsigned				m_gen_count;
 	unsigned				m_cl_count;
 	unsigned                                m_max_depth;
 	Search_Node*				m_root;
+	// Last solution returned, and the rest of it kept by replan()
+	Search_Node*				m_goal;
+	Search_Node*				m_reused_goal;
+	// Nodes kept by replan() still to be expanded, by depth
+	std::deque<Search_Node*>		m_kept;
 	std::vector<Action_Idx> 		m_app_set;
+	Budget					m_budget;
+	Stats_Reporter*				m_reporter;
 };
 
 }
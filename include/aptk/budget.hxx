@@ -0,0 +1,104 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __BUDGET__
+#define __BUDGET__
+
+#include <aptk/memory.hxx>
+#include <atomic>
+
+namespace aptk
+{
+
+// Time and memory limits of a search, cheap enough to check on every
+// expansion. The clock is only read every so many calls to exhausted(),
+// that many as are made in about check_interval() secs at the rate seen
+// over the last reads, so the limit is overshot by about that much. The
+// clock is CLOCK_MONOTONIC, which is read without a system call, and the
+// peak resident set size is read on one check out of every few.
+//
+// stop() can be called from other threads or from a signal handler, the
+// engine then stops as if a limit had been hit.
+//
+// When the shared Memory_Budget is limited, it is read as often as the
+// peak resident set size. Under pressure the engine set with set_degradable()
+// is asked to give up memory, once a second past the soft limit and on
+// every read past the limit, and the search stops if it is still past
+// the limit after that.
+class Budget
+{
+public:
+	enum Limit { NONE = 0, TIME, MEMORY, STOPPED };
+
+	Budget();
+	~Budget();
+
+	// In secs and MB, both unlimited to begin with
+	void	set_time( double secs )		{ m_time = secs; }
+	double	time() const			{ return m_time; }
+	void	set_memory( double mb )		{ m_memory = mb; }
+	double	memory() const			{ return m_memory; }
+
+	// Time is counted from here, and whatever limit was hit is cleared
+	void	start();
+	double	elapsed() const;
+	double	remaining() const		{ return m_time - elapsed(); }
+
+	bool	exhausted() {
+		if ( m_stop.load( std::memory_order_relaxed ) ) return true;
+		if ( --m_countdown > 0 ) return false;
+		return check();
+	}
+
+	void	stop()				{ m_stop.store( true, std::memory_order_relaxed ); }
+	Limit	hit() const {
+		if ( m_hit == NONE && m_stop.load( std::memory_order_relaxed ) ) return STOPPED;
+		return m_hit;
+	}
+
+	void	set_degradable( Degradable* d )	{ m_degradable = d; }
+
+	void	set_check_interval( double secs )	{ m_interval = secs; }
+	double	check_interval() const		{ return m_interval; }
+	// Times the clock has been read by exhausted()
+	unsigned long	checks() const		{ return m_checks; }
+
+protected:
+
+	bool	check();
+
+	double			m_time;
+	double			m_memory;
+	double			m_interval;
+	double			m_t0;
+	double			m_last;
+	double			m_last_memory;
+	double			m_last_degraded;
+	Degradable*		m_degradable;
+	long			m_period;
+	long			m_countdown;
+	unsigned long		m_checks;
+	Limit			m_hit;
+	std::atomic<bool>	m_stop;
+};
+
+}
+
+#endif // budget.hxx
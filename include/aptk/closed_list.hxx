@@ -22,7 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define __CLOSED_LIST__
 
 #include <unordered_map>
+#include <functional>
 #include <utility>
+#include <aptk/probes.hxx>
+#include <aptk/memory.hxx>
 
 namespace aptk {
 
@@ -30,20 +33,50 @@ namespace search {
 enum class Node_Generation { Eager, Lazy};
 
 	template <typename Node, Node_Generation gen_opt = Node_Generation::Eager>
-class Closed_List : public std::unordered_multimap< size_t, Node* > {
+class Closed_List : public std::unordered_multimap< size_t, Node*, std::hash<size_t>, std::equal_to<size_t>,
+						Tracking_Allocator< std::pair< const size_t, Node* > > > {
 public:
+	typedef std::unordered_multimap< size_t, Node*, std::hash<size_t>, std::equal_to<size_t>,
+					Tracking_Allocator< std::pair< const size_t, Node* > > >	Map;
 	typedef typename Node::State_Type						State;
-	typedef typename std::unordered_multimap< size_t, Node* >::iterator 		iterator;
-	typedef typename std::unordered_multimap< size_t, Node* >::const_iterator	const_iterator;
+	typedef typename Map::iterator 							iterator;
+	typedef typename Map::const_iterator						const_iterator;
+
+	// Memory is counted as part of s
+	Closed_List( Memory_Budget::Subsystem s = Memory_Budget::CLOSED )
+	: Map( typename Map::allocator_type( s ) ) {
+	}
+
+	// Nodes whose states were dropped by compact() are taken to be the
+	// same as any node with the same hash
+	static bool	same_state( Node* a, Node* b ) {
+		return a->state() == NULL || (*a->state()) == (*b->state());
+	}
+
+	// Hash compaction: drops the states of the nodes in the list, so from
+	// then on a state is taken to be in the list if its hash is. Returns
+	// the number of states dropped
+	size_t	compact() {
+		if ( gen_opt == Node_Generation::Lazy ) return 0;
+		size_t dropped = 0;
+		for ( iterator it = this->begin(); it != this->end(); it++ ) {
+			if ( it->second->m_state == NULL ) continue;
+			delete it->second->m_state;
+			it->second->m_state = NULL;
+			dropped++;
+		}
+		return dropped;
+	}
 
 	Node*	retrieve( Node* n ) {
+		APTK_PHASE( DUPLICATES );
 		std::pair< iterator, iterator > range = (gen_opt == Node_Generation::Lazy ? this->equal_range( n->hash() ) : this->equal_range( n->state()->hash() ));
 		if ( range.first != range.second ) {
 			bool in_closed = false;
 			iterator it;
 			for ( it = range.first; it != range.second; it++ )
 				if(gen_opt == Node_Generation::Eager){
-					if ( (*it->second->state()) == (*n->state()) ) {
+					if ( same_state( it->second, n ) ) {
 						in_closed = true;
 						return it->second;
 					}
@@ -57,8 +90,8 @@ public:
 			if ( !in_closed && range.second != this->end() ) {
 			
 				if(gen_opt == Node_Generation::Eager){
-					const State& lhs = *(range.second->second->state());
-					if ( lhs == *(n->state()) ) return range.second->second;
+					Node* lhs = range.second->second;
+					if ( lhs->state() != NULL && *(lhs->state()) == *(n->state()) ) return range.second->second;
 				}
 				else{
 					const Node& lhs = *(range.second->second);
@@ -70,6 +103,7 @@ public:
 	}
 
 	iterator retrieve_iterator( Node* n ) {
+		APTK_PHASE( DUPLICATES );
 		std::pair< iterator, iterator > range = (gen_opt == Node_Generation::Lazy ? this->equal_range( n->hash() ) : this->equal_range( n->state()->hash() ));
 		
 		if ( range.first != this->end() ) {
@@ -77,7 +111,7 @@ public:
 			iterator it;
 			for ( it = range.first; it != range.second; it++ )
 				if(gen_opt == Node_Generation::Eager){
-					if ( (*it->second->state()) == (*n->state()) ) {
+					if ( same_state( it->second, n ) ) {
 						in_closed = true;
 						return it;
 					}
@@ -90,8 +124,8 @@ public:
 				}
 			if ( !in_closed && range.second != this->end() ) {
 				if(gen_opt == Node_Generation::Eager){
-					const State& lhs = *(range.second->second->state());
-					if ( lhs == *(n->state()) ) return range.second;				
+					Node* lhs = range.second->second;
+					if ( lhs->state() != NULL && *(lhs->state()) == *(n->state()) ) return range.second;				
 				}
 				else{
 					const Node& lhs = *(range.second->second);
@@ -110,7 +144,7 @@ public:
 			const_iterator it;
 			for ( it = range.first; it != range.second; it++ )
 				if(gen_opt == Node_Generation::Eager){
-					if ( (*it->second->state()) == (*n->state()) ) {
+					if ( same_state( it->second, n ) ) {
 						in_closed = true;
 						return it;
 					}
@@ -123,8 +157,8 @@ public:
 				}	
 			if ( !in_closed && range.second != this->end() ) {
 				if(gen_opt == Node_Generation::Eager){
-					const State& lhs = *(range.second->second->state());
-					if ( lhs == *(n->state()) ) return range.second;
+					Node* lhs = range.second->second;
+					if ( lhs->state() != NULL && *(lhs->state()) == *(n->state()) ) return range.second;
 				}
 				else{
 					const Node& lhs = *(range.second->second);
@@ -135,6 +169,19 @@ public:
 		return this->end();			
 	}
 
+	// Same as retrieve(), but gets the node with the lowest g(n) if the
+	// state of n is there more than once, as it is when an action leads
+	// back to the state being expanded
+	Node*	retrieve_shallowest( Node* n ) {
+		APTK_PHASE( DUPLICATES );
+		std::pair< iterator, iterator > range = this->equal_range( n->state()->hash() );
+		Node* best = NULL;
+		for ( iterator it = range.first; it != range.second; it++ )
+			if ( same_state( it->second, n ) && ( best == NULL || it->second->gn() < best->gn() ) )
+				best = it->second;
+		return best;
+	}
+
 	void	put( Node* n ) {
 		if(gen_opt == Node_Generation::Lazy)
 			this->insert( std::make_pair( n->hash(), n ) );
@@ -152,6 +199,7 @@ public:
 	typedef typename std::unordered_multimap< size_t, Node* >::const_iterator	const_iterator;
 
 	Node*	retrieve( Node* n ) {
+		APTK_PHASE( DUPLICATES );
 		std::pair< iterator, iterator > range = equal_range( n->hash() );
 		if ( range.first != range.second ) {
 			bool in_closed = false;
@@ -170,6 +218,7 @@ public:
 	}
 
 	iterator retrieve_iterator( Node* n ) {
+		APTK_PHASE( DUPLICATES );
 		std::pair< iterator, iterator> range = this->equal_range( n->hash() );
 		if ( range.first != this->end() ) {
 			bool in_closed = false;
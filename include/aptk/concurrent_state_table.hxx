@@ -0,0 +1,162 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CONCURRENT_STATE_TABLE__
+#define __CONCURRENT_STATE_TABLE__
+
+#include <atomic>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace aptk
+{
+
+// State table that any number of threads can query and insert into at the
+// same time, without locks. States are given as a 64-bit fingerprint plus
+// a packed payload of a fixed number of 32-bit words (e.g. the bits of the
+// fluent set), and get a 32-bit ID which stays valid for the lifetime of the
+// table. Every entry also keeps the best g value seen, which can be lowered
+// concurrently.
+//
+// The index is an open addressing table with linear probing, whose slots
+// hold the ID and part of the fingerprint of an entry. When it gets half
+// full a table twice as large is allocated, and the threads trying to
+// insert move the old slots over in chunks before going on. Entries
+// themselves live in segments which are never moved, so IDs and payload
+// pointers are not affected by resizing.
+//
+// Two threads inserting the same state at the same time may both reserve
+// an ID, only one of them makes it into the index and the other is never
+// handed out, so IDs are unique but there may be gaps between them.
+class Concurrent_State_Table
+{
+public:
+	typedef	uint32_t	Word;
+	typedef	uint32_t	State_ID;
+
+	static const State_ID	no_state = 0xFFFFFFFF;
+
+	Concurrent_State_Table( unsigned payload_words, size_t initial_capacity = 1 << 16 );
+	~Concurrent_State_Table();
+
+	// Returns the ID of the state, and whether it was inserted by this call
+	std::pair< State_ID, bool >	insert( uint64_t fp, const Word* payload, float g );
+	State_ID			find( uint64_t fp, const Word* payload ) const;
+
+	// Lowers the g value of the entry to g, returns false if it was already
+	// as low
+	bool			update_g( State_ID id, float g );
+	float			g( State_ID id ) const;
+	const Word*		payload( State_ID id ) const;
+	uint64_t		fingerprint( State_ID id ) const;
+
+	unsigned		payload_words() const	{ return m_payload_words; }
+	// Number of states in the table
+	size_t			size() const		{ return m_size.load( std::memory_order_relaxed ); }
+	size_t			capacity() const;
+	unsigned		resizes() const		{ return m_resizes.load( std::memory_order_relaxed ); }
+
+	// 64-bit fingerprint of a packed state
+	static uint64_t		hash( const Word* payload, unsigned n );
+
+protected:
+
+	// Slots are 0 when empty, otherwise they keep the ID plus one in the low
+	// 32 bits and 31 bits of the fingerprint above it. The top bit freezes
+	// the slot once it has been moved to a larger table.
+	static const uint64_t	frozen_bit = 0x8000000000000000ULL;
+
+	struct Index {
+		Index( size_t cap );
+		~Index();
+
+		size_t				capacity;
+		std::atomic<uint64_t>*		slots;
+		std::atomic<Index*>		next;
+		std::atomic<size_t>		migrate_cursor;
+		std::atomic<size_t>		migrated;
+		Index*				retired;
+	};
+
+	struct Segment {
+		Segment( unsigned payload_words );
+		~Segment();
+
+		uint64_t*			fps;
+		std::atomic<Word>*		g;
+		Word*				payloads;
+	};
+
+	static const unsigned	segment_bits = 16;
+	static const unsigned	segment_size = 1 << segment_bits;
+	static const unsigned	max_segments = 1 << ( 32 - segment_bits );
+	static const size_t	migrate_chunk = 4096;
+
+	static uint64_t		slot_value( uint64_t fp, State_ID id ) {
+		return ( ( ( fp >> 32 ) & 0x7FFFFFFFULL ) << 32 ) | ( (uint64_t)id + 1 );
+	}
+	static State_ID		slot_id( uint64_t v )	{ return (State_ID)( ( v & 0xFFFFFFFFULL ) - 1 ); }
+	static uint32_t		slot_tag( uint64_t v )	{ return (uint32_t)( ( v >> 32 ) & 0x7FFFFFFFULL ); }
+
+	Segment*		segment( State_ID id ) const {
+		return m_segments[ id >> segment_bits ].load( std::memory_order_acquire );
+	}
+	Segment*		reserve_segment( State_ID id );
+	bool			matches( uint64_t v, uint64_t fp, const Word* payload ) const;
+	bool			place( Index* idx, uint64_t v );
+	void			help_migrate( Index* idx );
+	void			grow( Index* idx );
+
+	unsigned				m_payload_words;
+	std::atomic<Index*>			m_index;
+	std::atomic<Segment*>*			m_segments;
+	std::atomic<State_ID>			m_next_id;
+	std::atomic<size_t>			m_size;
+	std::atomic<unsigned>			m_resizes;
+};
+
+inline float Concurrent_State_Table::g( State_ID id ) const
+{
+	Word w = segment(id)->g[ id & ( segment_size - 1 ) ].load( std::memory_order_relaxed );
+	float v;
+	std::memcpy( &v, &w, sizeof(v) );
+	return v;
+}
+
+inline const Concurrent_State_Table::Word* Concurrent_State_Table::payload( State_ID id ) const
+{
+	return segment(id)->payloads + (size_t)( id & ( segment_size - 1 ) ) * m_payload_words;
+}
+
+inline uint64_t Concurrent_State_Table::fingerprint( State_ID id ) const
+{
+	return segment(id)->fps[ id & ( segment_size - 1 ) ];
+}
+
+inline size_t Concurrent_State_Table::capacity() const
+{
+	return m_index.load( std::memory_order_acquire )->capacity;
+}
+
+}
+
+#endif // concurrent_state_table.hxx
@@ -23,8 +23,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
+#include <aptk/budget.hxx>
+#include <aptk/probes.hxx>
+#include <aptk/stats_reporter.hxx>
 #include <aptk/closed_list.hxx>
 #include <aptk/sliding_window.hxx>
+#include <aptk/parallel_eval.hxx>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -92,6 +96,9 @@ public:
 
 	unsigned		exp_nr() const			{ return m_exp_nr; }
 
+	bool			operator==( const Node<State>& o ) const { return *m_state == *(o.m_state); }
+	size_t			hash() const			{ return m_state->hash(); }
+
 public:
 
 	State*		m_state;
@@ -108,7 +115,9 @@ public:
 };
 
 
-template < typename Search_Model, typename Abstract_Heuristic, typename Depth_Estimator, typename Open_List_Type >
+// With a Parallel_Evaluation policy the heuristic of successors is evaluated
+// in batches, the depth estimator is then evaluated in this thread
+template < typename Search_Model, typename Abstract_Heuristic, typename Depth_Estimator, typename Open_List_Type, typename Evaluation_Policy = Sequential_Evaluation >
 class	Deadline_Aware_Search {
 
 public:
@@ -118,9 +127,10 @@ public:
 
 	Deadline_Aware_Search( const Search_Model& p ) 
 	: m_problem( p ), m_h_func( NULL ), m_d_func(NULL), m_exp_count(0), m_gen_count(0),
-	m_time_budget( std::numeric_limits<double>::max() ), m_root(NULL), m_open_repl_count(0),
-	m_pruned_repl_count(0), m_dead_end_count(0), m_t0(0.0), m_ed_stats( 200, 50 ), m_nr_stats( 200, 50 ),
-	m_B( infty ), m_pruned_B_count(0) {
+	m_root(NULL), m_open_repl_count(0),
+	m_pruned_repl_count(0), m_dead_end_count(0), m_ed_stats( 200, 50 ), m_nr_stats( 200, 50 ),
+	m_B( infty ), m_pruned_B_count(0), m_eval_policy( problem() ),
+	m_reporter( NULL ), m_best_h( infty ) {
 		m_h_func = new Abstract_Heuristic( problem() );
 		m_d_func = new Depth_Estimator( problem() );
 	}
@@ -149,9 +159,29 @@ public:
 	unsigned		pruned_by_bound() const		{ return m_pruned_B_count; }
 
 
-	void			set_budget( double v ) 		{ m_time_budget = v; }
-	double			time_budget() const		{ return m_time_budget; }
-	double			t0() const			{ return m_t0; }
+	void			set_budget( double v ) 		{ m_budget.set_time( v ); }
+	double			time_budget() const		{ return m_budget.time(); }
+	Budget&			budget()			{ return m_budget; }
+	void			set_reporter( Stats_Reporter* r )	{ m_reporter = r; }
+	float			best_h() const			{ return m_best_h; }
+
+	virtual void		stats( Search_Stats& s ) const {
+		s.expanded = expanded();
+		s.generated = generated();
+		s.dead_ends = dead_ends();
+		s.open_repl = open_repl();
+		s.pruned_bound = pruned_by_bound();
+		s.open = m_open_hash.size();
+		s.closed = m_closed.size();
+		s.best_h = m_best_h;
+		s.bound = bound();
+	}
+
+	// Called on each expansion
+	void			report( Search_Node* n ) {
+		if ( n->hn() < m_best_h ) m_best_h = n->hn();
+		if ( m_reporter != NULL ) m_reporter->tick( *this );
+	}
 
 	Search_Node*		root()				{ return m_root; }
 
@@ -163,6 +193,7 @@ public:
 	
 	Abstract_Heuristic&	heuristic()			{ return *m_h_func; }
 	Depth_Estimator&	depth_estimator()		{ return *m_d_func; }
+	Evaluation_Policy&	evaluation_policy()		{ return m_eval_policy; }
 
 	void			close( Search_Node* n )		{ m_closed.put(n); }
 
@@ -179,13 +210,12 @@ public:
 
 	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
 		cost = infty;
-		m_t0 = time_used();
-		m_last_exp_t = time_used(); 
+		m_budget.start();
+		m_last_exp_t = wall_time();
 		Search_Node* end = do_search();
 		if ( end == NULL ) return false;
 		extract_plan( m_root, end, plan, cost );	
-		double t2 = time_used();
-		m_time_budget -= ( t2 - m_t0 );		
+		m_budget.set_time( m_budget.time() - m_budget.elapsed() );
 		return true;
 	}
 
@@ -243,6 +273,11 @@ public:
 	}
 
 	void	generate_successors( Search_Node* head ) {
+		APTK_PHASE( EXPANSION );
+		generate_successors( head, typename Evaluation_Policy::Batched() );
+	}
+
+	void	generate_successors( Search_Node* head, std::false_type ) {
 		typedef typename Search_Model::Action_Iterator Iterator;
 		Iterator it( this->problem() );
 		int a = it.start( *(head->state()) );
@@ -268,6 +303,46 @@ public:
 		
 	}
 
+	void	generate_successors( Search_Node* head, std::true_type ) {
+		typedef typename Search_Model::Action_Iterator Iterator;
+		Iterator it( this->problem() );
+		int a = it.start( *(head->state()) );
+		while ( a != no_op ) {
+			State *succ = m_problem.next( *(head->state()), a );
+			Search_Node* n = new Search_Node( succ, expanded(), m_problem.cost( *(head->state()), a ), a, head );
+			if ( is_closed( n ) || is_open( n ) ) {
+				delete n;
+				a = it.next();
+				continue;
+			}
+			m_batch.push_back( n );
+			if ( m_batch.size() >= m_eval_policy.batch_size() )
+				open_batch();
+			a = it.next();
+		}
+		open_batch();
+	}
+
+	void	open_batch() {
+		if ( m_batch.empty() ) return;
+		m_eval_policy.evaluate( m_batch );
+		for ( unsigned i = 0; i < m_batch.size(); i++ ) {
+			Search_Node* n = m_batch[i];
+			// Two successors in the same batch can be the same state
+			if ( is_closed( n ) || is_open( n ) ) {
+				delete n;
+				continue;
+			}
+			n->hn() = m_eval_policy.h(i);
+			depth_estimator().eval( *(n->state()), n->dn() );
+			n->correct_depth_estimate();
+			n->fn() = n->hn() + n->gn();
+			add_to_open(n);
+			inc_gen();
+		}
+		m_batch.clear();
+	}
+
 	bool	is_closed( Search_Node* n ) {
 		Search_Node* n2 = closed().retrieve(n);
 
@@ -285,6 +360,7 @@ public:
 	}
 
 	virtual Search_Node*	 do_search() {
+		APTK_PHASE( SEARCH );
 		Search_Node *head = get_node();
 		while (head) {
 #ifdef DEBUG
@@ -308,7 +384,7 @@ public:
 				return head;
 			}
 
-			if ( (time_used() - t0() ) > m_time_budget ) {
+			if ( m_budget.exhausted() ) {
 #ifdef DEBUG
 				std::cout << "Time expired!" << std::endl;
 #endif
@@ -325,6 +401,7 @@ public:
 				inc_eval();
 				record_statistics(head);	
 				generate_successors(head);
+				report(head);
 				close(head);
 			}
 			//std::cout << "Getting next node..." << std::endl;
@@ -335,9 +412,10 @@ public:
 	}
 
 	void	record_statistics( Search_Node* n ) {
-		double exp_delta = time_used() - m_last_exp_t;
+		double t = wall_time();
+		double exp_delta = t - m_last_exp_t;
 		unsigned delay = expanded() - n->exp_nr();
-		m_last_exp_t = time_used();
+		m_last_exp_t = t;
 		m_ed_stats.push( delay );
 		m_nr_stats.push( exp_delta );	
 	}
@@ -374,7 +452,7 @@ public:
 	}
 
 	double	estimate_remaining_expansions() {
-		double remaining = m_time_budget - (time_used() - t0());
+		double remaining = m_budget.remaining();
 		double node_rate = 1.0 / m_nr_stats.get_avg();
 #ifdef DEBUG
 		std::cout << "Remaining time = " << remaining << " sec, rate = " << node_rate << " nodes/s" << std::endl;
@@ -433,19 +511,22 @@ protected:
 	Depth_Estimator*			m_d_func;
 	unsigned				m_exp_count;
 	unsigned				m_gen_count;
-	double					m_time_budget;
+	Budget					m_budget;
 	Search_Node*				m_root;
 	Closed_List_Type			m_closed, m_open_hash, m_pruned_hash;
 	Open_List_Type				m_open, m_pruned;
 	unsigned				m_open_repl_count;
 	unsigned				m_pruned_repl_count;
 	unsigned				m_dead_end_count;
-	double					m_t0;
 	double					m_last_exp_t;
 	Sliding_Window<double>			m_ed_stats;
 	Sliding_Window<double>			m_nr_stats;
 	float					m_B;
 	unsigned				m_pruned_B_count;	
+	Evaluation_Policy			m_eval_policy;
+	std::vector<Search_Node*>		m_batch;
+	Stats_Reporter*				m_reporter;
+	float					m_best_h;
 };
 
 }
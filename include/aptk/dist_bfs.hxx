@@ -0,0 +1,511 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __DISTRIBUTED_BEST_FIRST_SEARCH__
+#define __DISTRIBUTED_BEST_FIRST_SEARCH__
+
+#include <aptk/search_prob.hxx>
+#include <aptk/resources_control.hxx>
+#include <aptk/closed_list.hxx>
+#include <aptk/shm_transport.hxx>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace aptk {
+
+namespace search {
+
+namespace dist {
+
+// Nodes know their parent through the process that owns it and its index
+// in that process node table, so that plans can be traced back across
+// processes.
+template <typename State>
+class Node {
+public:
+
+	typedef State State_Type;
+
+	static const unsigned	no_parent = 0xFFFFFFFF;
+
+	Node( State* s, float g, unsigned parent_rank, unsigned parent_id, Action_Idx action )
+	: m_state( s ), m_h( 0 ), m_g( g ), m_f( 0 ), m_id( 0 ), m_parent_rank( parent_rank ),
+	m_parent_id( parent_id ), m_action( action ) {
+	}
+
+	virtual ~Node() {
+		if ( m_state != NULL ) delete m_state;
+	}
+
+	float&			hn()				{ return m_h; }
+	float			hn() const 			{ return m_h; }
+	float&			gn()				{ return m_g; }
+	float			gn() const 			{ return m_g; }
+	float&			fn()				{ return m_f; }
+	float			fn() const			{ return m_f; }
+	State*			state()				{ return m_state; }
+	const State&		state() const 			{ return *m_state; }
+	Action_Idx		action() const 			{ return m_action; }
+	unsigned		id() const			{ return m_id; }
+	unsigned		parent_rank() const		{ return m_parent_rank; }
+	unsigned		parent_id() const		{ return m_parent_id; }
+	bool			is_root() const			{ return m_parent_rank == no_parent; }
+
+	size_t			hash() const			{ return m_state->hash(); }
+	bool			operator==( const Node<State>& o ) const { return *m_state == *(o.m_state); }
+
+	void			print( std::ostream& os ) const {
+		os << "{@ = " << this << ", s = " << m_state << ", parent = (" << m_parent_rank << ", " << m_parent_id;
+		os << "), g(n) = " << m_g << ", h(n) = " << m_h << ", f(n) = " << m_f << "}";
+	}
+
+public:
+
+	State*		m_state;
+	float		m_h;
+	float		m_g;
+	float		m_f;
+	unsigned	m_id;
+	unsigned	m_parent_rank;
+	unsigned	m_parent_id;
+	Action_Idx	m_action;
+};
+
+// Distributed best-first search over several processes, each owning the
+// states whose hash maps to it (like HDA, see hda.hxx). Successors are
+// packed with State_Codec and sent to their owners in batches through
+// Transport (see shm_transport.hxx), nodes are evaluated when expanded.
+//
+// find_solution() forks one worker process per partition, and returns the
+// best plan found once the search space under the bound is exhausted, the
+// time budget runs out or, when stop_at_first_solution() is set, as soon
+// as some plan is found. Following calls search again under the bound
+// agreed so far and only succeed if a cheaper plan is found. Workers can be
+// given their own memory limit.
+template <typename Search_Model, typename Abstract_Heuristic, typename Open_List_Type, typename State_Codec,
+		typename Transport = Shm_Transport >
+class Distributed_BFS {
+
+public:
+
+	typedef		typename Search_Model::State_Type		State;
+	typedef  	typename Open_List_Type::Node_Type		Search_Node;
+	typedef 	Closed_List< Search_Node >			Closed_List_Type;
+	typedef		typename Transport::Word			Word;
+	typedef		typename Transport::Message			Message;
+
+	enum Message_Type { STATES = 0, TRACE = 1 };
+
+	Distributed_BFS( const Search_Model& search_problem, unsigned num_procs = 2, unsigned batch_size = 32 )
+	: m_problem( search_problem ), m_codec( search_problem ), m_transport( num_procs == 0 ? 1 : num_procs ),
+	m_batch_size( batch_size == 0 ? 1 : batch_size ), m_time_budget( infty ), m_memory_limit( 0 ),
+	m_stop_at_first( false ), m_plan_cost( infty ), m_heuristic( NULL ), m_t0( 0 ), m_active( false ),
+	m_exp_count( 0 ), m_gen_count( 0 ), m_pruned_B_count( 0 ), m_dead_end_count( 0 ), m_sent_count( 0 ) {
+	}
+
+	virtual ~Distributed_BFS() {
+	}
+
+	unsigned		num_procs() const		{ return m_transport.num_procs(); }
+	unsigned		batch_size() const		{ return m_batch_size; }
+	void			set_batch_size( unsigned v )	{ m_batch_size = ( v == 0 ? 1 : v ); }
+	void			set_budget( float v )		{ m_time_budget = v; }
+	float			time_budget() const		{ return m_time_budget; }
+	// Address space limit for each worker, in MB (0 means no limit)
+	void			set_memory_limit( unsigned mb )	{ m_memory_limit = mb; }
+	void			set_stop_at_first_solution( bool v ) { m_stop_at_first = v; }
+	Transport&		transport()			{ return m_transport; }
+	const Search_Model&	problem() const			{ return m_problem; }
+
+	// Statistics added up over all workers, available after find_solution()
+	unsigned		expanded() const		{ return sum( 0 ); }
+	unsigned		generated() const		{ return sum( 1 ); }
+	unsigned		pruned_by_bound() const		{ return sum( 2 ); }
+	unsigned		dead_ends() const		{ return sum( 3 ); }
+	unsigned		sent() const			{ return sum( 4 ); }
+	unsigned		expanded( unsigned rank ) const	{ return m_stats.empty() ? 0 : m_stats[rank][0]; }
+
+	void	start() {
+		m_transport.reset();
+		m_stats.clear();
+		m_plan_cost = infty;
+	}
+
+	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
+		cost = infty;
+		if ( m_time_budget <= 0.0f ) return false;
+		m_transport.reset( true );
+		unsigned n = m_transport.num_procs();
+		m_transport.add_work( n );
+		double t0 = wall_time();
+
+		// Each worker leaves its counters in a pipe
+		std::vector< pid_t > workers;
+		std::vector< int > pipes;
+		for ( unsigned k = 0; k < n; k++ ) {
+			int fd[2];
+			if ( pipe( fd ) != 0 ) {
+				m_transport.abort();
+				break;
+			}
+			pid_t pid = fork();
+			if ( pid == 0 ) {
+				close( fd[0] );
+				m_transport.set_rank( k );
+				if ( m_memory_limit > 0 ) {
+					struct rlimit lim;
+					lim.rlim_cur = lim.rlim_max = (rlim_t)m_memory_limit * 1024 * 1024;
+					setrlimit( RLIMIT_AS, &lim );
+				}
+				int rv = 0;
+				try {
+					work( t0 );
+				}
+				catch ( ... ) {
+					m_transport.abort();
+					rv = 1;
+				}
+				unsigned counters[5] = { m_exp_count, m_gen_count, m_pruned_B_count, m_dead_end_count, m_sent_count };
+				if ( write( fd[1], counters, sizeof(counters) ) < 0 ) rv = 1;
+				close( fd[1] );
+				_exit( rv );
+			}
+			close( fd[1] );
+			if ( pid < 0 ) {
+				close( fd[0] );
+				m_transport.abort();
+				break;
+			}
+			workers.push_back( pid );
+			pipes.push_back( fd[0] );
+		}
+
+		// If some worker dies (e.g. it ran out of memory), the rest could
+		// wait forever for its work to be done
+		m_stats.assign( n, std::vector<unsigned>( 5, 0 ) );
+		for ( unsigned k = 0; k < workers.size(); k++ ) {
+			int status;
+			pid_t pid = wait( &status );
+			if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
+				m_transport.abort();
+			for ( unsigned i = 0; i < workers.size(); i++ )
+				if ( workers[i] == pid ) {
+					unsigned counters[5];
+					if ( read( pipes[i], counters, sizeof(counters) ) == sizeof(counters) )
+						m_stats[i].assign( counters, counters + 5 );
+					close( pipes[i] );
+				}
+		}
+		m_time_budget -= ( wall_time() - t0 );
+
+		if ( !m_transport.best_plan( plan, cost ) || cost >= m_plan_cost ) {
+			plan.clear();
+			return false;
+		}
+		// The trace gives the actions, the cost is worked out again
+		// from the initial state
+		cost = 0.0f;
+		State* s = m_problem.init();
+		for ( unsigned k = 0; k < plan.size(); k++ ) {
+			cost += m_problem.cost( *s, plan[k] );
+			State* succ = m_problem.next( *s, plan[k] );
+			delete s;
+			s = succ;
+		}
+		delete s;
+		m_plan_cost = cost;
+		return true;
+	}
+
+protected:
+
+	unsigned	sum( unsigned i ) const {
+		unsigned total = 0;
+		for ( unsigned k = 0; k < m_stats.size(); k++ )
+			total += m_stats[k][i];
+		return total;
+	}
+
+	unsigned	owner( const State& s ) const {
+		return (unsigned)( s.hash() % m_transport.num_procs() );
+	}
+
+	// Worker process main loop. The transport work counter adds up active
+	// workers and messages not yet processed, as in HDA.
+	void	work( double t0 ) {
+		m_t0 = t0;
+		m_heuristic = new Abstract_Heuristic( m_problem );
+		m_outgoing.assign( m_transport.num_procs(), Message() );
+		m_active = true;
+
+		State* init = m_problem.init();
+		if ( owner( *init ) == m_transport.rank() ) {
+			Search_Node* root = new Search_Node( init, 0.0f, Search_Node::no_parent, Search_Node::no_parent, no_op );
+			m_heuristic->eval( *(root->state()), root->hn() );
+			root->fn() = root->hn() + root->gn();
+			insert( root );
+		}
+		else
+			delete init;
+
+		unsigned counter = 0;
+		while ( !m_transport.aborted() ) {
+			receive();
+			flush_pending();
+			Search_Node* head = m_transport.stopped() ? NULL : get_node();
+			if ( head == NULL ) {
+				flush();
+				if ( m_pending.empty() && m_active ) {
+					m_active = false;
+					m_transport.add_work( -1 );
+				}
+				if ( m_transport.work() == 0 ) break;
+				sched_yield();
+				continue;
+			}
+			if ( ( ++counter & 63 ) == 0 ) {
+				if ( wall_time() - m_t0 > m_time_budget )
+					m_transport.stop();
+				flush();
+			}
+			if ( head->gn() >= m_transport.bound() ) {
+				m_pruned_B_count++;
+				m_closed.put( head );
+				continue;
+			}
+			if ( m_problem.goal( *(head->state()) ) ) {
+				m_closed.put( head );
+				if ( m_transport.improve_bound( head->gn() ) ) {
+					std::vector<Action_Idx> suffix;
+					trace( head, suffix, head->gn() );
+					if ( m_stop_at_first ) m_transport.stop();
+				}
+				continue;
+			}
+			m_heuristic->eval( *(head->state()), head->hn() );
+			expand( head );
+			m_closed.put( head );
+		}
+		for ( unsigned k = 0; k < m_nodes.size(); k++ )
+			delete m_nodes[k];
+		delete m_heuristic;
+	}
+
+	Search_Node*	get_node() {
+		if ( m_open.empty() ) return NULL;
+		Search_Node* next = m_open.pop();
+		m_open_hash.erase( m_open_hash.retrieve_iterator( next ) );
+		return next;
+	}
+
+	void	expand( Search_Node* head ) {
+		typedef typename Search_Model::Action_Iterator Iterator;
+		Iterator it( this->problem() );
+		int a = it.start( *(head->state()) );
+		while ( a != no_op ) {
+			State *succ = m_problem.next( *(head->state()), a );
+			float g = head->gn() + m_problem.cost( *(head->state()), a );
+			unsigned dest = owner( *succ );
+			if ( dest == m_transport.rank() ) {
+				Search_Node* n = new Search_Node( succ, g, m_transport.rank(), head->id(), a );
+				n->hn() = head->hn();
+				n->fn() = n->hn() + n->gn();
+				insert( n );
+			}
+			else {
+				Message& msg = m_outgoing[dest];
+				if ( msg.empty() ) {
+					msg.push_back( STATES );
+					msg.push_back( 0 );
+				}
+				msg[1]++;
+				msg.push_back( to_word( g ) );
+				msg.push_back( to_word( head->hn() ) );
+				msg.push_back( m_transport.rank() );
+				msg.push_back( head->id() );
+				msg.push_back( (Word)a );
+				m_codec.pack( *succ, msg );
+				delete succ;
+				if ( msg[1] >= m_batch_size ) send( dest );
+			}
+			a = it.next();
+		}
+		m_exp_count++;
+	}
+
+	// Duplicate detection as in HDA. Nodes are never deleted during the
+	// search, since traces may still go through them.
+	void	insert( Search_Node* n ) {
+		Search_Node* n2 = m_closed.retrieve( n );
+		if ( n2 == NULL ) n2 = m_open_hash.retrieve( n );
+		if ( n2 != NULL ) {
+			if ( n2->gn() > n->gn() ) {
+				n2->m_g = n->m_g;
+				n2->m_parent_rank = n->m_parent_rank;
+				n2->m_parent_id = n->m_parent_id;
+				n2->m_action = n->m_action;
+				n2->m_f = n2->m_h + n2->m_g;
+				// Better path to a closed node, reopen it
+				typename Closed_List_Type::iterator it = m_closed.retrieve_iterator( n2 );
+				if ( it != m_closed.end() ) {
+					m_closed.erase( it );
+					m_open.insert( n2 );
+					m_open_hash.put( n2 );
+				}
+			}
+			delete n;
+			return;
+		}
+		n->m_id = m_nodes.size();
+		m_nodes.push_back( n );
+		if ( n->hn() == infty ) {
+			m_closed.put( n );
+			m_dead_end_count++;
+			return;
+		}
+		m_open.insert( n );
+		m_open_hash.put( n );
+		m_gen_count++;
+	}
+
+	// Follows parents while they're owned by this process, then hands the
+	// trace over to the owner of the next one
+	void	trace( Search_Node* n, std::vector<Action_Idx>& suffix, float cost ) {
+		while ( !n->is_root() ) {
+			suffix.push_back( n->action() );
+			if ( n->parent_rank() != m_transport.rank() ) {
+				Message msg;
+				msg.push_back( TRACE );
+				msg.push_back( n->parent_id() );
+				msg.push_back( to_word( cost ) );
+				msg.push_back( suffix.size() );
+				for ( unsigned k = 0; k < suffix.size(); k++ )
+					msg.push_back( (Word)suffix[k] );
+				post( n->parent_rank(), msg );
+				return;
+			}
+			n = m_nodes[ n->parent_id() ];
+		}
+		std::reverse( suffix.begin(), suffix.end() );
+		m_transport.publish_plan( suffix, cost );
+	}
+
+	void	receive() {
+		Message msg;
+		while ( m_transport.receive( msg ) ) {
+			if ( !m_active ) {
+				m_active = true;
+				m_transport.add_work( 1 );
+			}
+			if ( msg[0] == TRACE ) {
+				std::vector<Action_Idx> suffix( msg.begin() + 4, msg.begin() + 4 + msg[3] );
+				trace( m_nodes[ msg[1] ], suffix, to_float( msg[2] ) );
+			}
+			else if ( !m_transport.stopped() ) {
+				unsigned pos = 2;
+				for ( unsigned k = 0; k < msg[1]; k++ ) {
+					unsigned used;
+					State* s = m_codec.unpack( &msg[pos+5], used );
+					Search_Node* n = new Search_Node( s, to_float( msg[pos] ), msg[pos+2], msg[pos+3], (Action_Idx)msg[pos+4] );
+					n->hn() = to_float( msg[pos+1] );
+					n->fn() = n->hn() + n->gn();
+					insert( n );
+					pos += 5 + used;
+				}
+			}
+			m_transport.add_work( -1 );
+		}
+	}
+
+	void	send( unsigned dest ) {
+		Message& msg = m_outgoing[dest];
+		m_sent_count += msg[1];
+		post( dest, msg );
+		msg.clear();
+	}
+
+	// Messages are accounted for as soon as they're posted, those that
+	// don't fit in the transport wait in m_pending
+	void	post( unsigned dest, const Message& msg ) {
+		m_transport.add_work( 1 );
+		if ( m_pending.empty() && m_transport.send( dest, msg ) ) return;
+		m_pending.push_back( std::make_pair( dest, msg ) );
+	}
+
+	void	flush_pending() {
+		while ( !m_pending.empty() ) {
+			if ( !m_transport.send( m_pending.front().first, m_pending.front().second ) ) return;
+			m_pending.pop_front();
+		}
+	}
+
+	void	flush() {
+		for ( unsigned k = 0; k < m_outgoing.size(); k++ )
+			if ( !m_outgoing[k].empty() )
+				send( k );
+		flush_pending();
+	}
+
+	static Word	to_word( float v )	{ Word w; std::memcpy( &w, &v, sizeof(w) ); return w; }
+	static float	to_float( Word w )	{ float v; std::memcpy( &v, &w, sizeof(v) ); return v; }
+
+protected:
+
+	const Search_Model&				m_problem;
+	State_Codec					m_codec;
+	Transport					m_transport;
+	unsigned					m_batch_size;
+	float						m_time_budget;
+	unsigned					m_memory_limit;
+	bool						m_stop_at_first;
+	float						m_plan_cost;
+	std::vector< std::vector<unsigned> >		m_stats;
+
+	// Worker process state
+	Abstract_Heuristic*				m_heuristic;
+	double						m_t0;
+	bool						m_active;
+	Open_List_Type					m_open;
+	Closed_List_Type				m_closed, m_open_hash;
+	std::vector< Search_Node* >			m_nodes;
+	std::vector< Message >				m_outgoing;
+	std::deque< std::pair< unsigned, Message > >	m_pending;
+	unsigned					m_exp_count;
+	unsigned					m_gen_count;
+	unsigned					m_pruned_B_count;
+	unsigned					m_dead_end_count;
+	unsigned					m_sent_count;
+};
+
+}
+
+}
+
+}
+
+#endif // dist_bfs.hxx
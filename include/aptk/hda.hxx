@@ -0,0 +1,486 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __HASH_DISTRIBUTED_BEST_FIRST_SEARCH__
+#define __HASH_DISTRIBUTED_BEST_FIRST_SEARCH__
+
+#include <aptk/search_prob.hxx>
+#include <aptk/resources_control.hxx>
+#include <aptk/closed_list.hxx>
+#include <aptk/bit_array.hxx>
+#include <aptk/hash_table.hxx>
+#include <aptk/mpsc_queue.hxx>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace aptk {
+
+namespace search {
+
+namespace hda {
+
+// Builds search nodes both for the node types in at_bfs.hxx, which take
+// (state, cost, action, parent), and for those in at_bfs_dq.hxx, which also
+// need the number of actions to size the preferred operators set.
+template <typename Node, typename State,
+		bool Needs_Num_Actions = std::is_constructible< Node, State*, float, Action_Idx, Node*, int >::value >
+class Node_Factory {
+public:
+	static Node*	make( State* s, float cost, Action_Idx a, Node* parent, int ) {
+		return new Node( s, cost, a, parent );
+	}
+};
+
+template <typename Node, typename State>
+class Node_Factory< Node, State, true > {
+public:
+	static Node*	make( State* s, float cost, Action_Idx a, Node* parent, int num_actions ) {
+		return new Node( s, cost, a, parent, num_actions );
+	}
+};
+
+// Assigns states to threads with the state hash (Zobrist-like hashing of
+// HDA*, Kishimoto, Fukunaga and Botea, 2009)
+template <typename Search_Model>
+class State_Hash_Distribution {
+public:
+	typedef typename Search_Model::State_Type	State;
+
+	State_Hash_Distribution( const Search_Model& ) {}
+
+	unsigned	owner( const State& s, unsigned num_threads ) const {
+		return (unsigned)( s.hash() % num_threads );
+	}
+};
+
+// Assigns states to threads by hashing their projection onto a small set of
+// fluents. When the fluents chosen are rarely changed by actions, most
+// successors end up owned by the thread that generated them, cutting down
+// communication (Abstract HDA*, Burns et al. 2010, Jinnai and Fukunaga 2016).
+template <typename Search_Model>
+class Abstraction_Distribution {
+public:
+	typedef typename Search_Model::State_Type	State;
+
+	Abstraction_Distribution( const Search_Model& prob, unsigned abstraction_size = 16 ) {
+		build_abstraction( prob.task(), abstraction_size );
+	}
+
+	void			set_abstraction( const Fluent_Vec& fluents ) { m_fluents = fluents; }
+	const Fluent_Vec&	abstraction() const { return m_fluents; }
+
+	unsigned	owner( const State& s, unsigned num_threads ) const {
+		Hash_Key hasher;
+		for ( unsigned k = 0; k < m_fluents.size(); k++ )
+			if ( s.entails( m_fluents[k] ) )
+				hasher.add( m_fluents[k] );
+		return (unsigned)( (size_t)hasher % num_threads );
+	}
+
+protected:
+
+	template <typename Task>
+	void	build_abstraction( const Task& task, unsigned abstraction_size ) {
+		// Fluents ordered by how many actions change them, static fluents
+		// are useless to tell states apart.
+		std::vector< std::pair< unsigned, unsigned > > changes;
+		for ( unsigned f = 0; f < task.num_fluents(); f++ ) {
+			unsigned count = task.actions_adding(f).size() + task.actions_deleting(f).size();
+			if ( count == 0 ) continue;
+			changes.push_back( std::make_pair( count, f ) );
+		}
+		std::sort( changes.begin(), changes.end() );
+		m_fluents.clear();
+		for ( unsigned k = 0; k < changes.size() && k < abstraction_size; k++ )
+			m_fluents.push_back( changes[k].second );
+	}
+
+	Fluent_Vec	m_fluents;
+};
+
+// Hash Distributed best-first search. States are owned by the thread their
+// hash is mapped to, each thread keeps its own open and closed lists and
+// heuristic estimator, and successors travel to their owners in batches
+// through lock-free queues. Nodes are evaluated when expanded, like in the
+// AT_BFS_* engines.
+//
+// Every call to find_solution() runs the workers until a plan better than
+// the current bound is found, search space is exhausted under the bound or
+// the time budget runs out. Open and closed lists survive between calls, so
+// successive calls return plans of strictly decreasing cost, as the anytime
+// engines in at_bfs.hxx do.
+template <typename Search_Model, typename Abstract_Heuristic, typename Open_List_Type,
+		typename Distribution = State_Hash_Distribution< Search_Model > >
+class HDA {
+
+public:
+
+	typedef		typename Search_Model::State_Type		State;
+	typedef  	typename Open_List_Type::Node_Type		Search_Node;
+	typedef 	Closed_List< Search_Node >			Closed_List_Type;
+	typedef		MPSC_Queue< Search_Node* >			Node_Queue;
+	typedef		typename Node_Queue::Batch			Node_Batch;
+	typedef		Node_Factory< Search_Node, State >		Factory;
+
+	class Worker {
+	public:
+		Worker( unsigned id, const Search_Model& prob, unsigned num_threads )
+		: m_id( id ), m_heuristic( new Abstract_Heuristic( prob ) ), m_outgoing( num_threads, (Node_Batch*)NULL ),
+		m_exp_count(0), m_gen_count(0), m_pruned_B_count(0), m_dead_end_count(0), m_open_repl_count(0),
+		m_sent_count(0), m_active( false ) {
+		}
+
+		~Worker() {
+			for ( typename Closed_List_Type::iterator i = m_closed.begin();
+				i != m_closed.end(); i++ )
+				delete i->second;
+			while ( !m_open.empty() )
+				delete m_open.pop();
+			for ( typename std::list<Search_Node*>::iterator it = m_garbage.begin();
+				it != m_garbage.end(); it++ )
+				delete *it;
+			Node_Batch* b = m_inbox.pop_all();
+			while ( b != NULL ) {
+				Node_Batch* next = b->next();
+				for ( unsigned k = 0; k < b->items().size(); k++ )
+					delete b->items()[k];
+				delete b;
+				b = next;
+			}
+			for ( unsigned k = 0; k < m_outgoing.size(); k++ ) {
+				if ( m_outgoing[k] == NULL ) continue;
+				for ( unsigned i = 0; i < m_outgoing[k]->items().size(); i++ )
+					delete m_outgoing[k]->items()[i];
+				delete m_outgoing[k];
+			}
+			delete m_heuristic;
+		}
+
+		Search_Node*	get_node() {
+			if ( m_open.empty() ) return NULL;
+			Search_Node* next = m_open.pop();
+			m_open_hash.erase( m_open_hash.retrieve_iterator( next ) );
+			return next;
+		}
+
+		unsigned			m_id;
+		Abstract_Heuristic*		m_heuristic;
+		Open_List_Type			m_open;
+		Closed_List_Type		m_closed, m_open_hash;
+		std::list<Search_Node*>		m_garbage;
+		Node_Queue			m_inbox;
+		std::vector<Node_Batch*>	m_outgoing;
+		unsigned			m_exp_count;
+		unsigned			m_gen_count;
+		unsigned			m_pruned_B_count;
+		unsigned			m_dead_end_count;
+		unsigned			m_open_repl_count;
+		unsigned			m_sent_count;
+		bool				m_active;
+	};
+
+	HDA( const Search_Model& search_problem, unsigned num_threads = 2, unsigned batch_size = 32 )
+	: m_problem( search_problem ), m_distribution( search_problem ), m_num_threads( num_threads ),
+	m_batch_size( batch_size ), m_B( infty ), m_time_budget( infty ), m_t0( 0.0 ), m_root( NULL ),
+	m_found( NULL ), m_stop( false ), m_timed_out( false ), m_work( 0 ), m_in_flight( 0 ) {
+		if ( m_num_threads == 0 ) m_num_threads = 1;
+		if ( m_batch_size == 0 ) m_batch_size = 1;
+		for ( unsigned k = 0; k < m_num_threads; k++ )
+			m_workers.push_back( new Worker( k, search_problem, m_num_threads ) );
+	}
+
+	virtual ~HDA() {
+		for ( unsigned k = 0; k < m_workers.size(); k++ )
+			delete m_workers[k];
+	}
+
+	void	start() {
+		m_B = infty;
+		m_root = Factory::make( m_problem.init(), 0.0f, no_op, NULL, m_problem.num_actions() );
+		Worker& w = *(m_workers[ owner( m_root ) ]);
+		w.m_heuristic->eval( *(m_root->state()), m_root->hn() );
+		m_root->fn() = m_root->hn() + m_root->gn();
+		w.m_open.insert( m_root );
+		w.m_open_hash.put( m_root );
+		w.m_gen_count++;
+	}
+
+	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
+		cost = infty;
+		m_t0 = wall_time();
+		m_found = NULL;
+		m_stop = false;
+		m_timed_out = false;
+		m_work = (long)m_num_threads + m_in_flight.load();
+
+		std::vector< std::thread > threads;
+		for ( unsigned k = 1; k < m_num_threads; k++ )
+			threads.push_back( std::thread( &HDA::work, this, k ) );
+		work( 0 );
+		for ( unsigned k = 0; k < threads.size(); k++ )
+			threads[k].join();
+
+		m_time_budget -= ( wall_time() - m_t0 );
+		if ( m_found == NULL ) return false;
+		extract_plan( m_root, m_found, plan, cost );
+		return true;
+	}
+
+	float			bound() const			{ return m_B.load( std::memory_order_relaxed ); }
+	void			set_bound( float v ) 		{ m_B = v; }
+
+	unsigned		num_threads() const		{ return m_num_threads; }
+	unsigned		batch_size() const		{ return m_batch_size; }
+	void			set_batch_size( unsigned v )	{ m_batch_size = ( v == 0 ? 1 : v ); }
+
+	void			set_budget( float v ) 		{ m_time_budget = v; }
+	float			time_budget() const		{ return m_time_budget; }
+	bool			timed_out() const		{ return m_timed_out; }
+	float			t0() const			{ return m_t0; }
+
+	unsigned		generated() const		{ return sum( &Worker::m_gen_count ); }
+	unsigned		expanded() const		{ return sum( &Worker::m_exp_count ); }
+	unsigned		pruned_by_bound() const		{ return sum( &Worker::m_pruned_B_count ); }
+	unsigned		dead_ends() const		{ return sum( &Worker::m_dead_end_count ); }
+	unsigned		open_repl() const		{ return sum( &Worker::m_open_repl_count ); }
+	unsigned		sent() const			{ return sum( &Worker::m_sent_count ); }
+	unsigned		expanded( unsigned thread ) const { return m_workers[thread]->m_exp_count; }
+
+	const	Search_Model&	problem() const			{ return m_problem; }
+	Distribution&		distribution()			{ return m_distribution; }
+	Search_Node*		root()				{ return m_root; }
+
+protected:
+
+	unsigned	owner( Search_Node* n ) const {
+		return m_distribution.owner( *(n->state()), m_num_threads );
+	}
+
+	unsigned	sum( unsigned Worker::* counter ) const {
+		unsigned total = 0;
+		for ( unsigned k = 0; k < m_workers.size(); k++ )
+			total += m_workers[k]->*counter;
+		return total;
+	}
+
+	bool	time_exceeded() const {
+		return ( wall_time() - m_t0 ) > m_time_budget;
+	}
+
+	// Worker main loop. m_work counts active workers plus nodes in flight,
+	// a worker only becomes active after it has received nodes and the
+	// in-flight count is decreased afterwards, so m_work can only drop to zero
+	// once every worker is idle and no node is left in any queue.
+	void	work( unsigned id ) {
+		Worker& w = *(m_workers[id]);
+		w.m_active = true;
+		unsigned counter = 0;
+		while ( !m_stop.load( std::memory_order_relaxed ) ) {
+			receive( w );
+			Search_Node* head = w.get_node();
+			if ( head == NULL ) {
+				flush( w );
+				if ( w.m_active ) {
+					w.m_active = false;
+					m_work.fetch_sub( 1 );
+				}
+				if ( m_work.load() == 0 ) break;
+				std::this_thread::yield();
+				continue;
+			}
+			if ( ( ++counter & 63 ) == 0 ) {
+				if ( time_exceeded() ) {
+					m_timed_out = true;
+					m_stop = true;
+					w.m_open.insert( head );
+					w.m_open_hash.put( head );
+					break;
+				}
+				flush( w );
+			}
+			if ( head->gn() >= bound() ) {
+				w.m_pruned_B_count++;
+				w.m_closed.put( head );
+				continue;
+			}
+			if ( m_problem.goal( *(head->state()) ) ) {
+				w.m_closed.put( head );
+				if ( improve_incumbent( head ) )
+					m_stop = true;
+				continue;
+			}
+			w.m_heuristic->eval( *(head->state()), head->hn() );
+			process( w, head );
+			w.m_closed.put( head );
+		}
+		flush( w );
+	}
+
+	bool	improve_incumbent( Search_Node* n ) {
+		std::lock_guard< std::mutex > lock( m_incumbent_mutex );
+		if ( n->gn() >= bound() ) return false;
+		m_B = n->gn();
+		m_found = n;
+		return true;
+	}
+
+	void	process( Worker& w, Search_Node* head ) {
+		typedef typename Search_Model::Action_Iterator Iterator;
+		Iterator it( this->problem() );
+		int a = it.start( *(head->state()) );
+		while ( a != no_op ) {
+			State *succ = m_problem.next( *(head->state()), a );
+			Search_Node* n = Factory::make( succ, m_problem.cost( *(head->state()), a ), a, head, m_problem.num_actions() );
+			n->hn() = head->hn();
+			n->fn() = n->hn() + n->gn();
+			unsigned dest = owner( n );
+			if ( dest == w.m_id )
+				insert( w, n );
+			else
+				send( w, dest, n );
+			a = it.next();
+		}
+		w.m_exp_count++;
+	}
+
+	void	send( Worker& w, unsigned dest, Search_Node* n ) {
+		if ( w.m_outgoing[dest] == NULL )
+			w.m_outgoing[dest] = new Node_Batch;
+		w.m_outgoing[dest]->items().push_back( n );
+		if ( w.m_outgoing[dest]->items().size() >= m_batch_size )
+			send_batch( w, dest );
+	}
+
+	void	send_batch( Worker& w, unsigned dest ) {
+		Node_Batch* b = w.m_outgoing[dest];
+		w.m_outgoing[dest] = NULL;
+		long k = b->items().size();
+		m_in_flight.fetch_add( k );
+		m_work.fetch_add( k );
+		w.m_sent_count += k;
+		m_workers[dest]->m_inbox.push( b );
+	}
+
+	void	flush( Worker& w ) {
+		for ( unsigned k = 0; k < w.m_outgoing.size(); k++ )
+			if ( w.m_outgoing[k] != NULL && !w.m_outgoing[k]->items().empty() )
+				send_batch( w, k );
+	}
+
+	void	receive( Worker& w ) {
+		if ( w.m_inbox.empty() ) return;
+		Node_Batch* b = w.m_inbox.pop_all();
+		if ( b == NULL ) return;
+		if ( !w.m_active ) {
+			w.m_active = true;
+			m_work.fetch_add( 1 );
+		}
+		long k = 0;
+		while ( b != NULL ) {
+			Node_Batch* next = b->next();
+			for ( unsigned i = 0; i < b->items().size(); i++ )
+				insert( w, b->items()[i] );
+			k += b->items().size();
+			delete b;
+			b = next;
+		}
+		m_in_flight.fetch_sub( k );
+		m_work.fetch_sub( k );
+	}
+
+	// Duplicate detection against the lists of the owner thread, same
+	// policy as AT_BFS_SQ_SH: better paths to closed nodes re-open them,
+	// better paths to open nodes update them in place.
+	void	insert( Worker& w, Search_Node* n ) {
+		Search_Node* n2 = w.m_closed.retrieve( n );
+		if ( n2 != NULL ) {
+			if ( n2->gn() <= n->gn() ) {
+				delete n;
+				return;
+			}
+			w.m_closed.erase( w.m_closed.retrieve_iterator( n2 ) );
+			w.m_garbage.push_back( n2 );
+		}
+		n2 = w.m_open_hash.retrieve( n );
+		if ( n2 != NULL ) {
+			if ( n->gn() < n2->gn() ) {
+				n2->m_parent = n->m_parent;
+				n2->m_action = n->m_action;
+				n2->m_g = n->m_g;
+				n2->m_f = n2->m_h + n2->m_g;
+				w.m_open_repl_count++;
+			}
+			delete n;
+			return;
+		}
+		if ( n->hn() == infty ) {
+			w.m_closed.put( n );
+			w.m_dead_end_count++;
+			return;
+		}
+		w.m_open.insert( n );
+		w.m_open_hash.put( n );
+		w.m_gen_count++;
+	}
+
+	void	extract_plan( Search_Node* s, Search_Node* t, std::vector<Action_Idx>& plan, float& cost ) {
+		Search_Node *tmp = t;
+		cost = 0.0f;
+		while( tmp != s) {
+			cost += m_problem.cost( *(tmp->state()), tmp->action() );
+			plan.push_back(tmp->action());
+			tmp = tmp->parent();
+		}
+
+		std::reverse(plan.begin(), plan.end());
+	}
+
+protected:
+
+	const Search_Model&			m_problem;
+	Distribution				m_distribution;
+	unsigned				m_num_threads;
+	unsigned				m_batch_size;
+	std::vector<Worker*>			m_workers;
+	std::atomic<float>			m_B;
+	float					m_time_budget;
+	double					m_t0;
+	Search_Node*				m_root;
+	Search_Node*				m_found;
+	std::mutex				m_incumbent_mutex;
+	std::atomic<bool>			m_stop;
+	std::atomic<bool>			m_timed_out;
+	std::atomic<long>			m_work;
+	std::atomic<long>			m_in_flight;
+};
+
+}
+
+}
+
+}
+
+#endif // hda.hxx
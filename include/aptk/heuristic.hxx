@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define __HEURISTIC__
 
 #include <aptk/search_prob.hxx>
+#include <aptk/probes.hxx>
 #include <vector>
 
 namespace aptk {
@@ -24,8 +24,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/search_prob.hxx>
 #include <aptk/resources_control.hxx>
 #include <aptk/closed_list.hxx>
+#include <aptk/probes.hxx>
 #include <aptk/brfs.hxx>
 #include <vector>
+#include <string>
 #include <algorithm>
 #include <iostream>
 
@@ -92,6 +94,21 @@ public:
 	void			inc_pruned_bound() 		{ m_pruned_B_count++; }
 	unsigned		pruned_by_bound() const		{ return m_pruned_B_count; }
 
+	virtual void		stats( Search_Stats& s ) const {
+		BRFS< Search_Model >::stats( s );
+		s.pruned_bound = pruned_by_bound();
+		s.bound = bound();
+	}
+
+	// Lowers the bound to a novelty table of the next lower arity
+	virtual bool		degrade( Memory_Budget& m ) {
+		double before = m.used();
+		if ( !m_novelty->shrink() ) return false;
+		m_B = m_novelty->arity();
+		m.degraded( "lowered the novelty arity to " + std::to_string( m_novelty->arity() ), before - m.used() );
+		return true;
+	}
+
 protected:
 	bool   prune( Search_Node* n ){
 
@@ -155,6 +172,7 @@ protected:
 // 	}
 
 	virtual Search_Node*   	process(  Search_Node *head ) {
+		APTK_PHASE( EXPANSION );
 		for (int a = 0; a < this->problem().num_actions(); a++ ) {		
 			if( ! this->problem().task().actions()[ a ]->can_be_applied_on( *(head->state())) ) continue;
 			State *succ = this->problem().next( *(head->state()), a );
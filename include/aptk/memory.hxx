@@ -23,12 +23,146 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <iosfwd>
 
 namespace aptk
 {
 
 void report_memory_usage();
 
+// Bytes held by each part of the searches in the process, as counted by
+// the allocators of the classes and containers that make them up. The
+// memory in use is taken to be the memory resident when the limit was
+// set, plus what has been allocated since.
+class Memory_Budget
+{
+public:
+	enum Subsystem { NODES = 0, STATES, CLOSED, OPEN, HEURISTIC, NOVELTY, OTHER, NUM_SUBSYSTEMS };
+	// HIGH once the soft limit is reached, CRITICAL once the limit is
+	enum Pressure { NONE = 0, HIGH, CRITICAL };
+
+	// Shared by all engines
+	static Memory_Budget&	instance() {
+		static Memory_Budget budget;
+		return budget;
+	}
+
+	void	allocated( Subsystem s, size_t bytes )	{ m_bytes[s].fetch_add( bytes, std::memory_order_relaxed ); }
+	void	released( Subsystem s, size_t bytes )	{ m_bytes[s].fetch_sub( bytes, std::memory_order_relaxed ); }
+
+	// In MB
+	double	used( Subsystem s ) const;
+	double	used() const;
+	double	in_use() const				{ return m_baseline + used(); }
+	static const char*	name( Subsystem s );
+
+	// In MB, unlimited to begin with. The soft limit is a fraction of it
+	void	set_limit( double mb );
+	double	limit() const				{ return m_limit; }
+	bool	limited() const;
+	void	set_soft_limit( double fraction )	{ m_soft = fraction; }
+	double	soft_limit() const			{ return m_soft; }
+	Pressure	pressure() const;
+
+	// Logs what was given up to free freed MB
+	void	degraded( const std::string& what, double freed );
+	unsigned	degradations() const		{ return m_degradations; }
+	void	set_log( std::ostream& os )		{ m_log = &os; }
+	void	report( std::ostream& os ) const;
+
+	// RLIMIT_AS in MB, or unlimited if there is none
+	static double	address_space_limit();
+
+protected:
+
+	Memory_Budget();
+
+	std::atomic<long>	m_bytes[NUM_SUBSYSTEMS];
+	double			m_limit;
+	double			m_soft;
+	double			m_baseline;
+	std::atomic<unsigned>	m_degradations;
+	std::ostream*		m_log;
+	std::mutex		m_log_mutex;
+};
+
+// Implemented by engines that can give up some memory, at some cost to
+// the search, when the memory in use gets close to the limit
+class Degradable
+{
+public:
+	virtual ~Degradable() {}
+
+	// False when there is nothing left to give up
+	virtual bool	degrade( Memory_Budget& m ) = 0;
+};
+
+// Objects of classes derived from this one count as part of S when
+// allocated with new
+template <Memory_Budget::Subsystem S>
+class Tracked
+{
+public:
+	static void*	operator new( size_t bytes ) {
+		Memory_Budget::instance().allocated( S, bytes );
+		return ::operator new( bytes );
+	}
+
+	static void	operator delete( void* p, size_t bytes ) {
+		Memory_Budget::instance().released( S, bytes );
+		::operator delete( p );
+	}
+};
+
+// Allocator for the containers of a subsystem
+template <typename T>
+class Tracking_Allocator
+{
+public:
+	typedef T		value_type;
+	typedef T*		pointer;
+	typedef const T*	const_pointer;
+	typedef T&		reference;
+	typedef const T&	const_reference;
+	typedef size_t		size_type;
+	typedef ptrdiff_t	difference_type;
+
+	template <typename U>
+	struct rebind { typedef Tracking_Allocator<U> other; };
+
+	Tracking_Allocator( Memory_Budget::Subsystem s = Memory_Budget::OTHER )
+		: m_subsystem( s ) {}
+
+	template <typename U>
+	Tracking_Allocator( const Tracking_Allocator<U>& other )
+		: m_subsystem( other.subsystem() ) {}
+
+	T*	allocate( size_t n ) {
+		Memory_Budget::instance().allocated( m_subsystem, n * sizeof(T) );
+		return static_cast<T*>( ::operator new( n * sizeof(T) ) );
+	}
+
+	void	deallocate( T* p, size_t n ) {
+		Memory_Budget::instance().released( m_subsystem, n * sizeof(T) );
+		::operator delete( p );
+	}
+
+	Memory_Budget::Subsystem	subsystem() const	{ return m_subsystem; }
+
+protected:
+	Memory_Budget::Subsystem	m_subsystem;
+};
+
+// Memory from any of them can be freed by any other
+template <typename T, typename U>
+bool	operator==( const Tracking_Allocator<T>&, const Tracking_Allocator<U>& ) { return true; }
+template <typename T, typename U>
+bool	operator!=( const Tracking_Allocator<T>&, const Tracking_Allocator<U>& ) { return false; }
+
 }
 
 #endif
@@ -0,0 +1,99 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MPSC_QUEUE__
+#define __MPSC_QUEUE__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace aptk
+{
+
+// Lock-free multiple producer, single consumer queue of batches. Producers
+// push whole batches with a single CAS on the head of an intrusive stack,
+// the consumer detaches the complete stack with one exchange and restores
+// FIFO order locally. Since the consumer never pops single elements there
+// is no ABA hazard.
+template <typename T>
+class MPSC_Queue {
+public:
+
+	class Batch {
+	public:
+		Batch() : m_next( NULL ) {}
+
+		std::vector<T>&		items()		{ return m_items; }
+		const std::vector<T>&	items() const	{ return m_items; }
+		Batch*			next()		{ return m_next; }
+
+	private:
+		friend class MPSC_Queue<T>;
+
+		std::vector<T>		m_items;
+		Batch*			m_next;
+	};
+
+	MPSC_Queue()
+	: m_head( NULL ) {
+	}
+
+	~MPSC_Queue() {
+		Batch* b = m_head.exchange( NULL );
+		while ( b != NULL ) {
+			Batch* next = b->m_next;
+			delete b;
+			b = next;
+		}
+	}
+
+	// Called from any thread, ownership of b goes to the queue
+	void	push( Batch* b ) {
+		Batch* old_head = m_head.load( std::memory_order_relaxed );
+		do {
+			b->m_next = old_head;
+		} while ( !m_head.compare_exchange_weak( old_head, b, std::memory_order_release, std::memory_order_relaxed ) );
+	}
+
+	// Called from the consumer thread only. Returns the batches pushed so far,
+	// oldest first, linked through Batch::next(). Caller takes ownership.
+	Batch*	pop_all() {
+		Batch* b = m_head.exchange( NULL, std::memory_order_acquire );
+		Batch* reversed = NULL;
+		while ( b != NULL ) {
+			Batch* next = b->m_next;
+			b->m_next = reversed;
+			reversed = b;
+			b = next;
+		}
+		return reversed;
+	}
+
+	bool	empty() const { return m_head.load( std::memory_order_acquire ) == NULL; }
+
+private:
+
+	std::atomic<Batch*>	m_head;
+};
+
+}
+
+#endif // mpsc_queue.hxx
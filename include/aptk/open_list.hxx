@@ -25,6 +25,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <queue>
 #include <boost/heap/fibonacci_heap.hpp>
 #include <aptk/ext_math.hxx>
+#include <aptk/probes.hxx>
+#include <aptk/memory.hxx>
 
 namespace aptk
 {
@@ -79,11 +81,14 @@ public:
 
 private:
 
-	std::priority_queue< Node*, std::vector< Node* >, Node_Comp > m_queue;
+	typedef std::vector< Node*, Tracking_Allocator< Node* > >	Container;
+
+	std::priority_queue< Node*, Container, Node_Comp > m_queue;
 };
 
 template < class Node_Comp, class Node >
 Open_List<Node_Comp, Node>::Open_List()
+	: m_queue( Node_Comp(), Container( Tracking_Allocator< Node* >( Memory_Budget::OPEN ) ) )
 {
 }
 
@@ -95,12 +100,14 @@ Open_List<Node_Comp, Node>::~Open_List()
 template < typename Node_Comp, typename Node >
 void	Open_List<Node_Comp, Node>::insert( Node* n )
 {
+	APTK_PHASE( OPEN_LIST );
 	m_queue.push( n );
 }
 
 template <typename Node_Comp, typename Node >
 Node*	Open_List<Node_Comp, Node>::pop()
 {
+	APTK_PHASE( OPEN_LIST );
         if( empty() ) return NULL;
 	Node* elem = m_queue.top();
 	m_queue.pop();
@@ -163,12 +170,14 @@ Fibonacci_Open_List<Node_Comp, Node>::~Fibonacci_Open_List()
 template < typename Node_Comp, typename Node >
 void	Fibonacci_Open_List<Node_Comp, Node>::insert( Node* n )
 {
+	APTK_PHASE( OPEN_LIST );
 	m_queue.push( n );
 }
 
 template <typename Node_Comp, typename Node >
 Node*	Fibonacci_Open_List<Node_Comp, Node>::pop()
 {
+	APTK_PHASE( OPEN_LIST );
         if( empty() ) return NULL;
 	Node* elem = m_queue.top();
 	m_queue.pop();
@@ -0,0 +1,275 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __PARALLEL_BREADTH_FIRST_SEARCH__
+#define __PARALLEL_BREADTH_FIRST_SEARCH__
+
+#include <aptk/search_prob.hxx>
+#include <aptk/resources_control.hxx>
+#include <aptk/closed_list.hxx>
+#include <aptk/brfs.hxx>
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace aptk {
+
+namespace search {
+
+namespace brfs {
+
+// Closed list split into shards, each with its own lock, so that several
+// threads can check and insert nodes at the same time. The shard is
+// chosen with the high bits of the state hash, the low ones are used
+// inside the shard by the hash table.
+template <typename Node>
+class Sharded_Closed_List {
+public:
+	typedef	Closed_List< Node >	Shard;
+
+	Sharded_Closed_List( unsigned num_shards = 64 )
+	: m_shards( num_shards ), m_locks( num_shards ) {
+	}
+
+	~Sharded_Closed_List() {
+		clear();
+	}
+
+	// Returns true and keeps n if no node with the same state was there
+	bool	put_if_absent( Node* n ) {
+		unsigned k = shard( n );
+		std::lock_guard< std::mutex > lock( m_locks[k] );
+		if ( m_shards[k].retrieve( n ) != NULL ) return false;
+		m_shards[k].put( n );
+		return true;
+	}
+
+	Node*	retrieve( Node* n ) {
+		unsigned k = shard( n );
+		std::lock_guard< std::mutex > lock( m_locks[k] );
+		return m_shards[k].retrieve( n );
+	}
+
+	size_t	size() const {
+		size_t total = 0;
+		for ( unsigned k = 0; k < m_shards.size(); k++ )
+			total += m_shards[k].size();
+		return total;
+	}
+
+	// Not thread-safe, deletes the nodes
+	void	clear() {
+		for ( unsigned k = 0; k < m_shards.size(); k++ ) {
+			for ( typename Shard::iterator i = m_shards[k].begin(); i != m_shards[k].end(); i++ )
+				delete i->second;
+			m_shards[k].clear();
+		}
+	}
+
+protected:
+
+	unsigned	shard( Node* n ) const {
+		size_t h = n->hash();
+		return (unsigned)( ( h ^ ( h >> 17 ) ^ ( h >> 31 ) ) % m_shards.size() );
+	}
+
+	std::vector< Shard >		m_shards;
+	std::vector< std::mutex >	m_locks;
+};
+
+// Breadth-first search expanding each layer concurrently. Every thread
+// takes chunks of the current layer and generates the next one, duplicates
+// are detected on a sharded closed list holding every node generated so
+// far. The first goal found in a layer stops the workers, any other goal
+// in that layer would give a plan of the same length.
+template <typename Search_Model>
+class Parallel_BRFS {
+
+public:
+
+	typedef		typename Search_Model::State_Type		State;
+	typedef  	Node< State >					Search_Node;
+	typedef		Sharded_Closed_List< Search_Node >		Closed_List_Type;
+
+	Parallel_BRFS( const Search_Model& search_problem, unsigned num_threads = 2 )
+	: m_problem( search_problem ), m_num_threads( num_threads == 0 ? 1 : num_threads ),
+	m_chunk_size( 16 ), m_min_parallel_layer( 64 ), m_root( NULL ), m_max_depth( 0 ),
+	m_exp_count( 0 ), m_gen_count( 0 ), m_cl_count( 0 ), m_goal( NULL ), m_next_item( 0 ) {
+	}
+
+	virtual ~Parallel_BRFS() {
+	}
+
+	void	reset() {
+		m_closed.clear();
+		m_layer.clear();
+		m_max_depth = 0;
+		m_goal = NULL;
+	}
+
+	void	start( State* s = NULL ) {
+		reset();
+		m_root = new Search_Node( s == NULL ? m_problem.init() : s, no_op, NULL );
+		m_closed.put_if_absent( m_root );
+		m_layer.push_back( m_root );
+		inc_gen();
+	}
+
+	bool	find_solution( float& cost, std::vector<Action_Idx>& plan ) {
+		Search_Node* end = do_search();
+		if ( end == NULL ) return false;
+		extract_plan( m_root, end, plan, cost );
+		return true;
+	}
+
+	unsigned		num_threads() const		{ return m_num_threads; }
+	void			set_num_threads( unsigned n )	{ m_num_threads = ( n == 0 ? 1 : n ); }
+	// Layers smaller than this are expanded by the calling thread alone
+	void			set_min_parallel_layer( unsigned n ) { m_min_parallel_layer = n; }
+
+	void			inc_gen()			{ m_gen_count++; }
+	unsigned		generated() const		{ return m_gen_count; }
+	unsigned		expanded() const		{ return m_exp_count; }
+	unsigned		pruned_closed() const		{ return m_cl_count; }
+	unsigned		max_depth() const		{ return m_max_depth; }
+
+	const	Search_Model&	problem() const			{ return m_problem; }
+	Closed_List_Type&	closed()			{ return m_closed; }
+
+	Search_Node*	do_search() {
+		if ( m_layer.empty() ) return NULL;
+		if ( m_problem.goal( *(m_root->state()) ) )
+			return m_root;
+
+		while ( !m_layer.empty() ) {
+			expand_layer();
+			if ( m_goal.load() != NULL ) return m_goal.load();
+			m_max_depth++;
+			if ( m_max_depth == 1 ) std::cout << std::endl;
+			std::cout << "[" << m_max_depth << "]" << std::flush;
+		}
+		return NULL;
+	}
+
+protected:
+
+	struct Worker_Stats {
+		Worker_Stats() : expanded( 0 ), generated( 0 ), pruned( 0 ) {}
+		std::vector< Search_Node* >	next;
+		unsigned			expanded;
+		unsigned			generated;
+		unsigned			pruned;
+	};
+
+	void	expand_layer() {
+		unsigned n = m_layer.size() < m_min_parallel_layer ? 1 : m_num_threads;
+		std::vector< Worker_Stats > stats( n );
+		m_next_item = 0;
+
+		std::vector< std::thread > threads;
+		for ( unsigned k = 1; k < n; k++ )
+			threads.push_back( std::thread( &Parallel_BRFS::work, this, std::ref( stats[k] ) ) );
+		work( stats[0] );
+		for ( unsigned k = 0; k < threads.size(); k++ )
+			threads[k].join();
+
+		// Next layer keeps the order in which threads were numbered
+		m_layer.clear();
+		for ( unsigned k = 0; k < n; k++ ) {
+			m_layer.insert( m_layer.end(), stats[k].next.begin(), stats[k].next.end() );
+			m_exp_count += stats[k].expanded;
+			m_gen_count += stats[k].generated;
+			m_cl_count += stats[k].pruned;
+		}
+	}
+
+	void	work( Worker_Stats& stats ) {
+		typedef typename Search_Model::Action_Iterator Iterator;
+		while ( m_goal.load( std::memory_order_relaxed ) == NULL ) {
+			unsigned first = m_next_item.fetch_add( m_chunk_size );
+			if ( first >= m_layer.size() ) return;
+			unsigned last = std::min( (unsigned)m_layer.size(), first + m_chunk_size );
+			for ( unsigned i = first; i < last; i++ ) {
+				Search_Node* head = m_layer[i];
+				Iterator it( this->problem() );
+				int a = it.start( *(head->state()) );
+				while ( a != no_op ) {
+					State *succ = m_problem.next( *(head->state()), a );
+					Search_Node* n = new Search_Node( succ, a, head );
+					if ( !m_closed.put_if_absent( n ) ) {
+						delete n;
+						stats.pruned++;
+						a = it.next();
+						continue;
+					}
+					stats.generated++;
+					if ( m_problem.goal( *(n->state()) ) ) {
+						Search_Node* none = NULL;
+						m_goal.compare_exchange_strong( none, n );
+						return;
+					}
+					stats.next.push_back( n );
+					a = it.next();
+				}
+				stats.expanded++;
+			}
+		}
+	}
+
+	void	extract_plan( Search_Node* s, Search_Node* t, std::vector<Action_Idx>& plan, float& cost ) {
+		Search_Node *tmp = t;
+		cost = 0.0f;
+		while( tmp != s) {
+			cost += m_problem.cost( *(tmp->state()), tmp->action() );
+			plan.push_back(tmp->action());
+			tmp = tmp->parent();
+		}
+
+		std::reverse(plan.begin(), plan.end());
+	}
+
+protected:
+
+	const Search_Model&			m_problem;
+	unsigned				m_num_threads;
+	unsigned				m_chunk_size;
+	unsigned				m_min_parallel_layer;
+	Closed_List_Type			m_closed;
+	std::vector< Search_Node* >		m_layer;
+	Search_Node*				m_root;
+	unsigned				m_max_depth;
+	unsigned				m_exp_count;
+	unsigned				m_gen_count;
+	unsigned				m_cl_count;
+	std::atomic< Search_Node* >		m_goal;
+	std::atomic< unsigned >			m_next_item;
+};
+
+}
+
+}
+
+}
+
+#endif // parallel_brfs.hxx
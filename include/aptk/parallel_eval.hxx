@@ -0,0 +1,205 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __PARALLEL_EVALUATION__
+#define __PARALLEL_EVALUATION__
+
+#include <aptk/search_prob.hxx>
+#include <aptk/resources_control.hxx>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+namespace aptk {
+
+namespace search {
+
+// Evaluation policies for the AT_BFS_DQ_* engines and DAS.
+//
+// With Sequential_Evaluation (the default) the engines evaluate states one
+// at a time with their own heuristic: AT_BFS_DQ_* when nodes are expanded,
+// DAS when they are generated.
+//
+// With Parallel_Evaluation successors surviving duplicate detection are
+// collected into batches and evaluated when generated by a pool of threads,
+// each with its own copy of the heuristic. Nodes are then put into OPEN in
+// the order they were generated, so the search is the same regardless of
+// the number of threads.
+class Sequential_Evaluation {
+public:
+	typedef	std::false_type		Batched;
+
+	template <typename Search_Model>
+	Sequential_Evaluation( const Search_Model& ) {}
+};
+
+template <typename Search_Model, typename Abstract_Heuristic>
+class Parallel_Evaluation {
+public:
+	typedef	std::true_type				Batched;
+	typedef	typename Search_Model::State_Type	State;
+
+	Parallel_Evaluation( const Search_Model& prob, unsigned num_threads = 2, unsigned batch_size = 64 )
+	: m_problem( prob ), m_batch_size( batch_size == 0 ? 1 : batch_size ), m_batches( 0 ),
+	m_generation( 0 ), m_busy( 0 ), m_quit( false ), m_batch_items( 0 ) {
+		start_threads( num_threads == 0 ? 1 : num_threads );
+	}
+
+	~Parallel_Evaluation() {
+		stop_threads();
+	}
+
+	unsigned		num_threads() const		{ return m_heuristics.size(); }
+	void			set_num_threads( unsigned n ) {
+		stop_threads();
+		start_threads( n == 0 ? 1 : n );
+	}
+
+	unsigned		batch_size() const		{ return m_batch_size; }
+	void			set_batch_size( unsigned n )	{ m_batch_size = ( n == 0 ? 1 : n ); }
+
+	// Per thread cost stats
+	unsigned		evaluations( unsigned k ) const	{ return m_evaluations[k]; }
+	double			eval_time( unsigned k ) const	{ return m_eval_time[k]; }
+	unsigned		batches() const			{ return m_batches; }
+
+	Abstract_Heuristic&	heuristic( unsigned k )		{ return *(m_heuristics[k]); }
+
+	// Evaluates the states of the nodes in the batch, the estimate for
+	// batch[i] is left in h(i) and, if want_po is true, its preferred
+	// operators in preferred(i).
+	template <typename Search_Node>
+	void	evaluate( const std::vector<Search_Node*>& batch, bool want_po = false ) {
+		if ( m_h.size() < batch.size() ) m_h.resize( batch.size() );
+		if ( want_po && m_po.size() < batch.size() ) m_po.resize( batch.size() );
+		m_batches++;
+		m_job = [&batch, want_po, this]( Abstract_Heuristic& h, unsigned i ) {
+			if ( want_po ) {
+				m_po[i].clear();
+				h.eval( *(batch[i]->state()), m_h[i], m_po[i] );
+			}
+			else
+				h.eval( *(batch[i]->state()), m_h[i] );
+		};
+		m_batch_items = batch.size();
+		m_next_item = 0;
+
+		if ( m_threads.empty() || batch.size() < 2 ) {
+			run( 0 );
+			return;
+		}
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_busy = m_threads.size();
+			m_generation++;
+		}
+		m_wakeup.notify_all();
+		run( 0 );
+		std::unique_lock< std::mutex > lock( m_mutex );
+		m_done.wait( lock, [this]() { return m_busy == 0; } );
+	}
+
+	float				h( unsigned i ) const		{ return m_h[i]; }
+	const std::vector<Action_Idx>&	preferred( unsigned i ) const	{ return m_po[i]; }
+
+protected:
+
+	void	start_threads( unsigned n ) {
+		m_quit = false;
+		for ( unsigned k = 0; k < n; k++ ) {
+			m_heuristics.push_back( new Abstract_Heuristic( m_problem ) );
+			m_evaluations.push_back( 0 );
+			m_eval_time.push_back( 0.0 );
+		}
+		// The calling thread does the share of thread 0
+		for ( unsigned k = 1; k < n; k++ )
+			m_threads.push_back( std::thread( &Parallel_Evaluation::work, this, k, m_generation ) );
+	}
+
+	void	stop_threads() {
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_quit = true;
+		}
+		m_wakeup.notify_all();
+		for ( unsigned k = 0; k < m_threads.size(); k++ )
+			m_threads[k].join();
+		m_threads.clear();
+		for ( unsigned k = 0; k < m_heuristics.size(); k++ )
+			delete m_heuristics[k];
+		m_heuristics.clear();
+		m_evaluations.clear();
+		m_eval_time.clear();
+	}
+
+	void	work( unsigned k, unsigned seen ) {
+		while ( true ) {
+			{
+				std::unique_lock< std::mutex > lock( m_mutex );
+				m_wakeup.wait( lock, [this, seen]() { return m_quit || m_generation != seen; } );
+				if ( m_quit ) return;
+				seen = m_generation;
+			}
+			run( k );
+			std::lock_guard< std::mutex > lock( m_mutex );
+			if ( --m_busy == 0 ) m_done.notify_one();
+		}
+	}
+
+	void	run( unsigned k ) {
+		double t0 = wall_time();
+		Abstract_Heuristic& h = *(m_heuristics[k]);
+		for ( unsigned i = m_next_item++; i < m_batch_items; i = m_next_item++ ) {
+			m_job( h, i );
+			m_evaluations[k]++;
+		}
+		m_eval_time[k] += wall_time() - t0;
+	}
+
+protected:
+
+	const Search_Model&						m_problem;
+	unsigned							m_batch_size;
+	unsigned							m_batches;
+	std::vector<Abstract_Heuristic*>				m_heuristics;
+	std::vector<std::thread>					m_threads;
+	std::vector<unsigned>						m_evaluations;
+	std::vector<double>						m_eval_time;
+	std::vector<float>						m_h;
+	std::vector< std::vector<Action_Idx> >				m_po;
+	std::function< void( Abstract_Heuristic&, unsigned ) >		m_job;
+	std::mutex							m_mutex;
+	std::condition_variable						m_wakeup, m_done;
+	unsigned							m_generation;
+	unsigned							m_busy;
+	bool								m_quit;
+	unsigned							m_batch_items;
+	std::atomic<unsigned>						m_next_item;
+};
+
+}
+
+}
+
+#endif // parallel_eval.hxx
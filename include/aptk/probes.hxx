@@ -0,0 +1,189 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __PROBES__
+#define __PROBES__
+
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <stdint.h>
+#include <aptk/resources_control.hxx>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Timers for the phases of a search, only there when APTK_PROBES is
+// defined, otherwise APTK_PHASE expands to nothing. APTK_PHASE( p ) times
+// the rest of the scope it is in, less the time of the phases timed
+// inside it, and counts the times the scope is entered. The breakdown is
+// printed on std::cerr at exit.
+//
+// Time is counted in TSC ticks, converted to secs with the rate seen
+// between the first timer and the report.
+#ifdef APTK_PROBES
+#define APTK_PHASE( p )		aptk::probes::Phase_Timer aptk_phase_timer( aptk::probes::p )
+#else
+#define APTK_PHASE( p )
+#endif
+
+namespace aptk
+{
+
+namespace probes
+{
+
+enum Phase {
+	SEARCH = 0,	// search loop, less what follows
+	EXPANSION,	// expansion of a node, less what follows
+	SUCCESSORS,	// finding the applicable actions
+	PROGRESSION,	// making successor states
+	HASHING,	// hashing states
+	DUPLICATES,	// looking up states in open and closed
+	HEURISTIC,	// heuristic evaluation
+	OPEN_LIST,	// open list insertions and removals
+	NUM_PHASES
+};
+
+inline const char*	phase_name( unsigned p ) {
+	static const char* names[] = { "search", "expansion", "successors", "progression",
+					"hashing", "duplicates", "heuristic", "open list" };
+	return names[p];
+}
+
+inline uint64_t	ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec	ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Sums over all threads, printed when destroyed
+class Totals {
+public:
+	Totals() : m_ticks0( ticks() ), m_wall0( wall_time() ) {
+		for ( unsigned p = 0; p < NUM_PHASES; p++ ) {
+			m_ticks[p] = 0;
+			m_calls[p] = 0;
+		}
+	}
+
+	~Totals() {
+		double secs = wall_time() - m_wall0;
+		uint64_t total = 0;
+		for ( unsigned p = 0; p < NUM_PHASES; p++ )
+			total += m_ticks[p];
+		if ( total == 0 ) return;
+		double rate = secs > 0 ? ( ticks() - m_ticks0 ) / secs : 1e9;
+		std::ios::fmtflags flags = std::cerr.flags();
+		std::cerr << std::fixed << std::setprecision(3);
+		std::cerr << "Phase           Calls        Secs     %    ns/call" << std::endl;
+		for ( unsigned p = 0; p < NUM_PHASES; p++ ) {
+			if ( m_calls[p] == 0 ) continue;
+			double t = m_ticks[p] / rate;
+			std::cerr << std::left << std::setw(12) << phase_name(p) << std::right
+				<< std::setw(10) << m_calls[p]
+				<< std::setw(12) << t
+				<< std::setw(6) << std::setprecision(1) << 100.0 * m_ticks[p] / total
+				<< std::setw(11) << std::setprecision(0) << 1e9 * t / m_calls[p]
+				<< std::setprecision(3) << std::endl;
+		}
+		std::cerr.flags( flags );
+	}
+
+	void	add( const uint64_t* t, const uint64_t* calls ) {
+		for ( unsigned p = 0; p < NUM_PHASES; p++ ) {
+			m_ticks[p] += t[p];
+			m_calls[p] += calls[p];
+		}
+	}
+
+protected:
+	uint64_t			m_ticks0;
+	double				m_wall0;
+	std::atomic<uint64_t>		m_ticks[NUM_PHASES];
+	std::atomic<uint64_t>		m_calls[NUM_PHASES];
+};
+
+inline Totals&	totals() {
+	static Totals t;
+	return t;
+}
+
+class Phase_Timer;
+
+// Kept by each thread, and added to the totals when the thread ends
+struct Thread_Probes {
+	Thread_Probes() : current( NULL ) {
+		totals();
+		for ( unsigned p = 0; p < NUM_PHASES; p++ ) {
+			ticks[p] = 0;
+			calls[p] = 0;
+		}
+	}
+
+	~Thread_Probes()	{ totals().add( ticks, calls ); }
+
+	uint64_t	ticks[NUM_PHASES];
+	uint64_t	calls[NUM_PHASES];
+	Phase_Timer*	current;
+};
+
+inline Thread_Probes&	thread_probes() {
+	static thread_local Thread_Probes tp;
+	return tp;
+}
+
+// A phase entered again from inside itself, as heuristics built on
+// others do, is counted once
+class Phase_Timer {
+public:
+	Phase_Timer( Phase p )
+	: m_phase( p ), m_probes( thread_probes() ), m_parent( m_probes.current ), m_inner( 0 ) {
+		m_probes.current = this;
+		m_t0 = ticks();
+	}
+
+	~Phase_Timer() {
+		uint64_t t = ticks() - m_t0;
+		m_probes.current = m_parent;
+		m_probes.ticks[m_phase] += t - m_inner;
+		if ( m_parent == NULL || m_parent->m_phase != m_phase )
+			m_probes.calls[m_phase]++;
+		if ( m_parent != NULL ) m_parent->m_inner += t;
+	}
+
+protected:
+	Phase			m_phase;
+	Thread_Probes&		m_probes;
+	Phase_Timer*		m_parent;
+	uint64_t		m_t0;
+	uint64_t		m_inner;
+};
+
+}
+
+}
+
+#endif // probes.hxx
@@ -24,8 +24,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/times.h>
 #include <sys/resource.h>
 #include <unistd.h>
+#include <time.h>
 #include <iostream>
 #include <iomanip>
+#include <cstdio>
 
 
 namespace aptk
@@ -43,6 +45,18 @@ inline double  time_used()
 	return user_time + system_time;
 }
 
+// Elapsed wall-clock time, in seconds, measured against a monotonic clock.
+// Unlike time_used() this does not add up the CPU time of every thread in
+// the process, so it is the right measure for parallel engines.
+inline double  wall_time()
+{
+	struct timespec	ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return (double)ts.tv_sec + ((double)ts.tv_nsec/1e9);
+}
+
 template <typename Stream>
 void report_interval( double t0, double t1, Stream& os )
 {
@@ -62,6 +76,19 @@ inline double mem_used()
 	return (double)data.ru_maxrss / 1024.;
 }
 
+// Resident set size now, in MB, unlike mem_used() which is the peak.
+// Falls back on the peak where /proc is not there.
+inline double mem_resident()
+{
+	FILE* f = fopen( "/proc/self/statm", "r" );
+	if ( f == NULL ) return mem_used();
+	unsigned long size = 0, resident = 0;
+	int read = fscanf( f, "%lu %lu", &size, &resident );
+	fclose( f );
+	if ( read != 2 ) return mem_used();
+	return (double)resident * sysconf( _SC_PAGESIZE ) / ( 1024. * 1024. );
+}
+
 }
 
 #endif // Resources_Control.hxx
@@ -149,6 +149,7 @@ public:
 		State* new_init_state = NULL;
 		m_goals_achieved.clear();
 		m_goal_candidates.clear();
+		this->budget().start();
 		m_goal_candidates.insert( m_goal_candidates.begin(), 
 					  this->problem().task().goal().begin(), this->problem().task().goal().end() );
 
@@ -0,0 +1,257 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SHM_TRANSPORT__
+#define __SHM_TRANSPORT__
+
+#include <aptk/search_prob.hxx>
+#include <vector>
+#include <atomic>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace aptk {
+
+namespace search {
+
+// Transport between the processes of a distributed search, built on POSIX
+// shared memory. Each pair of processes has a single producer, single
+// consumer ring of 32-bit words, and a control block keeps the state all
+// processes have to agree on: whether the search has to stop, the amount
+// of pending work, the incumbent bound and the best plan found so far.
+//
+// Any other transport (e.g. over sockets) has to provide the same
+// interface:
+//
+//	reset( keep_incumbent ), set_rank(), rank(), num_procs()
+//	send( dest, msg ), receive( msg )
+//	add_work(), work(), stop(), stopped(), abort(), aborted()
+//	bound(), improve_bound(), publish_plan(), best_plan()
+//
+// The segment is created before the worker processes are forked and it is
+// unlinked right away, so nothing is left behind in /dev/shm.
+class Shm_Transport {
+public:
+	typedef	uint32_t	Word;
+	typedef	std::vector<Word>	Message;
+
+	Shm_Transport( unsigned num_procs, unsigned ring_words = 1 << 16, unsigned max_plan_length = 1 << 14 )
+	: m_num_procs( num_procs ), m_ring_words( ring_words ), m_max_plan_length( max_plan_length ),
+	m_rank( 0 ), m_next_src( 0 ), m_base( NULL ), m_size( 0 ) {
+		m_size = control_size() + (size_t)num_procs * num_procs * ring_size();
+
+		std::stringstream name;
+		name << "/aptk-" << getpid() << "-" << (void*)this;
+		int fd = shm_open( name.str().c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+		if ( fd < 0 )
+			throw std::runtime_error( "Shm_Transport: could not create shared memory segment" );
+		shm_unlink( name.str().c_str() );
+		if ( ftruncate( fd, m_size ) != 0 ) {
+			close( fd );
+			throw std::runtime_error( "Shm_Transport: could not size shared memory segment" );
+		}
+		m_base = (char*)mmap( NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+		close( fd );
+		if ( m_base == MAP_FAILED )
+			throw std::runtime_error( "Shm_Transport: could not map shared memory segment" );
+		new ( control() ) Control;
+		for ( unsigned k = 0; k < num_procs * num_procs; k++ )
+			new ( m_base + control_size() + k * ring_size() ) Ring;
+		reset();
+	}
+
+	~Shm_Transport() {
+		if ( m_base != NULL ) munmap( m_base, m_size );
+	}
+
+	// Only to be called while no worker is running. The bound and the best
+	// plan are kept when keep_incumbent is true.
+	void	reset( bool keep_incumbent = false ) {
+		Control* c = control();
+		c->stop = 0;
+		c->abort = 0;
+		c->work = 0;
+		c->plan_lock = 0;
+		if ( !keep_incumbent ) {
+			c->bound = float_to_word( infty );
+			c->plan_cost = infty;
+			c->plan_length = 0;
+		}
+		for ( unsigned k = 0; k < m_num_procs * m_num_procs; k++ ) {
+			ring(k)->head = 0;
+			ring(k)->tail = 0;
+		}
+	}
+
+	void		set_rank( unsigned r )		{ m_rank = r; }
+	unsigned	rank() const			{ return m_rank; }
+	unsigned	num_procs() const		{ return m_num_procs; }
+
+	// Returns false if there is no room for msg in the ring to dest
+	bool	send( unsigned dest, const Message& msg ) {
+		Ring* r = ring( m_rank * m_num_procs + dest );
+		uint64_t head = r->head.load( std::memory_order_relaxed );
+		uint64_t tail = r->tail.load( std::memory_order_acquire );
+		if ( head + msg.size() + 1 - tail > m_ring_words ) {
+			if ( msg.size() + 1 > m_ring_words )
+				throw std::runtime_error( "Shm_Transport: message larger than ring buffer" );
+			return false;
+		}
+		Word* data = ring_data( r );
+		data[ head % m_ring_words ] = msg.size();
+		for ( unsigned k = 0; k < msg.size(); k++ )
+			data[ ( head + 1 + k ) % m_ring_words ] = msg[k];
+		r->head.store( head + msg.size() + 1, std::memory_order_release );
+		return true;
+	}
+
+	// Takes one message from any of the rings into this process, sources
+	// are visited round robin
+	bool	receive( Message& msg ) {
+		for ( unsigned i = 0; i < m_num_procs; i++ ) {
+			unsigned src = m_next_src;
+			m_next_src = ( m_next_src + 1 ) % m_num_procs;
+			Ring* r = ring( src * m_num_procs + m_rank );
+			uint64_t tail = r->tail.load( std::memory_order_relaxed );
+			uint64_t head = r->head.load( std::memory_order_acquire );
+			if ( head == tail ) continue;
+			Word* data = ring_data( r );
+			unsigned len = data[ tail % m_ring_words ];
+			msg.resize( len );
+			for ( unsigned k = 0; k < len; k++ )
+				msg[k] = data[ ( tail + 1 + k ) % m_ring_words ];
+			r->tail.store( tail + len + 1, std::memory_order_release );
+			return true;
+		}
+		return false;
+	}
+
+	// Processes active plus messages not yet processed, the search is
+	// over once it drops to zero
+	void	add_work( long v )	{ control()->work.fetch_add( v ); }
+	long	work() const		{ return control()->work.load(); }
+
+	void	stop()			{ control()->stop = 1; }
+	bool	stopped() const		{ return control()->stop.load( std::memory_order_relaxed ) != 0; }
+	// Something went wrong in some process, everybody leaves right away
+	void	abort()			{ control()->abort = 1; control()->stop = 1; }
+	bool	aborted() const		{ return control()->abort.load( std::memory_order_relaxed ) != 0; }
+
+	float	bound() const		{ return word_to_float( control()->bound.load( std::memory_order_relaxed ) ); }
+
+	// Lowers the bound to v, returns false if it was already as low
+	bool	improve_bound( float v ) {
+		Word current = control()->bound.load();
+		while ( v < word_to_float( current ) ) {
+			if ( control()->bound.compare_exchange_weak( current, float_to_word( v ) ) )
+				return true;
+		}
+		return false;
+	}
+
+	// Keeps plan if it is cheaper than the one stored
+	void	publish_plan( const std::vector<Action_Idx>& plan, float cost ) {
+		if ( plan.size() > m_max_plan_length ) return;
+		Control* c = control();
+		int unlocked = 0;
+		while ( !c->plan_lock.compare_exchange_weak( unlocked, 1 ) )
+			unlocked = 0;
+		if ( cost < c->plan_cost ) {
+			c->plan_cost = cost;
+			c->plan_length = plan.size();
+			Action_Idx* dst = plan_data();
+			for ( unsigned k = 0; k < plan.size(); k++ )
+				dst[k] = plan[k];
+		}
+		c->plan_lock = 0;
+	}
+
+	bool	best_plan( std::vector<Action_Idx>& plan, float& cost ) const {
+		const Control* c = control();
+		if ( c->plan_cost == infty ) return false;
+		cost = c->plan_cost;
+		const Action_Idx* src = plan_data();
+		plan.assign( src, src + c->plan_length );
+		return true;
+	}
+
+protected:
+
+	struct Control {
+		std::atomic<int>	stop;
+		std::atomic<int>	abort;
+		std::atomic<long>	work;
+		std::atomic<Word>	bound;
+		std::atomic<int>	plan_lock;
+		float			plan_cost;
+		unsigned		plan_length;
+	};
+
+	// head and tail on different cache lines
+	struct Ring {
+		std::atomic<uint64_t>	head;
+		char			pad0[56];
+		std::atomic<uint64_t>	tail;
+		char			pad1[56];
+	};
+
+	static Word	float_to_word( float v )	{ Word w; std::memcpy( &w, &v, sizeof(w) ); return w; }
+	static float	word_to_float( Word w )		{ float v; std::memcpy( &v, &w, sizeof(v) ); return v; }
+
+	size_t		control_size() const {
+		size_t s = sizeof(Control) + (size_t)m_max_plan_length * sizeof(Action_Idx);
+		return ( s + 63 ) & ~(size_t)63;
+	}
+	size_t		ring_size() const {
+		size_t s = sizeof(Ring) + (size_t)m_ring_words * sizeof(Word);
+		return ( s + 63 ) & ~(size_t)63;
+	}
+
+	Control*		control()		{ return (Control*)m_base; }
+	const Control*		control() const		{ return (const Control*)m_base; }
+	Action_Idx*		plan_data()		{ return (Action_Idx*)( m_base + sizeof(Control) ); }
+	const Action_Idx*	plan_data() const	{ return (const Action_Idx*)( m_base + sizeof(Control) ); }
+	Ring*			ring( unsigned k )	{ return (Ring*)( m_base + control_size() + k * ring_size() ); }
+	Word*			ring_data( Ring* r )	{ return (Word*)( (char*)r + sizeof(Ring) ); }
+
+protected:
+
+	unsigned	m_num_procs;
+	unsigned	m_ring_words;
+	unsigned	m_max_plan_length;
+	unsigned	m_rank;
+	unsigned	m_next_src;
+	char*		m_base;
+	size_t		m_size;
+};
+
+}
+
+}
+
+#endif // shm_transport.hxx
@@ -59,6 +59,7 @@ public:
 		State* new_init_state = NULL;
 		this->m_goals_achieved.clear();
 		this->m_goal_candidates.clear();
+		this->budget().start();
 		
 		if( m_goal_agenda ){
 			m_goal_agenda->get_leafs( this->m_goal_candidates );
@@ -76,6 +77,9 @@ public:
 
 			if ( end == NULL ) {
 
+				if ( this->budget().hit() != Budget::NONE )
+					return false;
+
 				/**
 				 * If no partial plan to achieve any goal is  found,
 				 * throw IW(b+1) from same root node
@@ -0,0 +1,113 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SOLUTION_SINK__
+#define __SOLUTION_SINK__
+
+#include <aptk/search_prob.hxx>
+#include <aptk/stats_reporter.hxx>
+#include <aptk/mpsc_queue.hxx>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace aptk
+{
+
+// A plan found by an anytime engine, with its cost, the secs since
+// find_solution() was called and the counters of the engine by then
+struct Solution {
+	std::vector<Action_Idx>	plan;
+	float			cost;
+	double			time;
+	Search_Stats		stats;
+};
+
+// Receives the plans of an anytime engine as soon as they are found.
+// Engines with a sink set do not return from find_solution() on the first
+// goal, they go on under the bound set by each plan until open is empty or
+// the budget runs out, and then return the last plan. solution() and ended()
+// are called on the thread of the search, so they should return quickly.
+class Solution_Sink
+{
+public:
+	virtual ~Solution_Sink() {}
+
+	template <typename Engine>
+	void	found( const Engine& e, const std::vector<Action_Idx>& plan, float cost, double time ) {
+		Solution s;
+		s.plan = plan;
+		s.cost = cost;
+		s.time = time;
+		e.stats( s.stats );
+		s.stats.time = time;
+		solution( s );
+	}
+
+	// Called once when the search is over, whether a plan was found or not
+	template <typename Engine>
+	void	finished( const Engine& e, double time ) {
+		Search_Stats s;
+		e.stats( s );
+		s.time = time;
+		ended( s );
+	}
+
+	virtual void	solution( const Solution& s ) = 0;
+	virtual void	ended( const Search_Stats& ) {}
+};
+
+// Hands the plans over to another thread, e.g. a controller which starts
+// executing the first plan while the search improves it. The search only
+// pushes onto a lock-free queue, and wakes up the consumer if it waits.
+class Solution_Queue : public Solution_Sink
+{
+public:
+	Solution_Queue();
+	~Solution_Queue();
+
+	virtual void	solution( const Solution& s );
+	virtual void	ended( const Search_Stats& s );
+
+	// Consumer side. Appends the plans queued so far to out, oldest first,
+	// and returns how many there were
+	unsigned	pop( std::vector<Solution>& out );
+	// Blocks until a plan is queued, the search is over or secs have passed,
+	// returns false in the last case
+	bool		wait( double secs );
+	bool		has_ended() const	{ return m_ended.load( std::memory_order_acquire ); }
+	// Counters at the end of the search, valid once has_ended()
+	const Search_Stats&	final_stats() const	{ return m_final; }
+
+protected:
+
+	typedef	MPSC_Queue< Solution >	Queue;
+
+	Queue				m_queue;
+	Search_Stats			m_final;
+	std::atomic<bool>		m_ended;
+	std::mutex			m_mutex;
+	std::condition_variable		m_wake;
+};
+
+}
+
+#endif // solution_sink.hxx
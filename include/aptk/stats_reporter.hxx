@@ -0,0 +1,116 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __STATS_REPORTER__
+#define __STATS_REPORTER__
+
+#include <aptk/mpsc_queue.hxx>
+#include <aptk/resources_control.hxx>
+#include <iosfwd>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace aptk
+{
+
+// Counters of a search engine at some point. Engines fill in what they
+// keep with stats(), the rest is left as it is.
+struct Search_Stats {
+	Search_Stats();
+
+	double		time;
+	unsigned	expanded;
+	unsigned	generated;
+	unsigned	dead_ends;
+	unsigned	open_repl;
+	unsigned	pruned_bound;
+	size_t		open;
+	size_t		closed;
+	float		best_h;
+	float		bound;
+	unsigned	depth;
+};
+
+// Writes the counters of an engine every interval() secs, as JSON lines
+// or CSV, together with the expansion rate since the last sample and the
+// resident set size. Engines call tick() on every expansion, which reads
+// the clock only every so many calls, and when a sample is due copies the
+// counters into a queue. Formatting and writing are done by a thread of
+// the reporter, so the search never waits on the sink.
+class Stats_Reporter
+{
+public:
+	enum Format { JSON = 0, CSV };
+
+	Stats_Reporter( std::ostream& os, Format format = JSON, double interval = 1.0 );
+	// Writes the samples still queued
+	~Stats_Reporter();
+
+	template <typename Engine>
+	void	tick( const Engine& e ) {
+		if ( --m_countdown > 0 ) return;
+		if ( due() ) sample( e );
+	}
+
+	// Takes a sample now, as when the search is over
+	template <typename Engine>
+	void	sample( const Engine& e ) {
+		Queue::Batch* b = new Queue::Batch;
+		b->items().resize( 1 );
+		e.stats( b->items()[0] );
+		b->items()[0].time = wall_time() - m_t0;
+		m_queue.push( b );
+	}
+
+	double		interval() const	{ return m_interval; }
+	Format		format() const		{ return m_format; }
+
+protected:
+
+	typedef	MPSC_Queue< Search_Stats >	Queue;
+
+	bool	due();
+	void	write_loop();
+	void	write_queued();
+	void	write( const Search_Stats& s );
+
+	std::ostream&			m_os;
+	Format				m_format;
+	double				m_interval;
+	double				m_t0;
+	double				m_last_check;
+	double				m_last_sample;
+	long				m_period;
+	long				m_countdown;
+	Queue				m_queue;
+	// Used by the writer only
+	double				m_prev_time;
+	unsigned			m_prev_expanded;
+	std::atomic<bool>		m_done;
+	std::mutex			m_mutex;
+	std::condition_variable		m_wake;
+	std::thread			m_writer;
+};
+
+}
+
+#endif // stats_reporter.hxx
@@ -0,0 +1,134 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __TRACE__
+#define __TRACE__
+
+#include <aptk/mpsc_queue.hxx>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+namespace aptk
+{
+
+// Layout of a trace file: this header, followed by a ring of capacity
+// records. Once more than capacity records have been written, the oldest
+// is the one at written % capacity.
+struct Trace_Header {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	record_size;
+	uint64_t	capacity;
+	uint64_t	written;
+	uint64_t	reserved[4];
+};
+
+// Nodes are told apart by the hash of their state, and linked to their
+// parents by the hash of the parent state. The queue is 0 for the open
+// list of nodes not reached by preferred operators, 1 for the preferred
+// one, and 2 for the one of nodes preferred by both heuristics.
+struct Trace_Record {
+	uint8_t		type;
+	uint8_t		queue;
+	uint16_t	reserved;
+	uint32_t	action;
+	float		g;
+	float		h;
+	uint64_t	hash;
+	uint64_t	parent;
+};
+
+// Writes events of a search into a memory-mapped ring file. Events are
+// appended to a batch in memory, and full batches are copied into the
+// file by a thread of the writer, so the search only fills in records.
+class Trace_Writer
+{
+public:
+	enum Event {
+		EXPAND = 0,	// a node is expanded, queue is the open list it came from
+		GOAL,		// a solution is returned
+		DUPLICATE,	// a successor is dropped, its state is known with lower or equal g
+		REOPEN,		// a successor reaches a closed state with lower g
+		REPLACE,	// a successor reaches a state in open with lower g
+		PRUNE		// a node is dropped because of the bound
+	};
+
+	static const char*	magic()		{ return "APTKTRC1"; }
+
+	// capacity is the number of records kept in the file
+	Trace_Writer( std::string filename, uint64_t capacity = 1 << 22 );
+	// Writes what is still in memory and closes the file
+	~Trace_Writer();
+
+	bool		good() const		{ return m_ring != NULL; }
+	uint64_t	recorded() const	{ return m_recorded; }
+
+	template <typename Node>
+	void	record( Event type, Node* n, float h, unsigned queue = 0 ) {
+		if ( m_batch == NULL || m_batch->items().size() == batch_size ) next_batch();
+		m_batch->items().push_back( Trace_Record() );
+		Trace_Record& r = m_batch->items().back();
+		r.type = type;
+		r.queue = queue;
+		r.reserved = 0;
+		r.action = n->action();
+		r.g = n->gn();
+		r.h = h;
+		r.hash = n->state()->hash();
+		// The states of parents in closed may have been dropped
+		r.parent = n->parent() != NULL && n->parent()->state() != NULL ? n->parent()->state()->hash() : 0;
+		m_recorded++;
+	}
+
+protected:
+
+	typedef MPSC_Queue< Trace_Record >	Queue;
+
+	static const unsigned	batch_size = 4096;
+
+	void	next_batch();
+	void	write_loop();
+	void	write_queued();
+
+	int				m_fd;
+	Trace_Header*			m_header;
+	Trace_Record*			m_ring;
+	uint64_t			m_capacity;
+	size_t				m_mapped;
+	uint64_t			m_recorded;
+	Queue::Batch*			m_batch;
+	// Full batches go to the writer, and come back empty to be reused
+	Queue				m_full;
+	Queue				m_empty;
+	std::vector< Queue::Batch* >	m_spare;
+	std::atomic<bool>		m_done;
+	std::mutex			m_mutex;
+	std::condition_variable		m_wake;
+	std::thread			m_writer;
+};
+
+}
+
+#endif // trace.hxx
@@ -25,12 +25,10 @@ namespace aptk
 {
 
 Action::Action( STRIPS_Problem& p )
-	: m_cost( 1 )
+	: m_problem( p ), m_signature( no_such_index ),
+	m_prec_set( p.fluent_pool() ), m_add_set( p.fluent_pool() ),
+	m_del_set( p.fluent_pool() ), m_edel_set( p.fluent_pool() ), m_cost( 1 )
 {
-	prec_set().resize( p.num_fluents() );
-	add_set().resize( p.num_fluents() );
-	del_set().resize( p.num_fluents() );
-	edel_set().resize( p.num_fluents() );
 }
 
 Action::~Action()
@@ -53,13 +51,21 @@ void Action::define( Fluent_Vec& precs, Fluent_Vec& adds, Fluent_Vec& dels, Cond
 	m_cond_effects = ceffs;	
 }
 
-void Action::define_fluent_list(  Fluent_Vec& in, Fluent_Vec& fluent_list, Fluent_Set& fluent_set )
+void Action::define_fluent_list(  Fluent_Vec& in, Fluent_Vec& fluent_list, Compact_Fluent_Set& fluent_set )
 {
 	for ( unsigned k = 0; k < in.size(); k++ )
-	{
 		fluent_list.push_back( in[k] );
-		fluent_set.set( in[k] );
-	}
+	fluent_set.assign( fluent_list );
+}
+
+void Action::make_dense_sets( unsigned num_fluents )
+{
+	prec_set().make_dense( num_fluents );
+	add_set().make_dense( num_fluents );
+	del_set().make_dense( num_fluents );
+	edel_set().make_dense( num_fluents );
+	for ( unsigned k = 0; k < ceff_vec().size(); k++ )
+		ceff_vec()[k]->make_dense_sets( num_fluents );
 }
 
 void	Action::print( const STRIPS_Problem& prob, std::ostream& os ) const {
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <strips_prob.hxx>
 #include <strips_state.hxx>
 #include <cond_eff.hxx>
+#include <compact_fluent_set.hxx>
 #include <iosfwd>
 
 namespace aptk
@@ -37,29 +38,31 @@ public:
 	virtual ~Action();
 
 	Fluent_Vec&	           	prec_vec() { return m_prec_vec; }
-	Fluent_Set&	           	prec_set() { return m_prec_set; }
+	Compact_Fluent_Set&		prec_set() { return m_prec_set; }
 	Fluent_Vec&	           	add_vec()  { return m_add_vec; }
-	Fluent_Set&	           	add_set()  { return m_add_set; }
+	Compact_Fluent_Set&		add_set()  { return m_add_set; }
 	Fluent_Vec&	           	del_vec()  { return m_del_vec; }
-	Fluent_Set&	           	del_set()  { return m_del_set; }
+	Compact_Fluent_Set&		del_set()  { return m_del_set; }
 	Fluent_Vec&	           	edel_vec()  { return m_edel_vec; }
-	Fluent_Set&	           	edel_set()  { return m_edel_set; }
+	Compact_Fluent_Set&		edel_set()  { return m_edel_set; }
 	Conditional_Effect_Vec&    	ceff_vec(){ return m_cond_effects; }
 
 	const Fluent_Vec&		prec_vec() const { return m_prec_vec; }
-	const Fluent_Set&	        prec_set() const { return m_prec_set; }
+	const Compact_Fluent_Set&	prec_set() const { return m_prec_set; }
 	const Fluent_Vec&	        add_vec()  const { return m_add_vec; }
-	const Fluent_Set&	        add_set()  const { return m_add_set; }
+	const Compact_Fluent_Set&	add_set()  const { return m_add_set; }
 	const Fluent_Vec&	        del_vec()  const { return m_del_vec; }
-	const Fluent_Set&	        del_set()  const { return m_del_set; }
+	const Compact_Fluent_Set&	del_set()  const { return m_del_set; }
 	const Fluent_Vec&	        edel_vec()  const { return m_edel_vec; }
-	const Fluent_Set&	        edel_set()  const { return m_edel_set; }
+	const Compact_Fluent_Set&	edel_set()  const { return m_edel_set; }
 	const Conditional_Effect_Vec&   ceff_vec() const { return m_cond_effects; }
 
 
 
-	std::string	          	signature() const { return m_signature; }
-	void		           	set_signature(std::string sig) { m_signature = sig; }
+	std::string	          	signature() const;
+	void		           	set_signature(std::string sig) { m_signature = m_problem.intern_signature( sig ); }
+	void		           	set_signature(unsigned sig) { m_signature = sig; }
+	unsigned	           	signature_id() const { return m_signature; }
 
 	std::string	           	name() const { return m_name; }
 	void		           	set_name(std::string nam) { m_name = nam; }
@@ -70,7 +73,11 @@ public:
 	void		           	define( Fluent_Vec& precs, Fluent_Vec& adds, Fluent_Vec& dels );
 	void		           	define( Fluent_Vec& precs, Fluent_Vec& adds, Fluent_Vec& dels, Conditional_Effect_Vec& ceffs );
 
-	void		           	define_fluent_list( Fluent_Vec& in, Fluent_Vec& list, Fluent_Set& set );
+	void		           	define_fluent_list( Fluent_Vec& in, Fluent_Vec& list, Compact_Fluent_Set& set );
+
+	// Dense sets for the preconditions and effects, of the conditional
+	// effects too, for lookups in constant time
+	void				make_dense_sets( unsigned num_fluents );
 
 	bool		           	requires( unsigned f ) const;
 	bool		           	asserts( unsigned f ) const;
@@ -92,23 +99,30 @@ public:
 
 	static bool	           	possible_supporter( const Action& a1, const Action& a2, Fluent_Vec& pvec );
 protected:
+	STRIPS_Problem&			m_problem;
 	// Preconditions and Effects ( Adds and Deletes)
-	std::string			m_signature;
+	unsigned			m_signature;
 	std::string			m_name;
 	Fluent_Vec			m_prec_vec;
-	Fluent_Set			m_prec_set;
+	Compact_Fluent_Set		m_prec_set;
 	Fluent_Vec			m_add_vec;
-	Fluent_Set			m_add_set;
+	Compact_Fluent_Set		m_add_set;
 	Fluent_Vec			m_del_vec;
-	Fluent_Set			m_del_set;
+	Compact_Fluent_Set		m_del_set;
 	Fluent_Vec			m_edel_vec;
-	Fluent_Set			m_edel_set;
+	Compact_Fluent_Set		m_edel_set;
 	Conditional_Effect_Vec		m_cond_effects;
 	float				m_cost;	
 	unsigned			m_index;
 
 };
 
+inline std::string	Action::signature() const
+{
+	if ( m_signature == no_such_index ) return "";
+	return m_problem.signature( m_signature );
+}
+
 inline bool	Action::possible_supporter( const Action& a1, const Action& a2, Fluent_Vec& pvec )
 {
 	pvec.clear();
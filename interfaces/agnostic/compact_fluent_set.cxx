@@ -0,0 +1,91 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <compact_fluent_set.hxx>
+#include <algorithm>
+
+namespace aptk {
+
+Compact_Fluent_Set::Compact_Fluent_Set( Index_Vec& pool )
+	: m_pool( &pool ), m_offset( 0 ), m_size( 0 ), m_capacity( 0 ), m_mask( 0 ), m_dense_made( false ) {
+}
+
+Compact_Fluent_Set::~Compact_Fluent_Set() {
+}
+
+void	Compact_Fluent_Set::assign( const Fluent_Vec& fluents ) {
+	Fluent_Vec sorted( fluents );
+	std::sort( sorted.begin(), sorted.end() );
+	sorted.erase( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+	m_offset = m_pool->size();
+	m_size = m_capacity = sorted.size();
+	m_pool->insert( m_pool->end(), sorted.begin(), sorted.end() );
+	m_mask = 0;
+	for ( unsigned k = 0; k < m_size; k++ )
+		m_mask |= mask_bit( sorted[k] );
+	if ( m_dense_made ) {
+		m_dense.reset();
+		for ( unsigned k = 0; k < m_size; k++ )
+			m_dense.set( sorted[k] );
+	}
+}
+
+// Sets that grow are moved to the end of the pool with room to double,
+// leaving their old place unused
+void	Compact_Fluent_Set::set( unsigned f ) {
+	if ( m_dense_made ) m_dense.set( f );
+	if ( ( m_mask & mask_bit( f ) ) && std::binary_search( begin(), end(), f ) ) return;
+	Index_Vec& pool = *m_pool;
+	if ( m_size == m_capacity ) {
+		unsigned offset = pool.size();
+		m_capacity = std::max( 4u, 2 * m_capacity );
+		pool.resize( offset + m_capacity );
+		std::copy( pool.begin() + m_offset, pool.begin() + m_offset + m_size, pool.begin() + offset );
+		m_offset = offset;
+	}
+	Index_Vec::iterator b = pool.begin() + m_offset;
+	Index_Vec::iterator pos = std::upper_bound( b, b + m_size, f );
+	std::copy_backward( pos, b + m_size, b + m_size + 1 );
+	*pos = f;
+	m_size++;
+	m_mask |= mask_bit( f );
+}
+
+// Also makes the set larger when fluents are added to the task
+void	Compact_Fluent_Set::make_dense( unsigned num_fluents ) {
+	if ( !m_dense_made || m_dense.bits().max_index() < num_fluents + 1 )
+		m_dense.resize( num_fluents );
+	m_dense_made = true;
+	for ( const unsigned* f = begin(); f != end(); f++ )
+		m_dense.set( *f );
+}
+
+void	Compact_Fluent_Set::add_to( Bit_Set& s ) const {
+	for ( const unsigned* f = begin(); f != end(); f++ )
+		s.set( *f );
+}
+
+void	Compact_Fluent_Set::intersect( Bit_Set& s ) const {
+	for ( unsigned k = 0; k < s.bits().max_index(); k++ )
+		if ( s.isset( k ) && !isset( k ) )
+			s.unset( k );
+}
+
+}
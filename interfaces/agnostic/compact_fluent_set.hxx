@@ -0,0 +1,87 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __COMPACT_FLUENT_SET__
+#define __COMPACT_FLUENT_SET__
+
+#include <types.hxx>
+#include <algorithm>
+
+namespace aptk {
+
+// Fluents of a precondition or effect. They are kept sorted in a pool
+// shared by all of the actions of a task, behind a 64 bit mask where each
+// fluent sets one bit, so most fluents not in the set are ruled out
+// without looking into the pool. A dense Bit_Set is made on request, for
+// tasks small enough to afford one per action, see
+// STRIPS_Problem::make_action_tables().
+class Compact_Fluent_Set {
+public:
+	Compact_Fluent_Set( Index_Vec& pool );
+	~Compact_Fluent_Set();
+
+	void		assign( const Fluent_Vec& fluents );
+	void		set( unsigned f );
+	bool		isset( unsigned f ) const;
+
+	unsigned	size() const			{ return m_size; }
+	const unsigned*	begin() const			{ return m_pool->data() + m_offset; }
+	const unsigned*	end() const			{ return begin() + m_size; }
+
+	void		make_dense( unsigned num_fluents );
+	bool		is_dense() const		{ return m_dense_made; }
+
+	// Sets in s the fluents in the set, or unsets those not in it
+	void		add_to( Bit_Set& s ) const;
+	void		intersect( Bit_Set& s ) const;
+
+protected:
+
+	static unsigned long long	mask_bit( unsigned f ) {
+		return 1ULL << ( ( f * 2654435761u ) >> 26 );
+	}
+
+	Index_Vec*		m_pool;
+	unsigned		m_offset;
+	unsigned		m_size;
+	unsigned		m_capacity;
+	unsigned long long	m_mask;
+	bool			m_dense_made;
+	Bit_Set			m_dense;
+};
+
+inline bool	Compact_Fluent_Set::isset( unsigned f ) const {
+	if ( m_dense_made ) return m_dense.isset( f );
+	if ( !( m_mask & mask_bit( f ) ) ) return false;
+	const unsigned* b = begin();
+	const unsigned* e = b + m_size;
+	// Most sets are a handful of fluents
+	if ( m_size <= 8 ) {
+		for ( ; b != e; b++ )
+			if ( *b >= f ) return *b == f;
+		return false;
+	}
+	b = std::lower_bound( b, e, f );
+	return b != e && *b == f;
+}
+
+}
+
+#endif // compact_fluent_set.hxx
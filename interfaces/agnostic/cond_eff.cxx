@@ -24,10 +24,8 @@ namespace aptk
 {
 
 Conditional_Effect::Conditional_Effect( STRIPS_Problem& p )
+	: m_prec_set( p.fluent_pool() ), m_add_set( p.fluent_pool() ), m_del_set( p.fluent_pool() )
 {
-	prec_set().resize( p.num_fluents() );
-	add_set().resize( p.num_fluents() );
-	del_set().resize( p.num_fluents() );
 }
 
 Conditional_Effect::~Conditional_Effect()
@@ -43,13 +41,18 @@ void Conditional_Effect::define( Fluent_Vec& precs, Fluent_Vec& adds, Fluent_Vec
 }
 
 	
-void Conditional_Effect::define_fluent_list(  Fluent_Vec& in, Fluent_Vec& fluent_list, Fluent_Set& fluent_set )
+void Conditional_Effect::define_fluent_list(  Fluent_Vec& in, Fluent_Vec& fluent_list, Compact_Fluent_Set& fluent_set )
 {
 	for ( unsigned k = 0; k < in.size(); k++ )
-	{
 		fluent_list.push_back( in[k] );
-		fluent_set.set( in[k] );
-	}
+	fluent_set.assign( fluent_list );
+}
+
+void Conditional_Effect::make_dense_sets( unsigned num_fluents )
+{
+	prec_set().make_dense( num_fluents );
+	add_set().make_dense( num_fluents );
+	del_set().make_dense( num_fluents );
 }
 
 
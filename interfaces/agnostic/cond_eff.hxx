@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <types.hxx>
 #include <strips_prob.hxx>
 #include <strips_state.hxx>
+#include <compact_fluent_set.hxx>
 
 namespace aptk
 {
@@ -36,21 +37,22 @@ public:
 	~Conditional_Effect();
 
 	void		define( Fluent_Vec& precs, Fluent_Vec& adds, Fluent_Vec& dels );
-	void		define_fluent_list( Fluent_Vec& in, Fluent_Vec& list, Fluent_Set& set );
+	void		define_fluent_list( Fluent_Vec& in, Fluent_Vec& list, Compact_Fluent_Set& set );
+	void		make_dense_sets( unsigned num_fluents );
 
 	Fluent_Vec&	prec_vec() { return m_prec_vec; }
-	Fluent_Set&	prec_set() { return m_prec_set; }
+	Compact_Fluent_Set&	prec_set() { return m_prec_set; }
 	Fluent_Vec&	add_vec()  { return m_add_vec; }
-	Fluent_Set&	add_set()  { return m_add_set; }
+	Compact_Fluent_Set&	add_set()  { return m_add_set; }
 	Fluent_Vec&	del_vec()  { return m_del_vec; }
-	Fluent_Set&	del_set()  { return m_del_set; }
+	Compact_Fluent_Set&	del_set()  { return m_del_set; }
 
 	const Fluent_Vec&	prec_vec() const { return m_prec_vec; }
-	const Fluent_Set&	prec_set() const { return m_prec_set; }
+	const Compact_Fluent_Set&	prec_set() const { return m_prec_set; }
 	const Fluent_Vec&	add_vec()  const { return m_add_vec; }
-	const Fluent_Set&	add_set()  const { return m_add_set; }
+	const Compact_Fluent_Set&	add_set()  const { return m_add_set; }
 	const Fluent_Vec&	del_vec()  const { return m_del_vec; }
-	const Fluent_Set&	del_set()  const { return m_del_set; }
+	const Compact_Fluent_Set&	del_set()  const { return m_del_set; }
 
 	bool            requires( unsigned f ) const;
 	bool	        asserts( unsigned f ) const;
@@ -62,11 +64,11 @@ public:
 
 protected:
 	Fluent_Vec			m_prec_vec;
-	Fluent_Set			m_prec_set;
+	Compact_Fluent_Set		m_prec_set;
 	Fluent_Vec			m_add_vec;
-	Fluent_Set			m_add_set;
+	Compact_Fluent_Set		m_add_set;
 	Fluent_Vec			m_del_vec;
-	Fluent_Set			m_del_set;
+	Compact_Fluent_Set		m_del_set;
 
 };
 
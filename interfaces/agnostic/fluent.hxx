@@ -41,6 +41,9 @@ public:
 
 	void		set_index( unsigned idx );
 	void		set_signature( std::string signature );
+	// Signature as interned by the problem, see STRIPS_Problem::intern_signature()
+	void		set_signature( unsigned sig );
+	unsigned	signature_id() const			{ return m_signature; }
 
 	STRIPS_Problem& problem();
 
@@ -48,7 +51,7 @@ protected:
 
 	STRIPS_Problem&			m_problem;
 	unsigned			m_index;
-	std::string			m_signature;
+	unsigned			m_signature;
 };
 
 inline unsigned		Fluent::index() const
@@ -58,7 +61,8 @@ inline unsigned		Fluent::index() const
 
 inline	std::string	Fluent::signature() const
 {
-	return m_signature;
+	if ( m_signature == no_such_index ) return "(not-a-fluent)";
+	return m_problem.signature( m_signature );
 }
 
 inline void	Fluent::set_index( unsigned idx ) 
@@ -67,6 +71,11 @@ inline void	Fluent::set_index( unsigned idx )
 }
 
 inline void	Fluent::set_signature( std::string sig )
+{
+	m_signature = m_problem.intern_signature( sig );
+}
+
+inline void	Fluent::set_signature( unsigned sig )
 {
 	m_signature = sig;
 }
@@ -0,0 +1,141 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fluent_action_table.hxx>
+#include <algorithm>
+
+namespace aptk {
+
+Fluent_Action_Table::Fluent_Action_Table( unsigned width )
+	: m_width( width ), m_num_entries( 0 ) {
+}
+
+Fluent_Action_Table::~Fluent_Action_Table() {
+}
+
+void	Fluent_Action_Table::reset( unsigned num_fluents ) {
+	Row empty = { 0, 0 };
+	m_rows.assign( num_fluents, empty );
+	m_entries.clear();
+	m_capacity.clear();
+	m_num_entries = 0;
+}
+
+// Lists start empty where their entries will go, add() moves their end
+void	Fluent_Action_Table::start() {
+	unsigned offset = 0;
+	for ( unsigned f = 0; f < m_rows.size(); f++ ) {
+		unsigned n = m_rows[f].end;
+		m_rows[f].begin = m_rows[f].end = offset;
+		offset += n;
+	}
+	m_entries.resize( (size_t)m_width * offset );
+	m_num_entries = offset;
+}
+
+void	Fluent_Action_Table::assign( unsigned num_fluents, const std::vector< std::pair<unsigned, unsigned> >& pairs ) {
+	reset( num_fluents );
+	for ( unsigned k = 0; k < pairs.size(); k++ )
+		count( pairs[k].first );
+	start();
+	for ( unsigned k = 0; k < pairs.size(); k++ )
+		add( pairs[k].first, pairs[k].second );
+}
+
+bool	Fluent_Action_Table::before( const unsigned* x, const unsigned* y ) const {
+	if ( x[m_width-1] != y[m_width-1] ) return x[m_width-1] < y[m_width-1];
+	return x[0] < y[0];
+}
+
+void	Fluent_Action_Table::insert( unsigned f, const unsigned* entry ) {
+	track_capacity();
+	if ( size( f ) == m_capacity[f] )
+		grow( f );
+	unsigned* b = m_entries.data() + m_width * m_rows[f].begin;
+	unsigned* e = m_entries.data() + m_width * m_rows[f].end;
+	unsigned* pos = e;
+	while ( pos != b && before( entry, pos - m_width ) )
+		pos -= m_width;
+	std::copy_backward( pos, e, e + m_width );
+	std::copy( entry, entry + m_width, pos );
+	m_rows[f].end++;
+	m_num_entries++;
+}
+
+void	Fluent_Action_Table::erase( unsigned f, unsigned a ) {
+	track_capacity();
+	unsigned* b = m_entries.data() + m_width * m_rows[f].begin;
+	unsigned* e = m_entries.data() + m_width * m_rows[f].end;
+	unsigned* out = b;
+	for ( unsigned* in = b; in != e; in += m_width ) {
+		if ( in[m_width-1] == a ) continue;
+		if ( out != in ) std::copy( in, in + m_width, out );
+		out += m_width;
+	}
+	unsigned removed = ( e - out ) / m_width;
+	m_rows[f].end -= removed;
+	m_num_entries -= removed;
+}
+
+void	Fluent_Action_Table::add_fluent() {
+	unsigned end = m_entries.size() / m_width;
+	Row empty = { end, end };
+	m_rows.push_back( empty );
+	if ( !m_capacity.empty() ) m_capacity.push_back( 0 );
+}
+
+// Lists as made by start() have no room to spare
+void	Fluent_Action_Table::track_capacity() {
+	if ( !m_capacity.empty() || m_rows.empty() ) return;
+	m_capacity.resize( m_rows.size() );
+	for ( unsigned f = 0; f < m_rows.size(); f++ )
+		m_capacity[f] = m_rows[f].end - m_rows[f].begin;
+}
+
+void	Fluent_Action_Table::grow( unsigned f ) {
+	if ( unused() > m_num_entries )
+		compact();
+	unsigned n = size( f );
+	unsigned begin = m_entries.size() / m_width;
+	m_capacity[f] = std::max( 4u, 2 * n );
+	m_entries.resize( m_entries.size() + (size_t)m_width * m_capacity[f] );
+	std::copy( m_entries.begin() + (size_t)m_width * m_rows[f].begin,
+		m_entries.begin() + (size_t)m_width * m_rows[f].end,
+		m_entries.begin() + (size_t)m_width * begin );
+	m_rows[f].begin = begin;
+	m_rows[f].end = begin + n;
+}
+
+// Lays the lists out one after the other again
+void	Fluent_Action_Table::compact() {
+	std::vector<unsigned> entries;
+	entries.reserve( (size_t)m_width * m_num_entries );
+	for ( unsigned f = 0; f < m_rows.size(); f++ ) {
+		unsigned n = size( f );
+		unsigned begin = entries.size() / m_width;
+		entries.insert( entries.end(), row_begin( f ), row_end( f ) );
+		m_rows[f].begin = begin;
+		m_rows[f].end = begin + n;
+		m_capacity[f] = n;
+	}
+	m_entries.swap( entries );
+}
+
+}
@@ -0,0 +1,168 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __FLUENT_ACTION_TABLE__
+#define __FLUENT_ACTION_TABLE__
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+
+namespace aptk {
+
+class Action;
+
+// Lists of actions for each fluent, the actions adding it, requiring it,
+// ... kept in one array with the entries of all the lists, and the range
+// of each list in it. Entries are action indices, or pairs of words for
+// tables of wider entries, see STRIPS_Problem::ceffs_adding().
+//
+// Tables are filled as a counting sort: reset(), count() each entry,
+// start(), then add() the same entries, in the order wanted within each
+// list. This lays the lists one after the other, as in CSR form.
+//
+// Afterwards, insert() and erase() change single lists in place. A list
+// with no room left is moved to the end of the array with room to double,
+// and the array is compacted once more of it is left unused than used.
+class Fluent_Action_Table {
+public:
+	Fluent_Action_Table( unsigned width = 1 );
+	~Fluent_Action_Table();
+
+	void		reset( unsigned num_fluents );
+	void		count( unsigned f )		{ m_rows[f].end++; }
+	void		start();
+	void		add( unsigned f, unsigned w ) {
+		m_entries[ m_width * m_rows[f].end++ ] = w;
+	}
+	void		add( unsigned f, unsigned w0, unsigned w1 ) {
+		unsigned* e = &m_entries[ m_width * m_rows[f].end++ ];
+		e[0] = w0;
+		e[1] = w1;
+	}
+
+	// Makes the table from (fluent, action) pairs, keeping their order
+	// within each list
+	void		assign( unsigned num_fluents, const std::vector< std::pair<unsigned, unsigned> >& pairs );
+
+	// Entries are kept ordered by action, the last word of each entry,
+	// then by their first word
+	void		insert( unsigned f, const unsigned* entry );
+	// Takes out of the list of f the entries of the action a
+	void		erase( unsigned f, unsigned a );
+	void		add_fluent();
+
+	unsigned	num_fluents() const		{ return m_rows.size(); }
+	unsigned	size( unsigned f ) const	{ return m_rows[f].end - m_rows[f].begin; }
+	unsigned	num_entries() const		{ return m_num_entries; }
+	const unsigned*	row_begin( unsigned f ) const	{ return m_entries.data() + m_width * m_rows[f].begin; }
+	const unsigned*	row_end( unsigned f ) const	{ return m_entries.data() + m_width * m_rows[f].end; }
+	size_t		bytes() const {
+		return m_rows.capacity() * sizeof(Row) + ( m_entries.capacity() + m_capacity.capacity() ) * sizeof(unsigned);
+	}
+
+protected:
+
+	// In entries, not words
+	struct Row {
+		unsigned	begin;
+		unsigned	end;
+	};
+
+	bool		before( const unsigned* x, const unsigned* y ) const;
+	unsigned	unused() const			{ return m_entries.size() / m_width - m_num_entries; }
+	void		track_capacity();
+	void		grow( unsigned f );
+	void		compact();
+
+	unsigned		m_width;
+	std::vector<Row>	m_rows;
+	std::vector<unsigned>	m_entries;
+	unsigned		m_num_entries;
+	// Room of each list, only kept once lists are changed
+	std::vector<unsigned>	m_capacity;
+};
+
+// Read-only view of a list of a Fluent_Action_Table, giving the actions
+// themselves, so it can be used like the vector of actions it replaces
+class Action_Span {
+public:
+	class const_iterator {
+	public:
+		typedef	std::forward_iterator_tag	iterator_category;
+		typedef	const Action*			value_type;
+		typedef	std::ptrdiff_t			difference_type;
+		typedef	const Action* const*		pointer;
+		typedef	const Action*			reference;
+
+		const_iterator( const unsigned* p, const Action* const* actions ) : m_p( p ), m_actions( actions ) {}
+		const Action*		operator*() const	{ return m_actions[*m_p]; }
+		const_iterator&		operator++()		{ m_p++; return *this; }
+		bool			operator==( const const_iterator& o ) const	{ return m_p == o.m_p; }
+		bool			operator!=( const const_iterator& o ) const	{ return m_p != o.m_p; }
+	protected:
+		const unsigned*		m_p;
+		const Action* const*	m_actions;
+	};
+
+	Action_Span( const unsigned* b, const unsigned* e, const Action* const* actions )
+		: m_begin( b ), m_end( e ), m_actions( actions ) {}
+
+	unsigned	size() const				{ return m_end - m_begin; }
+	bool		empty() const				{ return m_begin == m_end; }
+	const Action*	operator[]( unsigned k ) const		{ return m_actions[ m_begin[k] ]; }
+	const_iterator	begin() const				{ return const_iterator( m_begin, m_actions ); }
+	const_iterator	end() const				{ return const_iterator( m_end, m_actions ); }
+
+	// Indices of the actions, for those who do not need the actions
+	unsigned	index( unsigned k ) const		{ return m_begin[k]; }
+	const unsigned*	index_begin() const			{ return m_begin; }
+	const unsigned*	index_end() const			{ return m_end; }
+
+protected:
+	const unsigned*		m_begin;
+	const unsigned*		m_end;
+	const Action* const*	m_actions;
+};
+
+// Same for lists of (conditional effect, action) pairs
+class Ceff_Span {
+public:
+	Ceff_Span( const unsigned* b, const unsigned* e, const Action* const* actions )
+		: m_begin( b ), m_end( e ), m_actions( actions ) {}
+
+	unsigned	size() const				{ return ( m_end - m_begin ) / 2; }
+	bool		empty() const				{ return m_begin == m_end; }
+	std::pair< unsigned, const Action* >
+			operator[]( unsigned k ) const {
+		return std::make_pair( m_begin[2*k], m_actions[ m_begin[2*k+1] ] );
+	}
+	unsigned	index( unsigned k ) const		{ return m_begin[2*k+1]; }
+
+protected:
+	const unsigned*		m_begin;
+	const unsigned*		m_end;
+	const Action* const*	m_actions;
+};
+
+}
+
+#endif // fluent_action_table.hxx
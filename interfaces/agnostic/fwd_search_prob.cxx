@@ -70,10 +70,11 @@ bool	Fwd_Search_Problem::lazy_goal( const State& s, Action_Idx a  ) const {
 bool	Fwd_Search_Problem::is_applicable( const State& s, Action_Idx a ) const {
 
 	const Action& act = *(task().actions().at(a));
-	return act.can_be_applied_on(s);
+	return task().is_enabled( a ) && act.can_be_applied_on(s);
 }
 
 void	Fwd_Search_Problem::applicable_set( const State& s, std::vector<Action_Idx>& app_set ) const {
+	APTK_PHASE( SUCCESSORS );
 	m_task->applicable_actions( s, app_set ); 
 }
 
@@ -83,6 +84,7 @@ float	Fwd_Search_Problem::cost( const State& s, Action_Idx a ) const {
 }
 
 State*	Fwd_Search_Problem::next( const State& s, Action_Idx a ) const {
+	APTK_PHASE( PROGRESSION );
 	const Action& act = *(task().actions().at(a));
 	State* succ = s.progress_through( act );
 	succ->update_hash();
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/search_prob.hxx>
 #include <strips_state.hxx>
 #include <action.hxx>
+#include <aptk/probes.hxx>
 
 namespace aptk {
 
@@ -63,11 +64,13 @@ public:
 		}
 
 		int	start( const State& s ) {
+			APTK_PHASE( SUCCESSORS );
 			m_it_impl = new Successor_Generator::Iterator( s, m_problem.successor_generator().nodes() );
 			return m_it_impl->first();
 		}
 	
 		int	next() {
+			APTK_PHASE( SUCCESSORS );
 			return m_it_impl->next();
 		}	
 	
@@ -96,6 +96,7 @@ public:
 
 
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 
 		m_already_updated.reset();
 		m_updated.clear();
@@ -114,6 +115,7 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		eval( s, h_val );
 	}
 
@@ -196,6 +198,7 @@ protected:
 			//while ( i != -1 ) {
 			for ( unsigned i = 0; i < m_strips_model.num_actions(); i++ ) {
 				const Action& a = *(m_strips_model.actions()[i]);
+				if ( !m_strips_model.is_enabled( i ) ) continue;
 
 				//std::cout << "Action considered: " << a.signature() << std::endl;
 				bool relevant =  a.prec_set().isset(p);
@@ -291,7 +294,7 @@ protected:
 				const Action& a = *(m_strips_model.actions()[i]);
 				
 				//if( ! m_allowed_actions[ i ] )
-				if(! *it_allowed )
+				if(! *it_allowed || !m_strips_model.is_enabled( i ) )
 					continue;
 
 				//std::cout << "Action considered: " << a.signature() << std::endl;
@@ -67,12 +67,14 @@ public:
 	}
 
 	virtual	void	eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 		initialize( s );
 		compute();
 		h_val = eval( m_strips_model.goal() ); 
 	}
 
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		eval( s, h_val );
 	}
 
@@ -149,6 +151,7 @@ public:
 		initialize( prob.init() );
 		compute_mutexes_only();
 
+		std::vector< std::pair<unsigned, unsigned> > edeleting;
 
 		for ( unsigned p = 0 ; p < prob.num_fluents(); p++ ){
 			for ( unsigned a = 0; a < prob.num_actions(); a++ ){
@@ -161,7 +164,7 @@ public:
 						is_edelete = true;
 						action.edel_vec().push_back( p );					
 						action.edel_set().set( p );
-						prob.actions_edeleting( p ).push_back( (const Action*) &action );
+						edeleting.push_back( std::make_pair( p, action.index() ) );
 						break;
 					}
 				}
@@ -173,7 +176,7 @@ public:
 					if ( !action.add_set().isset(p) && value( p, r ) == infty ){
 						action.edel_vec().push_back( p );
 						action.edel_set().set( p );
-						prob.actions_edeleting( p ).push_back( (const Action*) &action );
+						edeleting.push_back( std::make_pair( p, action.index() ) );
 						break;
 					}
 				}
@@ -181,11 +184,12 @@ public:
 				if ( !action.edel_set().isset(p) && action.del_set().isset(p) ){
 					action.edel_vec().push_back( p );
 					action.edel_set().set( p );
-					prob.actions_edeleting( p ).push_back( (const Action*) &action );
+					edeleting.push_back( std::make_pair( p, action.index() ) );
 				}
 
 			}
 		}
+		prob.set_actions_edeleting( edeleting );
 		
 #ifdef DEBUG
 		print_values(std::cout);
@@ -236,6 +240,7 @@ protected:
 			fixed_point = true;
 
 			for ( unsigned a = 0; a < m_strips_model.num_actions(); a++ ) {
+				if ( !m_strips_model.is_enabled( a ) ) continue;
 				const Action& action = *(m_strips_model.actions()[a]);
 				op_value(a) = eval( action.prec_vec() );
 				if ( op_value(a) == infty ) continue;
@@ -288,6 +293,7 @@ protected:
 			fixed_point = true;
 
 			for ( unsigned a = 0; a < m_strips_model.num_actions(); a++ ) {
+				if ( !m_strips_model.is_enabled( a ) ) continue;
 				const Action& action = *(m_strips_model.actions()[a]);
 				op_value(a) = eval( action.prec_vec() );
 				if ( op_value(a) == infty ) continue;
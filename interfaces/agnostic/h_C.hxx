@@ -72,6 +72,7 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 
 		m_already_updated.reset();
 		m_updated.clear();
@@ -91,6 +92,7 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		eval( s, h_val );
 	}
 
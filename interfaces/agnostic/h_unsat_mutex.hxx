@@ -49,10 +49,12 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 		h_val = count_mutexes(s) + count_goals(s);
 	}
 	
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		h_val = count_mutexes(s) + count_goals(s);
 	}
 
@@ -0,0 +1,264 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <lifted_task.hxx>
+#include <iostream>
+#include <stdexcept>
+
+namespace aptk {
+
+namespace agnostic {
+
+const unsigned	Lifted_Task::equality;
+
+Lifted_Task::Lifted_Task( std::string domain_name, std::string problem_name )
+	: m_domain_name( domain_name ), m_problem_name( problem_name ), m_has_costs( false ) {
+	add_predicate( "=", 2 );
+}
+
+Lifted_Task::~Lifted_Task() {
+}
+
+unsigned	Lifted_Task::intern( std::map< std::string, unsigned >& table, std::vector<std::string>& names, std::string name ) {
+	std::map< std::string, unsigned >::iterator it = table.find( name );
+	if ( it != table.end() ) return it->second;
+	unsigned idx = names.size();
+	names.push_back( name );
+	table.insert( std::make_pair( name, idx ) );
+	return idx;
+}
+
+unsigned	Lifted_Task::find( const std::map< std::string, unsigned >& table, std::string name ) const {
+	std::map< std::string, unsigned >::const_iterator it = table.find( name );
+	return it == table.end() ? no_such_index : it->second;
+}
+
+unsigned	Lifted_Task::add_type( std::string name ) {
+	unsigned t = intern( m_types, m_type_names, name );
+	if ( t == m_type_objects.size() ) {
+		m_type_objects.resize( t + 1 );
+		m_type_members.push_back( std::vector<bool>( m_object_names.size(), false ) );
+	}
+	return t;
+}
+
+unsigned	Lifted_Task::add_object( std::string name ) {
+	unsigned o = intern( m_objects, m_object_names, name );
+	if ( o + 1 == m_object_names.size() )
+		for ( unsigned t = 0; t < m_type_members.size(); t++ )
+			m_type_members[t].push_back( false );
+	return o;
+}
+
+unsigned	Lifted_Task::add_predicate( std::string name, unsigned arity ) {
+	unsigned p = intern( m_predicates, m_predicate_names, name );
+	if ( p == m_arities.size() ) {
+		m_arities.push_back( arity );
+		m_changed.push_back( false );
+	}
+	return p;
+}
+
+void	Lifted_Task::add_to_type( unsigned object, unsigned type ) {
+	if ( m_type_members[type][object] ) return;
+	m_type_members[type][object] = true;
+	m_type_objects[type].push_back( object );
+}
+
+unsigned	Lifted_Task::add_schema( const Schema& s ) {
+	m_schemas.push_back( s );
+	for ( unsigned k = 0; k < s.add.size(); k++ )
+		m_changed[ s.add[k].predicate ] = true;
+	for ( unsigned k = 0; k < s.del.size(); k++ )
+		m_changed[ s.del[k].predicate ] = true;
+	for ( unsigned i = 0; i < s.ceffs.size(); i++ ) {
+		for ( unsigned k = 0; k < s.ceffs[i].add.size(); k++ )
+			m_changed[ s.ceffs[i].add[k].predicate ] = true;
+		for ( unsigned k = 0; k < s.ceffs[i].del.size(); k++ )
+			m_changed[ s.ceffs[i].del[k].predicate ] = true;
+	}
+	return m_schemas.size() - 1;
+}
+
+unsigned	Lifted_Task::add_function( std::string name, unsigned arity ) {
+	unsigned f = intern( m_functions, m_function_names, name );
+	if ( f == m_function_arities.size() )
+		m_function_arities.push_back( arity );
+	return f;
+}
+
+void	Lifted_Task::set_value( unsigned function, const std::vector<int>& args, float v ) {
+	std::vector<int> key( 1, function );
+	key.insert( key.end(), args.begin(), args.end() );
+	m_values[key] = v;
+}
+
+float	Lifted_Task::value( unsigned function, const std::vector<int>& args ) const {
+	std::vector<int> key( 1, function );
+	key.insert( key.end(), args.begin(), args.end() );
+	std::map< std::vector<int>, float >::const_iterator it = m_values.find( key );
+	return it == m_values.end() ? 0.0f : it->second;
+}
+
+unsigned	Lifted_Task::find_type( std::string name ) const {
+	return find( m_types, name );
+}
+
+unsigned	Lifted_Task::find_object( std::string name ) const {
+	return find( m_objects, name );
+}
+
+unsigned	Lifted_Task::find_predicate( std::string name ) const {
+	return find( m_predicates, name );
+}
+
+unsigned	Lifted_Task::find_function( std::string name ) const {
+	return find( m_functions, name );
+}
+
+bool	Lifted_Task::is_of_type( unsigned o, unsigned t ) const {
+	return m_type_members[t][o];
+}
+
+void	Lifted_Task::check_atoms( const std::vector<Atom>& atoms, const Schema& s, unsigned num_params, bool effects ) const {
+	for ( unsigned k = 0; k < atoms.size(); k++ ) {
+		const Atom& a = atoms[k];
+		if ( a.args.size() != m_arities[a.predicate] )
+			throw std::runtime_error( "Lifted_Task: wrong number of arguments for " + m_predicate_names[a.predicate] + " in " + s.name );
+		for ( unsigned j = 0; j < a.args.size(); j++ )
+			if ( is_param( a.args[j] ) ? param_index( a.args[j] ) >= num_params : (unsigned)a.args[j] >= m_object_names.size() )
+				throw std::runtime_error( "Lifted_Task: bad argument of " + m_predicate_names[a.predicate] + " in " + s.name );
+		if ( effects && ( a.negated || a.predicate == equality ) )
+			throw std::runtime_error( "Lifted_Task: bad effect on " + m_predicate_names[a.predicate] + " in " + s.name );
+		if ( !effects && a.negated && a.predicate != equality && !is_static( a.predicate ) )
+			throw std::runtime_error( "Lifted_Task: negative precondition on fluent " + m_predicate_names[a.predicate] + " in " + s.name );
+	}
+}
+
+void	Lifted_Task::validate() const {
+	for ( unsigned i = 0; i < m_schemas.size(); i++ ) {
+		const Schema& s = m_schemas[i];
+		unsigned n = s.param_names.size();
+		if ( s.param_types.size() != n )
+			throw std::runtime_error( "Lifted_Task: parameters of " + s.name + " without types" );
+		check_atoms( s.pre, s, n, false );
+		check_atoms( s.add, s, n, true );
+		check_atoms( s.del, s, n, true );
+		for ( unsigned c = 0; c < s.ceffs.size(); c++ ) {
+			const Cond_Effect& ce = s.ceffs[c];
+			if ( ce.param_types.size() != ce.param_names.size() )
+				throw std::runtime_error( "Lifted_Task: variables of an effect of " + s.name + " without types" );
+			unsigned m = n + ce.param_names.size();
+			check_atoms( ce.pre, s, m, false );
+			check_atoms( ce.add, s, m, true );
+			check_atoms( ce.del, s, m, true );
+		}
+		if ( !s.has_cost_term ) continue;
+		const Atom& t = s.cost_term;
+		if ( t.predicate >= m_function_names.size() || t.args.size() != m_function_arities[t.predicate] )
+			throw std::runtime_error( "Lifted_Task: bad cost of " + s.name );
+		for ( unsigned j = 0; j < t.args.size(); j++ )
+			if ( is_param( t.args[j] ) ? param_index( t.args[j] ) >= n : (unsigned)t.args[j] >= m_object_names.size() )
+				throw std::runtime_error( "Lifted_Task: bad cost of " + s.name );
+	}
+	const std::vector<Atom>* lists[] = { &m_init, &m_goal };
+	for ( unsigned l = 0; l < 2; l++ )
+		for ( unsigned k = 0; k < lists[l]->size(); k++ ) {
+			const Atom& a = (*lists[l])[k];
+			if ( a.negated || a.predicate == equality || a.args.size() != m_arities[a.predicate] )
+				throw std::runtime_error( "Lifted_Task: bad atom " + m_predicate_names[a.predicate] + ( l == 0 ? " in init" : " in goal" ) );
+			for ( unsigned j = 0; j < a.args.size(); j++ )
+				if ( is_param( a.args[j] ) || (unsigned)a.args[j] >= m_object_names.size() )
+					throw std::runtime_error( "Lifted_Task: atom " + m_predicate_names[a.predicate] + " is not ground" );
+		}
+}
+
+void	Lifted_Task::print_atom( std::ostream& os, const Atom& a, const Schema* s, const Cond_Effect* ce ) const {
+	if ( a.negated ) os << "(not ";
+	os << "(" << m_predicate_names[a.predicate];
+	for ( unsigned j = 0; j < a.args.size(); j++ ) {
+		os << " ";
+		unsigned i = is_param( a.args[j] ) ? param_index( a.args[j] ) : 0;
+		if ( is_param( a.args[j] ) && s && i < s->param_names.size() )
+			os << s->param_names[i];
+		else if ( is_param( a.args[j] ) && s && ce )
+			os << ce->param_names[ i - s->param_names.size() ];
+		else if ( is_param( a.args[j] ) )
+			os << "?x" << param_index( a.args[j] );
+		else
+			os << m_object_names[ a.args[j] ];
+	}
+	os << ")";
+	if ( a.negated ) os << ")";
+}
+
+void	Lifted_Task::print( std::ostream& os ) const {
+	os << "Domain: " << m_domain_name << std::endl;
+	os << "Problem: " << m_problem_name << std::endl;
+	for ( unsigned t = 0; t < m_type_names.size(); t++ )
+		os << "Type " << m_type_names[t] << ": " << m_type_objects[t].size() << " objects" << std::endl;
+	for ( unsigned p = 1; p < m_predicate_names.size(); p++ )
+		os << "Predicate " << m_predicate_names[p] << "/" << m_arities[p] << ( is_static( p ) ? " (static)" : "" ) << std::endl;
+	for ( unsigned i = 0; i < m_schemas.size(); i++ ) {
+		const Schema& s = m_schemas[i];
+		os << "Schema " << s.name << "(";
+		for ( unsigned j = 0; j < s.param_names.size(); j++ )
+			os << ( j > 0 ? " " : "" ) << s.param_names[j] << " - " << m_type_names[ s.param_types[j] ];
+		os << ")" << std::endl;
+		const std::vector<Atom>* lists[] = { &s.pre, &s.add, &s.del };
+		const char* labels[] = { "\tPre:", "\tAdd:", "\tDel:" };
+		for ( unsigned l = 0; l < 3; l++ ) {
+			os << labels[l];
+			for ( unsigned k = 0; k < lists[l]->size(); k++ ) {
+				os << " ";
+				print_atom( os, (*lists[l])[k], &s );
+			}
+			os << std::endl;
+		}
+		for ( unsigned c = 0; c < s.ceffs.size(); c++ ) {
+			const Cond_Effect& ce = s.ceffs[c];
+			os << "\tWhen";
+			for ( unsigned j = 0; j < ce.param_names.size(); j++ )
+				os << " " << ce.param_names[j] << " - " << m_type_names[ ce.param_types[j] ];
+			os << ":";
+			const std::vector<Atom>* parts[] = { &ce.pre, &ce.add, &ce.del };
+			const char* names[] = { "", " =>", " not" };
+			for ( unsigned l = 0; l < 3; l++ ) {
+				os << names[l];
+				for ( unsigned k = 0; k < parts[l]->size(); k++ ) {
+					os << " ";
+					print_atom( os, (*parts[l])[k], &s, &ce );
+				}
+			}
+			os << std::endl;
+		}
+		if ( m_has_costs ) {
+			os << "\tCost: " << s.cost;
+			if ( s.has_cost_term )
+				os << " + (" << m_function_names[ s.cost_term.predicate ] << " ...)";
+			os << std::endl;
+		}
+	}
+	os << "Init: " << m_init.size() << " atoms, Goal: " << m_goal.size() << " atoms" << std::endl;
+}
+
+}
+
+}
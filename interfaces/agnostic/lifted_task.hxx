@@ -0,0 +1,189 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __LIFTED_TASK__
+#define __LIFTED_TASK__
+
+#include <types.hxx>
+#include <string>
+#include <vector>
+#include <map>
+#include <iosfwd>
+
+namespace aptk {
+
+namespace agnostic {
+
+// A planning task before grounding: typed objects, predicates, the
+// initial state and goal as ground atoms, and action schemas with
+// conjunctive preconditions, effects and conditional effects.
+//
+// Arguments of the atoms in a schema are either objects (>= 0) or
+// parameters of the schema, encoded as negative numbers by param().
+// Types are plain sets of objects, so an object belongs to its declared
+// type and to all the supertypes of it.
+//
+// Action costs follow the usual (increase (total-cost) ...) effects: a
+// constant, plus optionally the value of a function term given in the
+// initial state. Tasks without them have unit costs.
+class Lifted_Task {
+public:
+
+	// Predicate 0 is always equality
+	static const unsigned	equality = 0;
+
+	struct Atom {
+		Atom() : predicate( 0 ), negated( false ) {}
+
+		unsigned		predicate;
+		std::vector<int>	args;
+		bool			negated;
+	};
+
+	// The variables of a forall around the effect are numbered after
+	// the parameters of the schema
+	struct Cond_Effect {
+		std::vector<std::string>	param_names;
+		std::vector<unsigned>		param_types;
+		std::vector<Atom>		pre;
+		std::vector<Atom>		add;
+		std::vector<Atom>		del;
+	};
+
+	struct Schema {
+		Schema() : cost( 0.0f ), has_cost_term( false ) {}
+
+		std::string			name;
+		std::vector<std::string>	param_names;
+		std::vector<unsigned>		param_types;
+		std::vector<Atom>		pre;
+		std::vector<Atom>		add;
+		std::vector<Atom>		del;
+		std::vector<Cond_Effect>	ceffs;
+		float				cost;
+		// The predicate of cost_term is a function
+		bool				has_cost_term;
+		Atom				cost_term;
+	};
+
+	static int	param( unsigned i )	{ return -(int)i - 1; }
+	static bool	is_param( int arg )	{ return arg < 0; }
+	static unsigned	param_index( int arg )	{ return (unsigned)( -arg - 1 ); }
+
+	Lifted_Task( std::string domain_name = "Unnamed", std::string problem_name = "Unnamed" );
+	~Lifted_Task();
+
+	void		set_domain_name( std::string name )	{ m_domain_name = name; }
+	void		set_problem_name( std::string name )	{ m_problem_name = name; }
+	std::string	domain_name() const			{ return m_domain_name; }
+	std::string	problem_name() const			{ return m_problem_name; }
+
+	// The add_ methods return the index of the existing element when
+	// there is one with the same name already
+	unsigned	add_type( std::string name );
+	unsigned	add_object( std::string name );
+	unsigned	add_predicate( std::string name, unsigned arity );
+	void		add_to_type( unsigned object, unsigned type );
+	unsigned	add_schema( const Schema& s );
+	void		add_init( const Atom& a )		{ m_init.push_back( a ); }
+	void		add_goal( const Atom& a )		{ m_goal.push_back( a ); }
+	unsigned	add_function( std::string name, unsigned arity );
+	void		set_value( unsigned function, const std::vector<int>& args, float v );
+	void		set_has_costs( bool v )			{ m_has_costs = v; }
+
+	// no_such_index when there is no such name
+	unsigned	find_type( std::string name ) const;
+	unsigned	find_object( std::string name ) const;
+	unsigned	find_predicate( std::string name ) const;
+	unsigned	find_function( std::string name ) const;
+
+	unsigned	num_types() const			{ return m_type_names.size(); }
+	unsigned	num_objects() const			{ return m_object_names.size(); }
+	unsigned	num_predicates() const			{ return m_predicate_names.size(); }
+	unsigned	num_functions() const			{ return m_function_names.size(); }
+
+	const std::string&	type_name( unsigned t ) const		{ return m_type_names[t]; }
+	const std::string&	object_name( unsigned o ) const		{ return m_object_names[o]; }
+	const std::string&	predicate_name( unsigned p ) const	{ return m_predicate_names[p]; }
+	unsigned		arity( unsigned p ) const		{ return m_arities[p]; }
+	const std::string&	function_name( unsigned f ) const	{ return m_function_names[f]; }
+	unsigned		function_arity( unsigned f ) const	{ return m_function_arities[f]; }
+	const std::vector<unsigned>&	objects_of( unsigned t ) const	{ return m_type_objects[t]; }
+	bool			is_of_type( unsigned o, unsigned t ) const;
+
+	const std::vector<Schema>&	schemas() const		{ return m_schemas; }
+	const std::vector<Atom>&	init() const		{ return m_init; }
+	const std::vector<Atom>&	goal() const		{ return m_goal; }
+
+	// Value given in the initial state, 0 if there is none
+	float		value( unsigned function, const std::vector<int>& args ) const;
+	bool		has_costs() const			{ return m_has_costs; }
+
+	// Predicates no schema adds or deletes
+	bool		is_static( unsigned p ) const		{ return !m_changed[p]; }
+
+	// Checks the conditions the grounder relies on, throws
+	// std::runtime_error if they do not hold
+	void		validate() const;
+
+	void		print( std::ostream& os ) const;
+	void		print_atom( std::ostream& os, const Atom& a, const Schema* s = NULL, const Cond_Effect* ce = NULL ) const;
+
+protected:
+
+	void		check_atoms( const std::vector<Atom>& atoms, const Schema& s, unsigned num_params, bool effects ) const;
+
+	unsigned	intern( std::map< std::string, unsigned >& table, std::vector<std::string>& names, std::string name );
+	unsigned	find( const std::map< std::string, unsigned >& table, std::string name ) const;
+
+protected:
+
+	std::string				m_domain_name;
+	std::string				m_problem_name;
+
+	std::vector<std::string>		m_type_names;
+	std::map< std::string, unsigned >	m_types;
+	std::vector< std::vector<unsigned> >	m_type_objects;
+	std::vector< std::vector<bool> >	m_type_members;
+
+	std::vector<std::string>		m_object_names;
+	std::map< std::string, unsigned >	m_objects;
+
+	std::vector<std::string>		m_predicate_names;
+	std::map< std::string, unsigned >	m_predicates;
+	std::vector<unsigned>			m_arities;
+	std::vector<bool>			m_changed;
+
+	std::vector<std::string>		m_function_names;
+	std::map< std::string, unsigned >	m_functions;
+	std::vector<unsigned>			m_function_arities;
+	std::map< std::vector<int>, float >	m_values;
+	bool					m_has_costs;
+
+	std::vector<Schema>			m_schemas;
+	std::vector<Atom>			m_init;
+	std::vector<Atom>			m_goal;
+};
+
+}
+
+}
+
+#endif // lifted_task.hxx
@@ -0,0 +1,119 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <mapped_search_prob.hxx>
+#include <algorithm>
+#include <iostream>
+
+namespace aptk {
+
+namespace agnostic {
+
+Mapped_Search_Problem::Mapped_Search_Problem( const Mapped_Task& task )
+	: m_task( task ), m_skeleton( task.domain_name(), task.problem_name() ) {
+	for ( unsigned f = 0; f < task.num_fluents(); f++ )
+		STRIPS_Problem::add_fluent( m_skeleton, task.fluent_signature( f ) );
+	Fluent_Vec init( task.init().begin(), task.init().end() );
+	Fluent_Vec goal( task.goal().begin(), task.goal().end() );
+	STRIPS_Problem::set_init( m_skeleton, init );
+	STRIPS_Problem::set_goal( m_skeleton, goal );
+}
+
+Mapped_Search_Problem::~Mapped_Search_Problem() {
+}
+
+int	Mapped_Search_Problem::num_actions() const {
+	return m_task.num_actions();
+}
+
+State*	Mapped_Search_Problem::init() const {
+	State* s0 = new State( m_skeleton );
+	Mapped_Task::Span fv = m_task.init();
+	for ( unsigned i = 0; i < fv.size(); i++ )
+		s0->set( fv[i] );
+	std::sort( s0->fluent_vec().begin(), s0->fluent_vec().end() );
+	s0->update_hash();
+	return s0;
+}
+
+bool	Mapped_Search_Problem::goal( const State& s ) const {
+	return entails( s, m_task.goal() );
+}
+
+bool	Mapped_Search_Problem::is_applicable( const State& s, Action_Idx a ) const {
+	return entails( s, m_task.pre( a ) );
+}
+
+void	Mapped_Search_Problem::applicable_set( const State& s, std::vector<Action_Idx>& app_set ) const {
+	Action_Iterator it( *this );
+	for ( int a = it.start( s ); a != no_op; a = it.next() )
+		app_set.push_back( a );
+}
+
+float	Mapped_Search_Problem::cost( const State& s, Action_Idx a ) const {
+	return m_task.action_cost( a );
+}
+
+// Same as State::progress_through(), but on the mapped tables
+State*	Mapped_Search_Problem::next( const State& s, Action_Idx a ) const {
+	State* succ = new State( m_skeleton );
+	const Fluent_Vec& fv = s.fluent_vec();
+	succ->fluent_vec().reserve( fv.size() );
+
+	Mapped_Task::Span del = m_task.del( a );
+	unsigned first = m_task.first_ceff( a );
+	unsigned last = m_task.first_ceff( a + 1 );
+
+	for ( unsigned k = 0; k < fv.size(); k++ ) {
+		if ( del.contains( fv[k] ) ) continue;
+		bool retracts = false;
+		for ( unsigned c = first; c < last && !retracts; c++ )
+			retracts = m_task.ceff_del( c ).contains( fv[k] ) && entails( s, m_task.ceff_pre( c ) );
+		if ( retracts ) continue;
+		succ->set( fv[k] );
+	}
+
+	Mapped_Task::Span add = m_task.add( a );
+	for ( unsigned k = 0; k < add.size(); k++ )
+		succ->set( add[k] );
+
+	for ( unsigned c = first; c < last; c++ ) {
+		if ( !entails( s, m_task.ceff_pre( c ) ) ) continue;
+		Mapped_Task::Span cadd = m_task.ceff_add( c );
+		for ( unsigned k = 0; k < cadd.size(); k++ )
+			succ->set( cadd[k] );
+	}
+
+	succ->update_hash();
+	return succ;
+}
+
+void	Mapped_Search_Problem::print( std::ostream& os ) const {
+	os << "# Fluents: " << m_task.num_fluents() << std::endl;
+	for ( unsigned f = 0; f < m_task.num_fluents(); f++ )
+		os << f+1 << ". " << m_task.fluent_signature( f ) << std::endl;
+	os << "# Actions: " << m_task.num_actions() << std::endl;
+	for ( unsigned a = 0; a < m_task.num_actions(); a++ )
+		os << "Action " << m_task.action_signature( a ) << std::endl;
+}
+
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MAPPED_SEARCH_PROB__
+#define __MAPPED_SEARCH_PROB__
+
+#include <mapped_task.hxx>
+#include <strips_prob.hxx>
+#include <strips_state.hxx>
+#include <aptk/search_prob.hxx>
+#include <vector>
+
+namespace aptk {
+
+namespace agnostic {
+
+// Forward search over a task loaded from a .aptk file, with the same
+// successor ordering as Fwd_Search_Problem on the task it was exported
+// from. States still refer to a STRIPS_Problem, so a skeleton holding
+// only the fluents, init and goal is built, without any actions.
+class Mapped_Search_Problem : public Search_Problem<State> {
+public:
+
+	Mapped_Search_Problem( const Mapped_Task& task );
+	virtual ~Mapped_Search_Problem();
+
+	virtual	int		num_actions() const;
+	virtual State*		init() const;
+	virtual bool		goal( const State& s ) const;
+	virtual bool		is_applicable( const State& s, Action_Idx a ) const;
+	virtual void		applicable_set( const State& s, std::vector<Action_Idx>& app_set ) const;
+	virtual float		cost( const State& s, Action_Idx a ) const;
+	virtual State*		next( const State& s, Action_Idx a ) const;
+	virtual void		print( std::ostream& os ) const;
+
+	const Mapped_Task&	task() const		{ return m_task; }
+	const STRIPS_Problem&	skeleton() const	{ return m_skeleton; }
+
+	// Walks the flattened successor generator depth first, visiting the
+	// nodes in the same order as Successor_Generator::Iterator does
+	class Action_Iterator {
+	public:
+		Action_Iterator( const Mapped_Search_Problem& p )
+		: m_task( p.task() ), m_state( NULL ) {
+		}
+
+		int	start( const State& s ) {
+			m_state = &s;
+			m_open.clear();
+			m_actions = Mapped_Task::Span();
+			m_index = 0;
+			if ( m_task.num_sg_nodes() == 0 ) return no_op;
+			m_open.push_back( 0 );
+			return advance();
+		}
+
+		int	next() {
+			if ( m_index < m_actions.size() )
+				return m_actions[m_index++];
+			return advance();
+		}
+
+	protected:
+
+		int	advance() {
+			while ( !m_open.empty() ) {
+				unsigned k = m_open.back();
+				m_open.pop_back();
+				const Mapped_Task::SG_Node& n = m_task.sg_node( k );
+				if ( n.selection_fluent == no_such_index ) {
+					m_actions = m_task.sg_actions( k );
+					if ( m_actions.empty() ) continue;
+					m_index = 0;
+					return m_actions[m_index++];
+				}
+				if ( n.dont_care_child != no_such_index )
+					m_open.push_back( n.dont_care_child );
+				if ( n.true_child != no_such_index && m_state->entails( n.selection_fluent ) )
+					m_open.push_back( n.true_child );
+			}
+			return no_op;
+		}
+
+		const Mapped_Task&	m_task;
+		const State*		m_state;
+		std::vector<unsigned>	m_open;
+		Mapped_Task::Span	m_actions;
+		unsigned		m_index;
+	};
+
+protected:
+
+	bool			entails( const State& s, const Mapped_Task::Span& fv ) const {
+		for ( unsigned k = 0; k < fv.size(); k++ )
+			if ( !s.entails( fv[k] ) ) return false;
+		return true;
+	}
+
+protected:
+
+	const Mapped_Task&	m_task;
+	STRIPS_Problem		m_skeleton;
+};
+
+}
+
+}
+
+#endif // mapped_search_prob.hxx
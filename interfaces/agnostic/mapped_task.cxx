@@ -0,0 +1,323 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <mapped_task.hxx>
+#include <action.hxx>
+#include <fluent.hxx>
+#include <cond_eff.hxx>
+#include <succ_gen.hxx>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace aptk {
+
+namespace agnostic {
+
+const Mapped_Task::Word	Mapped_Task::magic;
+const Mapped_Task::Word	Mapped_Task::version;
+
+static const uint32_t	byte_order_mark = 0x01020304;
+
+// Sections being put together by the exporter
+class Task_Image {
+public:
+	typedef	Mapped_Task::Word	Word;
+
+	Task_Image() : m_sections( Mapped_Task::NUM_SECTIONS ) {
+	}
+
+	std::vector<Word>&	section( unsigned s )	{ return m_sections[s]; }
+
+	Word	add_string( const std::string& s ) {
+		Word offset = m_strings.size();
+		m_strings.insert( m_strings.end(), s.begin(), s.end() );
+		m_strings.push_back( '\0' );
+		return offset;
+	}
+
+	template <typename Sequence>
+	void	add_row( unsigned offsets, unsigned data, const Sequence& row ) {
+		if ( m_sections[offsets].empty() ) m_sections[offsets].push_back( 0 );
+		for ( typename Sequence::const_iterator it = row.begin(); it != row.end(); it++ )
+			m_sections[data].push_back( *it );
+		m_sections[offsets].push_back( m_sections[data].size() );
+	}
+
+	// Vectors of actions or Action_Spans
+	template <typename Actions>
+	void	add_action_row( unsigned offsets, unsigned data, const Actions& row ) {
+		std::vector<Word> indices;
+		for ( unsigned k = 0; k < row.size(); k++ )
+			indices.push_back( row[k]->index() );
+		add_row( offsets, data, indices );
+	}
+
+	// Tables of empty problems still need their leading offset
+	void	close_rows( unsigned offsets ) {
+		if ( m_sections[offsets].empty() ) m_sections[offsets].push_back( 0 );
+	}
+
+	void	write( Mapped_Task::Header& h, std::string filename ) {
+		std::vector<Word>& str = m_sections[ Mapped_Task::STRINGS ];
+		m_strings.resize( ( m_strings.size() + 3 ) & ~(size_t)3, '\0' );
+		str.resize( m_strings.size() / sizeof(Word) );
+		if ( !m_strings.empty() )
+			std::memcpy( &str[0], &m_strings[0], m_strings.size() );
+
+		std::vector< Mapped_Task::Section_Entry > table( Mapped_Task::NUM_SECTIONS );
+		uint64_t offset = sizeof( Mapped_Task::Header ) + table.size() * sizeof( Mapped_Task::Section_Entry );
+		for ( unsigned s = 0; s < table.size(); s++ ) {
+			offset = ( offset + 7 ) & ~(uint64_t)7;
+			table[s].offset = offset;
+			table[s].count = m_sections[s].size();
+			offset += m_sections[s].size() * sizeof(Word);
+		}
+		h.file_size = offset;
+
+		std::ofstream out( filename.c_str(), std::ios::binary | std::ios::trunc );
+		if ( !out )
+			throw std::runtime_error( "Mapped_Task: could not open " + filename + " for writing" );
+		out.write( (const char*)&h, sizeof(h) );
+		out.write( (const char*)&table[0], table.size() * sizeof( Mapped_Task::Section_Entry ) );
+		uint64_t written = sizeof( Mapped_Task::Header ) + table.size() * sizeof( Mapped_Task::Section_Entry );
+		const char zeros[8] = { 0 };
+		for ( unsigned s = 0; s < table.size(); s++ ) {
+			out.write( zeros, table[s].offset - written );
+			if ( !m_sections[s].empty() )
+				out.write( (const char*)&m_sections[s][0], m_sections[s].size() * sizeof(Word) );
+			written = table[s].offset + m_sections[s].size() * sizeof(Word);
+		}
+		if ( !out )
+			throw std::runtime_error( "Mapped_Task: could not write " + filename );
+	}
+
+protected:
+	std::vector< std::vector<Word> >	m_sections;
+	std::string				m_strings;
+};
+
+void	Mapped_Task::write( const STRIPS_Problem& prob, std::string filename ) {
+	Task_Image img;
+	Header h;
+	std::memset( &h, 0, sizeof(h) );
+	h.magic = magic;
+	h.version = version;
+	h.byte_order = byte_order_mark;
+	h.num_sections = NUM_SECTIONS;
+	h.num_fluents = prob.num_fluents();
+	h.num_actions = prob.num_actions();
+	h.end_operator = prob.end_operator();
+	h.domain_name = img.add_string( prob.domain_name() );
+	h.problem_name = img.add_string( prob.problem_name() );
+
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ )
+		img.section( FLUENT_NAMES ).push_back( img.add_string( prob.fluents()[f]->signature() ) );
+
+	unsigned num_ceffs = 0;
+	img.section( CEFF_OFFSETS ).push_back( 0 );
+	for ( unsigned a = 0; a < prob.num_actions(); a++ ) {
+		const Action& act = *(prob.actions()[a]);
+		img.section( ACTION_NAMES ).push_back( img.add_string( act.signature() ) );
+		float c = act.cost();
+		Word w;
+		std::memcpy( &w, &c, sizeof(w) );
+		img.section( ACTION_COSTS ).push_back( w );
+		img.add_row( PRE_OFFSETS, PRE, act.prec_vec() );
+		img.add_row( ADD_OFFSETS, ADD, act.add_vec() );
+		img.add_row( DEL_OFFSETS, DEL, act.del_vec() );
+		img.add_row( EDEL_OFFSETS, EDEL, act.edel_vec() );
+		for ( unsigned k = 0; k < act.ceff_vec().size(); k++ ) {
+			const Conditional_Effect& ce = *(act.ceff_vec()[k]);
+			img.add_row( CEFF_PRE_OFFSETS, CEFF_PRE, ce.prec_vec() );
+			img.add_row( CEFF_ADD_OFFSETS, CEFF_ADD, ce.add_vec() );
+			img.add_row( CEFF_DEL_OFFSETS, CEFF_DEL, ce.del_vec() );
+		}
+		num_ceffs += act.ceff_vec().size();
+		img.section( CEFF_OFFSETS ).push_back( num_ceffs );
+	}
+	h.num_ceffs = num_ceffs;
+
+	img.section( INIT ).assign( prob.init().begin(), prob.init().end() );
+	img.section( GOAL ).assign( prob.goal().begin(), prob.goal().end() );
+
+	for ( unsigned f = 0; f < prob.num_fluents(); f++ ) {
+		img.add_action_row( ADDING_OFFSETS, ADDING, prob.actions_adding(f) );
+		img.add_action_row( DELETING_OFFSETS, DELETING, prob.actions_deleting(f) );
+		img.add_action_row( EDELETING_OFFSETS, EDELETING, prob.actions_edeleting(f) );
+		img.add_action_row( REQUIRING_OFFSETS, REQUIRING, prob.actions_requiring(f) );
+		std::vector<Word> pairs;
+		Ceff_Span ceffs = prob.ceffs_adding(f);
+		for ( unsigned k = 0; k < ceffs.size(); k++ ) {
+			pairs.push_back( ceffs[k].first );
+			pairs.push_back( ceffs.index( k ) );
+		}
+		img.add_row( CEFFS_ADDING_OFFSETS, CEFFS_ADDING, pairs );
+	}
+	for ( unsigned k = 0; k < prob.empty_prec_actions().size(); k++ )
+		img.section( EMPTY_PRECS ).push_back( prob.empty_prec_actions()[k]->index() );
+
+	const auto& nodes = prob.successor_generator().nodes();
+	h.num_sg_nodes = nodes.size();
+	for ( unsigned n = 0; n < nodes.size(); n++ ) {
+		img.section( SG_NODES ).push_back( nodes[n]->selection_fluent() );
+		img.section( SG_NODES ).push_back( nodes[n]->selection_node() ? nodes[n]->true_child() : no_such_index );
+		img.section( SG_NODES ).push_back( nodes[n]->selection_node() ? nodes[n]->dont_care_child() : no_such_index );
+		img.section( SG_NODES ).push_back( 0 );
+		img.add_action_row( SG_ACTION_OFFSETS, SG_ACTIONS, nodes[n]->actions() );
+	}
+
+	unsigned offsets[] = { PRE_OFFSETS, ADD_OFFSETS, DEL_OFFSETS, EDEL_OFFSETS,
+				CEFF_PRE_OFFSETS, CEFF_ADD_OFFSETS, CEFF_DEL_OFFSETS,
+				ADDING_OFFSETS, DELETING_OFFSETS, EDELETING_OFFSETS, REQUIRING_OFFSETS,
+				CEFFS_ADDING_OFFSETS, SG_ACTION_OFFSETS };
+	for ( unsigned k = 0; k < sizeof(offsets) / sizeof(unsigned); k++ )
+		img.close_rows( offsets[k] );
+
+	img.write( h, filename );
+}
+
+Mapped_Task::Mapped_Task( std::string filename )
+	: m_base( NULL ), m_size( 0 ) {
+	int fd = open( filename.c_str(), O_RDONLY );
+	if ( fd < 0 )
+		throw std::runtime_error( "Mapped_Task: could not open " + filename );
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 || (size_t)st.st_size < sizeof(Header) ) {
+		close( fd );
+		throw std::runtime_error( "Mapped_Task: " + filename + " is not a task file" );
+	}
+	m_size = st.st_size;
+	void* p = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if ( p == MAP_FAILED )
+		throw std::runtime_error( "Mapped_Task: could not map " + filename );
+	m_base = (const char*)p;
+	try {
+		validate( filename );
+	}
+	catch ( ... ) {
+		munmap( (void*)m_base, m_size );
+		throw;
+	}
+}
+
+Mapped_Task::~Mapped_Task() {
+	munmap( (void*)m_base, m_size );
+}
+
+void	Mapped_Task::make_problem( STRIPS_Problem& prob ) const {
+	prob.set_domain_name( domain_name() );
+	prob.set_problem_name( problem_name() );
+	for ( unsigned f = 0; f < num_fluents(); f++ )
+		STRIPS_Problem::add_fluent( prob, fluent_signature( f ) );
+
+	for ( unsigned a = 0; a < num_actions(); a++ ) {
+		Conditional_Effect_Vec ceffs;
+		for ( unsigned c = first_ceff( a ); c < first_ceff( a + 1 ); c++ ) {
+			Fluent_Vec cpre( ceff_pre(c).begin(), ceff_pre(c).end() );
+			Fluent_Vec cadd( ceff_add(c).begin(), ceff_add(c).end() );
+			Fluent_Vec cdel( ceff_del(c).begin(), ceff_del(c).end() );
+			Conditional_Effect* ce = new Conditional_Effect( prob );
+			ce->define( cpre, cadd, cdel );
+			ceffs.push_back( ce );
+		}
+		Fluent_Vec apre( pre(a).begin(), pre(a).end() );
+		Fluent_Vec aadd( add(a).begin(), add(a).end() );
+		Fluent_Vec adel( del(a).begin(), del(a).end() );
+		STRIPS_Problem::add_action( prob, action_signature( a ), apre, aadd, adel, ceffs, action_cost( a ) );
+	}
+
+	Fluent_Vec I( init().begin(), init().end() );
+	Fluent_Vec G( goal().begin(), goal().end() );
+	STRIPS_Problem::set_init( prob, I );
+	STRIPS_Problem::set_goal( prob, G );
+	prob.make_action_tables();
+}
+
+// Checks the layout only, so that no accessor reads outside the file. The
+// contents of the sections are taken as written by the exporter.
+void	Mapped_Task::validate( std::string filename ) const {
+	const Header& h = header();
+	if ( h.magic != magic || h.byte_order != byte_order_mark )
+		throw std::runtime_error( "Mapped_Task: " + filename + " is not a task file, or was written on a machine with another byte order" );
+	if ( h.version != version )
+		throw std::runtime_error( "Mapped_Task: " + filename + " was written with an unsupported format version" );
+	if ( h.num_sections != NUM_SECTIONS || h.file_size != m_size
+		|| m_size < sizeof(Header) + NUM_SECTIONS * sizeof(Section_Entry) )
+		throw std::runtime_error( "Mapped_Task: " + filename + " is truncated or corrupt" );
+
+	for ( unsigned s = 0; s < NUM_SECTIONS; s++ ) {
+		const Section_Entry& e = section(s);
+		if ( e.offset % 8 != 0 || e.offset > m_size || e.count > ( m_size - e.offset ) / sizeof(Word) )
+			throw std::runtime_error( "Mapped_Task: " + filename + " has a section out of bounds" );
+	}
+
+	struct Table { unsigned offsets; unsigned data; unsigned rows; };
+	Table tables[] = {
+		{ PRE_OFFSETS, PRE, h.num_actions }, { ADD_OFFSETS, ADD, h.num_actions },
+		{ DEL_OFFSETS, DEL, h.num_actions }, { EDEL_OFFSETS, EDEL, h.num_actions },
+		{ CEFF_PRE_OFFSETS, CEFF_PRE, h.num_ceffs }, { CEFF_ADD_OFFSETS, CEFF_ADD, h.num_ceffs },
+		{ CEFF_DEL_OFFSETS, CEFF_DEL, h.num_ceffs },
+		{ ADDING_OFFSETS, ADDING, h.num_fluents }, { DELETING_OFFSETS, DELETING, h.num_fluents },
+		{ EDELETING_OFFSETS, EDELETING, h.num_fluents }, { REQUIRING_OFFSETS, REQUIRING, h.num_fluents },
+		{ CEFFS_ADDING_OFFSETS, CEFFS_ADDING, h.num_fluents },
+		{ SG_ACTION_OFFSETS, SG_ACTIONS, h.num_sg_nodes },
+		{ CEFF_OFFSETS, CEFF_OFFSETS, h.num_actions }
+	};
+	for ( unsigned t = 0; t < sizeof(tables) / sizeof(Table); t++ ) {
+		const Section_Entry& o = section( tables[t].offsets );
+		if ( o.count != (uint64_t)tables[t].rows + 1 )
+			throw std::runtime_error( "Mapped_Task: " + filename + " has a table of the wrong size" );
+		const Word* w = words( tables[t].offsets );
+		uint64_t limit = tables[t].offsets == CEFF_OFFSETS ? h.num_ceffs : section( tables[t].data ).count;
+		for ( unsigned i = 0; i < tables[t].rows; i++ )
+			if ( w[i] > w[i+1] )
+				throw std::runtime_error( "Mapped_Task: " + filename + " has a corrupt table" );
+		if ( w[0] != 0 || w[ tables[t].rows ] != limit )
+			throw std::runtime_error( "Mapped_Task: " + filename + " has a corrupt table" );
+	}
+
+	if ( section( FLUENT_NAMES ).count != h.num_fluents || section( ACTION_NAMES ).count != h.num_actions
+		|| section( ACTION_COSTS ).count != h.num_actions
+		|| section( SG_NODES ).count != (uint64_t)h.num_sg_nodes * sizeof(SG_Node) / sizeof(Word) )
+		throw std::runtime_error( "Mapped_Task: " + filename + " has a table of the wrong size" );
+	// Strings have to start and end inside their section
+	const Section_Entry& str = section( STRINGS );
+	uint64_t str_size = str.count * sizeof(Word);
+	if ( str_size == 0 || m_base[ str.offset + str_size - 1 ] != '\0'
+		|| h.domain_name >= str_size || h.problem_name >= str_size )
+		throw std::runtime_error( "Mapped_Task: " + filename + " has a corrupt string table" );
+	for ( unsigned f = 0; f < h.num_fluents; f++ )
+		if ( words( FLUENT_NAMES )[f] >= str_size )
+			throw std::runtime_error( "Mapped_Task: " + filename + " has a corrupt string table" );
+	for ( unsigned a = 0; a < h.num_actions; a++ )
+		if ( words( ACTION_NAMES )[a] >= str_size )
+			throw std::runtime_error( "Mapped_Task: " + filename + " has a corrupt string table" );
+}
+
+}
+
+}
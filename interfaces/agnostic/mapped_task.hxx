@@ -0,0 +1,210 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MAPPED_TASK__
+#define __MAPPED_TASK__
+
+#include <strips_prob.hxx>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace aptk {
+
+namespace agnostic {
+
+// Binary image of a grounded STRIPS_Problem, the .aptk task format. The
+// file starts with a header and a table of sections, and every section is
+// a flat array of 32-bit words aligned to 8 bytes, so the whole file can
+// be mapped into memory and used as it is, without parsing anything.
+//
+// Lists of lists (preconditions of each action, actions adding each
+// fluent, ...) are kept in CSR form, as an array of num + 1 offsets and
+// the array with the elements, so that the elements of row i are those
+// between offsets[i] and offsets[i+1]. The successor generator tree is
+// stored with the nodes in the same order Successor_Generator::build()
+// creates them.
+//
+// Files are written in the byte order of the machine, and are rejected by
+// the loader when the byte order, the magic or the version do not match.
+class Mapped_Task {
+public:
+	typedef	uint32_t	Word;
+
+	static const Word	magic = 0x4B545041;	// "APTK"
+	static const Word	version = 1;
+
+	enum Section {
+		STRINGS = 0,
+		FLUENT_NAMES,
+		ACTION_NAMES,
+		ACTION_COSTS,
+		PRE_OFFSETS, PRE,
+		ADD_OFFSETS, ADD,
+		DEL_OFFSETS, DEL,
+		EDEL_OFFSETS, EDEL,
+		CEFF_OFFSETS,
+		CEFF_PRE_OFFSETS, CEFF_PRE,
+		CEFF_ADD_OFFSETS, CEFF_ADD,
+		CEFF_DEL_OFFSETS, CEFF_DEL,
+		INIT,
+		GOAL,
+		ADDING_OFFSETS, ADDING,
+		DELETING_OFFSETS, DELETING,
+		EDELETING_OFFSETS, EDELETING,
+		REQUIRING_OFFSETS, REQUIRING,
+		CEFFS_ADDING_OFFSETS, CEFFS_ADDING,
+		EMPTY_PRECS,
+		SG_NODES,
+		SG_ACTION_OFFSETS, SG_ACTIONS,
+		NUM_SECTIONS
+	};
+
+	struct Header {
+		Word		magic;
+		Word		version;
+		Word		byte_order;
+		Word		num_sections;
+		Word		num_fluents;
+		Word		num_actions;
+		Word		num_ceffs;
+		Word		num_sg_nodes;
+		Word		end_operator;
+		Word		domain_name;
+		Word		problem_name;
+		Word		reserved;
+		uint64_t	file_size;
+	};
+
+	struct Section_Entry {
+		uint64_t	offset;
+		uint64_t	count;
+	};
+
+	// Successor generator node, children are no_such_index when missing.
+	// Leaf nodes have no selection fluent and own a row of SG_ACTIONS.
+	struct SG_Node {
+		Word		selection_fluent;
+		Word		true_child;
+		Word		dont_care_child;
+		Word		reserved;
+	};
+
+	// Read-only view of a contiguous range of words
+	class Span {
+	public:
+		Span( const Word* b = NULL, const Word* e = NULL ) : m_begin( b ), m_end( e ) {}
+
+		const Word*	begin() const			{ return m_begin; }
+		const Word*	end() const			{ return m_end; }
+		unsigned	size() const			{ return m_end - m_begin; }
+		bool		empty() const			{ return m_begin == m_end; }
+		Word		operator[]( unsigned i ) const	{ return m_begin[i]; }
+		bool		contains( Word v ) const {
+			for ( const Word* p = m_begin; p != m_end; p++ )
+				if ( *p == v ) return true;
+			return false;
+		}
+
+	protected:
+		const Word*	m_begin;
+		const Word*	m_end;
+	};
+
+	// Exporter, prob must have its action tables already made
+	static void	write( const STRIPS_Problem& prob, std::string filename );
+
+	// Maps filename, throws std::runtime_error if it is not a valid task
+	Mapped_Task( std::string filename );
+	~Mapped_Task();
+
+	// Builds an ordinary STRIPS_Problem with the same fluents and actions,
+	// for engines and heuristics that need one. The end operator, if any,
+	// comes back as a plain action.
+	void		make_problem( STRIPS_Problem& prob ) const;
+
+	std::string	domain_name() const		{ return string( header().domain_name ); }
+	std::string	problem_name() const		{ return string( header().problem_name ); }
+	unsigned	num_fluents() const		{ return header().num_fluents; }
+	unsigned	num_actions() const		{ return header().num_actions; }
+	unsigned	num_ceffs() const		{ return header().num_ceffs; }
+	unsigned	end_operator() const		{ return header().end_operator; }
+
+	std::string	fluent_signature( unsigned f ) const	{ return string( words( FLUENT_NAMES )[f] ); }
+	std::string	action_signature( unsigned a ) const	{ return string( words( ACTION_NAMES )[a] ); }
+	float		action_cost( unsigned a ) const		{ return ( (const float*)words( ACTION_COSTS ) )[a]; }
+
+	Span		pre( unsigned a ) const		{ return row( PRE_OFFSETS, PRE, a ); }
+	Span		add( unsigned a ) const		{ return row( ADD_OFFSETS, ADD, a ); }
+	Span		del( unsigned a ) const		{ return row( DEL_OFFSETS, DEL, a ); }
+	Span		edel( unsigned a ) const	{ return row( EDEL_OFFSETS, EDEL, a ); }
+
+	// Conditional effects of action a are those numbered from
+	// first_ceff(a) up to first_ceff(a+1)
+	unsigned	first_ceff( unsigned a ) const	{ return words( CEFF_OFFSETS )[a]; }
+	Span		ceff_pre( unsigned c ) const	{ return row( CEFF_PRE_OFFSETS, CEFF_PRE, c ); }
+	Span		ceff_add( unsigned c ) const	{ return row( CEFF_ADD_OFFSETS, CEFF_ADD, c ); }
+	Span		ceff_del( unsigned c ) const	{ return row( CEFF_DEL_OFFSETS, CEFF_DEL, c ); }
+
+	Span		init() const			{ return all( INIT ); }
+	Span		goal() const			{ return all( GOAL ); }
+
+	Span		actions_adding( unsigned f ) const	{ return row( ADDING_OFFSETS, ADDING, f ); }
+	Span		actions_deleting( unsigned f ) const	{ return row( DELETING_OFFSETS, DELETING, f ); }
+	Span		actions_edeleting( unsigned f ) const	{ return row( EDELETING_OFFSETS, EDELETING, f ); }
+	Span		actions_requiring( unsigned f ) const	{ return row( REQUIRING_OFFSETS, REQUIRING, f ); }
+	// Pairs of words, the index of the conditional effect within its
+	// action and the action
+	Span		ceffs_adding( unsigned f ) const	{ return row( CEFFS_ADDING_OFFSETS, CEFFS_ADDING, f ); }
+	Span		empty_prec_actions() const		{ return all( EMPTY_PRECS ); }
+
+	unsigned	num_sg_nodes() const			{ return header().num_sg_nodes; }
+	const SG_Node&	sg_node( unsigned n ) const		{ return ( (const SG_Node*)words( SG_NODES ) )[n]; }
+	Span		sg_actions( unsigned n ) const		{ return row( SG_ACTION_OFFSETS, SG_ACTIONS, n ); }
+
+	size_t		file_size() const		{ return m_size; }
+
+protected:
+
+	const Header&	header() const			{ return *(const Header*)m_base; }
+	const Section_Entry&	section( unsigned s ) const {
+		return ( (const Section_Entry*)( m_base + sizeof(Header) ) )[s];
+	}
+	const Word*	words( unsigned s ) const	{ return (const Word*)( m_base + section(s).offset ); }
+	Span		all( unsigned s ) const		{ return Span( words(s), words(s) + section(s).count ); }
+	Span		row( unsigned offsets, unsigned data, unsigned i ) const {
+		const Word* o = words( offsets );
+		return Span( words( data ) + o[i], words( data ) + o[i+1] );
+	}
+	std::string	string( Word offset ) const	{ return std::string( (const char*)words( STRINGS ) + offset ); }
+
+	void		validate( std::string filename ) const;
+
+protected:
+
+	const char*	m_base;
+	size_t		m_size;
+};
+
+}
+
+}
+
+#endif // mapped_task.hxx
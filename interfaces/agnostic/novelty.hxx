@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <aptk/search_prob.hxx>
 #include <aptk/heuristic.hxx>
 #include <aptk/ext_math.hxx>
+#include <aptk/memory.hxx>
 #include <strips_state.hxx>
 #include <strips_prob.hxx>
 #include <vector>
@@ -39,7 +40,8 @@ class Novelty : public Heuristic<State> {
 public:
 
 	Novelty( const Search_Model& prob, unsigned max_arity = 1, const unsigned max_MB = 600 ) 
-		: Heuristic<State>( prob ), m_strips_model( prob.task() ), m_max_memory_size_MB(max_MB) {
+		: Heuristic<State>( prob ), m_strips_model( prob.task() ),
+		m_nodes_tuples( Tuple_Allocator( Memory_Budget::NOVELTY ) ), m_max_memory_size_MB(max_MB) {
 		
 		set_arity(max_arity);
 		
@@ -50,7 +52,7 @@ public:
 
 
 	void init() {
-		for(std::vector<State*>::iterator it = m_nodes_tuples.begin();
+		for(Tuple_Vec::iterator it = m_nodes_tuples.begin();
 		    it != m_nodes_tuples.end(); it++)		
 			*it = NULL;
 
@@ -79,13 +81,28 @@ public:
 		m_nodes_tuples.resize(m_num_tuples, NULL);
 
 	}
+
+	/**
+	 * Frees the table and makes a new one for the next lower arity, which
+	 * set_arity() will not go above from then on. False if arity is 1
+	 */
+	bool shrink() {
+		if( m_arity <= 1 ) return false;
+		Tuple_Vec( Tuple_Allocator( Memory_Budget::NOVELTY ) ).swap( m_nodes_tuples );
+		float size_novelty = ( (float) pow(m_num_fluents,m_arity-1) / 1024000.) * sizeof(State*);
+		m_max_memory_size_MB = (unsigned) ceil( size_novelty );
+		set_arity( m_arity-1 );
+		return true;
+	}
 	
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 	
 		compute( s, h_val );		
 	}
 
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		eval( s, h_val );
 	}
 
@@ -94,6 +111,7 @@ public:
 	 */
 	template <class Node >
 	void eval( const Node& n, float& h_val ) { 
+		APTK_PHASE( HEURISTIC );
 		if( n.action() != no_op )
 			compute( n, h_val );
 		else
@@ -103,6 +121,8 @@ public:
 
 protected:
 
+	typedef Tracking_Allocator< State* >			Tuple_Allocator;
+	typedef std::vector< State*, Tuple_Allocator >		Tuple_Vec;
 	
 	/**
 	 * If T == Node,  the computation is F^i-1 aprox. FASTER!!!
@@ -304,7 +324,7 @@ protected:
 
 
 	const STRIPS_Problem&	m_strips_model;
-        std::vector<State*>     m_nodes_tuples;
+        Tuple_Vec               m_nodes_tuples;
         unsigned                m_arity;
 	unsigned long           m_num_tuples;
 	unsigned                m_num_fluents;
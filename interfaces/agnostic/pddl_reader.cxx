@@ -0,0 +1,665 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <pddl_reader.hxx>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace aptk {
+
+namespace agnostic {
+
+typedef Lifted_Task::Atom		Atom;
+typedef Lifted_Task::Schema		Schema;
+typedef Lifted_Task::Cond_Effect	Cond_Effect;
+
+static const char* keyword_names[] = {
+	"DEFINE", "DOMAIN", "PROBLEM", ":REQUIREMENTS", ":TYPES", ":CONSTANTS",
+	":PREDICATES", ":FUNCTIONS", ":ACTION", ":PARAMETERS", ":PRECONDITION",
+	":EFFECT", "AND", "NOT", "OR", "IMPLY", "EXISTS", "FORALL", "WHEN",
+	"INCREASE", "TOTAL-COST", "-", "EITHER", "OBJECT", "=",
+	":DOMAIN", ":OBJECTS", ":INIT", ":GOAL", ":METRIC", "NUMBER"
+};
+
+// Whitespace is any control character or blank
+static inline bool	is_space( char c ) {
+	return (unsigned char)c <= ' ';
+}
+
+static inline bool	is_delimiter( char c ) {
+	return is_space( c ) || c == '(' || c == ')' || c == ';';
+}
+
+// Both scans look at 16 bytes at a time while there are as many left
+static inline const char*	skip_space( const char* p, const char* end ) {
+#ifdef __SSE2__
+	const __m128i blank = _mm_set1_epi8( ' ' );
+	while ( end - p >= 16 ) {
+		__m128i v = _mm_loadu_si128( (const __m128i*)p );
+		unsigned mask = ~_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_min_epu8( v, blank ), v ) ) & 0xFFFF;
+		if ( mask ) return p + __builtin_ctz( mask );
+		p += 16;
+	}
+#endif
+	while ( p < end && is_space( *p ) ) p++;
+	return p;
+}
+
+static inline const char*	find_delimiter( const char* p, const char* end ) {
+#ifdef __SSE2__
+	const __m128i blank = _mm_set1_epi8( ' ' );
+	const __m128i open = _mm_set1_epi8( '(' );
+	const __m128i close = _mm_set1_epi8( ')' );
+	const __m128i semicolon = _mm_set1_epi8( ';' );
+	while ( end - p >= 16 ) {
+		__m128i v = _mm_loadu_si128( (const __m128i*)p );
+		__m128i d = _mm_or_si128( _mm_cmpeq_epi8( _mm_min_epu8( v, blank ), v ),
+				_mm_or_si128( _mm_cmpeq_epi8( v, open ),
+					_mm_or_si128( _mm_cmpeq_epi8( v, close ), _mm_cmpeq_epi8( v, semicolon ) ) ) );
+		unsigned mask = _mm_movemask_epi8( d );
+		if ( mask ) return p + __builtin_ctz( mask );
+		p += 16;
+	}
+#endif
+	while ( p < end && !is_delimiter( *p ) ) p++;
+	return p;
+}
+
+// Maps a file for as long as it is being read
+class Mapped_Text {
+public:
+	Mapped_Text( std::string filename, const char*& text, size_t& size )
+		: m_text( text ), m_size( size ) {
+		int fd = open( filename.c_str(), O_RDONLY );
+		if ( fd < 0 )
+			throw std::runtime_error( "PDDL_Reader: could not open " + filename );
+		struct stat st;
+		if ( fstat( fd, &st ) != 0 ) {
+			close( fd );
+			throw std::runtime_error( "PDDL_Reader: could not read " + filename );
+		}
+		m_size = st.st_size;
+		m_text = "";
+		if ( m_size > 0 ) {
+			void* p = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+			if ( p == MAP_FAILED ) {
+				close( fd );
+				throw std::runtime_error( "PDDL_Reader: could not map " + filename );
+			}
+			madvise( p, m_size, MADV_SEQUENTIAL );
+			m_text = (const char*)p;
+		}
+		close( fd );
+	}
+
+	~Mapped_Text() {
+		if ( m_size > 0 )
+			munmap( (void*)m_text, m_size );
+		m_text = NULL;
+		m_size = 0;
+	}
+
+protected:
+	const char*&	m_text;
+	size_t&		m_size;
+};
+
+PDDL_Reader::PDDL_Reader( Lifted_Task& task )
+	: m_task( task ), m_symbols( true ), m_text( NULL ), m_size( 0 ), m_root( 0 ),
+	m_num_params( 0 ), m_bytes( 0 ), m_tokens( 0 ) {
+	for ( unsigned k = 0; k < NUM_KEYWORDS; k++ )
+		m_symbols.intern( keyword_names[k], strlen( keyword_names[k] ) );
+	m_task.add_type( "OBJECT" );
+}
+
+PDDL_Reader::~PDDL_Reader() {
+}
+
+void	PDDL_Reader::read_domain( std::string filename ) {
+	m_filename = filename;
+	Mapped_Text text( filename, m_text, m_size );
+	tokenize();
+	read_domain_sections();
+}
+
+void	PDDL_Reader::read_problem( std::string filename ) {
+	m_filename = filename;
+	Mapped_Text text( filename, m_text, m_size );
+	tokenize();
+	read_problem_sections();
+	finish();
+}
+
+// Node 0 is a list with the expressions at the top of the file
+void	PDDL_Reader::tokenize() {
+	m_nodes.clear();
+	m_root = 0;
+	Node root = { no_such_index, no_such_index, no_such_index, 0 };
+	m_nodes.push_back( root );
+	// Open lists, and the last element of each
+	std::vector<unsigned> open( 1, 0 ), last( 1, no_such_index );
+
+	const char* end = m_text + m_size;
+	const char* p = m_text;
+	while ( true ) {
+		p = skip_space( p, end );
+		if ( p == end ) break;
+		if ( *p == ';' ) {
+			const char* nl = (const char*)memchr( p, '\n', end - p );
+			p = nl ? nl + 1 : end;
+			continue;
+		}
+		if ( *p == ')' ) {
+			if ( open.size() == 1 ) {
+				Node n = { no_such_index, no_such_index, no_such_index, (unsigned)( p - m_text ) };
+				m_nodes.push_back( n );
+				error( m_nodes.size() - 1, "unbalanced parentheses" );
+			}
+			open.pop_back();
+			last.pop_back();
+			p++;
+			continue;
+		}
+		Node n = { no_such_index, no_such_index, no_such_index, (unsigned)( p - m_text ) };
+		const char* q = p + 1;
+		if ( *p == '-' && q < end && isalpha( (unsigned char)*q ) )
+			// A type glued to its dash, as in ?x -block, FF reads it too
+			n.symbol = K_DASH;
+		else if ( *p != '(' ) {
+			q = find_delimiter( p, end );
+			n.symbol = m_symbols.intern( p, q - p );
+		}
+		unsigned idx = m_nodes.size();
+		m_nodes.push_back( n );
+		if ( last.back() == no_such_index )
+			m_nodes[ open.back() ].first = idx;
+		else
+			m_nodes[ last.back() ].next = idx;
+		last.back() = idx;
+		if ( *p == '(' ) {
+			open.push_back( idx );
+			last.push_back( no_such_index );
+		}
+		p = q;
+	}
+	if ( open.size() > 1 )
+		error( open.back(), "list not closed" );
+	m_bytes += m_size;
+	m_tokens += m_nodes.size() - 1;
+}
+
+unsigned	PDDL_Reader::head( unsigned n ) const {
+	unsigned f = m_nodes[n].first;
+	return f == no_such_index ? no_such_index : m_nodes[f].symbol;
+}
+
+unsigned	PDDL_Reader::child( unsigned n, unsigned i ) const {
+	unsigned c = m_nodes[n].first;
+	for ( ; c != no_such_index && i > 0; i-- )
+		c = m_nodes[c].next;
+	if ( c == no_such_index )
+		error( n, "missing element" );
+	return c;
+}
+
+unsigned	PDDL_Reader::symbol_of( unsigned n ) const {
+	if ( is_list( n ) )
+		error( n, "expected a name" );
+	return m_nodes[n].symbol;
+}
+
+void	PDDL_Reader::error( unsigned n, std::string what ) const {
+	unsigned offset = m_nodes[n].offset;
+	unsigned line = 1;
+	for ( unsigned i = 0; i < offset && i < m_size; i++ )
+		if ( m_text[i] == '\n' ) line++;
+	std::stringstream msg;
+	msg << "PDDL_Reader: " << m_filename << ":" << line << ": " << what;
+	throw std::runtime_error( msg.str() );
+}
+
+unsigned	PDDL_Reader::lookup( const std::vector<unsigned>& table, unsigned symbol ) const {
+	return symbol < table.size() ? table[symbol] : no_such_index;
+}
+
+static void	set_entry( std::vector<unsigned>& table, unsigned symbol, unsigned value ) {
+	if ( symbol >= table.size() )
+		table.resize( symbol + 1, no_such_index );
+	table[symbol] = value;
+}
+
+// Reads the names from node n on, as in a - t1 b c - (either t2 t3) d
+void	PDDL_Reader::typed_list( unsigned n, std::vector<Typed_Name>& names ) {
+	unsigned untyped = names.size();
+	for ( ; n != no_such_index; n = m_nodes[n].next ) {
+		if ( is_list( n ) || m_nodes[n].symbol != K_DASH ) {
+			Typed_Name tn;
+			tn.symbol = symbol_of( n );
+			names.push_back( tn );
+			continue;
+		}
+		n = m_nodes[n].next;
+		if ( n == no_such_index )
+			error( m_root, "type missing after -" );
+		std::vector<unsigned> types;
+		if ( !is_list( n ) )
+			types.push_back( m_nodes[n].symbol );
+		else {
+			if ( head( n ) != K_EITHER )
+				error( n, "expected a type" );
+			for ( unsigned c = m_nodes[ m_nodes[n].first ].next; c != no_such_index; c = m_nodes[c].next )
+				types.push_back( symbol_of( c ) );
+		}
+		for ( ; untyped < names.size(); untyped++ )
+			names[untyped].types = types;
+	}
+	for ( ; untyped < names.size(); untyped++ )
+		names[untyped].types.assign( 1, K_OBJECT );
+}
+
+unsigned	PDDL_Reader::type_of( const std::vector<unsigned>& types ) {
+	if ( types.size() == 1 )
+		return m_task.add_type( m_symbols.name( types[0] ) );
+	std::string name = "(EITHER";
+	for ( unsigned k = 0; k < types.size(); k++ )
+		name += " " + m_symbols.name( types[k] );
+	name += ")";
+	unsigned num_types = m_task.num_types();
+	unsigned t = m_task.add_type( name );
+	if ( t == num_types )
+		m_either_types.push_back( std::make_pair( t, types ) );
+	return t;
+}
+
+unsigned	PDDL_Reader::add_object( unsigned symbol, const std::vector<unsigned>& types ) {
+	unsigned o = m_task.add_object( m_symbols.name( symbol ) );
+	set_entry( m_object_of, symbol, o );
+	m_object_types.push_back( std::make_pair( o, types ) );
+	return o;
+}
+
+void	PDDL_Reader::read_domain_sections() {
+	unsigned def = m_nodes[m_root].first;
+	if ( def == no_such_index || !is_list( def ) || head( def ) != K_DEFINE )
+		error( m_root, "expected (define (domain ...) ...)" );
+	unsigned name = child( def, 1 );
+	if ( !is_list( name ) || head( name ) != K_DOMAIN )
+		error( name, "expected (domain ...)" );
+	m_task.set_domain_name( m_symbols.name( symbol_of( child( name, 1 ) ) ) );
+
+	for ( unsigned s = m_nodes[name].next; s != no_such_index; s = m_nodes[s].next ) {
+		if ( !is_list( s ) || head( s ) == no_such_index )
+			error( s, "expected a section" );
+		unsigned items = m_nodes[ m_nodes[s].first ].next;
+		std::vector<Typed_Name> names;
+		switch ( head( s ) ) {
+		case K_REQUIREMENTS:
+			break;
+		case K_TYPES:
+			typed_list( items, names );
+			for ( unsigned k = 0; k < names.size(); k++ ) {
+				if ( names[k].types.size() > 1 )
+					error( s, "either types as supertypes are not supported" );
+				m_task.add_type( m_symbols.name( names[k].symbol ) );
+				if ( names[k].symbol >= m_supertypes.size() )
+					m_supertypes.resize( names[k].symbol + 1 );
+				m_supertypes[ names[k].symbol ].push_back( names[k].types[0] );
+			}
+			break;
+		case K_CONSTANTS:
+			typed_list( items, names );
+			for ( unsigned k = 0; k < names.size(); k++ )
+				add_object( names[k].symbol, names[k].types );
+			break;
+		case K_PREDICATES:
+			for ( unsigned p = items; p != no_such_index; p = m_nodes[p].next ) {
+				if ( !is_list( p ) )
+					error( p, "expected a predicate" );
+				unsigned sym = symbol_of( m_nodes[p].first );
+				names.clear();
+				typed_list( m_nodes[ m_nodes[p].first ].next, names );
+				set_entry( m_predicate_of, sym, m_task.add_predicate( m_symbols.name( sym ), names.size() ) );
+			}
+			break;
+		case K_FUNCTIONS:
+			// Function types, as in - number, are skipped
+			for ( unsigned f = items; f != no_such_index; f = m_nodes[f].next ) {
+				if ( !is_list( f ) ) continue;
+				unsigned sym = symbol_of( m_nodes[f].first );
+				names.clear();
+				typed_list( m_nodes[ m_nodes[f].first ].next, names );
+				set_entry( m_function_of, sym, m_task.add_function( m_symbols.name( sym ), names.size() ) );
+			}
+			break;
+		case K_ACTION:
+			read_action( s );
+			break;
+		default:
+			error( s, "section " + m_symbols.name( head( s ) ) + " is not supported" );
+		}
+	}
+}
+
+void	PDDL_Reader::read_action( unsigned n ) {
+	Schema s;
+	unsigned name = child( n, 1 );
+	s.name = m_symbols.name( symbol_of( name ) );
+	m_scope.clear();
+	m_scope_types.clear();
+	m_num_params = 0;
+
+	for ( unsigned k = m_nodes[name].next; k != no_such_index; k = m_nodes[k].next ) {
+		unsigned v = m_nodes[k].next;
+		if ( v == no_such_index )
+			error( k, "value missing" );
+		switch ( symbol_of( k ) ) {
+		case K_PARAMETERS: {
+			if ( !is_list( v ) )
+				error( v, "expected a list of parameters" );
+			std::vector<Typed_Name> names;
+			typed_list( m_nodes[v].first, names );
+			for ( unsigned i = 0; i < names.size(); i++ ) {
+				m_scope.push_back( names[i].symbol );
+				m_scope_types.push_back( type_of( names[i].types ) );
+				s.param_names.push_back( m_symbols.name( names[i].symbol ) );
+				s.param_types.push_back( m_scope_types.back() );
+			}
+			m_num_params = m_scope.size();
+			break;
+		}
+		case K_PRECONDITION:
+			condition( v, s.pre, false );
+			break;
+		case K_EFFECT:
+			effect( v, s, NULL, false );
+			break;
+		default:
+			error( k, m_symbols.name( symbol_of( k ) ) + " is not supported in actions" );
+		}
+		k = v;
+	}
+	m_task.add_schema( s );
+}
+
+void	PDDL_Reader::condition( unsigned n, std::vector<Atom>& atoms, bool negated ) {
+	if ( !is_list( n ) )
+		error( n, "expected a formula" );
+	if ( m_nodes[n].first == no_such_index ) return;
+	switch ( head( n ) ) {
+	case K_AND:
+		if ( negated )
+			error( n, "negated conjunctions are not supported" );
+		for ( unsigned c = m_nodes[ m_nodes[n].first ].next; c != no_such_index; c = m_nodes[c].next )
+			condition( c, atoms, false );
+		break;
+	case K_NOT:
+		condition( child( n, 1 ), atoms, !negated );
+		break;
+	case K_OR:
+	case K_IMPLY:
+	case K_EXISTS:
+	case K_FORALL:
+		error( n, "disjunctions and quantifiers are not supported in conditions" );
+		break;
+	default:
+		atoms.push_back( Atom() );
+		atom( n, atoms.back(), negated );
+	}
+}
+
+void	PDDL_Reader::effect( unsigned n, Schema& s, Cond_Effect* ce, bool in_when ) {
+	if ( !is_list( n ) )
+		error( n, "expected an effect" );
+	if ( m_nodes[n].first == no_such_index ) return;
+	switch ( head( n ) ) {
+	case K_AND:
+		for ( unsigned c = m_nodes[ m_nodes[n].first ].next; c != no_such_index; c = m_nodes[c].next )
+			effect( c, s, ce, in_when );
+		break;
+	case K_NOT: {
+		Atom a;
+		atom( child( n, 1 ), a, false );
+		if ( a.predicate == Lifted_Task::equality )
+			error( n, "equality in an effect" );
+		( ce ? ce->del : s.del ).push_back( a );
+		break;
+	}
+	case K_WHEN: {
+		if ( in_when )
+			error( n, "nested conditional effects are not supported" );
+		Cond_Effect w;
+		for ( unsigned i = m_num_params; i < m_scope.size(); i++ ) {
+			w.param_names.push_back( m_symbols.name( m_scope[i] ) );
+			w.param_types.push_back( m_scope_types[i] );
+		}
+		condition( child( n, 1 ), w.pre, false );
+		effect( child( n, 2 ), s, &w, true );
+		s.ceffs.push_back( w );
+		break;
+	}
+	case K_FORALL: {
+		if ( in_when )
+			error( n, "quantified effects inside conditional effects are not supported" );
+		unsigned vars = child( n, 1 );
+		if ( !is_list( vars ) )
+			error( vars, "expected a list of variables" );
+		std::vector<Typed_Name> names;
+		typed_list( m_nodes[vars].first, names );
+		unsigned saved = m_scope.size();
+		for ( unsigned i = 0; i < names.size(); i++ ) {
+			m_scope.push_back( names[i].symbol );
+			m_scope_types.push_back( type_of( names[i].types ) );
+		}
+		// Plain literals in the body are an effect with no condition
+		Cond_Effect q;
+		for ( unsigned i = m_num_params; i < m_scope.size(); i++ ) {
+			q.param_names.push_back( m_symbols.name( m_scope[i] ) );
+			q.param_types.push_back( m_scope_types[i] );
+		}
+		effect( child( n, 2 ), s, &q, false );
+		if ( !q.add.empty() || !q.del.empty() )
+			s.ceffs.push_back( q );
+		m_scope.resize( saved );
+		m_scope_types.resize( saved );
+		break;
+	}
+	case K_INCREASE: {
+		unsigned target = child( n, 1 );
+		if ( !is_list( target ) || head( target ) != K_TOTAL_COST )
+			error( n, "only (total-cost) can be increased" );
+		if ( ce )
+			error( n, "costs inside conditional and quantified effects are not supported" );
+		unsigned v = child( n, 2 );
+		if ( !is_list( v ) )
+			s.cost += number( v );
+		else {
+			if ( s.has_cost_term )
+				error( n, "more than one cost function" );
+			unsigned f = lookup( m_function_of, head( v ) );
+			if ( f == no_such_index )
+				error( v, "unknown function " + m_symbols.name( head( v ) ) );
+			s.has_cost_term = true;
+			s.cost_term.predicate = f;
+			for ( unsigned c = m_nodes[ m_nodes[v].first ].next; c != no_such_index; c = m_nodes[c].next )
+				s.cost_term.args.push_back( argument( c ) );
+		}
+		m_task.set_has_costs( true );
+		break;
+	}
+	default: {
+		Atom a;
+		atom( n, a, false );
+		if ( a.predicate == Lifted_Task::equality )
+			error( n, "equality in an effect" );
+		( ce ? ce->add : s.add ).push_back( a );
+	}
+	}
+}
+
+void	PDDL_Reader::atom( unsigned n, Atom& a, bool negated ) {
+	if ( !is_list( n ) || m_nodes[n].first == no_such_index )
+		error( n, "expected an atom" );
+	unsigned h = symbol_of( m_nodes[n].first );
+	a.negated = negated;
+	a.predicate = h == K_EQUAL ? Lifted_Task::equality : lookup( m_predicate_of, h );
+	if ( a.predicate == no_such_index )
+		error( n, "unknown predicate " + m_symbols.name( h ) );
+	a.args.clear();
+	for ( unsigned c = m_nodes[ m_nodes[n].first ].next; c != no_such_index; c = m_nodes[c].next )
+		a.args.push_back( argument( c ) );
+	if ( a.args.size() != m_task.arity( a.predicate ) )
+		error( n, "wrong number of arguments for " + m_symbols.name( h ) );
+}
+
+int	PDDL_Reader::argument( unsigned n ) {
+	unsigned sym = symbol_of( n );
+	const std::string& name = m_symbols.name( sym );
+	if ( name[0] == '?' ) {
+		// Inner variables hide outer ones with the same name
+		for ( unsigned i = m_scope.size(); i > 0; i-- )
+			if ( m_scope[i-1] == sym )
+				return Lifted_Task::param( i - 1 );
+		error( n, "unknown variable " + name );
+	}
+	unsigned o = lookup( m_object_of, sym );
+	if ( o == no_such_index )
+		error( n, "unknown object " + name );
+	return o;
+}
+
+float	PDDL_Reader::number( unsigned n ) const {
+	const std::string& s = m_symbols.name( symbol_of( n ) );
+	char* end = NULL;
+	float v = strtod( s.c_str(), &end );
+	if ( end == s.c_str() || *end != '\0' )
+		error( n, "expected a number" );
+	return v;
+}
+
+void	PDDL_Reader::read_problem_sections() {
+	unsigned def = m_nodes[m_root].first;
+	if ( def == no_such_index || !is_list( def ) || head( def ) != K_DEFINE )
+		error( m_root, "expected (define (problem ...) ...)" );
+	unsigned name = child( def, 1 );
+	if ( !is_list( name ) || head( name ) != K_PROBLEM )
+		error( name, "expected (problem ...)" );
+	m_task.set_problem_name( m_symbols.name( symbol_of( child( name, 1 ) ) ) );
+	m_scope.clear();
+	m_scope_types.clear();
+	m_num_params = 0;
+
+	for ( unsigned s = m_nodes[name].next; s != no_such_index; s = m_nodes[s].next ) {
+		if ( !is_list( s ) || head( s ) == no_such_index )
+			error( s, "expected a section" );
+		unsigned items = m_nodes[ m_nodes[s].first ].next;
+		switch ( head( s ) ) {
+		case K_PROBLEM_DOMAIN:
+		case K_REQUIREMENTS:
+		case K_METRIC:
+			break;
+		case K_OBJECTS: {
+			std::vector<Typed_Name> names;
+			typed_list( items, names );
+			for ( unsigned k = 0; k < names.size(); k++ )
+				add_object( names[k].symbol, names[k].types );
+			break;
+		}
+		case K_INIT: {
+			Atom a;
+			for ( unsigned i = items; i != no_such_index; i = m_nodes[i].next ) {
+				if ( is_list( i ) && head( i ) == K_EQUAL ) {
+					unsigned term = child( i, 1 );
+					unsigned f = is_list( term ) ? lookup( m_function_of, head( term ) ) : no_such_index;
+					if ( f == no_such_index )
+						error( i, "expected a function" );
+					std::vector<int> args;
+					for ( unsigned c = m_nodes[ m_nodes[term].first ].next; c != no_such_index; c = m_nodes[c].next )
+						args.push_back( argument( c ) );
+					m_task.set_value( f, args, number( child( i, 2 ) ) );
+					continue;
+				}
+				atom( i, a, false );
+				m_task.add_init( a );
+			}
+			break;
+		}
+		case K_GOAL: {
+			std::vector<Atom> atoms;
+			condition( child( s, 1 ), atoms, false );
+			for ( unsigned k = 0; k < atoms.size(); k++ )
+				m_task.add_goal( atoms[k] );
+			break;
+		}
+		default:
+			error( s, "section " + m_symbols.name( head( s ) ) + " is not supported" );
+		}
+	}
+}
+
+// Objects belong to their types and to all of the supertypes of them, and
+// either types are the union of their members
+void	PDDL_Reader::finish() {
+	unsigned object = m_task.find_type( "OBJECT" );
+	for ( unsigned i = 0; i < m_object_types.size(); i++ ) {
+		unsigned o = m_object_types[i].first;
+		const std::vector<unsigned>& types = m_object_types[i].second;
+		m_task.add_to_type( o, object );
+		if ( types.size() > 1 ) {
+			m_task.add_to_type( o, type_of( types ) );
+			continue;
+		}
+		std::vector<unsigned> open( 1, types[0] ), seen;
+		while ( !open.empty() ) {
+			unsigned t = open.back();
+			open.pop_back();
+			if ( std::find( seen.begin(), seen.end(), t ) != seen.end() ) continue;
+			seen.push_back( t );
+			m_task.add_to_type( o, m_task.add_type( m_symbols.name( t ) ) );
+			if ( t < m_supertypes.size() )
+				open.insert( open.end(), m_supertypes[t].begin(), m_supertypes[t].end() );
+		}
+	}
+	for ( unsigned i = 0; i < m_either_types.size(); i++ ) {
+		unsigned e = m_either_types[i].first;
+		const std::vector<unsigned>& types = m_either_types[i].second;
+		for ( unsigned k = 0; k < types.size(); k++ ) {
+			unsigned t = m_task.find_type( m_symbols.name( types[k] ) );
+			if ( t == no_such_index ) continue;
+			std::vector<unsigned> members( m_task.objects_of( t ) );
+			for ( unsigned j = 0; j < members.size(); j++ )
+				m_task.add_to_type( members[j], e );
+		}
+	}
+}
+
+}
+
+}
@@ -0,0 +1,148 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __PDDL_READER__
+#define __PDDL_READER__
+
+#include <lifted_task.hxx>
+#include <symbol_table.hxx>
+#include <string>
+#include <vector>
+
+namespace aptk {
+
+namespace agnostic {
+
+// Reads PDDL domain and problem files into a Lifted_Task, without going
+// through FF. Files are mapped into memory and split into tokens in
+// place, names are interned as they are found and the parser works on
+// a flat tree of symbol numbers, so nothing is copied but the names
+// seen for the first time.
+//
+// Covered are typing (either types included), constants, equality,
+// negated preconditions, conditional effects with when and forall, and
+// action costs as (increase (total-cost) ...) with a number or a
+// function of the parameters. Disjunctions, quantified preconditions,
+// derived predicates and other numeric effects are rejected.
+//
+// Names are kept in upper case, as FF does, so the fluents and actions
+// grounded from the task have the same names as with FF.
+class PDDL_Reader {
+public:
+
+	PDDL_Reader( Lifted_Task& task );
+	~PDDL_Reader();
+
+	// Both throw std::runtime_error with file and line for syntax errors
+	// and what is not covered. The domain has to be read first.
+	void		read_domain( std::string filename );
+	void		read_problem( std::string filename );
+
+	// Bytes and tokens read so far
+	size_t		bytes_read() const	{ return m_bytes; }
+	size_t		tokens_read() const	{ return m_tokens; }
+
+protected:
+
+	// Lists have no symbol, and their elements are the nodes from first
+	// following next
+	struct Node {
+		unsigned	symbol;
+		unsigned	first;
+		unsigned	next;
+		unsigned	offset;
+	};
+
+	enum Keyword {
+		K_DEFINE = 0, K_DOMAIN, K_PROBLEM, K_REQUIREMENTS, K_TYPES, K_CONSTANTS,
+		K_PREDICATES, K_FUNCTIONS, K_ACTION, K_PARAMETERS, K_PRECONDITION,
+		K_EFFECT, K_AND, K_NOT, K_OR, K_IMPLY, K_EXISTS, K_FORALL, K_WHEN,
+		K_INCREASE, K_TOTAL_COST, K_DASH, K_EITHER, K_OBJECT, K_EQUAL,
+		K_PROBLEM_DOMAIN, K_OBJECTS, K_INIT, K_GOAL, K_METRIC, K_NUMBER,
+		NUM_KEYWORDS
+	};
+
+	// Names declared in a typed list, and the type of each one, as a
+	// list of types to take the union of
+	struct Typed_Name {
+		unsigned		symbol;
+		std::vector<unsigned>	types;
+	};
+
+	void		tokenize();
+	void		read_domain_sections();
+	void		read_problem_sections();
+
+	// Navigation of the tree
+	bool		is_list( unsigned n ) const		{ return m_nodes[n].symbol == no_such_index; }
+	unsigned	head( unsigned n ) const;
+	unsigned	child( unsigned n, unsigned i ) const;
+	unsigned	symbol_of( unsigned n ) const;
+	void		error( unsigned n, std::string what ) const;
+
+	unsigned	lookup( const std::vector<unsigned>& table, unsigned symbol ) const;
+	void		typed_list( unsigned n, std::vector<Typed_Name>& names );
+	unsigned	type_of( const std::vector<unsigned>& types );
+	unsigned	add_object( unsigned symbol, const std::vector<unsigned>& types );
+
+	void		read_action( unsigned n );
+	void		condition( unsigned n, std::vector<Lifted_Task::Atom>& atoms, bool negated );
+	void		effect( unsigned n, Lifted_Task::Schema& s, Lifted_Task::Cond_Effect* ce, bool in_when );
+	void		atom( unsigned n, Lifted_Task::Atom& a, bool negated );
+	int		argument( unsigned n );
+	float		number( unsigned n ) const;
+	void		finish();
+
+protected:
+
+	Lifted_Task&			m_task;
+	Symbol_Table			m_symbols;
+
+	// File being read, mapped into memory
+	std::string			m_filename;
+	const char*			m_text;
+	size_t				m_size;
+	std::vector<Node>		m_nodes;
+	unsigned			m_root;
+
+	// Indexed by symbol, no_such_index if the symbol is not one
+	std::vector<unsigned>		m_predicate_of;
+	std::vector<unsigned>		m_function_of;
+	std::vector<unsigned>		m_object_of;
+	// Supertypes of each type symbol, and declared types of each object
+	std::vector< std::vector<unsigned> >			m_supertypes;
+	std::vector< std::pair< unsigned, std::vector<unsigned> > >	m_object_types;
+	std::vector< std::pair< unsigned, std::vector<unsigned> > >	m_either_types;
+
+	// Variables in scope, the symbol of parameter i of the schema being
+	// read, followed by those of enclosing foralls
+	std::vector<unsigned>		m_scope;
+	std::vector<unsigned>		m_scope_types;
+	unsigned			m_num_params;
+
+	size_t				m_bytes;
+	size_t				m_tokens;
+};
+
+}
+
+}
+
+#endif // pddl_reader.hxx
@@ -0,0 +1,589 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <relaxed_grounder.hxx>
+#include <action.hxx>
+#include <cond_eff.hxx>
+#include <algorithm>
+#include <stdexcept>
+
+namespace aptk {
+
+namespace agnostic {
+
+typedef Lifted_Task::Atom	Atom;
+typedef Lifted_Task::Schema	Schema;
+
+struct Fact_Order {
+	Fact_Order( const std::vector<const std::vector<unsigned>*>& facts ) : m_facts( facts ) {}
+	bool operator()( unsigned a, unsigned b ) const { return *m_facts[a] < *m_facts[b]; }
+	const std::vector<const std::vector<unsigned>*>&	m_facts;
+};
+
+static void	push_unique( Fluent_Vec& v, unsigned f ) {
+	if ( std::find( v.begin(), v.end(), f ) == v.end() )
+		v.push_back( f );
+}
+
+Relaxed_Grounder::Relaxed_Grounder( const Lifted_Task& task )
+	: m_task( task ) {
+	m_task.validate();
+	m_triggers_of.resize( m_task.num_predicates() );
+	m_indices_of.resize( m_task.num_predicates() );
+	m_facts_of.resize( m_task.num_predicates() );
+	for ( unsigned p = 0; p < m_task.num_predicates(); p++ )
+		if ( m_task.arity( p ) > 32 )
+			throw std::runtime_error( "Relaxed_Grounder: predicate " + m_task.predicate_name( p ) + " has more than 32 arguments" );
+	m_free_params.resize( m_task.schemas().size() );
+	m_filters.resize( m_task.schemas().size() );
+	for ( unsigned s = 0; s < m_task.schemas().size(); s++ )
+		make_triggers( s );
+}
+
+Relaxed_Grounder::~Relaxed_Grounder() {
+}
+
+void	Relaxed_Grounder::make_triggers( unsigned s ) {
+	const Schema& schema = m_task.schemas()[s];
+	unsigned n = schema.param_names.size();
+
+	// Positive preconditions are joined, the rest are filters
+	std::vector<unsigned> positive;
+	std::vector<bool> covered( n, false );
+	for ( unsigned k = 0; k < schema.pre.size(); k++ ) {
+		const Atom& a = schema.pre[k];
+		if ( a.negated || a.predicate == Lifted_Task::equality ) {
+			m_filters[s].push_back( k );
+			continue;
+		}
+		positive.push_back( k );
+		for ( unsigned j = 0; j < a.args.size(); j++ )
+			if ( Lifted_Task::is_param( a.args[j] ) )
+				covered[ Lifted_Task::param_index( a.args[j] ) ] = true;
+	}
+	for ( unsigned i = 0; i < n; i++ )
+		if ( !covered[i] ) m_free_params[s].push_back( i );
+
+	if ( positive.empty() ) {
+		m_unconditional.push_back( s );
+		return;
+	}
+
+	for ( unsigned t = 0; t < positive.size(); t++ ) {
+		Trigger trigger;
+		trigger.schema = s;
+		trigger.atom = positive[t];
+
+		std::vector<bool> bound( n, false );
+		const Atom& first = schema.pre[ positive[t] ];
+		for ( unsigned j = 0; j < first.args.size(); j++ )
+			if ( Lifted_Task::is_param( first.args[j] ) )
+				bound[ Lifted_Task::param_index( first.args[j] ) ] = true;
+
+		std::vector<unsigned> remaining( positive );
+		remaining.erase( remaining.begin() + t );
+		while ( !remaining.empty() ) {
+			// Next is the one with more arguments bound, and fewer
+			// left unbound on ties
+			unsigned best = 0;
+			int best_bound = -1, best_free = 0;
+			for ( unsigned r = 0; r < remaining.size(); r++ ) {
+				const Atom& a = schema.pre[ remaining[r] ];
+				int nb = 0, nf = 0;
+				for ( unsigned j = 0; j < a.args.size(); j++ )
+					if ( !Lifted_Task::is_param( a.args[j] ) || bound[ Lifted_Task::param_index( a.args[j] ) ] )
+						nb++;
+					else
+						nf++;
+				if ( nb > best_bound || ( nb == best_bound && nf < best_free ) ) {
+					best = r;
+					best_bound = nb;
+					best_free = nf;
+				}
+			}
+			const Atom& a = schema.pre[ remaining[best] ];
+			unsigned mask = 0;
+			for ( unsigned j = 0; j < a.args.size(); j++ )
+				if ( !Lifted_Task::is_param( a.args[j] ) || bound[ Lifted_Task::param_index( a.args[j] ) ] )
+					mask |= 1u << j;
+
+			Join_Step step;
+			step.atom = remaining[best];
+			step.index = no_such_index;
+			if ( best_free == 0 )
+				step.kind = CHECK;
+			else if ( mask == 0 )
+				step.kind = SCAN;
+			else {
+				step.kind = LOOKUP;
+				step.index = get_index( a.predicate, mask );
+			}
+			trigger.steps.push_back( step );
+
+			for ( unsigned j = 0; j < a.args.size(); j++ )
+				if ( Lifted_Task::is_param( a.args[j] ) )
+					bound[ Lifted_Task::param_index( a.args[j] ) ] = true;
+			remaining.erase( remaining.begin() + best );
+		}
+
+		m_triggers_of[ first.predicate ].push_back( m_triggers.size() );
+		m_triggers.push_back( trigger );
+	}
+}
+
+unsigned	Relaxed_Grounder::get_index( unsigned predicate, unsigned mask ) {
+	for ( unsigned i = 0; i < m_indices_of[predicate].size(); i++ )
+		if ( m_indices[ m_indices_of[predicate][i] ].mask == mask )
+			return m_indices_of[predicate][i];
+	m_indices.push_back( Index() );
+	m_indices.back().predicate = predicate;
+	m_indices.back().mask = mask;
+	m_indices_of[predicate].push_back( m_indices.size() - 1 );
+	return m_indices.size() - 1;
+}
+
+unsigned	Relaxed_Grounder::insert_fact( const Key& k ) {
+	std::pair< Fact_Table::iterator, bool > r = m_fact_ids.insert( std::make_pair( k, (unsigned)m_facts.size() ) );
+	if ( r.second )
+		m_facts.push_back( &r.first->first );
+	return r.first->second;
+}
+
+void	Relaxed_Grounder::process( unsigned f ) {
+	// Keys are owned by m_fact_ids, whose elements never move
+	const Key& k = *m_facts[f];
+	unsigned p = k[0];
+
+	// The atom goes into the indices before joining, so it can match
+	// more than one precondition of the same instance
+	for ( unsigned i = 0; i < m_indices_of[p].size(); i++ ) {
+		Index& ix = m_indices[ m_indices_of[p][i] ];
+		Key sub;
+		for ( unsigned j = 0; j + 1 < k.size(); j++ )
+			if ( ix.mask & ( 1u << j ) )
+				sub.push_back( k[j+1] );
+		ix.table[sub].push_back( f );
+	}
+	m_facts_of[p].push_back( f );
+
+	for ( unsigned i = 0; i < m_triggers_of[p].size(); i++ ) {
+		const Trigger& t = m_triggers[ m_triggers_of[p][i] ];
+		const Schema& schema = m_task.schemas()[t.schema];
+		std::vector<int> binding( schema.param_names.size(), -1 );
+		std::vector<unsigned> bound;
+		if ( unify( schema.pre[t.atom], k, t.schema, binding, bound ) )
+			join( t, 0, binding );
+	}
+}
+
+void	Relaxed_Grounder::join( const Trigger& t, unsigned step, std::vector<int>& binding ) {
+	if ( step == t.steps.size() ) {
+		bind_free( t.schema, 0, binding );
+		return;
+	}
+	const Join_Step& js = t.steps[step];
+	const Atom& a = m_task.schemas()[t.schema].pre[js.atom];
+
+	if ( js.kind == CHECK ) {
+		Key g;
+		ground_atom( a, binding, g );
+		if ( m_fact_ids.find( g ) != m_fact_ids.end() )
+			join( t, step + 1, binding );
+		return;
+	}
+
+	// Only process() adds to the indices, so the candidates cannot
+	// change while joining
+	const std::vector<unsigned>* candidates = &m_facts_of[ a.predicate ];
+	if ( js.kind == LOOKUP ) {
+		Index& ix = m_indices[js.index];
+		Key sub;
+		for ( unsigned j = 0; j < a.args.size(); j++ )
+			if ( ix.mask & ( 1u << j ) )
+				sub.push_back( Lifted_Task::is_param( a.args[j] ) ? binding[ Lifted_Task::param_index( a.args[j] ) ] : a.args[j] );
+		Index_Table::const_iterator it = ix.table.find( sub );
+		if ( it == ix.table.end() ) return;
+		candidates = &it->second;
+	}
+	for ( unsigned i = 0; i < candidates->size(); i++ )
+		join_with( t, step, (*candidates)[i], binding );
+}
+
+void	Relaxed_Grounder::join_with( const Trigger& t, unsigned step, unsigned f, std::vector<int>& binding ) {
+	const Atom& a = m_task.schemas()[t.schema].pre[ t.steps[step].atom ];
+	std::vector<unsigned> bound;
+	if ( !unify( a, *m_facts[f], t.schema, binding, bound ) ) return;
+	join( t, step + 1, binding );
+	for ( unsigned i = 0; i < bound.size(); i++ )
+		binding[ bound[i] ] = -1;
+}
+
+void	Relaxed_Grounder::bind_free( unsigned s, unsigned i, std::vector<int>& binding ) {
+	if ( i == m_free_params[s].size() ) {
+		emit( s, binding );
+		return;
+	}
+	unsigned param = m_free_params[s][i];
+	const std::vector<unsigned>& objects = m_task.objects_of( m_task.schemas()[s].param_types[param] );
+	for ( unsigned o = 0; o < objects.size(); o++ ) {
+		binding[param] = objects[o];
+		bind_free( s, i + 1, binding );
+	}
+	binding[param] = -1;
+}
+
+void	Relaxed_Grounder::emit( unsigned s, const std::vector<int>& binding ) {
+	const Schema& schema = m_task.schemas()[s];
+	for ( unsigned i = 0; i < m_filters[s].size(); i++ )
+		if ( !holds( schema.pre[ m_filters[s][i] ], binding ) )
+			return;
+
+	Key inst( 1, s );
+	inst.insert( inst.end(), binding.begin(), binding.end() );
+	std::pair< Instance_Set::iterator, bool > r = m_instance_set.insert( inst );
+	if ( !r.second ) return;
+	m_instances.push_back( &*r.first );
+
+	fire( schema.add, binding );
+
+	for ( unsigned c = 0; c < schema.ceffs.size(); c++ ) {
+		std::vector<int> ext( binding );
+		std::vector< std::vector<int> > groundings;
+		ground_ceff( s, c, 0, ext, groundings );
+		for ( unsigned k = 0; k < groundings.size(); k++ ) {
+			if ( reached( schema.ceffs[c].pre, groundings[k] ) )
+				fire( schema.ceffs[c].add, groundings[k] );
+			else
+				m_pending.push_back( std::make_pair( &schema.ceffs[c], groundings[k] ) );
+		}
+	}
+}
+
+void	Relaxed_Grounder::fire( const std::vector<Atom>& adds, const std::vector<int>& binding ) {
+	Key g;
+	for ( unsigned k = 0; k < adds.size(); k++ ) {
+		ground_atom( adds[k], binding, g );
+		insert_fact( g );
+	}
+}
+
+// Bindings of the variables of conditional effect c for which the static
+// part of its condition holds
+void	Relaxed_Grounder::ground_ceff( unsigned s, unsigned c, unsigned i, std::vector<int>& binding, std::vector< std::vector<int> >& out ) const {
+	const Schema& schema = m_task.schemas()[s];
+	const Lifted_Task::Cond_Effect& ce = schema.ceffs[c];
+	if ( i == ce.param_names.size() ) {
+		for ( unsigned k = 0; k < ce.pre.size(); k++ ) {
+			const Atom& a = ce.pre[k];
+			bool fixed = a.negated || a.predicate == Lifted_Task::equality || m_task.is_static( a.predicate );
+			if ( fixed && !holds( a, binding ) ) return;
+		}
+		out.push_back( binding );
+		return;
+	}
+	if ( i == 0 )
+		binding.resize( schema.param_names.size() + ce.param_names.size(), -1 );
+	const std::vector<unsigned>& objects = m_task.objects_of( ce.param_types[i] );
+	for ( unsigned o = 0; o < objects.size(); o++ ) {
+		binding[ schema.param_names.size() + i ] = objects[o];
+		ground_ceff( s, c, i + 1, binding, out );
+	}
+}
+
+bool	Relaxed_Grounder::reached( const std::vector<Atom>& atoms, const std::vector<int>& binding ) const {
+	Key g;
+	for ( unsigned k = 0; k < atoms.size(); k++ ) {
+		if ( atoms[k].negated || atoms[k].predicate == Lifted_Task::equality ) continue;
+		ground_atom( atoms[k], binding, g );
+		if ( m_fact_ids.find( g ) == m_fact_ids.end() ) return false;
+	}
+	return true;
+}
+
+bool	Relaxed_Grounder::unify( const Atom& a, const Key& fact, unsigned s, std::vector<int>& binding, std::vector<unsigned>& bound ) const {
+	const Schema& schema = m_task.schemas()[s];
+	for ( unsigned j = 0; j < a.args.size(); j++ ) {
+		int arg = a.args[j];
+		int v = fact[j+1];
+		bool ok;
+		if ( !Lifted_Task::is_param( arg ) )
+			ok = ( arg == v );
+		else {
+			unsigned i = Lifted_Task::param_index( arg );
+			if ( binding[i] >= 0 )
+				ok = ( binding[i] == v );
+			else if ( ( ok = m_task.is_of_type( v, schema.param_types[i] ) ) ) {
+				binding[i] = v;
+				bound.push_back( i );
+			}
+		}
+		if ( !ok ) {
+			for ( unsigned b = 0; b < bound.size(); b++ )
+				binding[ bound[b] ] = -1;
+			bound.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+void	Relaxed_Grounder::ground_atom( const Atom& a, const std::vector<int>& binding, Key& k ) const {
+	k.resize( a.args.size() + 1 );
+	k[0] = a.predicate;
+	for ( unsigned j = 0; j < a.args.size(); j++ )
+		k[j+1] = Lifted_Task::is_param( a.args[j] ) ? binding[ Lifted_Task::param_index( a.args[j] ) ] : a.args[j];
+}
+
+bool	Relaxed_Grounder::holds( const Atom& a, const std::vector<int>& binding ) const {
+	Key g;
+	ground_atom( a, binding, g );
+	bool value;
+	if ( a.predicate == Lifted_Task::equality )
+		value = ( g[1] == g[2] );
+	else
+		// Negated atoms are static, so they are known since the start
+		value = ( m_fact_ids.find( g ) != m_fact_ids.end() );
+	return value != a.negated;
+}
+
+// Names are interned once for each predicate, schema and object, and
+// signatures made of them as FF would name the atoms and actions
+unsigned	Relaxed_Grounder::fact_signature( STRIPS_Problem& prob, const Key& k ) {
+	Index_Vec symbols( 1, intern( prob, m_predicate_symbols, k[0], m_task.predicate_name( k[0] ) ) );
+	for ( unsigned j = 1; j < k.size(); j++ )
+		symbols.push_back( intern( prob, m_object_symbols, k[j], m_task.object_name( k[j] ) ) );
+	return prob.intern_signature( symbols );
+}
+
+unsigned	Relaxed_Grounder::instance_signature( STRIPS_Problem& prob, const Key& k ) {
+	Index_Vec symbols( 1, intern( prob, m_schema_symbols, k[0], m_task.schemas()[ k[0] ].name ) );
+	for ( unsigned j = 1; j < k.size(); j++ )
+		symbols.push_back( intern( prob, m_object_symbols, k[j], m_task.object_name( k[j] ) ) );
+	return prob.intern_signature( symbols, k.size() == 1 );
+}
+
+unsigned	Relaxed_Grounder::intern( STRIPS_Problem& prob, Index_Vec& table, unsigned i, const std::string& name ) {
+	if ( i >= table.size() )
+		table.resize( i + 1, no_such_index );
+	if ( table[i] == no_such_index )
+		table[i] = prob.symbols().intern( name );
+	return table[i];
+}
+
+void	Relaxed_Grounder::ground( STRIPS_Problem& prob ) {
+	prob.set_domain_name( m_task.domain_name() );
+	prob.set_problem_name( m_task.problem_name() );
+	m_predicate_symbols.clear();
+	m_schema_symbols.clear();
+	m_object_symbols.clear();
+
+	Key g;
+	for ( unsigned k = 0; k < m_task.init().size(); k++ ) {
+		const Atom& a = m_task.init()[k];
+		g.assign( 1, a.predicate );
+		g.insert( g.end(), a.args.begin(), a.args.end() );
+		insert_fact( g );
+	}
+	for ( unsigned i = 0; i < m_unconditional.size(); i++ ) {
+		std::vector<int> binding( m_task.schemas()[ m_unconditional[i] ].param_names.size(), -1 );
+		bind_free( m_unconditional[i], 0, binding );
+	}
+	// m_facts doubles as the queue of atoms still to process, pending
+	// conditional effects are looked at again each time it runs out
+	unsigned f = 0;
+	while ( true ) {
+		for ( ; f < m_facts.size(); f++ )
+			process( f );
+		unsigned kept = 0;
+		for ( unsigned i = 0; i < m_pending.size(); i++ ) {
+			if ( reached( m_pending[i].first->pre, m_pending[i].second ) )
+				fire( m_pending[i].first->add, m_pending[i].second );
+			else
+				m_pending[kept++] = m_pending[i];
+		}
+		m_pending.resize( kept );
+		if ( f == m_facts.size() ) break;
+	}
+
+	// Atoms true at the start that no action deletes stay true, and
+	// are left out as those of static predicates are
+	std::vector<bool> rigid( m_facts.size(), false );
+	for ( unsigned k = 0; k < m_task.init().size(); k++ ) {
+		const Atom& a = m_task.init()[k];
+		g.assign( 1, a.predicate );
+		g.insert( g.end(), a.args.begin(), a.args.end() );
+		rigid[ m_fact_ids[g] ] = true;
+	}
+	for ( unsigned i = 0; i < m_instances.size(); i++ ) {
+		const Key& inst = *m_instances[i];
+		const Schema& schema = m_task.schemas()[ inst[0] ];
+		std::vector<int> binding( inst.begin() + 1, inst.end() );
+		for ( unsigned k = 0; k < schema.del.size(); k++ ) {
+			ground_atom( schema.del[k], binding, g );
+			Fact_Table::iterator it = m_fact_ids.find( g );
+			if ( it != m_fact_ids.end() ) rigid[ it->second ] = false;
+		}
+		for ( unsigned c = 0; c < schema.ceffs.size(); c++ ) {
+			std::vector< std::vector<int> > groundings;
+			ground_ceff( inst[0], c, 0, binding, groundings );
+			binding.resize( schema.param_names.size() );
+			for ( unsigned j = 0; j < groundings.size(); j++ ) {
+				if ( !reached( schema.ceffs[c].pre, groundings[j] ) ) continue;
+				for ( unsigned k = 0; k < schema.ceffs[c].del.size(); k++ ) {
+					ground_atom( schema.ceffs[c].del[k], groundings[j], g );
+					Fact_Table::iterator it = m_fact_ids.find( g );
+					if ( it != m_fact_ids.end() ) rigid[ it->second ] = false;
+				}
+			}
+		}
+	}
+
+	// Fluents are numbered by predicate and arguments rather than in the
+	// order they were reached, which keeps the successor generator small
+	std::vector<unsigned> order;
+	for ( unsigned f = 0; f < m_facts.size(); f++ )
+		if ( !rigid[f] && !m_task.is_static( (*m_facts[f])[0] ) )
+			order.push_back( f );
+	std::sort( order.begin(), order.end(), Fact_Order( m_facts ) );
+	std::vector<unsigned> fluent_of( m_facts.size(), no_such_index );
+	for ( unsigned i = 0; i < order.size(); i++ )
+		fluent_of[ order[i] ] = STRIPS_Problem::add_fluent( prob, fact_signature( prob, *m_facts[ order[i] ] ) );
+
+	for ( unsigned i = 0; i < m_instances.size(); i++ ) {
+		const Key& inst = *m_instances[i];
+		const Schema& schema = m_task.schemas()[ inst[0] ];
+		std::vector<int> binding( inst.begin() + 1, inst.end() );
+		Fluent_Vec pre, add, del;
+		Conditional_Effect_Vec ceffs;
+
+		for ( unsigned k = 0; k < schema.pre.size(); k++ ) {
+			const Atom& a = schema.pre[k];
+			if ( a.negated || m_task.is_static( a.predicate ) ) continue;
+			ground_atom( a, binding, g );
+			unsigned fl = fluent_of[ m_fact_ids[g] ];
+			if ( fl != no_such_index ) push_unique( pre, fl );
+		}
+		for ( unsigned k = 0; k < schema.add.size(); k++ ) {
+			ground_atom( schema.add[k], binding, g );
+			unsigned fl = fluent_of[ m_fact_ids[g] ];
+			if ( fl != no_such_index ) push_unique( add, fl );
+		}
+		// Deletes of atoms never reached do not matter, and adds win
+		// over deletes
+		for ( unsigned k = 0; k < schema.del.size(); k++ ) {
+			ground_atom( schema.del[k], binding, g );
+			Fact_Table::iterator it = m_fact_ids.find( g );
+			if ( it == m_fact_ids.end() ) continue;
+			unsigned fl = fluent_of[ it->second ];
+			if ( std::find( add.begin(), add.end(), fl ) == add.end() )
+				push_unique( del, fl );
+		}
+		for ( unsigned c = 0; c < schema.ceffs.size(); c++ ) {
+			const Lifted_Task::Cond_Effect& ce = schema.ceffs[c];
+			std::vector< std::vector<int> > groundings;
+			ground_ceff( inst[0], c, 0, binding, groundings );
+			binding.resize( schema.param_names.size() );
+			for ( unsigned j = 0; j < groundings.size(); j++ ) {
+				if ( !reached( ce.pre, groundings[j] ) ) continue;
+				Fluent_Vec ce_pre, ce_add, ce_del;
+				for ( unsigned k = 0; k < ce.pre.size(); k++ ) {
+					const Atom& a = ce.pre[k];
+					if ( a.negated || m_task.is_static( a.predicate ) ) continue;
+					ground_atom( a, groundings[j], g );
+					unsigned fl = fluent_of[ m_fact_ids[g] ];
+					if ( fl != no_such_index ) push_unique( ce_pre, fl );
+				}
+				for ( unsigned k = 0; k < ce.add.size(); k++ ) {
+					ground_atom( ce.add[k], groundings[j], g );
+					unsigned fl = fluent_of[ m_fact_ids[g] ];
+					if ( fl != no_such_index ) push_unique( ce_add, fl );
+				}
+				for ( unsigned k = 0; k < ce.del.size(); k++ ) {
+					ground_atom( ce.del[k], groundings[j], g );
+					Fact_Table::iterator it = m_fact_ids.find( g );
+					if ( it == m_fact_ids.end() ) continue;
+					unsigned fl = fluent_of[ it->second ];
+					if ( std::find( ce_add.begin(), ce_add.end(), fl ) == ce_add.end() )
+						push_unique( ce_del, fl );
+				}
+				if ( ce_add.empty() && ce_del.empty() ) continue;
+				// Effects whose conditions the action already requires
+				// are unconditional, as forall effects mostly are
+				bool implied = true;
+				for ( unsigned k = 0; k < ce_pre.size() && implied; k++ )
+					implied = std::find( pre.begin(), pre.end(), ce_pre[k] ) != pre.end();
+				if ( implied ) {
+					for ( unsigned k = 0; k < ce_add.size(); k++ ) {
+						push_unique( add, ce_add[k] );
+						del.erase( std::remove( del.begin(), del.end(), ce_add[k] ), del.end() );
+					}
+					for ( unsigned k = 0; k < ce_del.size(); k++ )
+						if ( std::find( add.begin(), add.end(), ce_del[k] ) == add.end() )
+							push_unique( del, ce_del[k] );
+					continue;
+				}
+				Conditional_Effect* eff = new Conditional_Effect( prob );
+				eff->define( ce_pre, ce_add, ce_del );
+				ceffs.push_back( eff );
+			}
+		}
+
+		float cost = 1.0f;
+		if ( m_task.has_costs() ) {
+			cost = schema.cost;
+			if ( schema.has_cost_term ) {
+				const Atom& t = schema.cost_term;
+				std::vector<int> args( t.args.size() );
+				for ( unsigned j = 0; j < t.args.size(); j++ )
+					args[j] = Lifted_Task::is_param( t.args[j] ) ? binding[ Lifted_Task::param_index( t.args[j] ) ] : t.args[j];
+				cost += m_task.value( t.predicate, args );
+			}
+		}
+		STRIPS_Problem::add_action( prob, instance_signature( prob, inst ), pre, add, del, ceffs, cost );
+	}
+
+	Fluent_Vec I, G;
+	for ( unsigned k = 0; k < m_task.init().size(); k++ ) {
+		const Atom& a = m_task.init()[k];
+		g.assign( 1, a.predicate );
+		g.insert( g.end(), a.args.begin(), a.args.end() );
+		unsigned fl = fluent_of[ m_fact_ids[g] ];
+		if ( fl != no_such_index ) push_unique( I, fl );
+	}
+	for ( unsigned k = 0; k < m_task.goal().size(); k++ ) {
+		const Atom& a = m_task.goal()[k];
+		g.assign( 1, a.predicate );
+		g.insert( g.end(), a.args.begin(), a.args.end() );
+		Fact_Table::iterator it = m_fact_ids.find( g );
+		if ( it != m_fact_ids.end() && fluent_of[ it->second ] != no_such_index )
+			push_unique( G, fluent_of[ it->second ] );
+		else if ( it == m_fact_ids.end() )
+			// Unreachable, the goal gets a fluent nothing adds
+			push_unique( G, STRIPS_Problem::add_fluent( prob, fact_signature( prob, g ) ) );
+		// else always true, nothing to achieve
+	}
+	STRIPS_Problem::set_init( prob, I );
+	STRIPS_Problem::set_goal( prob, G );
+	prob.make_action_tables();
+}
+
+}
+
+}
@@ -0,0 +1,157 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __RELAXED_GROUNDER__
+#define __RELAXED_GROUNDER__
+
+#include <lifted_task.hxx>
+#include <strips_prob.hxx>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace aptk {
+
+namespace agnostic {
+
+// Grounds a Lifted_Task into a STRIPS_Problem with the actions and atoms
+// reachable from the initial state when deletes are ignored.
+//
+// Reachability is computed as the fixpoint of the Datalog program given
+// by the schemas: each new atom is joined with the atoms found before it
+// through the positive preconditions of the schemas it can match. Atoms
+// are looked up in hash indices keyed by the arguments already bound, one
+// index for each predicate and set of bound positions the joins need, and
+// the order of the joins is fixed beforehand preferring the preconditions
+// with more arguments bound.
+//
+// Conditional effects are reached once the atoms of their conditions
+// are. Fluents are the reachable atoms some action can change, with the
+// names FF gives them, so plans and signatures can be compared.
+class Relaxed_Grounder {
+public:
+
+	// Throws std::runtime_error if task is out of the fragment handled,
+	// see Lifted_Task::validate()
+	Relaxed_Grounder( const Lifted_Task& task );
+	~Relaxed_Grounder();
+
+	// Adds fluents, actions, initial state and goal to prob and makes
+	// its action tables
+	void		ground( STRIPS_Problem& prob );
+
+	unsigned	num_reachable_atoms() const	{ return m_facts.size(); }
+	unsigned	num_ground_actions() const	{ return m_instances.size(); }
+
+protected:
+
+	typedef	std::vector<unsigned>	Key;
+
+	struct Key_Hash {
+		size_t operator()( const Key& k ) const {
+			size_t h = 2166136261u;
+			for ( unsigned i = 0; i < k.size(); i++ )
+				h = ( h ^ k[i] ) * 16777619u;
+			return h;
+		}
+	};
+
+	// Facts are keyed by predicate followed by arguments, instances by
+	// schema followed by the objects bound to its parameters
+	typedef std::unordered_map< Key, unsigned, Key_Hash >			Fact_Table;
+	typedef std::unordered_set< Key, Key_Hash >				Instance_Set;
+	typedef std::unordered_map< Key, std::vector<unsigned>, Key_Hash >	Index_Table;
+
+	struct Index {
+		unsigned	predicate;
+		unsigned	mask;
+		Index_Table	table;
+	};
+
+	enum Step_Kind { SCAN, LOOKUP, CHECK };
+
+	struct Join_Step {
+		unsigned	atom;
+		Step_Kind	kind;
+		unsigned	index;
+	};
+
+	// Joins to do when an atom of the predicate of precondition atom of
+	// schema appears
+	struct Trigger {
+		unsigned		schema;
+		unsigned		atom;
+		std::vector<Join_Step>	steps;
+	};
+
+	void		make_triggers( unsigned s );
+	unsigned	get_index( unsigned predicate, unsigned mask );
+
+	unsigned	insert_fact( const Key& k );
+	void		process( unsigned f );
+	void		join( const Trigger& t, unsigned step, std::vector<int>& binding );
+	void		join_with( const Trigger& t, unsigned step, unsigned f, std::vector<int>& binding );
+	void		bind_free( unsigned s, unsigned i, std::vector<int>& binding );
+	void		emit( unsigned s, const std::vector<int>& binding );
+	void		ground_ceff( unsigned s, unsigned c, unsigned i, std::vector<int>& binding, std::vector< std::vector<int> >& out ) const;
+	bool		reached( const std::vector<Lifted_Task::Atom>& atoms, const std::vector<int>& binding ) const;
+	void		fire( const std::vector<Lifted_Task::Atom>& adds, const std::vector<int>& binding );
+
+	bool		unify( const Lifted_Task::Atom& a, const Key& fact, unsigned s, std::vector<int>& binding, std::vector<unsigned>& bound ) const;
+	void		ground_atom( const Lifted_Task::Atom& a, const std::vector<int>& binding, Key& k ) const;
+	bool		holds( const Lifted_Task::Atom& a, const std::vector<int>& binding ) const;
+
+	unsigned	fact_signature( STRIPS_Problem& prob, const Key& k );
+	unsigned	instance_signature( STRIPS_Problem& prob, const Key& k );
+	unsigned	intern( STRIPS_Problem& prob, Index_Vec& table, unsigned i, const std::string& name );
+
+protected:
+
+	const Lifted_Task&			m_task;
+
+	std::vector<Trigger>			m_triggers;
+	std::vector< std::vector<unsigned> >	m_triggers_of;
+	std::vector<Index>			m_indices;
+	std::vector< std::vector<unsigned> >	m_indices_of;
+	// Schemas without positive preconditions, their parameters not in
+	// any of them and the preconditions checked once all are bound
+	std::vector<unsigned>			m_unconditional;
+	std::vector< std::vector<unsigned> >	m_free_params;
+	std::vector< std::vector<unsigned> >	m_filters;
+
+	Fact_Table				m_fact_ids;
+	std::vector<const Key*>			m_facts;
+	std::vector< std::vector<unsigned> >	m_facts_of;
+	Instance_Set				m_instance_set;
+	std::vector<const Key*>			m_instances;
+	// Conditional effects whose conditions were not reached yet, with
+	// all of their variables bound
+	std::vector< std::pair< const Lifted_Task::Cond_Effect*, std::vector<int> > >	m_pending;
+	// Symbols of the names in the problem grounded into
+	Index_Vec				m_predicate_symbols;
+	Index_Vec				m_schema_symbols;
+	Index_Vec				m_object_symbols;
+};
+
+}
+
+}
+
+#endif // relaxed_grounder.hxx
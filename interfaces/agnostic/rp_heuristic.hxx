@@ -184,11 +184,13 @@ public:
 	virtual ~Relaxed_Plan_Heuristic() {}
 
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 		std::vector<Action_Idx> po;
 		eval( s, h_val, po );
 	}
 	
 	virtual void eval( const State& s, float& h_val, std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		m_plan_extractor.compute( s, h_val, pref_ops );
 	}
 	
@@ -154,7 +154,7 @@ public:
 				/**
 				 * If all actions adding p edel q, then p must precede q
 				 */
-				const std::vector<const Action*>& add_acts_p = m_strips_model.actions_adding( p );
+				Action_Span add_acts_p = m_strips_model.actions_adding( p );
 				
 				bool all_actions_edel_q = true;
 				for ( unsigned k = 0; k < add_acts_p.size(); k++ ) {
@@ -170,7 +170,7 @@ public:
 				 * If all actions adding q edel p, then q must precede p
 				 */
 				
-				const std::vector<const Action*>& add_acts_q = m_strips_model.actions_adding( q );
+				Action_Span add_acts_q = m_strips_model.actions_adding( q );
 				bool all_actions_edel_p = true;
 				for ( unsigned k = 0; k < add_acts_q.size(); k++ ) {
 					//add_acts_q[k]->print( m_strips_model, std::cout );
@@ -210,24 +210,24 @@ public:
 			//processed.set(p);
 
 			//std::cout << "Processing landmark: " << m_strips_model.fluents()[ p ]->signature() << std::endl;
-			const std::vector<const Action*>& add_acts = m_strips_model.actions_adding( p );
+			Action_Span add_acts = m_strips_model.actions_adding( p );
 			//std::cout << "Added by " << add_acts.size() << " actions" << std::endl;
 			if ( !add_acts.empty() ) {
 				lm_set.reset();
-				lm_set.add( add_acts[0]->prec_set() );
+				add_acts[0]->prec_set().add_to( lm_set );
 	
 				for ( unsigned k = 1; k < add_acts.size(); k++ ) 
-					lm_set.set_intersection( add_acts[k]->prec_set() ); 
+					add_acts[k]->prec_set().intersect( lm_set ); 
 			}
 			
-			const std::vector< std::pair< unsigned, const Action*> >& add_acts_ce = 
+			Ceff_Span add_acts_ce = 
 				 m_strips_model.ceffs_adding( p );
 			
 			if ( !add_acts_ce.empty() ) {
 
 				for ( unsigned k = 0; k < add_acts_ce.size(); k++ ) {
-					lm_set.set_intersection( add_acts_ce[k].second->prec_set() );
-					lm_set.set_intersection( add_acts_ce[k].second->ceff_vec()[ add_acts_ce[k].first ]->prec_set() );
+					add_acts_ce[k].second->prec_set().intersect( lm_set );
+					add_acts_ce[k].second->ceff_vec()[ add_acts_ce[k].first ]->prec_set().intersect( lm_set );
 				}
 
 			}
@@ -273,6 +273,7 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val ) {
+		APTK_PHASE( HEURISTIC );
 		m_lm_cut.clear();
 		m_in_lm_cut.reset();
 
@@ -317,6 +318,7 @@ public:
 	}
 
 	virtual void eval( const State& s, float& h_val,  std::vector<Action_Idx>& pref_ops ) {
+		APTK_PHASE( HEURISTIC );
 		eval( s, h_val );
 		Successor_Generator::Iterator it( s, m_strips_model.successor_generator().nodes() );
 		int a = it.first();
@@ -357,24 +359,24 @@ protected:
 			//processed.set(p);
 
 			//std::cout << "Processing landmark: " << m_strips_model.fluents()[ p ]->signature() << std::endl;
-			const std::vector<const Action*>& add_acts = m_strips_model.actions_adding( p );
+			Action_Span add_acts = m_strips_model.actions_adding( p );
 			//std::cout << "Added by " << add_acts.size() << " actions" << std::endl;
 			if ( !add_acts.empty() ) {
 				lm_set.reset();
-				lm_set.add( add_acts[0]->prec_set() );
+				add_acts[0]->prec_set().add_to( lm_set );
 	
 				for ( unsigned k = 1; k < add_acts.size(); k++ ) 
-					lm_set.set_intersection( add_acts[k]->prec_set() ); 
+					add_acts[k]->prec_set().intersect( lm_set ); 
 			}
 			
-			const std::vector< std::pair< unsigned, const Action*> >& add_acts_ce = 
+			Ceff_Span add_acts_ce = 
 				 m_strips_model.ceffs_adding( p );
 			
 			if ( !add_acts_ce.empty() ) {
 
 				for ( unsigned k = 0; k < add_acts_ce.size(); k++ ) {
-					lm_set.set_intersection( add_acts_ce[k].second->prec_set() );
-					lm_set.set_intersection( add_acts_ce[k].second->ceff_vec()[ add_acts_ce[k].first ]->prec_set() );
+					add_acts_ce[k].second->prec_set().intersect( lm_set );
+					add_acts_ce[k].second->ceff_vec()[ add_acts_ce[k].first ]->prec_set().intersect( lm_set );
 				}
 
 			}
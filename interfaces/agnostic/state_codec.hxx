@@ -0,0 +1,71 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __STATE_CODEC__
+#define __STATE_CODEC__
+
+#include <fwd_search_prob.hxx>
+#include <strips_state.hxx>
+#include <vector>
+#include <cstdint>
+
+namespace aptk {
+
+namespace agnostic {
+
+// Packs states into 32-bit words, as the number of fluents followed by the
+// fluents themselves in the order they appear in the state, so that they
+// can be sent to other processes.
+class Fluent_State_Codec {
+public:
+	typedef	uint32_t	Word;
+
+	Fluent_State_Codec( const Fwd_Search_Problem& p )
+	: m_task( p.task() ) {
+	}
+
+	void	pack( const State& s, std::vector<Word>& out ) const {
+		const Fluent_Vec& fv = s.fluent_vec();
+		out.push_back( fv.size() );
+		for ( unsigned k = 0; k < fv.size(); k++ )
+			out.push_back( fv[k] );
+	}
+
+	// Sets used to the number of words read
+	State*	unpack( const Word* in, unsigned& used ) const {
+		State* s = new State( m_task );
+		unsigned n = in[0];
+		for ( unsigned k = 0; k < n; k++ )
+			s->set( in[k+1] );
+		s->update_hash();
+		used = n + 1;
+		return s;
+	}
+
+protected:
+
+	const STRIPS_Problem&	m_task;
+};
+
+}
+
+}
+
+#endif // state_codec.hxx
@@ -21,9 +21,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <strips_prob.hxx>
 #include <action.hxx>
 #include <fluent.hxx>
+#include <cond_eff.hxx>
 #include <cassert>
+#include <algorithm>
 #include <map>
 #include <iostream>
+#include <stdexcept>
 
 namespace aptk
 {
@@ -31,46 +34,104 @@ namespace aptk
 	STRIPS_Problem::STRIPS_Problem( std::string dom_name, std::string prob_name )
 		: m_domain_name(dom_name), m_problem_name( prob_name ), 
 		m_num_fluents( 0 ), m_num_actions( 0 ), m_end_operator_id( no_such_index ),
-		m_succ_gen( *this )
+		m_num_indexed( 0 ), m_dense_sets_limit( 1 << 26 ), m_has_dense_sets( false ),
+		m_succ_gen( *this ), m_ceffs_adding( 2 ), m_tables_made( false ), m_has_edeleting( false )
 	{
 	}
 
 	STRIPS_Problem::~STRIPS_Problem()
 	{
+		for ( unsigned k = 0; k < m_actions.size(); k++ ) {
+			for ( unsigned i = 0; i < m_actions[k]->ceff_vec().size(); i++ )
+				delete m_actions[k]->ceff_vec()[i];
+			delete m_actions[k];
+		}
+		for ( unsigned k = 0; k < m_fluents.size(); k++ )
+			delete m_fluents[k];
 	}
 
 	void	STRIPS_Problem::make_action_tables()
 	{
-		m_requiring.resize( fluents().size() );
-		m_deleting.resize( fluents().size() );
-		m_edeleting.resize( fluents().size() );
-		m_adding.resize( fluents().size() );
-		m_ceffs_adding.resize( fluents().size() );
-		
-		for ( unsigned k = 0; k < actions().size(); k++ )
-			register_action_in_tables( actions()[k] );
+		m_has_dense_sets = (size_t)num_actions() * num_fluents() <= m_dense_sets_limit;
+		if ( m_has_dense_sets )
+			for ( unsigned k = 0; k < actions().size(); k++ )
+				actions()[k]->make_dense_sets( num_fluents() );
+
+		make_fluent_action_tables();
 		
 		m_succ_gen.build();
+		m_tables_made = true;
+	}
+
+	// The lists are laid out by counting the actions of each fluent first,
+	// then filled in action order, as they used to be when they were grown
+	// one action at a time
+	void	STRIPS_Problem::make_fluent_action_tables()
+	{
+		m_requiring.reset( fluents().size() );
+		m_deleting.reset( fluents().size() );
+		m_edeleting.reset( fluents().size() );
+		m_adding.reset( fluents().size() );
+		m_ceffs_adding.reset( fluents().size() );
+		m_empty_precs.clear();
+
+		for ( unsigned k = 0; k < actions().size(); k++ )
+			if ( is_enabled( k ) )
+				count_action_in_tables( actions()[k] );
+
+		m_requiring.start();
+		m_deleting.start();
+		m_adding.start();
+		m_ceffs_adding.start();
+
+		for ( unsigned k = 0; k < actions().size(); k++ )
+			if ( is_enabled( k ) )
+				register_action_in_tables( actions()[k] );
 	}
 
-	void	STRIPS_Problem::register_action_in_tables( Action* a )
+	size_t	STRIPS_Problem::fluent_action_tables_bytes() const
+	{
+		return m_requiring.bytes() + m_deleting.bytes() + m_edeleting.bytes()
+			+ m_adding.bytes() + m_ceffs_adding.bytes();
+	}
+
+	void	STRIPS_Problem::set_actions_edeleting( const std::vector< std::pair<unsigned, unsigned> >& pairs )
+	{
+		m_edeleting.assign( fluents().size(), pairs );
+		m_has_edeleting = true;
+	}
+
+	void	STRIPS_Problem::count_action_in_tables( const Action* a )
+	{
+		for ( unsigned k = 0; k < a->prec_vec().size(); k++ )
+			m_requiring.count( a->prec_vec()[k] );
+		for ( unsigned k = 0; k < a->add_vec().size(); k++ )
+			m_adding.count( a->add_vec()[k] );
+		for ( unsigned k = 0; k < a->ceff_vec().size(); k++ )
+			for ( unsigned i = 0; i < a->ceff_vec()[k]->add_vec().size(); i++ )
+				m_ceffs_adding.count( a->ceff_vec()[k]->add_vec()[i] );
+		for ( unsigned k = 0; k < a->del_vec().size(); k++ )
+			m_deleting.count( a->del_vec()[k] );
+	}
+
+	void	STRIPS_Problem::register_action_in_tables( const Action* a )
 	{
 		if ( a->prec_vec().empty() ) {
 			m_empty_precs.push_back(a);
 		}
 		else {
 			for ( unsigned k = 0; k < a->prec_vec().size(); k++ )
-				actions_requiring(a->prec_vec()[k]).push_back( a );
+				m_requiring.add( a->prec_vec()[k], a->index() );
 		}
 		for ( unsigned k = 0; k < a->add_vec().size(); k++ )
-			actions_adding(a->add_vec()[k]).push_back(a);
+			m_adding.add( a->add_vec()[k], a->index() );
 
 		for ( unsigned k = 0; k < a->ceff_vec().size(); k++ )
 			for ( unsigned i = 0; i < a->ceff_vec()[k]->add_vec().size(); i++ )
-				ceffs_adding( a->ceff_vec()[k]->add_vec()[i] ).push_back( std::make_pair( k, a ) );
+				m_ceffs_adding.add( a->ceff_vec()[k]->add_vec()[i], k, a->index() );
 
 		for ( unsigned k = 0; k < a->del_vec().size(); k++ )
-			actions_deleting(a->del_vec()[k]).push_back(a);	
+			m_deleting.add( a->del_vec()[k], a->index() );
 		
 		//register conditional effects
 		/*
@@ -86,9 +147,107 @@ namespace aptk
 		*/
 	}
 	
+	static bool	index_less( const Action* x, const Action* y )
+	{
+		return x->index() < y->index();
+	}
+
+	void	STRIPS_Problem::put_in_tables( Action* a )
+	{
+		if ( m_has_dense_sets )
+			a->make_dense_sets( num_fluents() );
+
+		unsigned i = a->index();
+		if ( a->prec_vec().empty() )
+			m_empty_precs.insert( std::upper_bound( m_empty_precs.begin(), m_empty_precs.end(), a, index_less ), a );
+		for ( unsigned k = 0; k < a->prec_vec().size(); k++ )
+			m_requiring.insert( a->prec_vec()[k], &i );
+		for ( unsigned k = 0; k < a->add_vec().size(); k++ )
+			m_adding.insert( a->add_vec()[k], &i );
+		for ( unsigned k = 0; k < a->ceff_vec().size(); k++ )
+			for ( unsigned j = 0; j < a->ceff_vec()[k]->add_vec().size(); j++ ) {
+				unsigned entry[2] = { k, i };
+				m_ceffs_adding.insert( a->ceff_vec()[k]->add_vec()[j], entry );
+			}
+		for ( unsigned k = 0; k < a->del_vec().size(); k++ )
+			m_deleting.insert( a->del_vec()[k], &i );
+		if ( m_has_edeleting )
+			for ( const unsigned* p = a->edel_set().begin(); p != a->edel_set().end(); p++ )
+				m_edeleting.insert( *p, &i );
+
+		m_succ_gen.add_action( a );
+	}
+
+	void	STRIPS_Problem::take_out_of_tables( const Action* a )
+	{
+		unsigned i = a->index();
+		if ( a->prec_vec().empty() ) {
+			std::vector<const Action*>::iterator it = std::lower_bound( m_empty_precs.begin(), m_empty_precs.end(), a, index_less );
+			if ( it != m_empty_precs.end() && *it == a )
+				m_empty_precs.erase( it );
+		}
+		for ( unsigned k = 0; k < a->prec_vec().size(); k++ )
+			m_requiring.erase( a->prec_vec()[k], i );
+		for ( unsigned k = 0; k < a->add_vec().size(); k++ )
+			m_adding.erase( a->add_vec()[k], i );
+		for ( unsigned k = 0; k < a->ceff_vec().size(); k++ )
+			for ( unsigned j = 0; j < a->ceff_vec()[k]->add_vec().size(); j++ )
+				m_ceffs_adding.erase( a->ceff_vec()[k]->add_vec()[j], i );
+		for ( unsigned k = 0; k < a->del_vec().size(); k++ )
+			m_deleting.erase( a->del_vec()[k], i );
+		for ( const unsigned* p = a->edel_set().begin(); p != a->edel_set().end(); p++ )
+			m_edeleting.erase( *p, i );
+
+		m_succ_gen.remove_action( a );
+	}
+
+	void	STRIPS_Problem::set_action_enabled( unsigned a, bool enabled )
+	{
+		if ( enabled && m_removed[a] )
+			throw std::runtime_error( "STRIPS_Problem: action " + actions()[a]->signature() + " was removed" );
+		if ( m_enabled[a] == enabled ) return;
+		m_enabled[a] = enabled;
+		if ( !m_tables_made ) return;
+		if ( enabled )
+			put_in_tables( actions()[a] );
+		else
+			take_out_of_tables( actions()[a] );
+	}
+
+	void	STRIPS_Problem::remove_action( unsigned a )
+	{
+		set_action_enabled( a, false );
+		m_removed[a] = true;
+	}
+
+	void	STRIPS_Problem::set_action_cost( unsigned a, float cost )
+	{
+		actions()[a]->set_cost( cost );
+	}
+
+	void	STRIPS_Problem::update_goal( Fluent_Vec& goal_vec )
+	{
+		set_goal( *this, goal_vec, false );
+		if ( m_end_operator_id == no_such_index ) return;
+
+		Action* end = actions()[ m_end_operator_id ];
+		bool in_tables = m_tables_made && is_enabled( m_end_operator_id );
+		if ( in_tables ) take_out_of_tables( end );
+		end->prec_vec().assign( goal_vec.begin(), goal_vec.end() );
+		end->prec_set().assign( end->prec_vec() );
+		if ( in_tables ) put_in_tables( end );
+	}
+
 	unsigned STRIPS_Problem::add_action( STRIPS_Problem& p, std::string signature,
 					     Fluent_Vec& pre, Fluent_Vec& add, Fluent_Vec& del,
 					     Conditional_Effect_Vec& ceffs, float cost )
+	{
+		return add_action( p, p.intern_signature( signature ), pre, add, del, ceffs, cost );
+	}
+
+	unsigned STRIPS_Problem::add_action( STRIPS_Problem& p, unsigned signature,
+					     Fluent_Vec& pre, Fluent_Vec& add, Fluent_Vec& del,
+					     Conditional_Effect_Vec& ceffs, float cost )
 	{
 		Action* new_act = new Action( p );
 		new_act->set_signature( signature );
@@ -98,21 +257,159 @@ namespace aptk
 		new_act->set_index( p.actions().size()-1 );
 		new_act->set_cost( cost );
 		p.m_const_actions.push_back( new_act );
+		p.m_enabled.push_back( true );
+		p.m_removed.push_back( false );
+		if ( p.m_tables_made )
+			p.put_in_tables( new_act );
 		return p.actions().size()-1;
 	}
 
 	unsigned STRIPS_Problem::add_fluent( STRIPS_Problem& p, std::string signature )
+	{
+		return add_fluent( p, p.intern_signature( signature ) );
+	}
+
+	unsigned STRIPS_Problem::add_fluent( STRIPS_Problem& p, unsigned signature )
 	{
 		Fluent* new_fluent = new Fluent( p );
 		new_fluent->set_index( p.fluents().size() );
 		new_fluent->set_signature( signature );
-		p.m_fluents_map[signature] = new_fluent->index();
 		p.increase_num_fluents();
 		p.fluents().push_back( new_fluent );
 		p.m_const_fluents.push_back( new_fluent );
+		p.index_fluent( new_fluent->index() );
+		if ( p.m_tables_made ) {
+			p.m_requiring.add_fluent();
+			p.m_deleting.add_fluent();
+			p.m_edeleting.add_fluent();
+			p.m_adding.add_fluent();
+			p.m_ceffs_adding.add_fluent();
+			if ( !p.m_in_init.empty() ) p.m_in_init.push_back( false );
+			if ( !p.m_in_goal.empty() ) p.m_in_goal.push_back( false );
+			if ( p.m_has_dense_sets )
+				for ( unsigned k = 0; k < p.actions().size(); k++ )
+					p.actions()[k]->make_dense_sets( p.num_fluents() );
+		}
 		return p.fluents().size()-1;
 	}
 
+	// Splits (A B C) into the spans of its symbols, false if the signature
+	// is not of that form
+	static bool	split_signature( const std::string& sig, std::vector< std::pair<size_t,size_t> >& spans, bool& blank )
+	{
+		size_t n = sig.size();
+		spans.clear();
+		blank = false;
+		if ( n < 3 || sig[0] != '(' || sig[n-1] != ')' ) return false;
+		for ( size_t i = 1; ; ) {
+			size_t j = i;
+			while ( j < n - 1 && sig[j] != ' ' && sig[j] != '(' && sig[j] != ')' ) j++;
+			if ( j == i || sig[j] == '(' || ( sig[j] == ')' && j != n - 1 ) )
+				return false;
+			spans.push_back( std::make_pair( i, j - i ) );
+			if ( j == n - 1 ) return true;
+			if ( j == n - 2 ) {
+				blank = true;
+				return true;
+			}
+			i = j + 1;
+		}
+	}
+
+	unsigned	STRIPS_Problem::intern_signature( const std::string& signature )
+	{
+		std::vector< std::pair<size_t,size_t> > spans;
+		bool blank;
+		unsigned sig = m_signatures.size();
+		if ( !split_signature( signature, spans, blank ) ) {
+			m_signatures.push_back( 0 );
+			m_signatures.push_back( m_symbols.intern( signature ) );
+			return sig;
+		}
+		m_signatures.push_back( 2 * spans.size() + ( blank ? 1 : 0 ) );
+		for ( unsigned k = 0; k < spans.size(); k++ )
+			m_signatures.push_back( m_symbols.intern( signature.data() + spans[k].first, spans[k].second ) );
+		return sig;
+	}
+
+	unsigned	STRIPS_Problem::intern_signature( const Index_Vec& symbols, bool blank_before_close )
+	{
+		if ( symbols.empty() )
+			return intern_signature( blank_before_close ? "( )" : "()" );
+		unsigned sig = m_signatures.size();
+		m_signatures.push_back( 2 * symbols.size() + ( blank_before_close ? 1 : 0 ) );
+		m_signatures.insert( m_signatures.end(), symbols.begin(), symbols.end() );
+		return sig;
+	}
+
+	std::string	STRIPS_Problem::signature( unsigned sig ) const
+	{
+		unsigned header = m_signatures[sig];
+		if ( header == 0 )
+			return m_symbols.name( m_signatures[sig+1] );
+		std::string str( "(" );
+		for ( unsigned k = 0; k < header / 2; k++ ) {
+			if ( k > 0 ) str += " ";
+			str += m_symbols.name( m_signatures[sig+1+k] );
+		}
+		if ( header & 1 ) str += " ";
+		str += ")";
+		return str;
+	}
+
+	// Code of a signature, header first, as in m_signatures
+	static inline unsigned	code_length( const unsigned* code )
+	{
+		return code[0] == 0 ? 2 : 1 + code[0] / 2;
+	}
+
+	size_t	STRIPS_Problem::hash_signature( const unsigned* code ) const
+	{
+		size_t h = 14695981039346656037ULL;
+		for ( unsigned k = 0; k < code_length( code ); k++ )
+			h = ( h ^ code[k] ) * 1099511628211ULL;
+		return h;
+	}
+
+	bool	STRIPS_Problem::same_signature( unsigned sig, const unsigned* code ) const
+	{
+		const unsigned* other = &m_signatures[sig];
+		unsigned n = code_length( code );
+		if ( code_length( other ) != n ) return false;
+		for ( unsigned k = 0; k < n; k++ )
+			if ( other[k] != code[k] ) return false;
+		return true;
+	}
+
+	// Slot of the fluent with that signature, or the free slot where it
+	// would go
+	unsigned	STRIPS_Problem::find_fluent_slot( const unsigned* code ) const
+	{
+		size_t mask = m_fluent_slots.size() - 1;
+		for ( size_t i = hash_signature( code ) & mask; ; i = ( i + 1 ) & mask ) {
+			unsigned f = m_fluent_slots[i];
+			if ( f == no_such_index || same_signature( m_fluents[f]->signature_id(), code ) )
+				return i;
+		}
+	}
+
+	// Fluents added later win over earlier ones with the same signature
+	void	STRIPS_Problem::index_fluent( unsigned f )
+	{
+		if ( 2 * ( m_num_indexed + 1 ) > m_fluent_slots.size() ) {
+			m_fluent_slots.assign( std::max( (size_t)64, 2 * m_fluent_slots.size() ), no_such_index );
+			m_num_indexed = 0;
+			for ( unsigned g = 0; g < f; g++ ) {
+				unsigned i = find_fluent_slot( &m_signatures[ m_fluents[g]->signature_id() ] );
+				if ( m_fluent_slots[i] == no_such_index ) m_num_indexed++;
+				m_fluent_slots[i] = g;
+			}
+		}
+		unsigned i = find_fluent_slot( &m_signatures[ m_fluents[f]->signature_id() ] );
+		if ( m_fluent_slots[i] == no_such_index ) m_num_indexed++;
+		m_fluent_slots[i] = f;
+	}
+
 	void	STRIPS_Problem::set_init( STRIPS_Problem& p, Fluent_Vec& init_vec )
 	{
 #ifdef DEBUG
@@ -163,9 +460,25 @@ namespace aptk
 		}
 	}
 
-        unsigned STRIPS_Problem::get_fluent_index( std::string signature ) {
-              return m_fluents_map[signature];
-        }
+	unsigned STRIPS_Problem::get_fluent_index( std::string signature ) const
+	{
+		if ( m_fluent_slots.empty() ) return no_such_index;
+		std::vector< std::pair<size_t,size_t> > spans;
+		bool blank;
+		Index_Vec code;
+		if ( !split_signature( signature, spans, blank ) ) {
+			code.push_back( 0 );
+			code.push_back( m_symbols.find( signature ) );
+		}
+		else {
+			code.push_back( 2 * spans.size() + ( blank ? 1 : 0 ) );
+			for ( unsigned k = 0; k < spans.size(); k++ )
+				code.push_back( m_symbols.find( signature.data() + spans[k].first, spans[k].second ) );
+		}
+		if ( std::find( code.begin() + 1, code.end(), no_such_index ) != code.end() )
+			return no_such_index;
+		return m_fluent_slots[ find_fluent_slot( &code[0] ) ];
+	}
 
 	void	STRIPS_Problem::print( std::ostream& os ) const {
 		os << "# Fluents: " << num_fluents() << std::endl;
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <iosfwd>
 #include <types.hxx>
 #include <succ_gen.hxx>
+#include <symbol_table.hxx>
+#include <fluent_action_table.hxx>
 
 namespace aptk
 {
@@ -54,6 +56,13 @@ namespace aptk
 
 		static unsigned 	add_fluent( STRIPS_Problem& p, std::string signature );
 
+		// Same as above, with a signature from intern_signature()
+		static unsigned 	add_action( STRIPS_Problem& p, unsigned signature,
+						    Fluent_Vec& pre, Fluent_Vec& add, Fluent_Vec& del,
+						    Conditional_Effect_Vec& ceffs, float cost = 1.0f );
+
+		static unsigned 	add_fluent( STRIPS_Problem& p, unsigned signature );
+
 		static void		set_init( STRIPS_Problem& p, Fluent_Vec& init );
 		static void		set_goal( STRIPS_Problem& p, Fluent_Vec& goal, bool createEndOp = false );
 
@@ -71,30 +80,22 @@ namespace aptk
 		const Fluent_Vec&	init() const  			{ return m_init; }
 		const Fluent_Vec&	goal() const  			{ return m_goal; }
 
-		std::vector<const Action*>&		
-					actions_adding( unsigned f )		{ return m_adding[f]; }
-
-		std::vector< std::pair< unsigned, const Action*> >&
-					ceffs_adding( unsigned f )		{ return m_ceffs_adding[f]; }
-
-		const std::vector< std::pair< unsigned, const Action*> >&
-					ceffs_adding( unsigned f ) const	{ return m_ceffs_adding[f]; }
-
-		std::vector<const Action*>&		
-					actions_deleting( unsigned f )		{ return m_deleting[f]; }
+		// Lists of actions for each fluent, made by make_action_tables().
+		// The actions edeleting a fluent are left empty until they are set
+		// with set_actions_edeleting(), see H2_Heuristic::compute_edeletes().
+		Action_Span		actions_adding( unsigned f ) const	{ return action_span( m_adding, f ); }
+		Action_Span		actions_deleting( unsigned f ) const	{ return action_span( m_deleting, f ); }
+		Action_Span		actions_edeleting( unsigned f ) const	{ return action_span( m_edeleting, f ); }
+		Action_Span		actions_requiring( unsigned f ) const	{ return action_span( m_requiring, f ); }
+		// Pairs of the index of the conditional effect within its action
+		// and the action
+		Ceff_Span		ceffs_adding( unsigned f ) const {
+			return Ceff_Span( m_ceffs_adding.row_begin( f ), m_ceffs_adding.row_end( f ), m_const_actions.data() );
+		}
 
-		std::vector<const Action*>&		
-					actions_edeleting( unsigned f )		{ return m_edeleting[f]; }
-		std::vector<const Action*>&		
-					actions_requiring( unsigned f )		{ return m_requiring[f]; }
-		const std::vector<const Action*>&		
-					actions_adding( unsigned f ) const	{ return m_adding[f]; }
-		const std::vector<const Action*>&		
-					actions_deleting( unsigned f ) const	{ return m_deleting[f]; }
-		const std::vector<const Action*>&		
-					actions_edeleting( unsigned f ) const	{ return m_edeleting[f]; }
-		const std::vector<const Action*>&		
-					actions_requiring( unsigned f ) const	{ return m_requiring[f]; }
+		// Pairs of fluent and action index, in the order wanted for the
+		// actions of each fluent
+		void			set_actions_edeleting( const std::vector< std::pair<unsigned, unsigned> >& pairs );
 
 		const std::vector<const Action*>&
 					empty_prec_actions() const 		{ return m_empty_precs; }
@@ -115,11 +116,53 @@ namespace aptk
 		bool			is_in_goal( unsigned f )	{ return m_in_goal[f]; }
 
 		void                    print_fluent_vec(const Fluent_Vec &a);
-		unsigned                end_operator() { return m_end_operator_id; }
-	        unsigned                get_fluent_index(std::string signature);
+		unsigned                end_operator() const { return m_end_operator_id; }
+		// no_such_index if there is no fluent with that signature
+	        unsigned                get_fluent_index( std::string signature ) const;
+
+		// Signatures are kept as the symbols between their parentheses and
+		// made into strings only when asked for. Those not of the form
+		// (A B C) are kept whole as a single symbol, and blank_before_close
+		// gives (A ), as FF names actions with no arguments.
+		Symbol_Table&		symbols()			{ return m_symbols; }
+		const Symbol_Table&	symbols() const			{ return m_symbols; }
+		unsigned		intern_signature( const std::string& signature );
+		unsigned		intern_signature( const Index_Vec& symbols, bool blank_before_close = false );
+		std::string		signature( unsigned sig ) const;
+
+		// Dense fluent sets are made for the actions if there are at most
+		// this many (action, fluent) pairs, see Compact_Fluent_Set
+		void			set_dense_sets_limit( size_t pairs )	{ m_dense_sets_limit = pairs; }
+		size_t			dense_sets_limit() const		{ return m_dense_sets_limit; }
+		bool			has_dense_sets() const			{ return m_has_dense_sets; }
+		Index_Vec&		fluent_pool()				{ return m_fluent_pool; }
 
 		void			make_action_tables();
 
+		// Changes to a task whose tables are made, for replanning. Each of
+		// them patches the lists of actions of the fluents the action
+		// touches and its path in the successor generator, and nothing
+		// else. Actions added with add_action() and fluents added with
+		// add_fluent() are put into the tables too, and set_init() can be
+		// called at any time.
+		//
+		// Actions keep their indices. Disabled actions stay in actions(),
+		// but are taken out of the tables and the successor generator, and
+		// the heuristics that go over all actions skip them. Removed
+		// actions are disabled for good.
+		void			set_action_enabled( unsigned a, bool enabled );
+		bool			is_enabled( unsigned a ) const		{ return m_enabled[a]; }
+		void			remove_action( unsigned a );
+		bool			is_removed( unsigned a ) const		{ return m_removed[a]; }
+		void			set_action_cost( unsigned a, float cost );
+		// Same as set_goal(), changing the preconditions of the end
+		// operator if there is one
+		void			update_goal( Fluent_Vec& goal );
+
+		// Only the lists of actions of each fluent, done by make_action_tables()
+		void			make_fluent_action_tables();
+		size_t			fluent_action_tables_bytes() const;
+
 		void			print( std::ostream& os ) const;
 		void			print_fluents( std::ostream& os ) const;
 		void			print_actions( std::ostream& os ) const;
@@ -131,7 +174,18 @@ namespace aptk
 	
 		void			increase_num_fluents()        	{ m_num_fluents++; }
 		void			increase_num_actions()        	{ m_num_actions++; }
-		void			register_action_in_tables( Action* act );
+		void			count_action_in_tables( const Action* act );
+		void			register_action_in_tables( const Action* act );
+		void			put_in_tables( Action* act );
+		void			take_out_of_tables( const Action* act );
+		Action_Span		action_span( const Fluent_Action_Table& t, unsigned f ) const {
+			return Action_Span( t.row_begin( f ), t.row_end( f ), m_const_actions.data() );
+		}
+
+		size_t			hash_signature( const unsigned* code ) const;
+		bool			same_signature( unsigned sig, const unsigned* code ) const;
+		unsigned		find_fluent_slot( const unsigned* code ) const;
+		void			index_fluent( unsigned f );
 
 	protected:
 
@@ -152,10 +206,26 @@ namespace aptk
 		std::vector<bool>	 				m_in_init;
 		std::vector<bool>	 				m_in_goal;
 		unsigned                 				m_end_operator_id;
-	  	std::map<std::string,int> 				m_fluents_map;
+		Symbol_Table						m_symbols;
+		// Each signature is a header, the number of symbols times two plus
+		// one if there is a blank before the closing parenthesis, followed
+		// by the symbols. A header of zero is followed by a whole signature.
+		Index_Vec						m_signatures;
+		// Open addressing over the signatures of the fluents, no_such_index
+		// for free slots
+		Index_Vec						m_fluent_slots;
+		unsigned						m_num_indexed;
+		// Sorted preconditions and effects of all the actions
+		Index_Vec						m_fluent_pool;
+		size_t							m_dense_sets_limit;
+		bool							m_has_dense_sets;
 		agnostic::Successor_Generator				m_succ_gen;
 		std::vector< const  Action* >   			m_empty_precs;
-		std::vector< std::vector< std::pair< unsigned, const Action* > > >	m_ceffs_adding;
+		Fluent_Action_Table					m_ceffs_adding;
+		bool							m_tables_made;
+		bool							m_has_edeleting;
+		Bool_Vec						m_enabled;
+		Bool_Vec						m_removed;
 	  };
 
 }
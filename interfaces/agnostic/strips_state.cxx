@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <fluent.hxx>
 #include <aptk/hash_table.hxx>
 #include <aptk/resources_control.hxx>
+#include <aptk/probes.hxx>
 #include <iostream>
 #include <cassert>
 
@@ -32,13 +33,23 @@ namespace aptk
 State::State( const STRIPS_Problem& problem )
 	: m_fluent_set( problem.num_fluents() ), m_problem( problem )
 {
+	Memory_Budget::instance().allocated( Memory_Budget::STATES, tracked_bytes() );
+}
+
+State::State( const State& other )
+	: m_fluent_vec( other.m_fluent_vec ), m_fluent_set( other.m_fluent_set ), m_problem( other.m_problem ),
+	m_hash( other.m_hash )
+{
+	Memory_Budget::instance().allocated( Memory_Budget::STATES, tracked_bytes() );
 }
 
 State::~State()
 {
+	Memory_Budget::instance().released( Memory_Budget::STATES, tracked_bytes() );
 }
 
 void	State::update_hash() {
+	APTK_PHASE( HASHING );
 	Hash_Key hasher;
 	hasher.add( fluent_set().bits() );
 	m_hash = (size_t)hasher;	
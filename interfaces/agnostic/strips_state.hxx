@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <strips_prob.hxx>
 #include <types.hxx>
 #include <fluent.hxx>
+#include <aptk/memory.hxx>
 #include <iostream>
 
 namespace aptk
@@ -35,6 +36,7 @@ class State
 {
 public:
 	State( const STRIPS_Problem& p );
+	State( const State& other );
 	~State();
 
 	Fluent_Vec& fluent_vec() 		{ return m_fluent_vec; }
@@ -68,6 +70,9 @@ public:
 
 protected:
 
+	// Counted as part of Memory_Budget::STATES, all but the fluent vector
+	size_t	tracked_bytes() const	{ return sizeof(State) + m_fluent_set.bits().npacks() * sizeof(unsigned); }
+
 	Fluent_Vec			m_fluent_vec;
 	Fluent_Set			m_fluent_set;
 	const STRIPS_Problem&		m_problem;
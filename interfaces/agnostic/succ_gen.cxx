@@ -60,167 +60,297 @@ void	Successor_Generator::build_fluent_ordering( std::vector<unsigned>& ord_flue
 	//std::sort( ord_fluents.begin(), ord_fluents.end(), Fluent_Cmp( m_problem ) );
 }
 
+static bool	depth_less( const std::pair< unsigned, const Action* >& x, const std::pair< unsigned, const Action* >& y ) {
+	return x.first < y.first;
+}
+
+// Nodes are made only for the fluents some action still requires, and the
+// actions requiring no more of them go to a leaf right away. The chain of
+// don't care children is made in a loop, as it can be as long as the
+// ordering.
 unsigned Successor_Generator::make_nodes( unsigned index, std::vector<unsigned>& F, const std::vector<const Action*>& acts ) {
 	if ( acts.empty() ) return no_such_index;
 
-	// Leaf Node
-	if ( index == F.size() ) {
-		Node* n = new Node;
-		unsigned node_index = m_nodes.size();
-		m_nodes.push_back(n);
-		for ( unsigned k = 0; k < acts.size(); k++ )
-			n->actions().push_back( acts[k] );
-		return node_index;
-	}
+	// Actions by the first depth they require, in the order given otherwise
+	std::vector< std::pair< unsigned, const Action* > >	keyed( acts.size() );
+	for ( unsigned k = 0; k < acts.size(); k++ )
+		keyed[k] = std::make_pair( first_required( acts[k], index ), acts[k] );
+	std::stable_sort( keyed.begin(), keyed.end(), depth_less );
+
+	unsigned first = no_such_index;
+	Node* last = NULL;
+	unsigned remaining = acts.size();
+	for ( unsigned k = 0; k < keyed.size(); ) {
+		unsigned depth = keyed[k].first;
+		std::vector<const Action*>	group;
+		for ( ; k < keyed.size() && keyed[k].first == depth; k++ )
+			group.push_back( keyed[k].second );
+		remaining -= group.size();
 
-	// Split action set
-	std::vector<const Action*>	true_set;
-	std::vector<const Action*>	dont_care_set;
-	for ( unsigned k = 0; k < acts.size(); k++ ) {
-		if ( acts[k]->prec_set().isset( F[index] ) )
-			true_set.push_back( acts[k] );
+		unsigned node_index = m_nodes.size();
+		Node* n;
+		// Leaf Node
+		if ( depth == F.size() ) {
+			n = new Node;
+			m_nodes.push_back(n);
+			n->actions().swap( group );
+		}
+		else {
+			n = new Node( F[depth] );
+			m_nodes.push_back(n);
+			n->set_true_num_actions( group.size() );
+			n->set_dont_care_num_actions( remaining );
+			n->set_true_child( make_nodes( depth + 1, F, group ) );
+		}
+		if ( last == NULL )
+			first = node_index;
 		else
-			dont_care_set.push_back( acts[k] ); 
+			last->set_dont_care_child( node_index );
+		last = n;
 	}
+	return first;
+} 
 
-	Node* n = new Node( F[index] );
-	unsigned node_index = m_nodes.size(); 
-	m_nodes.push_back(n);
-	n->set_true_num_actions( true_set.size() );
-	n->set_dont_care_num_actions( dont_care_set.size() );
+void	Successor_Generator::build() {
+
+	make_tree();
+	std::cout << "Successor generator built, with " << m_nodes.size() << " nodes" << std::endl;
+}
 
-	if ( !true_set.empty() ) {
-		unsigned true_child = make_nodes( index + 1, F, true_set );
-		n->set_true_child( true_child );
+void	Successor_Generator::make_tree() {
+	for ( unsigned k = 0; k < m_nodes.size(); k++ )
+		delete m_nodes[k];
+	m_nodes.clear();
+	m_unused_nodes = 0;
+
+	m_ordering.clear();
+	build_fluent_ordering( m_ordering );
+	m_depth.assign( m_problem.num_fluents(), no_such_index );
+	for ( unsigned k = 0; k < m_ordering.size(); k++ )
+		m_depth[ m_ordering[k] ] = k;
+
+	std::vector<const Action*> actions;
+	for ( unsigned k = 0; k < m_problem.actions().size(); k++ )
+		if ( m_problem.is_enabled( k ) )
+			actions.push_back( m_problem.actions()[k] );
+	make_nodes( 0, m_ordering, actions );
+}
+
+static bool	index_less( const Action* x, const Action* y ) {
+	return x->index() < y->index();
+}
+
+unsigned	Successor_Generator::first_required( const Action* a, unsigned index ) const {
+	unsigned first = m_ordering.size();
+	for ( unsigned k = 0; k < a->prec_vec().size(); k++ ) {
+		unsigned d = m_depth[ a->prec_vec()[k] ];
+		if ( d >= index && d < first ) first = d;
 	}
+	return first;
+}
 
-	if ( !dont_care_set.empty() ) {
-		unsigned dont_care_child = make_nodes( index + 1, F, dont_care_set );
-		n->set_dont_care_child( dont_care_child );
+void	Successor_Generator::add_action( const Action* a ) {
+	for ( unsigned k = 0; k < a->prec_vec().size(); k++ ) {
+		unsigned p = a->prec_vec()[k];
+		if ( p >= m_depth.size() ) m_depth.resize( p + 1, no_such_index );
+		if ( m_depth[p] != no_such_index ) continue;
+		m_depth[p] = m_ordering.size();
+		m_ordering.push_back( p );
 	}
 
-	return node_index;
-} 
+	std::vector<const Action*> single( 1, a );
+	if ( m_nodes.empty() ) {
+		make_nodes( 0, m_ordering, single );
+		return;
+	}
 
-void	Successor_Generator::build() {
+	unsigned n = 0;
+	for ( unsigned index = 0; ; ) {
+		Node* node = m_nodes[n];
+		unsigned depth = node->selection_node() ? m_depth[ node->selection_fluent() ] : m_ordering.size();
+		unsigned next = first_required( a, index );
+		if ( next == m_ordering.size() && !node->selection_node() ) {
+			std::vector<const Action*>& acts = node->actions();
+			acts.insert( std::upper_bound( acts.begin(), acts.end(), a, index_less ), a );
+			return;
+		}
+		if ( next < depth ) {
+			// The fluent a requires next is not tested on the way here, a
+			// node testing it takes the place of this one, which is moved
+			// to the end and becomes its don't care child
+			unsigned count = node->selection_node() ?
+				node->true_num_actions() + node->dont_care_num_actions() : node->actions().size();
+			Node* test = new Node( m_ordering[next] );
+			m_nodes[n] = test;
+			test->set_dont_care_child( m_nodes.size() );
+			test->set_dont_care_num_actions( count );
+			m_nodes.push_back( node );
+			test->set_true_child( make_nodes( next + 1, m_ordering, single ) );
+			test->set_true_num_actions( 1 );
+			return;
+		}
 
-	std::vector<unsigned> ordered_fluent_set;
-	build_fluent_ordering(ordered_fluent_set);
-	make_nodes( 0, ordered_fluent_set, m_problem.actions() );	
-	std::cout << "Successor generator built, with " << m_nodes.size() << " nodes" << std::endl;
+		bool required = next == depth;
+		unsigned child = required ? node->true_child() : node->dont_care_child();
+		if ( child == no_such_index ) {
+			child = make_nodes( depth + 1, m_ordering, single );
+			if ( required ) {
+				node->set_true_child( child );
+				node->set_true_num_actions( 1 );
+			}
+			else {
+				node->set_dont_care_child( child );
+				node->set_dont_care_num_actions( 1 );
+			}
+			return;
+		}
+		if ( required )
+			node->set_true_num_actions( node->true_num_actions() + 1 );
+		else
+			node->set_dont_care_num_actions( node->dont_care_num_actions() + 1 );
+		n = child;
+		index = depth + 1;
+	}
+}
+
+void	Successor_Generator::remove_action( const Action* a ) {
+	if ( m_nodes.empty() ) return;
+
+	// Nodes on the way to the leaf of a, and whether a went to the true child
+	std::vector< std::pair< unsigned, bool > > path;
+	unsigned n = 0;
+	while ( m_nodes[n]->selection_node() ) {
+		const Node* node = m_nodes[n];
+		bool required = a->prec_set().isset( node->selection_fluent() );
+		unsigned child = required ? node->true_child() : node->dont_care_child();
+		if ( child == no_such_index ) return;
+		path.push_back( std::make_pair( n, required ) );
+		n = child;
+	}
+	std::vector<const Action*>& acts = m_nodes[n]->actions();
+	std::vector<const Action*>::iterator it = std::lower_bound( acts.begin(), acts.end(), a, index_less );
+	if ( it == acts.end() || *it != a ) return;
+	acts.erase( it );
+
+	// The highest subtree left without actions is unlinked, it can only
+	// be the rest of the path
+	unsigned cut = no_such_index;
+	for ( unsigned k = path.size(); k-- > 0; ) {
+		Node* node = m_nodes[ path[k].first ];
+		unsigned count;
+		if ( path[k].second ) {
+			count = node->true_num_actions() - 1;
+			node->set_true_num_actions( count );
+		}
+		else {
+			count = node->dont_care_num_actions() - 1;
+			node->set_dont_care_num_actions( count );
+		}
+		if ( count == 0 ) cut = k;
+	}
+	if ( cut != no_such_index ) {
+		Node* node = m_nodes[ path[cut].first ];
+		if ( path[cut].second )
+			node->set_true_child( no_such_index );
+		else
+			node->set_dont_care_child( no_such_index );
+		m_unused_nodes += path.size() - cut;
+	}
+
+	if ( 2 * m_unused_nodes > m_nodes.size() )
+		make_tree();
 }
 
+// The tree is walked depth first, with the true child of a node before
+// its don't care child, so the actions come in the order of the leaves
 
 void	Successor_Generator::retrieve_applicable( const State& s, std::vector<int>& actions ) const {
-	std::deque<const Node*> open;
+	if ( m_nodes.empty() ) return;
+	std::vector<const Node*> open;
 	open.push_back( m_nodes[0] );
 	while ( !open.empty() ) {
-		const Node* n = open.front();
-		open.pop_front();
+		const Node* n = open.back();
+		open.pop_back();
 		if ( !n->selection_node() ) {
 			for ( unsigned k = 0; k < n->actions().size(); k++ )
 				actions.push_back( n->actions()[k]->index() );
 			continue;
 		}
-		if ( s.entails( n->selection_fluent() ) ) {
-			if ( n->true_child() != no_such_index ) { 
-				open.push_back( m_nodes[n->true_child()] );
-			}
-		}
-		if ( n->dont_care_child() != no_such_index ) {
-			open.push_back( m_nodes[n->dont_care_child()] );	
-		}
+		if ( n->dont_care_child() != no_such_index )
+			open.push_back( m_nodes[n->dont_care_child()] );
+		if ( n->true_child() != no_such_index && s.entails( n->selection_fluent() ) )
+			open.push_back( m_nodes[n->true_child()] );
 	}
 }
 
 void	Successor_Generator::retrieve_applicable( const State& s, std::vector<const Action*>& actions ) const {
-
-	std::deque<const Node*> open;
+	if ( m_nodes.empty() ) return;
+	std::vector<const Node*> open;
 	open.push_back( m_nodes[0] );
 	while ( !open.empty() ) {
-		const Node* n = open.front();
-		open.pop_front();
+		const Node* n = open.back();
+		open.pop_back();
 		if ( !n->selection_node() ) {
 			for ( unsigned k = 0; k < n->actions().size(); k++ )
 				actions.push_back( n->actions()[k] );
 			continue;
 		}
-		if ( s.entails( n->selection_fluent() ) ) {
-			if ( n->true_child() != no_such_index ) 
-				open.push_back( m_nodes[n->true_child()] );
-		}
 		if ( n->dont_care_child() != no_such_index )
-			open.push_back( m_nodes[n->dont_care_child()] );	
+			open.push_back( m_nodes[n->dont_care_child()] );
+		if ( n->true_child() != no_such_index && s.entails( n->selection_fluent() ) )
+			open.push_back( m_nodes[n->true_child()] );
 	}
-
 }
 
 void	Successor_Generator::retrieve_applicable( const std::vector<float>& v, std::vector<const Action*>& actions ) const {
-
-	std::deque<const Node*> open;
+	if ( m_nodes.empty() ) return;
+	std::vector<const Node*> open;
 	open.push_back( m_nodes[0] );
 	while ( !open.empty() ) {
-		const Node* n = open.front();
-		open.pop_front();
-		//std::cout << n->selection_fluent() << " " << n->true_num_actions()<< " " << n->dont_care_num_actions() << " " << n->true_child() << " " << n->dont_care_child() << std::endl;
+		const Node* n = open.back();
+		open.pop_back();
 		if ( !n->selection_node() ) {
-			for ( unsigned k = 0; k < n->actions().size(); k++ ) {
+			for ( unsigned k = 0; k < n->actions().size(); k++ )
 				actions.push_back( n->actions()[k] );
-				//std::cout << "Retrieved: " << n->actions()[k]->signature() << std::endl;
-			}
 			continue;
 		}
-		if ( v[n->selection_fluent()] != infty ) {
-			if ( n->true_child() != no_such_index ) { 
-				open.push_back( m_nodes[n->true_child()] );
-			}
-		}
-		if ( n->dont_care_child() != no_such_index ) {
-			open.push_back( m_nodes[n->dont_care_child()] );	
-		}
+		if ( n->dont_care_child() != no_such_index )
+			open.push_back( m_nodes[n->dont_care_child()] );
+		if ( n->true_child() != no_such_index && v[n->selection_fluent()] != infty )
+			open.push_back( m_nodes[n->true_child()] );
 	}
-
 }
 
 Successor_Generator::Iterator::Iterator( const State& s, const std::vector<Node*>& nodes )
 	: m_state(s), m_nodes( nodes ), m_current_node( NULL ), m_index(no_such_index) {
-	m_open.resize( m_nodes.size() );
+	m_open.reserve( 64 );
 }
 
 Successor_Generator::Iterator::~Iterator() {
 }
 
 int	Successor_Generator::Iterator::first( ) {
-	//m_open.push_back( m_nodes[0] );
-	m_open_index = 0;
-	m_open[m_open_index] = true;
+	if ( m_nodes.empty() ) return -1;
+	m_open.clear();
+	m_open.push_back( 0 );
 	return advance();
 }
 
 int	Successor_Generator::Iterator::advance( ) {
-	//while ( !m_open.empty() ) {
-	for ( ; m_open_index < m_open.size(); m_open_index++ ) { 
-		//const Node* n = m_open.front();
-		//m_open.pop_front();
-		if ( !m_open[m_open_index] ) continue;
-		const Node* n = m_nodes[m_open_index];
+	while ( !m_open.empty() ) {
+		const Node* n = m_nodes[ m_open.back() ];
+		m_open.pop_back();
 		if ( !n->selection_node() ) {
+			// Leaves emptied by Successor_Generator::remove_action()
+			if ( n->actions().empty() ) continue;
 			m_current_node = n;
 			m_index = 0;
-			m_open[m_open_index] = false;
 			return n->actions()[m_index++]->index();
 		}
-		if ( m_state.entails( n->selection_fluent() ) ) {
-			if ( n->true_child() != no_such_index ) { 
-				//m_open.push_back( m_nodes[n->true_child()] );
-				m_open[ n->true_child() ] = true;
-			}
-		}
-		if ( n->dont_care_child() != no_such_index ) {
-			//m_open.push_back( m_nodes[n->dont_care_child()] );	
-			m_open[ n->dont_care_child() ] = true;
-		}
-		m_open[m_open_index] = false;
+		if ( n->dont_care_child() != no_such_index )
+			m_open.push_back( n->dont_care_child() );
+		if ( n->true_child() != no_such_index && m_state.entails( n->selection_fluent() ) )
+			m_open.push_back( n->true_child() );
 	}
 	return -1;	
 }
@@ -240,27 +370,25 @@ Successor_Generator::Heuristic_Iterator::~Heuristic_Iterator() {
 }
 
 int	Successor_Generator::Heuristic_Iterator::first( ) {
+	if ( m_nodes.empty() ) return -1;
 	m_open.push_back( m_nodes[0] );
 	return advance();
 }
 
 int	Successor_Generator::Heuristic_Iterator::advance( ) {
 	while ( !m_open.empty() ) {
-		const Node* n = m_open.front();
-		m_open.pop_front();
+		const Node* n = m_open.back();
+		m_open.pop_back();
 		if ( !n->selection_node() ) {
+			if ( n->actions().empty() ) continue;
 			m_current_node = n;
 			m_index = 0;
 			return n->actions()[m_index++]->index();
 		}
-		if ( m_values[n->selection_fluent()] != infty ) {
-			if ( n->true_child() != no_such_index ) { 
-				m_open.push_back( m_nodes[n->true_child()] );
-			}
-		}
-		if ( n->dont_care_child() != no_such_index ) {
-			m_open.push_back( m_nodes[n->dont_care_child()] );	
-		}
+		if ( n->dont_care_child() != no_such_index )
+			m_open.push_back( m_nodes[n->dont_care_child()] );
+		if ( n->true_child() != no_such_index && m_values[n->selection_fluent()] != infty )
+			m_open.push_back( m_nodes[n->true_child()] );
 	}
 	return -1;	
 }
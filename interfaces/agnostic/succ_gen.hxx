@@ -47,6 +47,7 @@ class	Successor_Generator {
 		~Node() {}
 
 		unsigned	selection_fluent() const { return m_selection_fluent; }
+		void		set_selection_fluent( unsigned p ) { m_selection_fluent = p; }
 
 		std::vector<const Action*>&		actions() { return m_actions; }
 		const std::vector<const Action*>&	actions() const { return m_actions; }
@@ -88,9 +89,8 @@ public:
 		const std::vector<Node*>&	m_nodes;
 		const Node*			m_current_node;
 		unsigned			m_index;
-		//std::deque<const Node*>		m_open;
-		std::vector<bool>		m_open;
-		unsigned			m_open_index;
+		// Indices of the nodes left to visit
+		std::vector<unsigned>		m_open;
 	};
 
 	class	Heuristic_Iterator {
@@ -107,18 +107,24 @@ public:
 		const std::vector<Node*>&	m_nodes;
 		const Node*			m_current_node;
 		unsigned			m_index;
-		std::deque<const Node*>		m_open;
+		std::vector<const Node*>	m_open;
 	};
 
 
 	Successor_Generator( const STRIPS_Problem& prob ) 
-	: m_problem( prob ) {
+	: m_problem( prob ), m_unused_nodes( 0 ) {
 	}
 
 	~Successor_Generator();
 
 	void	build();
 
+	// Changes to the tree once it is built. Only the path of the action
+	// is changed. Nodes left without actions are unlinked, and the tree
+	// is built again once more than half of them are.
+	void	add_action( const Action* a );
+	void	remove_action( const Action* a );
+
 	void	retrieve_applicable( const State& s, std::vector<const Action*>& actions ) const;	
 	void	retrieve_applicable( const State& s, std::vector<int>& actions ) const;
 	void	retrieve_applicable( const std::vector<float>& v, std::vector<const Action*>& actions ) const;
@@ -129,11 +135,21 @@ protected:
 
 	void		build_fluent_ordering( std::vector<unsigned>& ord_fluents );
 	unsigned	make_nodes( unsigned index, std::vector<unsigned>& ord_fluents, const std::vector<const Action*>& actions );
+	void		make_tree();
+	// Depth of the first fluent from index on that a requires, the size
+	// of the ordering if there is none
+	unsigned	first_required( const Action* a, unsigned index ) const;
 
 private:
 
 	const STRIPS_Problem&		m_problem;
 	std::vector<Node*>		m_nodes;
+	// Fluents tested at each depth of the tree, and the depth at which
+	// each fluent is tested. Fluents first required by actions added
+	// after the tree is built go at the bottom.
+	std::vector<unsigned>		m_ordering;
+	std::vector<unsigned>		m_depth;
+	unsigned			m_unused_nodes;
 };
 
 }
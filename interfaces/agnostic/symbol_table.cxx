@@ -0,0 +1,100 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <symbol_table.hxx>
+
+namespace aptk {
+
+static inline char	upper( char c ) {
+	return ( c >= 'a' && c <= 'z' ) ? c - 'a' + 'A' : c;
+}
+
+Symbol_Table::Symbol_Table( bool fold_case )
+	: m_fold_case( fold_case ), m_slots( 64, no_such_index ) {
+}
+
+Symbol_Table::~Symbol_Table() {
+}
+
+size_t	Symbol_Table::hash( const char* s, size_t len ) const {
+	size_t h = 14695981039346656037ULL;
+	if ( m_fold_case )
+		for ( size_t i = 0; i < len; i++ )
+			h = ( h ^ (unsigned char)upper( s[i] ) ) * 1099511628211ULL;
+	else
+		for ( size_t i = 0; i < len; i++ )
+			h = ( h ^ (unsigned char)s[i] ) * 1099511628211ULL;
+	return h;
+}
+
+bool	Symbol_Table::equal( unsigned id, const char* s, size_t len ) const {
+	const std::string& n = m_names[id];
+	if ( n.size() != len ) return false;
+	if ( !m_fold_case )
+		return n.compare( 0, len, s, len ) == 0;
+	for ( size_t i = 0; i < len; i++ )
+		if ( n[i] != upper( s[i] ) ) return false;
+	return true;
+}
+
+// Slot holding the name, or the free slot where it would go
+unsigned	Symbol_Table::slot( size_t h, const char* s, size_t len ) const {
+	size_t mask = m_slots.size() - 1;
+	for ( size_t i = h & mask; ; i = ( i + 1 ) & mask ) {
+		unsigned id = m_slots[i];
+		if ( id == no_such_index || ( m_hashes[id] == h && equal( id, s, len ) ) )
+			return i;
+	}
+}
+
+unsigned	Symbol_Table::find( const char* s, size_t len ) const {
+	return m_slots[ slot( hash( s, len ), s, len ) ];
+}
+
+unsigned	Symbol_Table::intern( const char* s, size_t len ) {
+	size_t h = hash( s, len );
+	unsigned i = slot( h, s, len );
+	if ( m_slots[i] != no_such_index ) return m_slots[i];
+
+	unsigned id = m_names.size();
+	m_names.push_back( std::string( s, len ) );
+	if ( m_fold_case )
+		for ( size_t k = 0; k < len; k++ )
+			m_names.back()[k] = upper( s[k] );
+	m_hashes.push_back( h );
+	m_slots[i] = id;
+	// Kept at most half full
+	if ( 2 * m_names.size() > m_slots.size() )
+		grow();
+	return id;
+}
+
+void	Symbol_Table::grow() {
+	m_slots.assign( 2 * m_slots.size(), no_such_index );
+	size_t mask = m_slots.size() - 1;
+	for ( unsigned id = 0; id < m_names.size(); id++ ) {
+		size_t i = m_hashes[id] & mask;
+		while ( m_slots[i] != no_such_index )
+			i = ( i + 1 ) & mask;
+		m_slots[i] = id;
+	}
+}
+
+}
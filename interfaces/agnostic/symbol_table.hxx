@@ -0,0 +1,69 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SYMBOL_TABLE__
+#define __SYMBOL_TABLE__
+
+#include <types.hxx>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace aptk {
+
+// Maps names to consecutive numbers, in the order they are first seen.
+// Lookups take a pointer and a length, so names can be found straight
+// from the buffer they were read into, and a copy is made only of the
+// names not seen before. With fold_case, names are compared ignoring
+// case and kept in upper case, as PDDL and FF want them.
+class Symbol_Table {
+public:
+	Symbol_Table( bool fold_case = false );
+	~Symbol_Table();
+
+	unsigned		intern( const char* s, size_t len );
+	unsigned		intern( const std::string& s )		{ return intern( s.data(), s.size() ); }
+
+	// no_such_index when there is no such name
+	unsigned		find( const char* s, size_t len ) const;
+	unsigned		find( const std::string& s ) const	{ return find( s.data(), s.size() ); }
+
+	const std::string&	name( unsigned id ) const		{ return m_names[id]; }
+	unsigned		size() const				{ return m_names.size(); }
+
+protected:
+
+	size_t		hash( const char* s, size_t len ) const;
+	bool		equal( unsigned id, const char* s, size_t len ) const;
+	unsigned	slot( size_t h, const char* s, size_t len ) const;
+	void		grow();
+
+protected:
+
+	bool				m_fold_case;
+	std::vector<std::string>	m_names;
+	std::vector<size_t>		m_hashes;
+	// Open addressing, no_such_index for free slots
+	std::vector<unsigned>		m_slots;
+};
+
+}
+
+#endif // symbol_table.hxx
@@ -44,7 +44,6 @@ namespace aptk
 	typedef 	std::vector<Action* >				Action_Ptr_Vec;
 	typedef 	std::vector<Fluent* >				Fluent_Ptr_Vec;
 	typedef		std::vector<Conditional_Effect* > 		Conditional_Effect_Vec;
-	typedef		std::vector< std::vector< const Action* > >	Fluent_Action_Table;
 	typedef         std::vector< Action_Ptr_Vec >           	PDDLop_Action_Table;
 	typedef		std::vector< Fluent_Ptr_Vec >	        	Type_Fluent_Table;
 	typedef		std::vector< Fluent_Ptr_Vec >	        	Object_Fluent_Table;
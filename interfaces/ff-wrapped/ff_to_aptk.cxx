@@ -21,17 +21,95 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <ff_to_aptk.hxx>
 #include <action.hxx>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <libff/libff.h>
 
 namespace aptk
 {
 
 namespace  FF_Parser {
 
+// Gives the calling thread a context of its own for as long as the task
+// is being read, so several threads can read tasks at the same time, and
+// puts back whatever context the thread had before
+class Scoped_Context {
+public:
+	Scoped_Context() : m_saved( ff_ctx ) {
+		ff_ctx = FF_create_context();
+	}
+
+	~Scoped_Context() {
+		release();
+	}
+
+	// Frees all of the memory FF used for the task
+	void	release() {
+		if ( ff_ctx == m_saved ) return;
+		FF_destroy_context( ff_ctx );
+		ff_ctx = m_saved;
+	}
+
+protected:
+	FF_Context*	m_saved;
+};
+
+// Interns the names FF gives to facts and actions symbol by symbol, so no
+// string is made for each of them. Those FF names some other way, like
+// (REACH-GOAL) or the equalities, still go through FF's own names.
+class Signatures {
+public:
+	Signatures( STRIPS_Problem& p )
+		: m_problem( p ), m_predicates( gnum_predicates, no_such_index ),
+		m_constants( gnum_constants, no_such_index ) {
+	}
+
+	unsigned	fluent( int index ) {
+		Fact* f = &(grelevant_facts[index]);
+		if ( f->predicate < 0 )
+			return m_problem.intern_signature( FF::get_ft_name( index ) );
+		m_symbols.assign( 1, intern( m_predicates[ f->predicate ], gpredicates[ f->predicate ] ) );
+		for ( int j = 0; j < garity[f->predicate]; j++ ) {
+			if ( f->args[j] < 0 )
+				return m_problem.intern_signature( FF::get_ft_name( index ) );
+			m_symbols.push_back( constant( f->args[j] ) );
+		}
+		return m_problem.intern_signature( m_symbols );
+	}
+
+	unsigned	action( ::Action* a ) {
+		if ( !a->norm_operator && !a->pseudo_action )
+			return m_problem.intern_signature( FF::get_op_name( a ) );
+		m_symbols.assign( 1, m_problem.symbols().intern( a->name ) );
+		for ( int i = 0; i < a->num_name_vars; i++ )
+			m_symbols.push_back( constant( a->name_inst_table[i] ) );
+		// FF leaves a blank after the name
+		return m_problem.intern_signature( m_symbols, a->num_name_vars == 0 );
+	}
+
+protected:
+	unsigned	intern( unsigned& id, const char* name ) {
+		if ( id == no_such_index )
+			id = m_problem.symbols().intern( name );
+		return id;
+	}
+
+	unsigned	constant( int c ) {
+		return intern( m_constants[c], gconstants[c] );
+	}
+
+	STRIPS_Problem&		m_problem;
+	Index_Vec		m_predicates;
+	Index_Vec		m_constants;
+	Index_Vec		m_symbols;
+};
+
 void	get_problem_description( std::string pddl_domain_path,
 					std::string pddl_problem_path,
 					STRIPS_Problem& strips_problem,
 					bool get_detailed_fluent_names )
 {
+	Scoped_Context	context;
 
 	FF_parse_problem( pddl_domain_path.c_str(), pddl_problem_path.c_str() );
 	//	std::cout << "FF-preprocessing of PDDL problem description" << std::endl;
@@ -41,17 +119,9 @@ void	get_problem_description( std::string pddl_domain_path,
 	strips_problem.set_domain_name( FF::get_domain_name() );
 	strips_problem.set_problem_name( FF::get_problem_name() );
 
+	Signatures signatures( strips_problem );
 	for ( int i = 0; i < gnum_ft_conn; i++ )
-	{
-		if ( !get_detailed_fluent_names )
-		{
-			std::string ft_name = FF::get_ft_name(i);
-			STRIPS_Problem::add_fluent( strips_problem, ft_name);
-			continue;
-		}
-		std::string ft_signature = FF::get_ft_name(i);
-		STRIPS_Problem::add_fluent( strips_problem, ft_signature  );
-	}
+		STRIPS_Problem::add_fluent( strips_problem, signatures.fluent(i) );
 	Fluent_Vec I, G;
 	FF::get_initial_state( I );
 	FF::get_goal_state( G );
@@ -74,7 +144,7 @@ void	get_problem_description( std::string pddl_domain_path,
 		{
 			if( ! (gop_conn[i].action) ) continue;
 
-			std::string op_name = FF::get_op_name( gop_conn[i].action );
+			unsigned op_name = signatures.action( gop_conn[i].action );
 			
 			Fluent_Vec op_precs;
 
@@ -134,7 +204,7 @@ void	get_problem_description( std::string pddl_domain_path,
 			if ( gef_conn[i].removed == TRUE ) continue;
 			if ( gef_conn[i].illegal == TRUE ) continue;
 
-			std::string op_name = FF::get_op_name(i);
+			unsigned op_name = signatures.action( gop_conn[ gef_conn[i].op ].action );
 			Fluent_Vec  op_precs, op_adds, op_dels;
 			Conditional_Effect_Vec cond_effects;
 
@@ -164,9 +234,128 @@ void	get_problem_description( std::string pddl_domain_path,
 			strips_problem.actions()[op_idx]->set_cost( op_cost );
 		}
 	}
+	// Everything is copied by now, FF's tables can go before the
+	// action tables are made
+	context.release();
 	strips_problem.make_action_tables();
 }
 
+typedef std::map< std::string, unsigned >	Param_Table;
+
+static void	unsupported( std::string what ) {
+	throw std::runtime_error( "FF_Parser: " + what + " not supported by the lifted grounder" );
+}
+
+static agnostic::Lifted_Task::Atom	make_atom( agnostic::Lifted_Task& task, TokenList* atom, const Param_Table& params, bool negated ) {
+	agnostic::Lifted_Task::Atom a;
+	a.negated = negated;
+	a.predicate = task.find_predicate( atom->item );
+	if ( a.predicate == no_such_index )
+		throw std::runtime_error( std::string( "FF_Parser: unknown predicate " ) + atom->item );
+	for ( TokenList* t = atom->next; t; t = t->next ) {
+		if ( t->item[0] == '?' ) {
+			Param_Table::const_iterator it = params.find( t->item );
+			if ( it == params.end() )
+				throw std::runtime_error( std::string( "FF_Parser: unknown variable " ) + t->item );
+			a.args.push_back( agnostic::Lifted_Task::param( it->second ) );
+			continue;
+		}
+		unsigned o = task.find_object( t->item );
+		if ( o == no_such_index )
+			throw std::runtime_error( std::string( "FF_Parser: unknown object " ) + t->item );
+		a.args.push_back( o );
+	}
+	return a;
+}
+
+// Collects the literals of a conjunction
+static void	get_literals( agnostic::Lifted_Task& task, PlNode* n, const Param_Table& params, std::vector<agnostic::Lifted_Task::Atom>& atoms ) {
+	switch ( n->connective ) {
+	case TRU:
+		break;
+	case AND:
+		for ( PlNode* s = n->sons; s; s = s->next )
+			get_literals( task, s, params, atoms );
+		break;
+	case ATOM:
+		atoms.push_back( make_atom( task, n->atom, params, false ) );
+		break;
+	case NOT:
+		if ( n->sons->connective != ATOM )
+			unsupported( "Negation of formulae" );
+		atoms.push_back( make_atom( task, n->sons->atom, params, true ) );
+		break;
+	case OR:
+	case EX:
+	case ALL:
+		unsupported( "Disjunction and quantification" );
+	default:
+		unsupported( "Numeric or constant formulae" );
+	}
+}
+
+void	get_lifted_task( std::string pddl_domain_path,
+			std::string pddl_problem_path,
+			agnostic::Lifted_Task& task )
+{
+	Scoped_Context	context;
+
+	if ( FF_parse_problem( pddl_domain_path.c_str(), pddl_problem_path.c_str() ) != 0 )
+		throw std::runtime_error( "FF_Parser: could not parse " + pddl_domain_path );
+
+	task.set_domain_name( FF::get_domain_name() );
+	task.set_problem_name( FF::get_problem_name() );
+
+	// One pair for each type an object belongs to, supertypes included
+	for ( FactList* f = gorig_constant_list; f; f = f->next )
+		task.add_to_type( task.add_object( f->item->item ), task.add_type( f->item->next->item ) );
+
+	for ( FactList* f = gpredicates_and_types; f; f = f->next ) {
+		unsigned arity = 0;
+		for ( TokenList* t = f->item->next; t; t = t->next )
+			arity++;
+		task.add_predicate( f->item->item, arity );
+	}
+
+	for ( PlOperator* op = gloaded_ops; op; op = op->next ) {
+		agnostic::Lifted_Task::Schema s;
+		Param_Table params;
+		s.name = op->name;
+		for ( FactList* p = op->params; p; p = p->next ) {
+			params[ p->item->item ] = s.param_names.size();
+			s.param_names.push_back( p->item->item );
+			s.param_types.push_back( task.add_type( p->item->next->item ) );
+		}
+		get_literals( task, op->preconds, params, s.pre );
+
+		// Effects are a conjunction of WHEN nodes, unconditional ones
+		// have TRU as condition
+		for ( PlNode* w = op->effects->sons; w; w = w->next ) {
+			if ( w->connective != WHEN || w->sons->connective != TRU )
+				unsupported( "Conditional and quantified effects" );
+			for ( PlNode* l = w->sons->next->sons; l; l = l->next ) {
+				if ( l->connective == ATOM )
+					s.add.push_back( make_atom( task, l->atom, params, false ) );
+				else if ( l->connective == NOT )
+					s.del.push_back( make_atom( task, l->sons->atom, params, false ) );
+				else
+					unsupported( "Numeric effects" );
+			}
+		}
+		task.add_schema( s );
+	}
+
+	std::vector<agnostic::Lifted_Task::Atom> atoms;
+	Param_Table no_params;
+	get_literals( task, gorig_initial_facts, no_params, atoms );
+	for ( unsigned k = 0; k < atoms.size(); k++ )
+		task.add_init( atoms[k] );
+	atoms.clear();
+	get_literals( task, gorig_goal_facts, no_params, atoms );
+	for ( unsigned k = 0; k < atoms.size(); k++ )
+		task.add_goal( atoms[k] );
+}
+
 }
 
 }
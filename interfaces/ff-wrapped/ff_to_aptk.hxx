@@ -23,17 +23,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <string>
 #include <strips_prob.hxx>
-#include <libff/libff.h>
+#include <lifted_task.hxx>
 
 namespace aptk
 {
 
 namespace FF_Parser
 {
+	// Reads the task with a FF context of its own, so several threads
+	// can be loading tasks at the same time
 	void get_problem_description( 	std::string pddl_domain_path,
 					std::string pddl_problem_path,
 					STRIPS_Problem& strips_problem,
 					bool get_detailed_fluent_names = false );
+
+	// Reads the task without grounding it, for agnostic::Relaxed_Grounder.
+	// Throws std::runtime_error when the domain uses something other than
+	// typed STRIPS with equality and negated static preconditions.
+	void get_lifted_task(	std::string pddl_domain_path,
+				std::string pddl_problem_path,
+				agnostic::Lifted_Task& task );
 }
 
 }
@@ -41,6 +41,7 @@ Bit_Array::Bit_Array( unsigned dim )
 Bit_Array::Bit_Array( const Bit_Array& other )
 {
 	m_pack_sz = 32;
+	m_max_idx = other.m_max_idx;
 	m_n_packs = other.m_n_packs;
 	m_packs = new unsigned [m_n_packs];
 	memcpy( m_packs, other.m_packs, m_n_packs*sizeof(unsigned) );
@@ -51,6 +52,8 @@ void Bit_Array::resize( unsigned dim )
 	m_max_idx = dim+1;
 	unsigned nbits = (dim+1);
 	m_n_packs = (nbits/32)+1;
+	if ( m_packs != NULL )
+		delete [] m_packs;
 	m_packs = new unsigned[m_n_packs];
 	memset( m_packs, 0, m_n_packs*sizeof(unsigned) );
 }
@@ -0,0 +1,97 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <aptk/budget.hxx>
+#include <aptk/resources_control.hxx>
+#include <algorithm>
+#include <limits>
+
+namespace aptk
+{
+
+// The memory used is read once in this many secs
+static const double	memory_interval = 0.05;
+// Least time between degradations before the limit is reached
+static const double	degrade_interval = 1.0;
+static const double	unlimited = std::numeric_limits<double>::infinity();
+static const long	max_period = 1 << 20;
+
+Budget::Budget()
+	: m_time( unlimited ), m_memory( unlimited ), m_interval( 0.001 ), m_t0( 0.0 ), m_last( 0.0 ),
+	m_last_memory( 0.0 ), m_last_degraded( 0.0 ), m_degradable( NULL ), m_period( 1 ), m_countdown( 1 ), m_checks( 0 ), m_hit( NONE ), m_stop( false ) {
+	start();
+}
+
+Budget::~Budget() {
+}
+
+void	Budget::start() {
+	m_t0 = m_last = m_last_memory = wall_time();
+	m_last_degraded = m_t0 - degrade_interval;
+	m_period = m_countdown = 1;
+	m_hit = NONE;
+	m_stop = false;
+}
+
+double	Budget::elapsed() const {
+	return wall_time() - m_t0;
+}
+
+bool	Budget::check() {
+	double now = wall_time();
+	m_checks++;
+	// Calls expected until the next check, from the rate since the last
+	double dt = now - m_last;
+	if ( dt > 0.0 )
+		m_period = std::max( 1L, std::min( max_period, (long)( m_period * m_interval / dt ) ) );
+	else
+		m_period = std::min( max_period, 2 * m_period );
+	m_countdown = m_period;
+	m_last = now;
+
+	if ( now - m_t0 > m_time ) {
+		m_hit = TIME;
+		stop();
+		return true;
+	}
+	Memory_Budget& shared = Memory_Budget::instance();
+	if ( ( m_memory < unlimited || shared.limited() ) && now - m_last_memory >= memory_interval ) {
+		m_last_memory = now;
+		if ( m_memory < unlimited && mem_used() > m_memory ) {
+			m_hit = MEMORY;
+			stop();
+			return true;
+		}
+		Memory_Budget::Pressure p = shared.pressure();
+		if ( p != Memory_Budget::NONE && m_degradable != NULL
+			&& ( p == Memory_Budget::CRITICAL || now - m_last_degraded >= degrade_interval ) ) {
+			if ( m_degradable->degrade( shared ) )
+				m_last_degraded = now;
+		}
+		if ( p != Memory_Budget::NONE && shared.pressure() == Memory_Budget::CRITICAL ) {
+			m_hit = MEMORY;
+			stop();
+			return true;
+		}
+	}
+	return false;
+}
+
+}
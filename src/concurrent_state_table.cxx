@@ -0,0 +1,249 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <aptk/concurrent_state_table.hxx>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+
+namespace aptk
+{
+
+const Concurrent_State_Table::State_ID	Concurrent_State_Table::no_state;
+const uint64_t				Concurrent_State_Table::frozen_bit;
+const size_t				Concurrent_State_Table::migrate_chunk;
+
+Concurrent_State_Table::Index::Index( size_t cap )
+	: capacity( cap ), slots( new std::atomic<uint64_t>[cap] ), next( NULL ),
+	migrate_cursor( 0 ), migrated( 0 ), retired( NULL )
+{
+	for ( size_t i = 0; i < cap; i++ )
+		slots[i].store( 0, std::memory_order_relaxed );
+}
+
+Concurrent_State_Table::Index::~Index()
+{
+	delete [] slots;
+}
+
+Concurrent_State_Table::Segment::Segment( unsigned payload_words )
+	: fps( new uint64_t[segment_size] ), g( new std::atomic<Word>[segment_size] ),
+	payloads( new Word[ (size_t)segment_size * payload_words ] )
+{
+}
+
+Concurrent_State_Table::Segment::~Segment()
+{
+	delete [] fps;
+	delete [] g;
+	delete [] payloads;
+}
+
+Concurrent_State_Table::Concurrent_State_Table( unsigned payload_words, size_t initial_capacity )
+	: m_payload_words( payload_words ), m_index( NULL ), m_segments( new std::atomic<Segment*>[max_segments] ),
+	m_next_id( 0 ), m_size( 0 ), m_resizes( 0 )
+{
+	// Capacity has to be a power of two, and large enough for every thread
+	// to overshoot the load factor a bit before the table grows
+	size_t cap = 1024;
+	while ( cap < initial_capacity ) cap <<= 1;
+	m_index.store( new Index( cap ) );
+	for ( unsigned k = 0; k < max_segments; k++ )
+		m_segments[k].store( NULL, std::memory_order_relaxed );
+}
+
+Concurrent_State_Table::~Concurrent_State_Table()
+{
+	Index* idx = m_index.load();
+	while ( idx != NULL ) {
+		Index* prev = idx->retired;
+		delete idx;
+		idx = prev;
+	}
+	for ( unsigned k = 0; k < max_segments; k++ )
+		delete m_segments[k].load();
+	delete [] m_segments;
+}
+
+uint64_t Concurrent_State_Table::hash( const Word* payload, unsigned n )
+{
+	uint64_t h = 0x9E3779B97F4A7C15ULL ^ ( (uint64_t)n * 0xC2B2AE3D27D4EB4FULL );
+	for ( unsigned k = 0; k < n; k++ ) {
+		h ^= (uint64_t)payload[k] * 0x87C37B91114253D5ULL;
+		h = ( ( h << 31 ) | ( h >> 33 ) ) * 0x4CF5AD432745937FULL;
+	}
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDULL;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+Concurrent_State_Table::Segment* Concurrent_State_Table::reserve_segment( State_ID id )
+{
+	std::atomic<Segment*>& slot = m_segments[ id >> segment_bits ];
+	Segment* s = slot.load( std::memory_order_acquire );
+	if ( s != NULL ) return s;
+	Segment* fresh = new Segment( m_payload_words );
+	if ( slot.compare_exchange_strong( s, fresh ) )
+		return fresh;
+	delete fresh;
+	return s;
+}
+
+bool Concurrent_State_Table::matches( uint64_t v, uint64_t fp, const Word* payload ) const
+{
+	if ( slot_tag( v ) != ( ( fp >> 32 ) & 0x7FFFFFFFULL ) ) return false;
+	State_ID id = slot_id( v );
+	if ( fingerprint( id ) != fp ) return false;
+	return std::equal( payload, payload + m_payload_words, this->payload( id ) );
+}
+
+std::pair< Concurrent_State_Table::State_ID, bool >
+Concurrent_State_Table::insert( uint64_t fp, const Word* payload, float g )
+{
+	State_ID id = no_state;
+
+	while ( true ) {
+		Index* idx = m_index.load( std::memory_order_acquire );
+		if ( idx->next.load( std::memory_order_acquire ) != NULL ) {
+			help_migrate( idx );
+			continue;
+		}
+
+		size_t mask = idx->capacity - 1;
+		size_t i = fp & mask;
+		bool retry = false;
+		while ( !retry ) {
+			uint64_t v = idx->slots[i].load( std::memory_order_acquire );
+			if ( v == 0 ) {
+				// Entry is written once, and only made visible by the
+				// slot CAS
+				if ( id == no_state ) {
+					id = m_next_id.fetch_add( 1 );
+					if ( id == no_state )
+						throw std::runtime_error( "Concurrent_State_Table: out of state IDs" );
+					Segment* s = reserve_segment( id );
+					unsigned off = id & ( segment_size - 1 );
+					s->fps[off] = fp;
+					Word w;
+					std::memcpy( &w, &g, sizeof(w) );
+					s->g[off].store( w, std::memory_order_relaxed );
+					std::copy( payload, payload + m_payload_words, s->payloads + (size_t)off * m_payload_words );
+				}
+				if ( idx->slots[i].compare_exchange_strong( v, slot_value( fp, id ) ) ) {
+					size_t n = m_size.fetch_add( 1 ) + 1;
+					if ( n * 2 > idx->capacity )
+						grow( idx );
+					return std::make_pair( id, true );
+				}
+			}
+			if ( v & frozen_bit ) {
+				help_migrate( idx );
+				retry = true;
+				continue;
+			}
+			if ( v != 0 && matches( v, fp, payload ) )
+				return std::make_pair( slot_id( v ), false );
+			if ( v != 0 )
+				i = ( i + 1 ) & mask;
+		}
+	}
+}
+
+Concurrent_State_Table::State_ID Concurrent_State_Table::find( uint64_t fp, const Word* payload ) const
+{
+	// A table being migrated still has every entry it had before, so it can
+	// be read without helping
+	Index* idx = m_index.load( std::memory_order_acquire );
+	size_t mask = idx->capacity - 1;
+	for ( size_t i = fp & mask; ; i = ( i + 1 ) & mask ) {
+		uint64_t v = idx->slots[i].load( std::memory_order_acquire ) & ~frozen_bit;
+		if ( v == 0 ) return no_state;
+		if ( matches( v, fp, payload ) ) return slot_id( v );
+	}
+}
+
+bool Concurrent_State_Table::update_g( State_ID id, float g )
+{
+	std::atomic<Word>& cell = segment( id )->g[ id & ( segment_size - 1 ) ];
+	Word current = cell.load();
+	Word w;
+	std::memcpy( &w, &g, sizeof(w) );
+	while ( true ) {
+		float cv;
+		std::memcpy( &cv, &current, sizeof(cv) );
+		if ( !( g < cv ) ) return false;
+		if ( cell.compare_exchange_weak( current, w ) ) return true;
+	}
+}
+
+// Only called by migration, keys are already known to be unique
+bool Concurrent_State_Table::place( Index* idx, uint64_t v )
+{
+	size_t mask = idx->capacity - 1;
+	uint64_t fp = fingerprint( slot_id( v ) );
+	for ( size_t i = fp & mask; ; i = ( i + 1 ) & mask ) {
+		uint64_t empty = 0;
+		if ( idx->slots[i].compare_exchange_strong( empty, v ) )
+			return true;
+	}
+}
+
+void Concurrent_State_Table::grow( Index* idx )
+{
+	if ( idx->next.load() == NULL ) {
+		Index* fresh = new Index( idx->capacity * 2 );
+		fresh->retired = idx;
+		Index* none = NULL;
+		if ( !idx->next.compare_exchange_strong( none, fresh ) )
+			delete fresh;
+	}
+	help_migrate( idx );
+}
+
+// Threads claim chunks of slots, freeze them so nothing else can be
+// inserted there and copy them over. Whoever completes the last chunk
+// installs the new table, the others wait for it to happen.
+void Concurrent_State_Table::help_migrate( Index* idx )
+{
+	Index* next = idx->next.load( std::memory_order_acquire );
+	if ( next == NULL ) return;
+
+	while ( true ) {
+		size_t first = idx->migrate_cursor.fetch_add( migrate_chunk );
+		if ( first >= idx->capacity ) break;
+		size_t last = std::min( idx->capacity, first + migrate_chunk );
+		for ( size_t i = first; i < last; i++ ) {
+			uint64_t v = idx->slots[i].fetch_or( frozen_bit );
+			if ( v != 0 ) place( next, v );
+		}
+		if ( idx->migrated.fetch_add( last - first ) + ( last - first ) == idx->capacity ) {
+			m_index.store( next, std::memory_order_release );
+			m_resizes.fetch_add( 1 );
+		}
+	}
+
+	while ( m_index.load( std::memory_order_acquire ) == idx )
+		std::this_thread::yield();
+}
+
+}
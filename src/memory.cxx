@@ -19,11 +19,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <aptk/memory.hxx>
+#include <aptk/resources_control.hxx>
 #include <iostream>
+#include <limits>
 
 namespace aptk
 {
 
+static const double	unlimited = std::numeric_limits<double>::infinity();
+static const double	bytes_per_MB = 1024. * 1024.;
+
 void report_memory_usage()
 {
 	struct rusage usage_report;
@@ -33,6 +38,69 @@ void report_memory_usage()
 	std::cout << "Shared Memory Size:" << usage_report.ru_ixrss << std::endl;
 	std::cout << "Unshared Data Size:" << usage_report.ru_idrss << std::endl;
 	std::cout << "Unshared Stack Size:" << usage_report.ru_isrss << std::endl;
+	Memory_Budget::instance().report( std::cout );
+}
+
+Memory_Budget::Memory_Budget()
+	: m_limit( unlimited ), m_soft( 0.8 ), m_baseline( 0.0 ), m_degradations( 0 ), m_log( &std::cout ) {
+	for ( unsigned k = 0; k < NUM_SUBSYSTEMS; k++ )
+		m_bytes[k] = 0;
+}
+
+double	Memory_Budget::used( Subsystem s ) const {
+	return (double)m_bytes[s].load( std::memory_order_relaxed ) / bytes_per_MB;
+}
+
+double	Memory_Budget::used() const {
+	long total = 0;
+	for ( unsigned k = 0; k < NUM_SUBSYSTEMS; k++ )
+		total += m_bytes[k].load( std::memory_order_relaxed );
+	return (double)total / bytes_per_MB;
+}
+
+const char*	Memory_Budget::name( Subsystem s ) {
+	static const char* names[] = { "nodes", "states", "closed", "open", "heuristic", "novelty", "other" };
+	return names[s];
+}
+
+void	Memory_Budget::set_limit( double mb ) {
+	m_limit = mb;
+	m_baseline = mem_resident() - used();
+	if ( m_baseline < 0.0 ) m_baseline = 0.0;
+}
+
+bool	Memory_Budget::limited() const {
+	return m_limit < unlimited;
+}
+
+Memory_Budget::Pressure	Memory_Budget::pressure() const {
+	if ( !limited() ) return NONE;
+	double mb = in_use();
+	if ( mb >= m_limit ) return CRITICAL;
+	if ( mb >= m_soft * m_limit ) return HIGH;
+	return NONE;
+}
+
+void	Memory_Budget::degraded( const std::string& what, double freed ) {
+	m_degradations++;
+	std::lock_guard< std::mutex > lock( m_log_mutex );
+	*m_log << "Memory: " << in_use() << " MB of " << m_limit << " MB in use, " << what
+		<< ", " << freed << " MB freed" << std::endl;
+}
+
+void	Memory_Budget::report( std::ostream& os ) const {
+	os << "Memory used by search (MB):";
+	for ( unsigned k = 0; k < NUM_SUBSYSTEMS; k++ )
+		os << " " << name( (Subsystem)k ) << " " << used( (Subsystem)k );
+	os << std::endl;
+	if ( m_degradations > 0 )
+		os << "Degradations under memory pressure: " << m_degradations << std::endl;
+}
+
+double	Memory_Budget::address_space_limit() {
+	struct rlimit lim;
+	if ( getrlimit( RLIMIT_AS, &lim ) != 0 || lim.rlim_cur == RLIM_INFINITY ) return unlimited;
+	return (double)lim.rlim_cur / bytes_per_MB;
 }
 
 }
@@ -0,0 +1,71 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <aptk/solution_sink.hxx>
+#include <chrono>
+
+namespace aptk
+{
+
+Solution_Queue::Solution_Queue()
+	: m_ended( false ) {
+}
+
+Solution_Queue::~Solution_Queue() {
+}
+
+void	Solution_Queue::solution( const Solution& s ) {
+	Queue::Batch* b = new Queue::Batch;
+	b->items().push_back( s );
+	m_queue.push( b );
+	// Plans are few, so taking the lock here costs nothing worth counting
+	std::lock_guard< std::mutex > lock( m_mutex );
+	m_wake.notify_all();
+}
+
+void	Solution_Queue::ended( const Search_Stats& s ) {
+	std::lock_guard< std::mutex > lock( m_mutex );
+	m_final = s;
+	m_ended.store( true, std::memory_order_release );
+	m_wake.notify_all();
+}
+
+unsigned	Solution_Queue::pop( std::vector<Solution>& out ) {
+	unsigned count = 0;
+	Queue::Batch* b = m_queue.pop_all();
+	while ( b != NULL ) {
+		Queue::Batch* next = b->next();
+		for ( unsigned k = 0; k < b->items().size(); k++ ) {
+			out.push_back( b->items()[k] );
+			count++;
+		}
+		delete b;
+		b = next;
+	}
+	return count;
+}
+
+bool	Solution_Queue::wait( double secs ) {
+	std::unique_lock< std::mutex > lock( m_mutex );
+	return m_wake.wait_for( lock, std::chrono::duration<double>( secs ),
+		[this]() { return !m_queue.empty() || has_ended(); } );
+}
+
+}
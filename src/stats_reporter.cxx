@@ -0,0 +1,129 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <aptk/stats_reporter.hxx>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <cmath>
+
+namespace aptk
+{
+
+// The clock is read about once in this many secs by tick()
+static const double	check_interval = 0.001;
+static const long	max_period = 1 << 20;
+
+Search_Stats::Search_Stats()
+	: time( 0.0 ), expanded( 0 ), generated( 0 ), dead_ends( 0 ), open_repl( 0 ), pruned_bound( 0 ),
+	open( 0 ), closed( 0 ), best_h( std::numeric_limits<float>::infinity() ),
+	bound( std::numeric_limits<float>::infinity() ), depth( 0 ) {
+}
+
+Stats_Reporter::Stats_Reporter( std::ostream& os, Format format, double interval )
+	: m_os( os ), m_format( format ), m_interval( interval ), m_t0( wall_time() ),
+	m_last_check( m_t0 ), m_last_sample( m_t0 ), m_period( 1 ), m_countdown( 1 ),
+	m_prev_time( 0.0 ), m_prev_expanded( 0 ), m_done( false ) {
+	if ( m_format == CSV )
+		m_os << "time,expanded,generated,rate,open,closed,best_h,bound,depth,dead_ends,open_repl,pruned_bound,rss_mb" << std::endl;
+	m_writer = std::thread( &Stats_Reporter::write_loop, this );
+}
+
+Stats_Reporter::~Stats_Reporter() {
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+		m_done = true;
+	}
+	m_wake.notify_one();
+	m_writer.join();
+}
+
+bool	Stats_Reporter::due() {
+	double now = wall_time();
+	double dt = now - m_last_check;
+	if ( dt > 0.0 )
+		m_period = std::max( 1L, std::min( max_period, (long)( m_period * check_interval / dt ) ) );
+	else
+		m_period = std::min( max_period, 2 * m_period );
+	m_countdown = m_period;
+	m_last_check = now;
+	if ( now - m_last_sample < m_interval ) return false;
+	m_last_sample = now;
+	return true;
+}
+
+void	Stats_Reporter::write_loop() {
+	std::unique_lock< std::mutex > lock( m_mutex );
+	while ( !m_done ) {
+		m_wake.wait_for( lock, std::chrono::milliseconds( 50 ) );
+		write_queued();
+	}
+	write_queued();
+}
+
+void	Stats_Reporter::write_queued() {
+	Queue::Batch* b = m_queue.pop_all();
+	if ( b == NULL ) return;
+	while ( b != NULL ) {
+		for ( unsigned k = 0; k < b->items().size(); k++ )
+			write( b->items()[k] );
+		Queue::Batch* next = b->next();
+		delete b;
+		b = next;
+	}
+	m_os.flush();
+}
+
+// Infinite h and bounds are written as null, or left empty in CSV
+static void	write_value( std::ostream& os, float v, bool json ) {
+	if ( std::isinf( v ) ) {
+		if ( json ) os << "null";
+	}
+	else
+		os << v;
+}
+
+void	Stats_Reporter::write( const Search_Stats& s ) {
+	double dt = s.time - m_prev_time;
+	double rate = dt > 0.0 ? ( s.expanded - m_prev_expanded ) / dt : 0.0;
+	m_prev_time = s.time;
+	m_prev_expanded = s.expanded;
+	double rss = mem_resident();
+
+	if ( m_format == CSV ) {
+		m_os << s.time << "," << s.expanded << "," << s.generated << "," << rate << ","
+			<< s.open << "," << s.closed << ",";
+		write_value( m_os, s.best_h, false );
+		m_os << ",";
+		write_value( m_os, s.bound, false );
+		m_os << "," << s.depth << "," << s.dead_ends << "," << s.open_repl << ","
+			<< s.pruned_bound << "," << rss << "\n";
+		return;
+	}
+	m_os << "{\"time\":" << s.time << ",\"expanded\":" << s.expanded << ",\"generated\":" << s.generated
+		<< ",\"rate\":" << rate << ",\"open\":" << s.open << ",\"closed\":" << s.closed << ",\"best_h\":";
+	write_value( m_os, s.best_h, true );
+	m_os << ",\"bound\":";
+	write_value( m_os, s.bound, true );
+	m_os << ",\"depth\":" << s.depth << ",\"dead_ends\":" << s.dead_ends << ",\"open_repl\":" << s.open_repl
+		<< ",\"pruned_bound\":" << s.pruned_bound << ",\"rss_mb\":" << rss << "}\n";
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+Lightweight Automated Planning Toolkit
+Copyright (C) 2012
+Miquel Ramirez <miquel.ramirez@rmit.edu.au>
+Nir Lipovetzky <nirlipo@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <aptk/trace.hxx>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace aptk
+{
+
+Trace_Writer::Trace_Writer( std::string filename, uint64_t capacity )
+	: m_fd( -1 ), m_header( NULL ), m_ring( NULL ), m_capacity( capacity ), m_mapped( 0 ),
+	m_recorded( 0 ), m_batch( NULL ), m_done( false ) {
+	m_fd = open( filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+	if ( m_fd < 0 ) {
+		std::cerr << "Could not open trace file " << filename << std::endl;
+		return;
+	}
+	m_mapped = sizeof(Trace_Header) + m_capacity * sizeof(Trace_Record);
+	void* p = MAP_FAILED;
+	if ( ftruncate( m_fd, m_mapped ) == 0 )
+		p = mmap( NULL, m_mapped, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+	if ( p == MAP_FAILED ) {
+		std::cerr << "Could not map trace file " << filename << std::endl;
+		close( m_fd );
+		m_fd = -1;
+		return;
+	}
+	m_header = (Trace_Header*)p;
+	memset( m_header, 0, sizeof(Trace_Header) );
+	memcpy( m_header->magic, magic(), sizeof(m_header->magic) );
+	m_header->version = 1;
+	m_header->record_size = sizeof(Trace_Record);
+	m_header->capacity = m_capacity;
+	m_ring = (Trace_Record*)( m_header + 1 );
+	m_writer = std::thread( &Trace_Writer::write_loop, this );
+}
+
+Trace_Writer::~Trace_Writer() {
+	if ( m_batch != NULL ) m_full.push( m_batch );
+	m_batch = NULL;
+	if ( m_writer.joinable() ) {
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_done = true;
+		}
+		m_wake.notify_one();
+		m_writer.join();
+	}
+	for ( Queue::Batch* b = m_empty.pop_all(); b != NULL; ) {
+		Queue::Batch* next = b->next();
+		delete b;
+		b = next;
+	}
+	for ( unsigned k = 0; k < m_spare.size(); k++ )
+		delete m_spare[k];
+	if ( m_header != NULL ) {
+		msync( m_header, m_mapped, MS_SYNC );
+		munmap( m_header, m_mapped );
+	}
+	if ( m_fd >= 0 ) close( m_fd );
+}
+
+void	Trace_Writer::next_batch() {
+	if ( m_batch != NULL ) {
+		if ( good() )
+			m_full.push( m_batch );
+		else {
+			// Nowhere to write to, records are dropped
+			m_batch->items().clear();
+			return;
+		}
+	}
+	if ( m_spare.empty() )
+		for ( Queue::Batch* b = m_empty.pop_all(); b != NULL; b = b->next() )
+			m_spare.push_back( b );
+	if ( m_spare.empty() ) {
+		m_batch = new Queue::Batch;
+		m_batch->items().reserve( batch_size );
+		return;
+	}
+	m_batch = m_spare.back();
+	m_spare.pop_back();
+}
+
+void	Trace_Writer::write_loop() {
+	std::unique_lock< std::mutex > lock( m_mutex );
+	while ( !m_done ) {
+		m_wake.wait_for( lock, std::chrono::milliseconds( 20 ) );
+		write_queued();
+	}
+	write_queued();
+}
+
+void	Trace_Writer::write_queued() {
+	Queue::Batch* b = m_full.pop_all();
+	while ( b != NULL ) {
+		Queue::Batch* next = b->next();
+		const std::vector< Trace_Record >& items = b->items();
+		uint64_t written = m_header->written;
+		for ( unsigned k = 0; k < items.size(); ) {
+			uint64_t pos = written % m_capacity;
+			uint64_t n = std::min( (uint64_t)( items.size() - k ), m_capacity - pos );
+			memcpy( m_ring + pos, &items[k], n * sizeof(Trace_Record) );
+			k += n;
+			written += n;
+		}
+		m_header->written = written;
+		b->items().clear();
+		m_empty.push( b );
+		b = next;
+	}
+}
+
+}